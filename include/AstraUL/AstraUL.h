@@ -9,5 +9,8 @@
 #include "streams/DebugHand.h"
 #include "streams/Skeleton.h"
 #include "streams/Point.h"
+#include "streams/Normal.h"
+#include "streams/ColoredPoint.h"
+#include "streams/Gesture.h"
 
 #endif /* ASTRAUL_H */
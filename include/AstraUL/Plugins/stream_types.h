@@ -5,6 +5,7 @@
 #include <AstraUL/streams/color_types.h>
 #include <AstraUL/streams/hand_types.h>
 #include <AstraUL/streams/image_types.h>
+#include <AstraUL/streams/gesture_types.h>
 
 // https://gcc.gnu.org/onlinedocs/gcc/Zero-Length.html
 // http://stackoverflow.com/questions/3350852/how-to-correctly-fix-zero-sized-array-in-struct-union-warning-c4200-without
@@ -38,6 +39,12 @@ struct _astra_handframe {
     astra_handpoint_t* handpoints;
 } PACK_STRUCT;
 
+struct _astra_gestureframe {
+    astra_frame_t* frame;
+    size_t eventCount;
+    astra_gesture_event_t* events;
+} PACK_STRUCT;
+
 #if defined(_MSC_VER)
 #pragma warning( push )
 #pragma warning( disable : 4200 )
@@ -56,6 +63,11 @@ typedef struct _astra_handframe_wrapper {
     char frame_data[];
 } PACK_STRUCT astra_handframe_wrapper_t;
 
+typedef struct _astra_gestureframe_wrapper {
+    _astra_gestureframe frame;
+    char frame_data[];
+} PACK_STRUCT astra_gestureframe_wrapper_t;
+
 #if defined(_MSC_VER)
 #pragma warning( pop )
 #elif defined(__GNUC__)
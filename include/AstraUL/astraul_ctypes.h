@@ -33,6 +33,9 @@ enum astra_core_stream_types {
     ASTRA_STREAM_SKELETON = 5,
     ASTRA_STREAM_STYLIZED_DEPTH = 6,
     ASTRA_STREAM_POINT = 7,
+    ASTRA_STREAM_NORMAL = 8,
+    ASTRA_STREAM_COLORED_POINT = 9,
+    ASTRA_STREAM_GESTURE = 10,
     ASTRA_STREAM_DEBUG_HAND = 3001,
 };
 
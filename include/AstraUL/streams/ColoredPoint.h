@@ -0,0 +1,73 @@
+#ifndef COLOREDPOINT_H
+#define COLOREDPOINT_H
+
+#include <Astra/Astra.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/streams/colored_point_capi.h>
+#include <AstraUL/streams/Image.h>
+
+namespace astra {
+
+    // Depth points with the color sampled at their projection into the color
+    // camera. The projection uses the calibration of the registered depth
+    // stream (ASTRA_DEPTH_SUBTYPE_REGISTERED).
+    class ColoredPointStream : public DataStream
+    {
+    public:
+        ColoredPointStream()
+        {}
+
+        explicit ColoredPointStream(astra_streamconnection_t connection)
+            : DataStream(connection)
+        {
+            m_coloredPointStream = reinterpret_cast<astra_coloredpointstream_t>(connection);
+        }
+
+        static const astra_stream_type_t id = ASTRA_STREAM_COLORED_POINT;
+
+        astra_colored_point_layout_t layout()
+        {
+            astra_colored_point_layout_t layout = ASTRA_COLORED_POINT_LAYOUT_INTERLEAVED;
+            astra_coloredpointstream_get_layout(m_coloredPointStream, &layout);
+
+            return layout;
+        }
+
+        // interleaved frames are read with ColoredPointFrame,
+        // planar frames with PlanarColoredPointFrame
+        void set_layout(astra_colored_point_layout_t layout)
+        {
+            astra_coloredpointstream_set_layout(m_coloredPointStream, layout);
+        }
+
+    private:
+        astra_coloredpointstream_t m_coloredPointStream;
+    };
+
+    class ColoredPointFrame : public ImageFrame<astra_colored_point_t, ASTRA_STREAM_COLORED_POINT>
+    {
+    public:
+        ColoredPointFrame(astra_imageframe_t frame)
+            : ImageFrame(frame, ASTRA_PIXEL_FORMAT_COLORED_POINT)
+        {}
+    };
+
+    class PlanarColoredPointFrame : public ImageFrame<uint8_t, ASTRA_STREAM_COLORED_POINT>
+    {
+    public:
+        PlanarColoredPointFrame(astra_imageframe_t frame)
+            : ImageFrame(frame, ASTRA_PIXEL_FORMAT_COLORED_POINT_PLANAR)
+        {}
+
+        const float* x_plane() { return reinterpret_cast<const float*>(data()); }
+        const float* y_plane() { return x_plane() + numberOfPixels(); }
+        const float* z_plane() { return y_plane() + numberOfPixels(); }
+
+        const uint8_t* r_plane() { return reinterpret_cast<const uint8_t*>(z_plane() + numberOfPixels()); }
+        const uint8_t* g_plane() { return r_plane() + numberOfPixels(); }
+        const uint8_t* b_plane() { return g_plane() + numberOfPixels(); }
+        const uint8_t* alpha_plane() { return b_plane() + numberOfPixels(); }
+    };
+}
+
+#endif // COLOREDPOINT_H
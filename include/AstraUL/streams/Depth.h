@@ -66,6 +66,27 @@ namespace astra {
                                          depthX, depthY, depthZ);
         }
 
+        // converts count points at once; depthPoints and worldPoints may alias
+        void convert_depth_to_world(const Vector3f* depthPoints,
+                                    Vector3f* worldPoints,
+                                    size_t count) const
+        {
+            astra_convert_depth_to_world_array(m_depthStream,
+                                               depthPoints,
+                                               worldPoints,
+                                               count);
+        }
+
+        void convert_world_to_depth(const Vector3f* worldPoints,
+                                    Vector3f* depthPoints,
+                                    size_t count) const
+        {
+            astra_convert_world_to_depth_array(m_depthStream,
+                                               worldPoints,
+                                               depthPoints,
+                                               count);
+        }
+
     private:
         astra_depthstream_t m_depthStream;
     };
@@ -102,6 +123,35 @@ namespace astra {
             astra_depthstream_set_registration(m_depthStream, enable);
         }
 
+        // supported by streams that warp depth between cameras,
+        // such as the ASTRA_DEPTH_SUBTYPE_REGISTERED depth stream
+        astra_depth_calibration_t calibration()
+        {
+            astra_depth_calibration_t calibration;
+            astra_depthstream_get_calibration(m_depthStream, &calibration);
+
+            return calibration;
+        }
+
+        void set_calibration(const astra_depth_calibration_t& calibration)
+        {
+            astra_depthstream_set_calibration(m_depthStream, &calibration);
+        }
+
+        // supported by the ASTRA_DEPTH_SUBTYPE_FILTERED depth stream
+        astra_depth_filter_settings_t filter_settings()
+        {
+            astra_depth_filter_settings_t settings;
+            astra_depthstream_get_filter_settings(m_depthStream, &settings);
+
+            return settings;
+        }
+
+        void set_filter_settings(const astra_depth_filter_settings_t& settings)
+        {
+            astra_depthstream_set_filter_settings(m_depthStream, &settings);
+        }
+
         const CoordinateMapper& coordinateMapper() { return m_coordinateMapper; };
 
     private:
@@ -0,0 +1,109 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <Astra/Astra.h>
+#include <stdexcept>
+#include <vector>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/streams/gesture_capi.h>
+
+namespace astra {
+
+    using GestureEvent = astra_gesture_event_t;
+    using GestureEventList = std::vector<GestureEvent>;
+
+    class GestureStream : public DataStream
+    {
+    public:
+        explicit GestureStream(astra_streamconnection_t connection)
+            : DataStream(connection),
+              m_gestureStream(connection)
+        { }
+
+        static const astra_stream_type_t id = ASTRA_STREAM_GESTURE;
+
+    private:
+        astra_gesturestream_t m_gestureStream;
+    };
+
+    class GestureFrame
+    {
+    public:
+        template<typename TFrameType>
+        static TFrameType acquire(astra_reader_frame_t readerFrame,
+                                  astra_stream_subtype_t subtype)
+        {
+            if (readerFrame != nullptr)
+            {
+                astra_gestureframe_t gestureFrame;
+                astra_frame_get_gestureframe_with_subtype(readerFrame, subtype, &gestureFrame);
+                return TFrameType(gestureFrame);
+            }
+
+            return TFrameType(nullptr);
+        }
+
+        GestureFrame(astra_gestureframe_t gestureFrame)
+        {
+            m_gestureFrame = gestureFrame;
+            if (m_gestureFrame)
+            {
+                astra_gestureframe_get_frameindex(m_gestureFrame, &m_frameIndex);
+            }
+        }
+
+        //false when the reader frame has no gesture frame. A frame where no
+        //gesture was recognized is valid and has no events.
+        bool is_valid() { return m_gestureFrame != nullptr; }
+        astra_gestureframe_t handle() { return m_gestureFrame; }
+
+        size_t event_count()
+        {
+            throwIfInvalidFrame();
+            verify_eventlist();
+            return m_events.size();
+        }
+
+        const GestureEventList& events()
+        {
+            throwIfInvalidFrame();
+            verify_eventlist();
+            return m_events;
+        }
+
+        astra_frame_index_t frameIndex() { throwIfInvalidFrame(); return m_frameIndex; }
+
+    private:
+        void throwIfInvalidFrame()
+        {
+            if (m_gestureFrame == nullptr)
+            {
+                throw std::logic_error("Cannot operate on an invalid frame");
+            }
+        }
+
+        void verify_eventlist()
+        {
+            if (m_eventsInitialized)
+            {
+                return;
+            }
+
+            m_eventsInitialized = true;
+
+            astra_gesture_event_t* eventPtr;
+            size_t eventCount;
+
+            astra_gestureframe_get_shared_event_array(m_gestureFrame, &eventPtr, &eventCount);
+
+            m_events.assign(eventPtr, eventPtr + eventCount);
+        }
+
+        bool m_eventsInitialized{ false };
+        GestureEventList m_events;
+        astra_gestureframe_t m_gestureFrame{nullptr};
+        astra_frame_index_t m_frameIndex;
+    };
+}
+
+#endif /* GESTURE_H */
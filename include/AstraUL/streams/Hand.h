@@ -3,6 +3,7 @@
 
 #include <Astra/Astra.h>
 #include <stdexcept>
+#include <string>
 #include <AstraUL/astraul_ctypes.h>
 #include <AstraUL/streams/hand_capi.h>
 #include <AstraUL/Vector.h>
@@ -80,6 +81,53 @@ namespace astra {
         {
             astra_handstream_set_include_candidate_points(m_handStream, includeCandidatePoints);
         }
+
+        astra_hand_processing_size_t get_processing_size()
+        {
+            astra_hand_processing_size_t processingSize;
+            astra_handstream_get_processing_size(m_handStream, &processingSize);
+            return processingSize;
+        }
+
+        void set_processing_size(int width, int height)
+        {
+            astra_hand_processing_size_t processingSize;
+            processingSize.width = width;
+            processingSize.height = height;
+            astra_handstream_set_processing_size(m_handStream, processingSize);
+        }
+
+        bool get_adaptive_processing_size()
+        {
+            bool adaptiveProcessingSize;
+            astra_handstream_get_adaptive_processing_size(m_handStream, &adaptiveProcessingSize);
+            return adaptiveProcessingSize;
+        }
+
+        void set_adaptive_processing_size(bool adaptiveProcessingSize)
+        {
+            astra_handstream_set_adaptive_processing_size(m_handStream, adaptiveProcessingSize);
+        }
+
+        //the most hands a frame holds
+        size_t get_max_hand_count()
+        {
+            size_t maxHandCount = 0;
+            astra_handstream_get_max_hand_count(m_handStream, &maxHandCount);
+            return maxHandCount;
+        }
+
+        //applies TOML settings before the next frame, false if they do not parse
+        bool update_settings(const std::string& settings)
+        {
+            return astra_handstream_update_settings(m_handStream, settings.c_str()) == ASTRA_STATUS_SUCCESS;
+        }
+
+        //rereads orbbec_hand.toml before the next frame
+        void reload_settings()
+        {
+            astra_handstream_reload_settings(m_handStream);
+        }
     private:
         astra_handstream_t m_handStream;
     };
@@ -108,10 +156,10 @@ namespace astra {
             {
                 astra_handframe_get_frameindex(m_handFrame, &m_frameIndex);
 
-                size_t maxHandCount;
-                astra_handframe_get_hand_count(m_handFrame, &maxHandCount);
+                size_t handCount;
+                astra_handframe_get_hand_count(m_handFrame, &handCount);
 
-                m_handPoints.reserve(maxHandCount);
+                m_handPoints.reserve(handCount);
             }
         }
 
@@ -153,11 +201,12 @@ namespace astra {
             m_handPointsInitialized = true;
 
             astra_handpoint_t* handPtr;
-            size_t maxHandCount;
+            size_t handCount;
 
-            astra_handframe_get_shared_hand_array(m_handFrame, &handPtr, &maxHandCount);
+            astra_handframe_get_shared_hand_array(m_handFrame, &handPtr, &handCount);
 
-            for (size_t i = 0; i < maxHandCount; ++i, ++handPtr)
+            //padded frames end in entries that are not tracking
+            for (size_t i = 0; i < handCount; ++i, ++handPtr)
             {
                 astra_handpoint_t& p = *handPtr;
                 if (p.status != astra_handstatus_t::HAND_STATUS_NOTTRACKING)
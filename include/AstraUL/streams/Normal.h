@@ -0,0 +1,53 @@
+#ifndef NORMAL_H
+#define NORMAL_H
+
+#include <Astra/Astra.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/streams/normal_capi.h>
+#include <AstraUL/streams/Image.h>
+#include <AstraUL/Vector.h>
+
+namespace astra {
+
+    class NormalStream : public DataStream
+    {
+    public:
+        NormalStream()
+        {}
+
+        explicit NormalStream(astra_streamconnection_t connection)
+            : DataStream(connection)
+        {
+            m_normalStream = reinterpret_cast<astra_normalstream_t>(connection);
+        }
+
+        static const astra_stream_type_t id = ASTRA_STREAM_NORMAL;
+
+        int smoothing_radius()
+        {
+            int32_t radius = 0;
+            astra_normalstream_get_smoothing_radius(m_normalStream, &radius);
+
+            return radius;
+        }
+
+        // box radius in pixels applied to the normal map, 0 disables smoothing
+        void set_smoothing_radius(int radius)
+        {
+            astra_normalstream_set_smoothing_radius(m_normalStream, radius);
+        }
+
+    private:
+        astra_normalstream_t m_normalStream;
+    };
+
+    class NormalFrame : public ImageFrame<Vector3f, ASTRA_STREAM_NORMAL>
+    {
+    public:
+        NormalFrame(astra_imageframe_t frame)
+            : ImageFrame(frame, ASTRA_PIXEL_FORMAT_NORMAL)
+        {}
+    };
+}
+
+#endif // NORMAL_H
@@ -0,0 +1,44 @@
+#ifndef COLORED_POINT_CAPI_H
+#define COLORED_POINT_CAPI_H
+
+#include <Astra/astra_defines.h>
+#include <Astra/astra_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include "colored_point_types.h"
+
+ASTRA_BEGIN_DECLS
+
+ASTRA_API_EX astra_status_t astra_reader_get_coloredpointstream(astra_reader_t reader,
+                                                                astra_coloredpointstream_t* coloredPointStream);
+
+ASTRA_API_EX astra_status_t astra_frame_get_coloredpointframe(astra_reader_frame_t readerFrame,
+                                                              astra_coloredpointframe_t* coloredPointFrame);
+
+ASTRA_API_EX astra_status_t astra_frame_get_coloredpointframe_with_subtype(astra_reader_frame_t readerFrame,
+                                                                           astra_stream_subtype_t subtype,
+                                                                           astra_coloredpointframe_t* coloredPointFrame);
+
+ASTRA_API_EX astra_status_t astra_coloredpointstream_get_layout(astra_coloredpointstream_t coloredPointStream,
+                                                                astra_colored_point_layout_t* layout);
+
+ASTRA_API_EX astra_status_t astra_coloredpointstream_set_layout(astra_coloredpointstream_t coloredPointStream,
+                                                                astra_colored_point_layout_t layout);
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_data_byte_length(astra_coloredpointframe_t coloredPointFrame,
+                                                                         size_t* byteLength);
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_data_ptr(astra_coloredpointframe_t coloredPointFrame,
+                                                                 void** data,
+                                                                 size_t* byteLength);
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_copy_data(astra_coloredpointframe_t coloredPointFrame,
+                                                              void* data);
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_metadata(astra_coloredpointframe_t coloredPointFrame,
+                                                                 astra_image_metadata_t* metadata);
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_frameindex(astra_coloredpointframe_t coloredPointFrame,
+                                                                   astra_frame_index_t* index);
+ASTRA_END_DECLS
+
+#endif /* COLORED_POINT_CAPI_H */
@@ -0,0 +1,9 @@
+#ifndef COLORED_POINT_PARAMETERS_H
+#define COLORED_POINT_PARAMETERS_H
+
+enum
+{
+    ASTRA_PARAMETER_COLORED_POINT_LAYOUT = 0
+};
+
+#endif /* COLORED_POINT_PARAMETERS_H */
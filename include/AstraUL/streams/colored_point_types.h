@@ -0,0 +1,38 @@
+#ifndef COLORED_POINT_TYPES_H
+#define COLORED_POINT_TYPES_H
+
+#include <stdint.h>
+#include <Astra/astra_types.h>
+#include <AstraUL/streams/image_types.h>
+
+#ifdef _MSC_VER
+#pragma pack(push, 1)
+#endif
+
+// ASTRA_PIXEL_FORMAT_COLORED_POINT layout, one 16 byte record per depth pixel.
+// alpha is 255 when the point projected into the color image and 0 otherwise.
+typedef struct {
+    float x;
+    float y;
+    float z;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t alpha;
+} PACK_STRUCT astra_colored_point_t;
+
+#ifdef _MSC_VER
+#pragma pack(pop)
+#endif
+
+typedef enum {
+    // array of astra_colored_point_t
+    ASTRA_COLORED_POINT_LAYOUT_INTERLEAVED = 0,
+    // float x, y and z planes followed by uint8 r, g, b and alpha planes
+    ASTRA_COLORED_POINT_LAYOUT_PLANAR = 1
+} astra_colored_point_layout_t;
+
+typedef astra_streamconnection_t astra_coloredpointstream_t;
+typedef struct _astra_imageframe* astra_coloredpointframe_t;
+
+#endif // COLORED_POINT_TYPES_H
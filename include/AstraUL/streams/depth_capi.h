@@ -4,6 +4,8 @@
 #include <Astra/astra_defines.h>
 #include <Astra/astra_types.h>
 #include <AstraUL/streams/depth_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <stddef.h>
 #include <stdbool.h>
 
 ASTRA_BEGIN_DECLS
@@ -16,6 +18,18 @@ ASTRA_API_EX astra_status_t astra_convert_world_to_depth(astra_depthstream_t dep
                                                          float worldX, float worldY, float worldZ,
                                                          float* pDepthX, float* pDepthY, float* pDepthZ);
 
+// Convert count points per call, fetching the conversion data once.
+// The input and output arrays may be the same array.
+ASTRA_API_EX astra_status_t astra_convert_depth_to_world_array(astra_depthstream_t depthStream,
+                                                               const astra_vector3f_t* depthPoints,
+                                                               astra_vector3f_t* worldPoints,
+                                                               size_t count);
+
+ASTRA_API_EX astra_status_t astra_convert_world_to_depth_array(astra_depthstream_t depthStream,
+                                                               const astra_vector3f_t* worldPoints,
+                                                               astra_vector3f_t* depthPoints,
+                                                               size_t count);
+
 ASTRA_API_EX astra_status_t astra_reader_get_depthstream(astra_reader_t reader,
                                                          astra_depthstream_t* depthStream);
 
@@ -34,6 +48,18 @@ ASTRA_API_EX astra_status_t astra_depthstream_get_registration(astra_depthstream
 ASTRA_API_EX astra_status_t astra_depthstream_set_registration(astra_depthstream_t depthStream,
                                                                bool enabled);
 
+ASTRA_API_EX astra_status_t astra_depthstream_get_calibration(astra_depthstream_t depthStream,
+                                                              astra_depth_calibration_t* calibration);
+
+ASTRA_API_EX astra_status_t astra_depthstream_set_calibration(astra_depthstream_t depthStream,
+                                                              const astra_depth_calibration_t* calibration);
+
+ASTRA_API_EX astra_status_t astra_depthstream_get_filter_settings(astra_depthstream_t depthStream,
+                                                                  astra_depth_filter_settings_t* settings);
+
+ASTRA_API_EX astra_status_t astra_depthstream_set_filter_settings(astra_depthstream_t depthStream,
+                                                                  const astra_depth_filter_settings_t* settings);
+
 ASTRA_API_EX astra_status_t astra_frame_get_depthframe(astra_reader_frame_t readerFrame,
                                                        astra_depthframe_t* depthFrame);
 
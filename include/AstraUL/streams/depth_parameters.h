@@ -4,7 +4,9 @@
 enum
 {
     ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE = 100,
-    ASTRA_PARAMETER_DEPTH_REGISTRATION = 101
+    ASTRA_PARAMETER_DEPTH_REGISTRATION = 101,
+    ASTRA_PARAMETER_DEPTH_CALIBRATION = 102,
+    ASTRA_PARAMETER_DEPTH_FILTER_SETTINGS = 103
 };
 
 #endif /* DEPTH_PARAMETERS_H */
@@ -15,6 +15,51 @@ typedef struct {
     int halfResY;
 } conversion_cache_t;
 
+// pinhole camera model, in pixels
+typedef struct {
+    float fx;
+    float fy;
+    float cx;
+    float cy;
+    int width;
+    int height;
+} astra_camera_intrinsics_t;
+
+// rotation (row-major) and translation (mm) take a point from
+// depth camera coordinates to color camera coordinates
+typedef struct {
+    astra_camera_intrinsics_t depthIntrinsics;
+    astra_camera_intrinsics_t colorIntrinsics;
+    float rotation[9];
+    float translation[3];
+} astra_depth_calibration_t;
+
+// settings for the ASTRA_DEPTH_SUBTYPE_FILTERED depth stream, stages run
+// in the order listed
+typedef struct {
+    // holes are filled from the farther of the nearest valid pixels to the
+    // left and right, up to this many pixels away; 0 disables
+    int32_t holeFillRadius;
+    // box radius of the edge-preserving smoothing; 0 disables
+    int32_t spatialRadius;
+    // neighbors differing from the center by more than this (mm) are
+    // treated as belonging to another surface and left out of the average
+    float spatialEdgeThreshold;
+    // weight of the newest frame in the exponential moving average,
+    // 1 disables temporal filtering
+    float temporalAlpha;
+    // relative depth change that restarts the average instead of
+    // blending, so moving edges do not smear
+    float temporalJumpThreshold;
+} astra_depth_filter_settings_t;
+
+enum astra_depth_subtypes {
+    // depth warped into the color camera's frame of reference
+    ASTRA_DEPTH_SUBTYPE_REGISTERED = 1,
+    // hole filled, spatially and temporally smoothed depth
+    ASTRA_DEPTH_SUBTYPE_FILTERED = 2,
+};
+
 typedef astra_streamconnection_t astra_depthstream_t;
 typedef struct _astra_imageframe* astra_depthframe_t;
 
@@ -0,0 +1,38 @@
+#ifndef GESTURE_CAPI_H
+#define GESTURE_CAPI_H
+
+#include <Astra/astra_defines.h>
+#include <Astra/astra_types.h>
+#include "gesture_types.h"
+
+ASTRA_BEGIN_DECLS
+
+ASTRA_API_EX astra_status_t astra_reader_get_gesturestream(astra_reader_t reader,
+                                                           astra_gesturestream_t* gestureStream);
+
+// A gesture frame is written for every depth frame the hands are tracked
+// in, so gestures can be read from the same reader as hands. Frames where no
+// gesture was recognized have no events.
+ASTRA_API_EX astra_status_t astra_frame_get_gestureframe(astra_reader_frame_t readerFrame,
+                                                         astra_gestureframe_t* gestureFrame);
+
+ASTRA_API_EX astra_status_t astra_frame_get_gestureframe_with_subtype(astra_reader_frame_t readerFrame,
+                                                                      astra_stream_subtype_t subtype,
+                                                                      astra_gestureframe_t* gestureFrame);
+
+ASTRA_API_EX astra_status_t astra_gestureframe_get_frameindex(astra_gestureframe_t gestureFrame,
+                                                              astra_frame_index_t* index);
+
+ASTRA_API_EX astra_status_t astra_gestureframe_get_event_count(astra_gestureframe_t gestureFrame,
+                                                               size_t* eventCount);
+
+ASTRA_API_EX astra_status_t astra_gestureframe_copy_events(astra_gestureframe_t gestureFrame,
+                                                           astra_gesture_event_t* eventsDestination);
+
+ASTRA_API_EX astra_status_t astra_gestureframe_get_shared_event_array(astra_gestureframe_t gestureFrame,
+                                                                      astra_gesture_event_t** events,
+                                                                      size_t* eventCount);
+
+ASTRA_END_DECLS
+
+#endif // GESTURE_CAPI_H
@@ -0,0 +1,32 @@
+#ifndef GESTURE_TYPES_H
+#define GESTURE_TYPES_H
+
+#include <Astra/astra_types.h>
+#include <AstraUL/astraul_ctypes.h>
+
+//events one gesture frame can hold, further events in the same frame are dropped
+#define ASTRA_GESTURES_MAX_EVENT_COUNT 32
+
+typedef enum _astra_gesture_type {
+    //the hand waved, candidate hands become tracked hands on it
+    ASTRA_GESTURE_WAVE,
+    //the hand stopped moving
+    ASTRA_GESTURE_STEADY,
+    //the hand turned back during a wave
+    ASTRA_GESTURE_INFLECTION
+} astra_gesture_type_t;
+
+typedef struct _astra_gesture_event {
+    int32_t trackingId;
+    astra_gesture_type_t type;
+    //index of the depth frame the gesture was recognized in
+    astra_frame_index_t frameIndex;
+    //microseconds on a monotonic clock, for comparing events with each other
+    uint64_t timestamp;
+    astra_vector3f_t worldPosition;
+} astra_gesture_event_t;
+
+typedef struct _astra_gestureframe* astra_gestureframe_t;
+typedef astra_streamconnection_t astra_gesturestream_t;
+
+#endif // GESTURE_TYPES_H
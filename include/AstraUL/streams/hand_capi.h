@@ -20,6 +20,8 @@ ASTRA_API_EX astra_status_t astra_frame_get_handframe_with_subtype(astra_reader_
 ASTRA_API_EX astra_status_t astra_handframe_get_frameindex(astra_handframe_t handFrame,
                                                                     astra_frame_index_t* index);
 
+// The number of entries in the frame's hand array, which is the number of
+// hands reported unless the plugin pads frames to the maximum
 ASTRA_API_EX astra_status_t astra_handframe_get_hand_count(astra_handframe_t handFrame,
                                                                     size_t* handCount);
 
@@ -36,6 +38,31 @@ ASTRA_API_EX astra_status_t astra_handstream_get_include_candidate_points(astra_
 ASTRA_API_EX astra_status_t astra_handstream_set_include_candidate_points(astra_handstream_t handStream,
                                                                                    bool includeCandidatePoints);
 
+ASTRA_API_EX astra_status_t astra_handstream_get_processing_size(astra_handstream_t handStream,
+                                                                 astra_hand_processing_size_t* processingSize);
+
+ASTRA_API_EX astra_status_t astra_handstream_set_processing_size(astra_handstream_t handStream,
+                                                                 astra_hand_processing_size_t processingSize);
+
+ASTRA_API_EX astra_status_t astra_handstream_get_adaptive_processing_size(astra_handstream_t handStream,
+                                                                          bool* adaptiveProcessingSize);
+
+ASTRA_API_EX astra_status_t astra_handstream_set_adaptive_processing_size(astra_handstream_t handStream,
+                                                                          bool adaptiveProcessingSize);
+
+// The most hands a frame from this stream holds, for sizing copy buffers
+ASTRA_API_EX astra_status_t astra_handstream_get_max_hand_count(astra_handstream_t handStream,
+                                                                size_t* maxHandCount);
+
+// Applies TOML settings, e.g. "[pointprocessor]\nmaxHandPointUpdatesPerFrame = 5",
+// before the next frame is tracked. Returns ASTRA_STATUS_INVALID_PARAMETER if
+// they do not parse.
+ASTRA_API_EX astra_status_t astra_handstream_update_settings(astra_handstream_t handStream,
+                                                             const char* settings);
+
+// Rereads orbbec_hand.toml before the next frame is tracked.
+ASTRA_API_EX astra_status_t astra_handstream_reload_settings(astra_handstream_t handStream);
+
 ASTRA_API_EX astra_status_t astra_reader_get_debug_handstream(astra_reader_t reader,
                                                                        astra_debug_handstream_t* debugHandStream);
 
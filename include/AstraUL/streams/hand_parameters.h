@@ -9,6 +9,15 @@ enum
     ASTRA_PARAMETER_HAND_INCLUDE_CANDIDATE_POINTS = 3,
     ASTRA_PARAMETER_DEBUG_HAND_PAUSE_INPUT = 4,
     ASTRA_PARAMETER_DEBUG_HAND_LOCK_SPAWN_POINT = 5,
+    ASTRA_PARAMETER_HAND_PROCESSING_SIZE = 6,
+    ASTRA_PARAMETER_HAND_ADAPTIVE_PROCESSING_SIZE = 7,
+    ASTRA_PARAMETER_HAND_MAX_HAND_COUNT = 8,
+};
+
+enum
+{
+    ASTRA_COMMAND_HAND_UPDATE_SETTINGS = 0,
+    ASTRA_COMMAND_HAND_RELOAD_SETTINGS = 1,
 };
 
 #endif /* HAND_PARAMETERS_H */
@@ -4,6 +4,8 @@
 #include <Astra/astra_types.h>
 #include <AstraUL/astraul_ctypes.h>
 
+//the plugin's default for the most hands a hand frame holds, see
+//astra_handstream_get_max_hand_count for the stream's own
 #define ASTRA_HANDS_MAX_HAND_COUNT 10
 
 typedef enum _astra_debug_hand_view_type {
@@ -37,6 +39,13 @@ typedef struct _astra_handpoint {
     astra_vector3f_t worldDeltaPosition;
 } astra_handpoint_t;
 
+//resolution the depth frame is downscaled to before hands are tracked,
+//the depth frame size must be an integer multiple of it
+typedef struct _astra_hand_processing_size {
+    int32_t width;
+    int32_t height;
+} astra_hand_processing_size_t;
+
 typedef struct _astra_handframe* astra_handframe_t;
 typedef astra_streamconnection_t astra_handstream_t;
 
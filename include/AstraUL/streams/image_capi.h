@@ -3,6 +3,7 @@
 
 #include <Astra/astra_defines.h>
 #include <Astra/astra_types.h>
+#include <AstraUL/astraul_ctypes.h>
 #include <AstraUL/streams/image_types.h>
 
 ASTRA_BEGIN_DECLS
@@ -82,6 +83,17 @@ inline void astra_pixelformat_get_bytes_per_pixel(astra_pixel_format_t format,
     case astra_pixel_formats::ASTRA_PIXEL_FORMAT_YUYV:
         *bpp = 2;
         break;
+    case astra_pixel_formats::ASTRA_PIXEL_FORMAT_POINT:
+        *bpp = 12;
+        break;
+    case astra_pixel_formats::ASTRA_PIXEL_FORMAT_NORMAL:
+        //one astra_vector3f_t per pixel
+        *bpp = sizeof(astra_vector3f_t);
+        break;
+    case astra_pixel_formats::ASTRA_PIXEL_FORMAT_COLORED_POINT:
+    case astra_pixel_formats::ASTRA_PIXEL_FORMAT_COLORED_POINT_PLANAR:
+        *bpp = 16;
+        break;
     default:
         *bpp = 1;
         break;
@@ -28,6 +28,9 @@ typedef enum {
     ASTRA_PIXEL_FORMAT_GRAY16 = 301,
 
     ASTRA_PIXEL_FORMAT_POINT = 400,
+    ASTRA_PIXEL_FORMAT_NORMAL = 401,
+    ASTRA_PIXEL_FORMAT_COLORED_POINT = 402,
+    ASTRA_PIXEL_FORMAT_COLORED_POINT_PLANAR = 403,
 } astra_pixel_formats;
 
 typedef struct {
@@ -0,0 +1,44 @@
+#ifndef NORMAL_CAPI_H
+#define NORMAL_CAPI_H
+
+#include <Astra/astra_defines.h>
+#include <Astra/astra_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include "normal_types.h"
+
+ASTRA_BEGIN_DECLS
+
+ASTRA_API_EX astra_status_t astra_reader_get_normalstream(astra_reader_t reader,
+                                                          astra_normalstream_t* normalStream);
+
+ASTRA_API_EX astra_status_t astra_frame_get_normalframe(astra_reader_frame_t readerFrame,
+                                                        astra_normalframe_t* normalFrame);
+
+ASTRA_API_EX astra_status_t astra_frame_get_normalframe_with_subtype(astra_reader_frame_t readerFrame,
+                                                                     astra_stream_subtype_t subtype,
+                                                                     astra_normalframe_t* normalFrame);
+
+ASTRA_API_EX astra_status_t astra_normalstream_get_smoothing_radius(astra_normalstream_t normalStream,
+                                                                    int32_t* radius);
+
+ASTRA_API_EX astra_status_t astra_normalstream_set_smoothing_radius(astra_normalstream_t normalStream,
+                                                                    int32_t radius);
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_data_byte_length(astra_normalframe_t normalFrame,
+                                                                   size_t* byteLength);
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_data_ptr(astra_normalframe_t normalFrame,
+                                                           astra_vector3f_t** data,
+                                                           size_t* byteLength);
+
+ASTRA_API_EX astra_status_t astra_normalframe_copy_data(astra_normalframe_t normalFrame,
+                                                        astra_vector3f_t* data);
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_metadata(astra_normalframe_t normalFrame,
+                                                           astra_image_metadata_t* metadata);
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_frameindex(astra_normalframe_t normalFrame,
+                                                             astra_frame_index_t* index);
+ASTRA_END_DECLS
+
+#endif /* NORMAL_CAPI_H */
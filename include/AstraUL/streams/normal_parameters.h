@@ -0,0 +1,9 @@
+#ifndef NORMAL_PARAMETERS_H
+#define NORMAL_PARAMETERS_H
+
+enum
+{
+    ASTRA_PARAMETER_NORMAL_SMOOTHING_RADIUS = 0
+};
+
+#endif /* NORMAL_PARAMETERS_H */
@@ -0,0 +1,10 @@
+#ifndef NORMAL_TYPES_H
+#define NORMAL_TYPES_H
+
+#include <Astra/astra_types.h>
+#include <AstraUL/streams/image_types.h>
+
+typedef astra_streamconnection_t astra_normalstream_t;
+typedef struct _astra_imageframe* astra_normalframe_t;
+
+#endif // NORMAL_TYPES_H
@@ -0,0 +1,241 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astra { namespace parallel {
+
+    // Small persistent thread pool for splitting per-frame image work into
+    // row bands. The calling thread takes part in the work, so a pool created
+    // with a thread count of 1 runs everything inline.
+    class WorkerPool
+    {
+    public:
+        explicit WorkerPool(size_t threadCount = default_thread_count())
+            : m_threadCount(std::max<size_t>(1, threadCount))
+        {
+            for (size_t i = 1; i < m_threadCount; ++i)
+            {
+                m_workers.emplace_back([this]() { worker_loop(); });
+            }
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_isShuttingDown = true;
+            }
+            m_workAvailable.notify_all();
+
+            for (std::thread& worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        static size_t default_thread_count()
+        {
+            unsigned hardwareThreads = std::thread::hardware_concurrency();
+            return hardwareThreads > 0 ? hardwareThreads : 1;
+        }
+
+        size_t thread_count() const { return m_threadCount; }
+
+        // Invokes func(taskIndex) for every taskIndex in [0, taskCount).
+        // Blocks until all tasks have finished. Not reentrant.
+        template<typename TFunc>
+        void run(int taskCount, TFunc& func)
+        {
+            if (taskCount <= 0)
+            {
+                return;
+            }
+
+            if (taskCount == 1 || m_workers.empty())
+            {
+                for (int i = 0; i < taskCount; ++i)
+                {
+                    func(i);
+                }
+                return;
+            }
+
+            Batch batch;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_task = &WorkerPool::invoke<TFunc>;
+                m_taskContext = &func;
+                m_taskCount = taskCount;
+                m_pendingTasks = taskCount;
+                ++m_generation;
+                m_nextTask = static_cast<uint64_t>(m_generation) << 32;
+                batch = current_batch();
+            }
+            m_workAvailable.notify_all();
+
+            execute_tasks(batch);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workFinished.wait(lock, [this]() { return m_pendingTasks == 0; });
+            m_task = nullptr;
+            m_taskContext = nullptr;
+        }
+
+        // Splits [0, rowCount) into contiguous bands of at least minRowsPerBand
+        // rows and invokes func(rowBegin, rowEnd) for each band.
+        template<typename TFunc>
+        void parallel_for_rows(int rowCount, int minRowsPerBand, TFunc&& func)
+        {
+            if (rowCount <= 0)
+            {
+                return;
+            }
+
+            minRowsPerBand = std::max(1, minRowsPerBand);
+            const int maxBands = std::max(1, rowCount / minRowsPerBand);
+            const int bandCount = std::min(maxBands, static_cast<int>(m_threadCount));
+            const int rowsPerBand = (rowCount + bandCount - 1) / bandCount;
+
+            auto bandFunc = [&](int band)
+            {
+                const int rowBegin = band * rowsPerBand;
+                const int rowEnd = std::min(rowCount, rowBegin + rowsPerBand);
+                if (rowBegin < rowEnd)
+                {
+                    func(rowBegin, rowEnd);
+                }
+            };
+
+            run(bandCount, bandFunc);
+        }
+
+    private:
+        using TaskThunk = void(*)(void*, int);
+
+        template<typename TFunc>
+        static void invoke(void* context, int taskIndex)
+        {
+            (*static_cast<TFunc*>(context))(taskIndex);
+        }
+
+        // What a thread needs to work on one run, copied under m_mutex so a
+        // worker never reads the members while the next run replaces them
+        struct Batch
+        {
+            TaskThunk task{nullptr};
+            void* context{nullptr};
+            int taskCount{0};
+            uint32_t generation{0};
+        };
+
+        Batch current_batch() const
+        {
+            Batch batch;
+            batch.task = m_task;
+            batch.context = m_taskContext;
+            batch.taskCount = m_taskCount;
+            batch.generation = m_generation;
+            return batch;
+        }
+
+        // m_nextTask holds the run's generation in its high half and the next
+        // task index in its low half, so a worker still holding an earlier
+        // batch can't claim a task of a later run
+        bool claim_task(const Batch& batch, int& taskIndex)
+        {
+            uint64_t next = m_nextTask.load();
+            while (true)
+            {
+                const uint32_t generation = static_cast<uint32_t>(next >> 32);
+                const int index = static_cast<int>(next & 0xffffffffu);
+                if (generation != batch.generation || index >= batch.taskCount)
+                {
+                    return false;
+                }
+
+                if (m_nextTask.compare_exchange_weak(next, next + 1))
+                {
+                    taskIndex = index;
+                    return true;
+                }
+            }
+        }
+
+        void execute_tasks(const Batch& batch)
+        {
+            int finished = 0;
+            int taskIndex = 0;
+            while (claim_task(batch, taskIndex))
+            {
+                batch.task(batch.context, taskIndex);
+                ++finished;
+            }
+
+            if (finished > 0)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pendingTasks -= finished;
+                if (m_pendingTasks == 0)
+                {
+                    m_workFinished.notify_all();
+                }
+            }
+        }
+
+        void worker_loop()
+        {
+            uint32_t seenGeneration = 0;
+
+            while (true)
+            {
+                Batch batch;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_workAvailable.wait(lock, [&]()
+                    {
+                        return m_isShuttingDown || seenGeneration != m_generation;
+                    });
+
+                    if (m_isShuttingDown)
+                    {
+                        return;
+                    }
+
+                    seenGeneration = m_generation;
+                    batch = current_batch();
+                }
+
+                execute_tasks(batch);
+            }
+        }
+
+        size_t m_threadCount;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_workFinished;
+
+        TaskThunk m_task{nullptr};
+        void* m_taskContext{nullptr};
+        int m_taskCount{0};
+        std::atomic<uint64_t> m_nextTask{0};
+        int m_pendingTasks{0};
+        uint32_t m_generation{0};
+        bool m_isShuttingDown{false};
+    };
+
+}}
+
+#endif /* WORKERPOOL_H */
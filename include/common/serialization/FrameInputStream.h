@@ -48,9 +48,21 @@ namespace astra { namespace serialization {
         virtual void close() = 0;
         virtual bool read_frame(Frame*& frame) = 0;
         virtual bool read_frame_description(FrameDescription*& frameDescription) = 0;
+        //reads the first stream's header and moves to the first frame
         virtual bool read_stream_header(StreamHeader*& streamHeader) = 0;
+        //streams are numbered in the order of their headers, frames name
+        //theirs with Frame::streamId
+        virtual int get_stream_count() = 0;
+        virtual bool get_stream_header(int streamId, StreamHeader*& streamHeader) = 0;
         virtual bool seek(int offset) = 0;
         virtual bool seek_to_first_frame() = 0;
+        //frames are numbered from 0 in the order they were recorded. After a
+        //seek the frame's description is read next, then the frame
+        virtual bool seek_to_frame(int frameNumber) = 0;
+        //the frame read_frame returns next
+        virtual int get_frame_number() = 0;
+        //-1 when the recording has no index to count them from
+        virtual int get_frame_count() = 0;
         virtual int64_t get_position() = 0;
         virtual bool is_end_of_file() = 0;
         virtual int get_frame_description_size() = 0;
@@ -14,6 +14,7 @@ namespace astra { namespace serialization {
 
         virtual void stage_frame(Frame& frame) = 0;
         virtual void stage_frame_description(FrameDescription& frameDesc) = 0;
+        //staged once for each recorded stream, before write_stream_header
         virtual void stage_stream_header(StreamHeader& streamHeader) = 0;
         virtual bool write_frame() = 0;
         virtual bool write_frame_description() = 0;
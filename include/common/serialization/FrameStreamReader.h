@@ -3,10 +3,13 @@
 
 #include "StreamFileModels.h"
 #include "FrameInputStream.h"
-#include "../clock/Pulser.h"
+
+#include <chrono>
+#include <cstdint>
 
 namespace astra { namespace serialization {
 
+    //opens either recording format, indexed recordings are memory mapped
     FrameInputStream* open_frame_input_stream(const char* path);
 
     class FrameStreamReader
@@ -16,21 +19,33 @@ namespace astra { namespace serialization {
         ~FrameStreamReader();
 
         void close();
+        //reads the next frame once its timestamp is due, frames of all the
+        //streams in the order they were recorded. Starts over after the last
         bool read();
         bool seek(int numberOfFrames);
+        bool seek_to_frame(int frameNumber);
+        int get_frame_count();
         int get_stream_type();
+        int get_stream_count();
+        bool get_stream_header(int streamId, StreamHeader*& streamHeader);
         int get_buffer_length();
         bool is_end_of_file();
         Frame& peek();
         FrameInputStream* get_frame_input_stream();
 
     private:
+        //the next frame is due right away, the ones after it as recorded
+        void restart_clock();
+        bool is_frame_due();
 
         FrameInputStream* m_inputStream;
-        FrameDescription* m_frameDescription;
-        StreamHeader* m_streamHeader;
-        Frame* m_frame;
-        clock::Pulser m_pulser;
+        FrameDescription* m_frameDescription{ nullptr };
+        StreamHeader* m_streamHeader{ nullptr };
+        Frame* m_frame{ nullptr };
+
+        using clock_type = std::chrono::steady_clock;
+        clock_type::time_point m_playbackStart;
+        uint64_t m_startTimestamp{ 0 };
 
         bool m_isEndOfFile{ false };
     };
@@ -6,37 +6,82 @@
 #include <Astra/Plugins/plugin_capi.h>
 
 #include "StreamFileModels.h"
-#include "../clock/Stopwatch.h"
 #include "FrameOutputStream.h"
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace astra { namespace serialization {
 
     FrameOutputStream* open_frame_output_stream(FILE* file);
+    //writes the indexed recording format, the index is written when the stream is closed
+    FrameOutputStream* open_indexed_frame_output_stream(FILE* file);
     void close_frame_output_stream(FrameOutputStream*& stream);
-    
+
+    // The reader frame behind an astra::Frame, acquired like the stream
+    // frame types are: frame.get<ReaderFrame>()
+    class ReaderFrame
+    {
+    public:
+        template<typename TFrameType>
+        static TFrameType acquire(astra_reader_frame_t readerFrame,
+                                  astra_stream_subtype_t subtype)
+        {
+            return TFrameType(readerFrame);
+        }
+
+        ReaderFrame(astra_reader_frame_t readerFrame)
+            : m_readerFrame(readerFrame)
+        { }
+
+        astra_reader_frame_t handle() { return m_readerFrame; }
+
+    private:
+        astra_reader_frame_t m_readerFrame;
+    };
+
+    // Records any set of streams into one file, their frames interleaved in
+    // the order they are written. Streams are added before begin_write and
+    // numbered in that order; without any, a single depth stream is
+    // recorded. The stream headers are written with the first frames, which
+    // fill in the image streams' pixel format and resolution.
     class FrameStreamWriter
     {
     public:
         FrameStreamWriter(FrameOutputStream& frameOutputStream);
         ~FrameStreamWriter();
 
+        //returns the stream's id, or -1 once writing has begun
+        int add_stream(const StreamHeader& streamHeader);
+        int get_stream_count();
+
         bool begin_write();
         bool end_write();
+
+        //writes the frame of every added stream the reader frame holds
+        bool write(astra::Frame& frame);
+        bool write(astra_reader_frame_t readerFrame);
+        bool write(int streamId, astra_frame_t& astraFrame);
         bool write(DepthFrame& depthFrame);
 
     private:
-        void stage_frame(astra_frame_t& astraFrame);
-        void stage_frame_description(astra_frame_t& astraFrame, double fps);
-        void populate_frame(astra_frame_t& astraFrame, Frame& frame);
-        void populate_frame_description(astra_frame_t& astraFrame, FrameDescription& frameDescription, double fps);
+        bool write_stream_headers();
+        bool write_frame(int streamId, astra_frame_t& astraFrame);
+        void populate_image_metadata(astra_frame_t& astraFrame, StreamHeader& streamHeader);
+        void populate_frame(astra_frame_t& astraFrame, int streamId, Frame& frame);
+        void populate_frame_description(astra_frame_t& astraFrame, int streamId, FrameDescription& frameDescription);
 
         FrameOutputStream& m_outputStream;
         bool m_shouldWrite{ false };
+        bool m_headersWritten{ false };
+
+        std::vector<StreamHeader> m_streamHeaders;
+        //microseconds since the recording began, of each stream's last frame
+        std::vector<uint64_t> m_lastTimestamps;
 
-        Stopwatch m_swatch;
-        std::string m_swatchName;
+        std::chrono::steady_clock::time_point m_recordingStart;
     };
 
 }}
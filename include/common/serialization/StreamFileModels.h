@@ -1,11 +1,30 @@
 #ifndef STREAMFILEMODELS_H
 #define STREAMFILEMODELS_H
 
+#include <AstraUL/streams/depth_types.h>
+#include <cstdint>
+
 namespace astra { namespace serialization {
 
+    // Describes one recorded stream. Formats that only record the stream
+    // type leave the rest at its defaults.
     struct StreamHeader
     {
         int frameType;
+        int subtype{0};
+        //the largest frame of the stream, 0 when the format does not know it
+        int maxFrameLength{0};
+
+        //image streams, taken from their first frame
+        int pixelFormat{0};
+        int width{0};
+        int height{0};
+        float horizontalFov{0};
+        float verticalFov{0};
+
+        //depth streams only
+        bool hasConversionCache{false};
+        conversion_cache_t conversionCache{};
     };
 
     struct Frame
@@ -13,12 +32,17 @@ namespace astra { namespace serialization {
         int byteLength;
         int frameIndex;
         void* rawFrameWrapper;
+        //position of the frame's stream in the recording's stream headers
+        int streamId{0};
     };
 
     struct FrameDescription
     {
         double framePeriod;
         int bufferLength;
+        //microseconds since the recording began. Recordings without them get
+        //them added up from the frame periods when they are read
+        uint64_t timestamp;
     };
 
 }}
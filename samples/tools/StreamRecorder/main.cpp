@@ -1,4 +1,4 @@
-#include <AstraUL/streams/Depth.h>
+#include <AstraUL/AstraUL.h>
 #include <Astra/Plugins/plugin_capi.h>
 #include <Astra/astra_capi.h>
 #include <Astra/Astra.h>
@@ -17,13 +17,45 @@
 
 using namespace astra;
 
+serialization::StreamHeader describe_stream(astra_stream_type_t type)
+{
+    serialization::StreamHeader streamHeader;
+    streamHeader.frameType = type;
+    streamHeader.subtype = DEFAULT_SUBTYPE;
+    return streamHeader;
+}
+
+template<typename TStream>
+serialization::StreamHeader describe_image_stream(TStream stream)
+{
+    serialization::StreamHeader streamHeader = describe_stream(TStream::id);
+    streamHeader.horizontalFov = stream.horizontalFieldOfView();
+    streamHeader.verticalFov = stream.verticalFieldOfView();
+    return streamHeader;
+}
+
+serialization::StreamHeader describe_depth_stream(DepthStream stream)
+{
+    serialization::StreamHeader streamHeader = describe_image_stream(stream);
+    streamHeader.hasConversionCache = true;
+    streamHeader.conversionCache = stream.depth_to_world_data();
+    return streamHeader;
+}
+
 class Recorder
 {
 public:
-    explicit Recorder(const char* filename) {
+    Recorder(const char* filename, StreamReader& reader) {
         m_outputFile = fopen(filename, "wb");
-        m_frameOutputStream = serialization::open_frame_output_stream(m_outputFile);
+        m_frameOutputStream = serialization::open_indexed_frame_output_stream(m_outputFile);
         m_frameStreamWriter = FrameStreamWriterPtr(new serialization::FrameStreamWriter(*m_frameOutputStream));
+
+        //streams that aren't running just have no frames in the recording
+        m_frameStreamWriter->add_stream(describe_depth_stream(reader.stream<DepthStream>()));
+        m_frameStreamWriter->add_stream(describe_image_stream(reader.stream<ColorStream>()));
+        m_frameStreamWriter->add_stream(describe_stream(ASTRA_STREAM_POINT));
+        m_frameStreamWriter->add_stream(describe_stream(ASTRA_STREAM_HAND));
+
         m_frameStreamWriter->begin_write();
     }
 
@@ -35,11 +67,11 @@ public:
         printf("closed file\n");
     }
 
-    void add_frame(DepthFrame& depthFrame) {
-        if (!depthFrame.is_valid()) {
+    void add_frame(Frame& frame) {
+        if (!frame.is_valid()) {
             return;
         }
-        bool result = m_frameStreamWriter->write(depthFrame);
+        bool result = m_frameStreamWriter->write(frame);
         printf("Saving frame: %d %s\n", m_frameCount, result ? "" : "failure");
         ++m_frameCount;
     }
@@ -62,7 +94,9 @@ public:
         m_lastTimepoint = clock_type::now();
 
         m_reader.stream<DepthStream>().start();
+        m_reader.stream<ColorStream>().start();
         m_reader.stream<PointStream>().start();
+        m_reader.stream<HandStream>().start();
 
         m_reader.addListener(*this);
     }
@@ -81,7 +115,7 @@ public:
 
     void start_recording()
     {
-        m_recorder = RecorderPtr(new Recorder("test.df"));
+        m_recorder = RecorderPtr(new Recorder("test.df", m_reader));
     }
 
     void stop_recording()
@@ -159,10 +193,9 @@ private:
                                 Frame& frame) override
     {
         PointFrame pointFrame = frame.get<PointFrame>();
-        DepthFrame depthFrame = frame.get<DepthFrame>();
 
         if (m_recorder != nullptr) {
-            m_recorder->add_frame(depthFrame);
+            m_recorder->add_frame(frame);
         }
 
         visualize_frame(pointFrame);
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+#include <AstraUL/astraul_ctypes.h>
+#include "../astra_streamset.hpp"
+#include "../astra_streamset_connection.hpp"
+#include "../astra_stream_reader.hpp"
+#include "../astra_stream.hpp"
+#include "../astra_stream_bin.hpp"
+
+namespace {
+
+    // A stream of the set with a bin connected to the reader's connection,
+    // published to the way a plugin's stream publishes its frames.
+    class published_stream
+    {
+    public:
+        published_stream(astra::stream_reader& reader, astra_stream_type_t type)
+        {
+            astra_stream_desc_t desc;
+            desc.type = type;
+            desc.subtype = DEFAULT_SUBTYPE;
+
+            m_connection = reader.get_stream(desc);
+            m_bin = m_connection->get_stream()->create_bin(sizeof(astra_frame_index_t));
+            m_connection->set_bin(m_bin);
+            m_connection->start();
+        }
+
+        ~published_stream()
+        {
+            m_connection->stop();
+            m_connection->set_bin(nullptr);
+            m_connection->get_stream()->destroy_bin(m_bin);
+        }
+
+        void publish(astra_frame_index_t frameIndex)
+        {
+            astra_frame_t* frame = m_bin->get_backBuffer();
+            frame->frameIndex = frameIndex;
+            m_bin->cycle_buffers();
+        }
+
+    private:
+        astra::stream_connection* m_connection;
+        astra::stream_bin* m_bin;
+    };
+
+    int g_readerFrameCount = 0;
+
+    void count_reader_frame(void*, astra_reader_t, astra_reader_frame_t)
+    {
+        ++g_readerFrameCount;
+    }
+}
+
+TEST_CASE("A reader of hands and gestures raises a frame for every frame both publish", "[reader]")
+{
+    const int frameCount = 10;
+
+    astra::streamset streamSet("device/test");
+    astra::streamset_connection* connection = streamSet.add_new_connection();
+
+    {
+        astra::stream_reader reader(*connection);
+        published_stream hands(reader, ASTRA_STREAM_HAND);
+        published_stream gestures(reader, ASTRA_STREAM_GESTURE);
+
+        astra_callback_id_t callbackId = reader.register_frame_ready_callback(&count_reader_frame, nullptr);
+        g_readerFrameCount = 0;
+
+        SECTION("gestures are published every frame")
+        {
+            for (astra_frame_index_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+            {
+                hands.publish(frameIndex);
+                REQUIRE(g_readerFrameCount == frameIndex);
+
+                gestures.publish(frameIndex);
+                REQUIRE(g_readerFrameCount == frameIndex + 1);
+            }
+        }
+
+        SECTION("gestures are only published on the frames they happen in")
+        {
+            //the hand frames in between are held back until the next gesture
+            for (astra_frame_index_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+            {
+                hands.publish(frameIndex);
+                if (frameIndex == frameCount / 2)
+                {
+                    gestures.publish(frameIndex);
+                }
+            }
+
+            REQUIRE(g_readerFrameCount == 1);
+        }
+
+        reader.unregister_frame_ready_callback(callbackId);
+    }
+
+    streamSet.disconnect_streamset_connection(connection);
+}
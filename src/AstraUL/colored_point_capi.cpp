@@ -0,0 +1,97 @@
+#include <Astra/astra_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include "generic_stream_api.h"
+#include <AstraUL/streams/colored_point_capi.h>
+#include <AstraUL/streams/colored_point_types.h>
+#include <AstraUL/streams/colored_point_parameters.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <string.h>
+#include <AstraUL/streams/image_capi.h>
+
+ASTRA_BEGIN_DECLS
+
+ASTRA_API_EX astra_status_t astra_reader_get_coloredpointstream(astra_reader_t reader,
+                                                                astra_coloredpointstream_t* coloredPointStream)
+
+{
+    return astra_reader_get_stream(reader,
+                                   ASTRA_STREAM_COLORED_POINT,
+                                   DEFAULT_SUBTYPE,
+                                   coloredPointStream);
+}
+
+ASTRA_API_EX astra_status_t astra_frame_get_coloredpointframe(astra_reader_frame_t readerFrame,
+                                                              astra_coloredpointframe_t* coloredPointFrame)
+{
+    return astra_reader_get_imageframe(readerFrame,
+                                       ASTRA_STREAM_COLORED_POINT,
+                                       DEFAULT_SUBTYPE,
+                                       coloredPointFrame);
+}
+
+ASTRA_API_EX astra_status_t astra_frame_get_coloredpointframe_with_subtype(astra_reader_frame_t readerFrame,
+                                                                           astra_stream_subtype_t subtype,
+                                                                           astra_coloredpointframe_t* coloredPointFrame)
+{
+    return astra_reader_get_imageframe(readerFrame,
+                                       ASTRA_STREAM_COLORED_POINT,
+                                       subtype,
+                                       coloredPointFrame);
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointstream_get_layout(astra_coloredpointstream_t coloredPointStream,
+                                                                astra_colored_point_layout_t* layout)
+{
+    int32_t value = ASTRA_COLORED_POINT_LAYOUT_INTERLEAVED;
+    astra_status_t rc = astra_stream_get_parameter_fixed(coloredPointStream,
+                                                         ASTRA_PARAMETER_COLORED_POINT_LAYOUT,
+                                                         sizeof(int32_t),
+                                                         reinterpret_cast<astra_parameter_data_t*>(&value));
+
+    *layout = static_cast<astra_colored_point_layout_t>(value);
+
+    return rc;
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointstream_set_layout(astra_coloredpointstream_t coloredPointStream,
+                                                                astra_colored_point_layout_t layout)
+{
+    int32_t value = layout;
+    return astra_stream_set_parameter(coloredPointStream,
+                                      ASTRA_PARAMETER_COLORED_POINT_LAYOUT,
+                                      sizeof(int32_t),
+                                      reinterpret_cast<astra_parameter_data_t>(&value));
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_frameindex(astra_coloredpointframe_t coloredPointFrame,
+                                                                   astra_frame_index_t* index)
+{
+    return astra_generic_frame_get_frameindex(coloredPointFrame, index);
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_data_byte_length(astra_coloredpointframe_t coloredPointFrame,
+                                                                         size_t* byteLength)
+{
+    return astra_imageframe_get_data_byte_length(coloredPointFrame, byteLength);
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_data_ptr(astra_coloredpointframe_t coloredPointFrame,
+                                                                 void** data,
+                                                                 size_t* byteLength)
+{
+    return astra_imageframe_get_data_ptr(coloredPointFrame, data, byteLength);
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_copy_data(astra_coloredpointframe_t coloredPointFrame,
+                                                              void* data)
+{
+    return astra_imageframe_copy_data(coloredPointFrame, data);
+}
+
+ASTRA_API_EX astra_status_t astra_coloredpointframe_get_metadata(astra_coloredpointframe_t coloredPointFrame,
+                                                                 astra_image_metadata_t* metadata)
+{
+    return astra_imageframe_get_metadata(coloredPointFrame, metadata);
+}
+
+ASTRA_END_DECLS
@@ -73,6 +73,63 @@ ASTRA_API_EX astra_status_t astra_convert_world_to_depth(astra_depthstream_t dep
     return ASTRA_STATUS_SUCCESS;
 }
 
+ASTRA_API_EX astra_status_t astra_convert_depth_to_world_array(astra_depthstream_t depthStream,
+                                                               const astra_vector3f_t* depthPoints,
+                                                               astra_vector3f_t* worldPoints,
+                                                               size_t count)
+{
+    PROFILE_FUNC();
+    const conversion_cache_t conversionCache = astra_depth_fetch_conversion_cache(depthStream);
+
+    const float resolutionX = static_cast<float>(conversionCache.resolutionX);
+    const float resolutionY = static_cast<float>(conversionCache.resolutionY);
+    const float xzFactor = conversionCache.xzFactor;
+    const float yzFactor = conversionCache.yzFactor;
+
+    //same math as astra_convert_depth_to_world, in a loop the compiler can vectorize
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float depthX = depthPoints[i].x;
+        const float depthY = depthPoints[i].y;
+        const float depthZ = depthPoints[i].z;
+
+        const float normalizedX = depthX / resolutionX - .5f;
+        const float normalizedY = .5f - depthY / resolutionY;
+
+        worldPoints[i].x = normalizedX * depthZ * xzFactor;
+        worldPoints[i].y = normalizedY * depthZ * yzFactor;
+        worldPoints[i].z = depthZ;
+    }
+
+    return ASTRA_STATUS_SUCCESS;
+}
+
+ASTRA_API_EX astra_status_t astra_convert_world_to_depth_array(astra_depthstream_t depthStream,
+                                                               const astra_vector3f_t* worldPoints,
+                                                               astra_vector3f_t* depthPoints,
+                                                               size_t count)
+{
+    PROFILE_FUNC();
+    const conversion_cache_t conversionCache = astra_depth_fetch_conversion_cache(depthStream);
+
+    const float coeffX = conversionCache.coeffX;
+    const float coeffY = conversionCache.coeffY;
+    const float halfResX = static_cast<float>(conversionCache.halfResX);
+    const float halfResY = static_cast<float>(conversionCache.halfResY);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float worldX = worldPoints[i].x;
+        const float worldY = worldPoints[i].y;
+        const float worldZ = worldPoints[i].z;
+
+        depthPoints[i].x = coeffX * worldX / worldZ + halfResX;
+        depthPoints[i].y = halfResY - coeffY * worldY / worldZ;
+        depthPoints[i].z = worldZ;
+    }
+
+    return ASTRA_STATUS_SUCCESS;
+}
 
 ASTRA_API_EX astra_status_t astra_reader_get_depthstream(astra_reader_t reader,
                                                          astra_depthstream_t* depthStream)
@@ -126,6 +183,42 @@ ASTRA_API_EX astra_status_t astra_depthstream_get_registration(astra_depthstream
                                             reinterpret_cast<astra_parameter_data_t*>(enabled));
 }
 
+ASTRA_API_EX astra_status_t astra_depthstream_get_calibration(astra_depthstream_t depthStream,
+                                                              astra_depth_calibration_t* calibration)
+{
+    return astra_stream_get_parameter_fixed(depthStream,
+                                            ASTRA_PARAMETER_DEPTH_CALIBRATION,
+                                            sizeof(astra_depth_calibration_t),
+                                            reinterpret_cast<astra_parameter_data_t*>(calibration));
+}
+
+ASTRA_API_EX astra_status_t astra_depthstream_set_calibration(astra_depthstream_t depthStream,
+                                                              const astra_depth_calibration_t* calibration)
+{
+    return astra_stream_set_parameter(depthStream,
+                                      ASTRA_PARAMETER_DEPTH_CALIBRATION,
+                                      sizeof(astra_depth_calibration_t),
+                                      const_cast<astra_depth_calibration_t*>(calibration));
+}
+
+ASTRA_API_EX astra_status_t astra_depthstream_get_filter_settings(astra_depthstream_t depthStream,
+                                                                  astra_depth_filter_settings_t* settings)
+{
+    return astra_stream_get_parameter_fixed(depthStream,
+                                            ASTRA_PARAMETER_DEPTH_FILTER_SETTINGS,
+                                            sizeof(astra_depth_filter_settings_t),
+                                            reinterpret_cast<astra_parameter_data_t*>(settings));
+}
+
+ASTRA_API_EX astra_status_t astra_depthstream_set_filter_settings(astra_depthstream_t depthStream,
+                                                                  const astra_depth_filter_settings_t* settings)
+{
+    return astra_stream_set_parameter(depthStream,
+                                      ASTRA_PARAMETER_DEPTH_FILTER_SETTINGS,
+                                      sizeof(astra_depth_filter_settings_t),
+                                      const_cast<astra_depth_filter_settings_t*>(settings));
+}
+
 ASTRA_API_EX astra_status_t astra_frame_get_depthframe(astra_reader_frame_t readerFrame,
                                                        astra_depthframe_t* depthFrame)
 {
@@ -0,0 +1,74 @@
+#include <Astra/astra_types.h>
+#include "generic_stream_api.h"
+#include <memory.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <AstraUL/streams/gesture_capi.h>
+#include <string.h>
+
+ASTRA_BEGIN_DECLS
+
+ASTRA_API_EX astra_status_t astra_reader_get_gesturestream(astra_reader_t reader,
+                                                           astra_gesturestream_t* gestureStream)
+
+{
+    return astra_reader_get_stream(reader,
+                                   ASTRA_STREAM_GESTURE,
+                                   DEFAULT_SUBTYPE,
+                                   gestureStream);
+}
+
+ASTRA_API_EX astra_status_t astra_frame_get_gestureframe(astra_reader_frame_t readerFrame,
+                                                         astra_gestureframe_t* gestureFrame)
+{
+    return astra_generic_frame_get<astra_gestureframe_wrapper_t>(readerFrame,
+                                                                 ASTRA_STREAM_GESTURE,
+                                                                 DEFAULT_SUBTYPE,
+                                                                 gestureFrame);
+}
+
+ASTRA_API_EX astra_status_t astra_frame_get_gestureframe_with_subtype(astra_reader_frame_t readerFrame,
+                                                                      astra_stream_subtype_t subtype,
+                                                                      astra_gestureframe_t* gestureFrame)
+{
+    return astra_generic_frame_get<astra_gestureframe_wrapper_t>(readerFrame,
+                                                                 ASTRA_STREAM_GESTURE,
+                                                                 subtype,
+                                                                 gestureFrame);
+}
+
+ASTRA_API_EX astra_status_t astra_gestureframe_get_frameindex(astra_gestureframe_t gestureFrame,
+                                                              astra_frame_index_t* index)
+{
+    return astra_generic_frame_get_frameindex(gestureFrame, index);
+}
+
+ASTRA_API_EX astra_status_t astra_gestureframe_get_event_count(astra_gestureframe_t gestureFrame,
+                                                               size_t* eventCount)
+{
+    *eventCount = gestureFrame->eventCount;
+
+    return ASTRA_STATUS_SUCCESS;
+}
+
+ASTRA_API_EX astra_status_t astra_gestureframe_copy_events(astra_gestureframe_t gestureFrame,
+                                                           astra_gesture_event_t* eventsDestination)
+{
+    size_t size = gestureFrame->eventCount * sizeof(astra_gesture_event_t);
+
+    memcpy(eventsDestination, gestureFrame->events, size);
+
+    return ASTRA_STATUS_SUCCESS;
+}
+
+ASTRA_API_EX astra_status_t astra_gestureframe_get_shared_event_array(astra_gestureframe_t gestureFrame,
+                                                                      astra_gesture_event_t** events,
+                                                                      size_t* eventCount)
+{
+    *events = gestureFrame->events;
+    astra_gestureframe_get_event_count(gestureFrame, eventCount);
+
+    return ASTRA_STATUS_SUCCESS;
+}
+
+ASTRA_END_DECLS
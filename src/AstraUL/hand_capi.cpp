@@ -93,6 +93,98 @@ ASTRA_API_EX astra_status_t astra_handstream_set_include_candidate_points(astra_
 
 }
 
+ASTRA_API_EX astra_status_t astra_handstream_get_processing_size(astra_handstream_t handStream,
+                                                                 astra_hand_processing_size_t* processingSize)
+{
+    return astra_stream_get_parameter_fixed(handStream,
+                                            ASTRA_PARAMETER_HAND_PROCESSING_SIZE,
+                                            sizeof(astra_hand_processing_size_t),
+                                            reinterpret_cast<astra_parameter_data_t*>(processingSize));
+}
+
+ASTRA_API_EX astra_status_t astra_handstream_set_processing_size(astra_handstream_t handStream,
+                                                                 astra_hand_processing_size_t processingSize)
+{
+    return astra_stream_set_parameter(handStream,
+                                      ASTRA_PARAMETER_HAND_PROCESSING_SIZE,
+                                      sizeof(astra_hand_processing_size_t),
+                                      reinterpret_cast<astra_parameter_data_t>(&processingSize));
+}
+
+ASTRA_API_EX astra_status_t astra_handstream_get_adaptive_processing_size(astra_handstream_t handStream,
+                                                                          bool* adaptiveProcessingSize)
+{
+    return astra_stream_get_parameter_fixed(handStream,
+                                            ASTRA_PARAMETER_HAND_ADAPTIVE_PROCESSING_SIZE,
+                                            sizeof(bool),
+                                            reinterpret_cast<astra_parameter_data_t*>(adaptiveProcessingSize));
+}
+
+ASTRA_API_EX astra_status_t astra_handstream_set_adaptive_processing_size(astra_handstream_t handStream,
+                                                                          bool adaptiveProcessingSize)
+{
+    return astra_stream_set_parameter(handStream,
+                                      ASTRA_PARAMETER_HAND_ADAPTIVE_PROCESSING_SIZE,
+                                      sizeof(bool),
+                                      reinterpret_cast<astra_parameter_data_t>(&adaptiveProcessingSize));
+}
+
+ASTRA_API_EX astra_status_t astra_handstream_get_max_hand_count(astra_handstream_t handStream,
+                                                                size_t* maxHandCount)
+{
+    int32_t count = 0;
+    astra_status_t rc = astra_stream_get_parameter_fixed(handStream,
+                                                         ASTRA_PARAMETER_HAND_MAX_HAND_COUNT,
+                                                         sizeof(int32_t),
+                                                         reinterpret_cast<astra_parameter_data_t*>(&count));
+    *maxHandCount = count;
+
+    return rc;
+}
+
+ASTRA_API_EX astra_status_t astra_handstream_update_settings(astra_handstream_t handStream,
+                                                             const char* settings)
+{
+    size_t resultByteLength;
+    astra_result_token_t token;
+    astra_status_t rc = astra_stream_invoke(handStream,
+                                            ASTRA_COMMAND_HAND_UPDATE_SETTINGS,
+                                            strlen(settings),
+                                            reinterpret_cast<astra_parameter_data_t>(const_cast<char*>(settings)),
+                                            &resultByteLength,
+                                            &token);
+
+    if (rc != ASTRA_STATUS_SUCCESS || resultByteLength != sizeof(bool))
+    {
+        return rc != ASTRA_STATUS_SUCCESS ? rc : ASTRA_STATUS_INTERNAL_ERROR;
+    }
+
+    bool accepted = false;
+    rc = astra_stream_get_result(handStream,
+                                 token,
+                                 sizeof(bool),
+                                 reinterpret_cast<astra_parameter_data_t>(&accepted));
+
+    if (rc == ASTRA_STATUS_SUCCESS && !accepted)
+    {
+        return ASTRA_STATUS_INVALID_PARAMETER;
+    }
+
+    return rc;
+}
+
+ASTRA_API_EX astra_status_t astra_handstream_reload_settings(astra_handstream_t handStream)
+{
+    size_t resultByteLength;
+    astra_result_token_t token;
+    return astra_stream_invoke(handStream,
+                               ASTRA_COMMAND_HAND_RELOAD_SETTINGS,
+                               0,
+                               nullptr,
+                               &resultByteLength,
+                               &token);
+}
+
 ASTRA_API_EX astra_status_t astra_reader_get_debug_handstream(astra_reader_t reader,
                                                                        astra_debug_handstream_t* debugHandStream)
 
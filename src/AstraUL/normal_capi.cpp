@@ -0,0 +1,95 @@
+#include <Astra/astra_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include "generic_stream_api.h"
+#include <AstraUL/streams/normal_capi.h>
+#include <AstraUL/streams/normal_types.h>
+#include <AstraUL/streams/normal_parameters.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <string.h>
+#include <AstraUL/streams/image_capi.h>
+
+ASTRA_BEGIN_DECLS
+
+ASTRA_API_EX astra_status_t astra_reader_get_normalstream(astra_reader_t reader,
+                                                          astra_normalstream_t* normalStream)
+
+{
+    return astra_reader_get_stream(reader,
+                                   ASTRA_STREAM_NORMAL,
+                                   DEFAULT_SUBTYPE,
+                                   normalStream);
+}
+
+ASTRA_API_EX astra_status_t astra_frame_get_normalframe(astra_reader_frame_t readerFrame,
+                                                        astra_normalframe_t* normalFrame)
+{
+    return astra_reader_get_imageframe(readerFrame,
+                                       ASTRA_STREAM_NORMAL,
+                                       DEFAULT_SUBTYPE,
+                                       normalFrame);
+}
+
+ASTRA_API_EX astra_status_t astra_frame_get_normalframe_with_subtype(astra_reader_frame_t readerFrame,
+                                                                     astra_stream_subtype_t subtype,
+                                                                     astra_normalframe_t* normalFrame)
+{
+    return astra_reader_get_imageframe(readerFrame,
+                                       ASTRA_STREAM_NORMAL,
+                                       subtype,
+                                       normalFrame);
+}
+
+ASTRA_API_EX astra_status_t astra_normalstream_get_smoothing_radius(astra_normalstream_t normalStream,
+                                                                    int32_t* radius)
+{
+    return astra_stream_get_parameter_fixed(normalStream,
+                                            ASTRA_PARAMETER_NORMAL_SMOOTHING_RADIUS,
+                                            sizeof(int32_t),
+                                            reinterpret_cast<astra_parameter_data_t*>(radius));
+}
+
+ASTRA_API_EX astra_status_t astra_normalstream_set_smoothing_radius(astra_normalstream_t normalStream,
+                                                                    int32_t radius)
+{
+    return astra_stream_set_parameter(normalStream,
+                                      ASTRA_PARAMETER_NORMAL_SMOOTHING_RADIUS,
+                                      sizeof(int32_t),
+                                      reinterpret_cast<astra_parameter_data_t>(&radius));
+}
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_frameindex(astra_normalframe_t normalFrame,
+                                                             astra_frame_index_t* index)
+{
+    return astra_generic_frame_get_frameindex(normalFrame, index);
+}
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_data_byte_length(astra_normalframe_t normalFrame,
+                                                                   size_t* byteLength)
+{
+    return astra_imageframe_get_data_byte_length(normalFrame, byteLength);
+}
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_data_ptr(astra_normalframe_t normalFrame,
+                                                           astra_vector3f_t** data,
+                                                           size_t* byteLength)
+{
+    void* voidData = nullptr;
+    astra_imageframe_get_data_ptr(normalFrame, &voidData, byteLength);
+    *data = static_cast<astra_vector3f_t*>(voidData);
+
+    return ASTRA_STATUS_SUCCESS;
+}
+
+ASTRA_API_EX astra_status_t astra_normalframe_copy_data(astra_normalframe_t normalFrame,
+                                                        astra_vector3f_t* data)
+{
+    return astra_imageframe_copy_data(normalFrame, data);
+}
+
+ASTRA_API_EX astra_status_t astra_normalframe_get_metadata(astra_normalframe_t normalFrame,
+                                                           astra_image_metadata_t* metadata)
+{
+    return astra_imageframe_get_metadata(normalFrame, metadata);
+}
+
+ASTRA_END_DECLS
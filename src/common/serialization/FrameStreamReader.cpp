@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "ProtoFrameInputStream.h"
+#include "MappedFrameInputStream.h"
 
 namespace astra { namespace serialization {
 
@@ -17,9 +18,7 @@ namespace astra { namespace serialization {
         m_inputStream->read_stream_header(m_streamHeader);
         m_inputStream->read_frame_description(m_frameDescription);
 
-        m_pulser.set_period(1 / m_frameDescription->framePeriod);
-
-        m_pulser.start();
+        restart_clock();
     }
 
     FrameStreamReader::~FrameStreamReader()
@@ -39,47 +38,72 @@ namespace astra { namespace serialization {
         if (m_isEndOfFile)
         {
             m_inputStream->seek_to_first_frame();
+            m_inputStream->read_frame_description(m_frameDescription);
 
-            isSuccessful = m_inputStream->read_frame_description(m_frameDescription);
-            if (isSuccessful)
-            {
-                m_pulser.set_period(1 / m_frameDescription->framePeriod);
-            }
+            restart_clock();
 
             m_isEndOfFile = false;
         }
 
-        m_pulser.stop();
-
-        if (!m_pulser.is_pulse())
+        if (!is_frame_due())
         {
             return !isSuccessful;
         }
 
         isSuccessful = m_inputStream->read_frame(m_frame);
 
-        if (!is_end_of_file())
+        if (isSuccessful && !is_end_of_file())
         {
-            isSuccessful = m_inputStream->read_frame_description(m_frameDescription);
+            m_inputStream->read_frame_description(m_frameDescription);
+        }
+
+        return isSuccessful;
+    }
+
+    void FrameStreamReader::restart_clock()
+    {
+        m_playbackStart = clock_type::now();
+        m_startTimestamp = m_frameDescription != nullptr ? m_frameDescription->timestamp : 0;
+    }
 
-            if (isSuccessful)
-            {
-                m_pulser.set_period(1 / m_frameDescription->framePeriod);
-            }
+    bool FrameStreamReader::is_frame_due()
+    {
+        if (m_frameDescription == nullptr)
+        {
+            return false;
         }
 
-        m_pulser.start();
+        auto sinceStart = clock_type::now() - m_playbackStart;
+        const uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(sinceStart).count();
 
-        return isSuccessful;
+        return m_frameDescription->timestamp <= m_startTimestamp + elapsed;
     }
 
     bool FrameStreamReader::seek(int numberOfFrames)
     {
-        int sizeMarkerOffset = 8;
-        int totalFrameSize = m_inputStream->get_frame_description_size();
+        return seek_to_frame(m_inputStream->get_frame_number() + numberOfFrames);
+    }
+
+    bool FrameStreamReader::seek_to_frame(int frameNumber)
+    {
+        if (!m_inputStream->seek_to_frame(frameNumber))
+        {
+            return false;
+        }
 
-        int offset = numberOfFrames * (totalFrameSize + sizeMarkerOffset);
-        return m_inputStream->seek(offset);
+        //read() expects the next frame's description to have been read
+        bool isSuccessful = m_inputStream->read_frame_description(m_frameDescription);
+
+        restart_clock();
+
+        m_isEndOfFile = false;
+
+        return isSuccessful;
+    }
+
+    int FrameStreamReader::get_frame_count()
+    {
+        return m_inputStream->get_frame_count();
     }
 
     int FrameStreamReader::get_stream_type()
@@ -87,6 +111,16 @@ namespace astra { namespace serialization {
         return m_streamHeader->frameType;
     }
 
+    int FrameStreamReader::get_stream_count()
+    {
+        return m_inputStream->get_stream_count();
+    }
+
+    bool FrameStreamReader::get_stream_header(int streamId, StreamHeader*& streamHeader)
+    {
+        return m_inputStream->get_stream_header(streamId, streamHeader);
+    }
+
     int FrameStreamReader::get_buffer_length()
     {
         return m_frameDescription->bufferLength;
@@ -110,6 +144,11 @@ namespace astra { namespace serialization {
 
     FrameInputStream* open_frame_input_stream(const char* path)
     {
+        if (is_indexed_recording(path))
+        {
+            return new MappedFrameInputStream(path);
+        }
+
         return new ProtoFrameInputStream(path);
     }
 
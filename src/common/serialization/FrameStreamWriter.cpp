@@ -1,5 +1,6 @@
 #include <common/serialization/FrameStreamWriter.h>
 #include "ProtoFrameOutputStream.h"
+#include "IndexedFrameOutputStream.h"
 
 namespace astra { namespace serialization {
 
@@ -16,17 +17,43 @@ namespace astra { namespace serialization {
         return new ProtoFrameOutputStream(outputStream);
     }
 
+    FrameOutputStream* open_indexed_frame_output_stream(FILE* file)
+    {
+        return new IndexedFrameOutputStream(file);
+    }
+
     void close_frame_output_stream(FrameOutputStream*& stream)
     {
         delete stream;
         stream = nullptr;
     }
 
+    namespace {
+
+        //streams whose frames are astra_imageframe_wrapper_t
+        bool is_image_stream(int frameType)
+        {
+            switch (frameType)
+            {
+            case ASTRA_STREAM_DEPTH:
+            case ASTRA_STREAM_COLOR:
+            case ASTRA_STREAM_INFRARED:
+            case ASTRA_STREAM_STYLIZED_DEPTH:
+            case ASTRA_STREAM_POINT:
+            case ASTRA_STREAM_NORMAL:
+            case ASTRA_STREAM_COLORED_POINT:
+            case ASTRA_STREAM_DEBUG_HAND:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
+
     FrameStreamWriter::FrameStreamWriter(FrameOutputStream& frameOutputStream):
-        m_outputStream(frameOutputStream),
-        m_swatchName("FrameStreamWriter")
+        m_outputStream(frameOutputStream)
     {
-        m_swatch.set_mode(REAL_TIME);
+
     }
 
     FrameStreamWriter::~FrameStreamWriter()
@@ -34,83 +61,219 @@ namespace astra { namespace serialization {
 
     }
 
-    bool FrameStreamWriter::begin_write()
+    int FrameStreamWriter::add_stream(const StreamHeader& streamHeader)
     {
-        bool isSuccessful = true;
+        if (m_shouldWrite || m_headersWritten)
+        {
+            return -1;
+        }
 
-        StreamHeader streamHeader;
-        streamHeader.frameType = 1;
+        m_streamHeaders.push_back(streamHeader);
+        return static_cast<int>(m_streamHeaders.size()) - 1;
+    }
 
-        m_outputStream.stage_stream_header(streamHeader);
+    int FrameStreamWriter::get_stream_count()
+    {
+        return static_cast<int>(m_streamHeaders.size());
+    }
 
-        isSuccessful = m_outputStream.write_stream_header();
+    bool FrameStreamWriter::begin_write()
+    {
+        if (m_headersWritten)
+        {
+            return false;
+        }
 
-        if (isSuccessful)
+        if (m_streamHeaders.empty())
         {
-            m_shouldWrite = true;
-            m_swatch.start(m_swatchName);
+            StreamHeader streamHeader;
+            streamHeader.frameType = ASTRA_STREAM_DEPTH;
+            add_stream(streamHeader);
         }
 
-        return isSuccessful;
+        m_lastTimestamps.assign(m_streamHeaders.size(), 0);
+        m_shouldWrite = true;
+        m_recordingStart = std::chrono::steady_clock::now();
+
+        return true;
     }
 
     bool FrameStreamWriter::end_write()
     {
+        bool isSuccessful = true;
+
+        //a recording without frames still gets its headers
+        if (m_shouldWrite && !m_headersWritten)
+        {
+            isSuccessful = write_stream_headers();
+        }
+
         m_shouldWrite = false;
 
-        return true;
+        return isSuccessful;
     }
 
-    bool FrameStreamWriter::write(DepthFrame& depthFrame)
+    bool FrameStreamWriter::write(astra::Frame& frame)
     {
-        bool isSuccessful = true;
+        return write(frame.get<ReaderFrame>().handle());
+    }
 
-        if (!m_shouldWrite)
+    bool FrameStreamWriter::write(astra_reader_frame_t readerFrame)
+    {
+        if (!m_shouldWrite || readerFrame == nullptr)
         {
-            return !isSuccessful;
+            return false;
         }
 
-        m_swatch.stop(m_swatchName);
+        std::vector<astra_frame_t*> frames(m_streamHeaders.size(), nullptr);
+        for (size_t i = 0; i < m_streamHeaders.size(); ++i)
+        {
+            const StreamHeader& streamHeader = m_streamHeaders[i];
 
-        astra_imageframe_t imageFrame = depthFrame.handle();
-        astra_frame_t* astraFrame = imageFrame->frame;
+            astra_frame_t* astraFrame = nullptr;
+            astra_status_t rc = astra_reader_get_frame(readerFrame,
+                                                       streamHeader.frameType,
+                                                       streamHeader.subtype,
+                                                       &astraFrame);
+            if (rc == ASTRA_STATUS_SUCCESS)
+            {
+                frames[i] = astraFrame;
+            }
+        }
 
-        stage_frame(*astraFrame);
-        stage_frame_description(*astraFrame, 1 / m_swatch.get_time_so_far(m_swatchName));
+        if (!m_headersWritten)
+        {
+            for (size_t i = 0; i < frames.size(); ++i)
+            {
+                if (frames[i] != nullptr)
+                {
+                    populate_image_metadata(*frames[i], m_streamHeaders[i]);
+                }
+            }
 
-        isSuccessful = m_outputStream.write_frame_description();
-        isSuccessful = isSuccessful && m_outputStream.write_frame();
+            if (!write_stream_headers())
+            {
+                return false;
+            }
+        }
 
-        m_swatch.start(m_swatchName);
+        bool isSuccessful = true;
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            if (frames[i] != nullptr)
+            {
+                isSuccessful = write_frame(static_cast<int>(i), *frames[i]) && isSuccessful;
+            }
+        }
 
         return isSuccessful;
     }
 
-    void FrameStreamWriter::stage_frame(astra_frame_t& astraFrame)
+    bool FrameStreamWriter::write(int streamId, astra_frame_t& astraFrame)
     {
-        Frame frame;
-        populate_frame(astraFrame, frame);
-        m_outputStream.stage_frame(frame);
+        if (!m_shouldWrite || streamId < 0 || streamId >= get_stream_count())
+        {
+            return false;
+        }
+
+        if (!m_headersWritten)
+        {
+            populate_image_metadata(astraFrame, m_streamHeaders[streamId]);
+
+            if (!write_stream_headers())
+            {
+                return false;
+            }
+        }
+
+        return write_frame(streamId, astraFrame);
     }
 
-    void FrameStreamWriter::stage_frame_description(astra_frame_t& astraFrame, double fps)
+    bool FrameStreamWriter::write(DepthFrame& depthFrame)
     {
+        if (!depthFrame.is_valid())
+        {
+            return false;
+        }
+
+        //the first depth stream, the only one unless others were added
+        for (size_t i = 0; i < m_streamHeaders.size(); ++i)
+        {
+            if (m_streamHeaders[i].frameType == ASTRA_STREAM_DEPTH)
+            {
+                astra_imageframe_t imageFrame = depthFrame.handle();
+                return write(static_cast<int>(i), *imageFrame->frame);
+            }
+        }
+
+        return false;
+    }
+
+    bool FrameStreamWriter::write_stream_headers()
+    {
+        for (StreamHeader& streamHeader : m_streamHeaders)
+        {
+            m_outputStream.stage_stream_header(streamHeader);
+        }
+
+        m_headersWritten = m_outputStream.write_stream_header();
+
+        return m_headersWritten;
+    }
+
+    bool FrameStreamWriter::write_frame(int streamId, astra_frame_t& astraFrame)
+    {
+        Frame frame;
+        populate_frame(astraFrame, streamId, frame);
+        m_outputStream.stage_frame(frame);
+
         FrameDescription frameDesc;
-        populate_frame_description(astraFrame, frameDesc, fps);
+        populate_frame_description(astraFrame, streamId, frameDesc);
         m_outputStream.stage_frame_description(frameDesc);
+
+        bool isSuccessful = m_outputStream.write_frame_description();
+        isSuccessful = isSuccessful && m_outputStream.write_frame();
+
+        return isSuccessful;
     }
 
-    void FrameStreamWriter::populate_frame(astra_frame_t& astraFrame, Frame& frame)
+    void FrameStreamWriter::populate_image_metadata(astra_frame_t& astraFrame, StreamHeader& streamHeader)
     {
+        if (!is_image_stream(streamHeader.frameType) ||
+            astraFrame.byteLength < sizeof(astra_imageframe_wrapper_t))
+        {
+            return;
+        }
+
+        const astra_imageframe_wrapper_t* wrapper =
+            static_cast<const astra_imageframe_wrapper_t*>(astraFrame.data);
 
+        streamHeader.pixelFormat = wrapper->frame.metadata.pixelFormat;
+        streamHeader.width = wrapper->frame.metadata.width;
+        streamHeader.height = wrapper->frame.metadata.height;
+    }
+
+    void FrameStreamWriter::populate_frame(astra_frame_t& astraFrame, int streamId, Frame& frame)
+    {
         frame.frameIndex = astraFrame.frameIndex;
         frame.byteLength = astraFrame.byteLength;
         frame.rawFrameWrapper = astraFrame.data;
+        frame.streamId = streamId;
     }
 
-    void FrameStreamWriter::populate_frame_description(astra_frame_t& astraFrame, FrameDescription& frameDescription, double fps)
+    void FrameStreamWriter::populate_frame_description(astra_frame_t& astraFrame,
+                                                       int streamId,
+                                                       FrameDescription& frameDescription)
     {
+        auto sinceStart = std::chrono::steady_clock::now() - m_recordingStart;
+        const uint64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(sinceStart).count();
+
+        //the rate of the stream's frames, from the time since its last one
+        const uint64_t interval = timestamp - m_lastTimestamps[streamId];
+        m_lastTimestamps[streamId] = timestamp;
+
         frameDescription.bufferLength = astraFrame.byteLength;
-        frameDescription.framePeriod = fps;
+        frameDescription.framePeriod = interval > 0 ? 1000000.0 / interval : 0;
+        frameDescription.timestamp = timestamp;
     }
 }}
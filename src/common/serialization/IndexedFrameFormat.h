@@ -0,0 +1,78 @@
+#ifndef INDEXEDFRAMEFORMAT_H
+#define INDEXEDFRAMEFORMAT_H
+
+#include <AstraUL/streams/depth_types.h>
+#include <cstdint>
+#include <cstring>
+
+namespace astra { namespace serialization {
+
+    // Layout of an indexed recording:
+    //
+    //   IndexedFileHeader, then streamCount IndexedStreamHeaders
+    //   frame payloads, each starting on a page boundary
+    //   frameCount IndexedFrameEntries at indexOffset
+    //
+    // The file and stream headers are written again with the index offset,
+    // the frame count and each stream's largest frame when the recording is
+    // closed. Frames of all the streams are interleaved in the order they
+    // were written. Values are stored in the byte order of the machine that
+    // recorded them.
+
+    const char INDEXED_RECORDING_MAGIC[8] = { 'A', 'S', 'T', 'R', 'A', 'I', 'D', 'X' };
+    const uint32_t INDEXED_RECORDING_VERSION = 2;
+    const uint32_t INDEXED_RECORDING_PAGE_SIZE = 4096;
+
+    struct IndexedFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t pageSize;
+        uint32_t streamCount;
+        uint32_t reserved;
+        uint64_t frameCount;
+        //0 until the recording is closed
+        uint64_t indexOffset;
+    };
+
+    struct IndexedStreamHeader
+    {
+        uint32_t frameType;
+        int32_t subtype;
+        uint32_t maxFrameLength;
+        uint32_t pixelFormat;
+        uint32_t width;
+        uint32_t height;
+        float horizontalFov;
+        float verticalFov;
+        uint32_t hasConversionCache;
+        uint32_t reserved;
+        conversion_cache_t conversionCache;
+    };
+
+    struct IndexedFrameEntry
+    {
+        //from the start of the file
+        uint64_t offset;
+        //microseconds since the recording began
+        uint64_t timestamp;
+        double framePeriod;
+        uint32_t byteLength;
+        uint32_t frameIndex;
+        //position of the frame's stream in the stream headers
+        uint32_t streamId;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(IndexedFileHeader) == 40, "the recording header layout is fixed");
+    static_assert(sizeof(IndexedStreamHeader) == 72, "the stream header layout is fixed");
+    static_assert(sizeof(IndexedFrameEntry) == 40, "the index entry layout is fixed");
+
+    inline bool has_indexed_recording_magic(const char* magic)
+    {
+        return std::memcmp(magic, INDEXED_RECORDING_MAGIC, sizeof(INDEXED_RECORDING_MAGIC)) == 0;
+    }
+
+}}
+
+#endif /* INDEXEDFRAMEFORMAT_H */
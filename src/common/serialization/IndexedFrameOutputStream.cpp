@@ -0,0 +1,184 @@
+#include "IndexedFrameOutputStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace astra { namespace serialization {
+
+    IndexedFrameOutputStream::IndexedFrameOutputStream(FILE* file) :
+        FrameOutputStream(),
+        m_file(file)
+    {
+        m_frame = Frame();
+        m_frameDescription = FrameDescription();
+    }
+
+    IndexedFrameOutputStream::~IndexedFrameOutputStream()
+    {
+        if (m_headerWritten)
+        {
+            write_index();
+        }
+    }
+
+    void IndexedFrameOutputStream::stage_frame(Frame& frame)
+    {
+        //the frame's data is only read by write_frame
+        m_frame = frame;
+    }
+
+    void IndexedFrameOutputStream::stage_frame_description(FrameDescription& frameDesc)
+    {
+        m_frameDescription = frameDesc;
+    }
+
+    void IndexedFrameOutputStream::stage_stream_header(StreamHeader& streamHeader)
+    {
+        //streams can't be added once frames are being written
+        if (m_headerWritten)
+        {
+            return;
+        }
+
+        IndexedStreamHeader indexedHeader;
+        populate_stream_header(streamHeader, indexedHeader);
+        m_streamHeaders.push_back(indexedHeader);
+    }
+
+    bool IndexedFrameOutputStream::write_frame()
+    {
+        if (!m_headerWritten ||
+            m_frame.streamId < 0 ||
+            m_frame.streamId >= static_cast<int>(m_streamHeaders.size()) ||
+            !pad_to(INDEXED_RECORDING_PAGE_SIZE))
+        {
+            return false;
+        }
+
+        IndexedFrameEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.offset = m_position;
+        entry.timestamp = m_frameDescription.timestamp;
+        entry.framePeriod = m_frameDescription.framePeriod;
+        entry.byteLength = m_frame.byteLength;
+        entry.frameIndex = m_frame.frameIndex;
+        entry.streamId = m_frame.streamId;
+
+        if (!write_bytes(m_frame.rawFrameWrapper, m_frame.byteLength))
+        {
+            return false;
+        }
+
+        IndexedStreamHeader& streamHeader = m_streamHeaders[entry.streamId];
+        streamHeader.maxFrameLength = std::max(streamHeader.maxFrameLength, entry.byteLength);
+
+        m_index.push_back(entry);
+        return true;
+    }
+
+    bool IndexedFrameOutputStream::write_frame_description()
+    {
+        //descriptions are written to the index with their frames
+        return m_headerWritten;
+    }
+
+    bool IndexedFrameOutputStream::write_stream_header()
+    {
+        if (m_headerWritten || m_streamHeaders.empty())
+        {
+            return false;
+        }
+
+        m_headerWritten = write_headers(0, 0);
+
+        return m_headerWritten;
+    }
+
+    bool IndexedFrameOutputStream::write_bytes(const void* data, size_t byteLength)
+    {
+        if (byteLength > 0 && fwrite(data, 1, byteLength, m_file) != byteLength)
+        {
+            return false;
+        }
+
+        m_position += byteLength;
+        return true;
+    }
+
+    bool IndexedFrameOutputStream::pad_to(uint64_t alignment)
+    {
+        static const char zeros[INDEXED_RECORDING_PAGE_SIZE] = { 0 };
+
+        const size_t padding = static_cast<size_t>((alignment - m_position % alignment) % alignment);
+        return write_bytes(zeros, padding);
+    }
+
+    void IndexedFrameOutputStream::populate_file_header(IndexedFileHeader& header,
+                                                        uint64_t frameCount,
+                                                        uint64_t indexOffset)
+    {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, INDEXED_RECORDING_MAGIC, sizeof(header.magic));
+        header.version = INDEXED_RECORDING_VERSION;
+        header.pageSize = INDEXED_RECORDING_PAGE_SIZE;
+        header.streamCount = static_cast<uint32_t>(m_streamHeaders.size());
+        header.frameCount = frameCount;
+        header.indexOffset = indexOffset;
+    }
+
+    void IndexedFrameOutputStream::populate_stream_header(const StreamHeader& streamHeader,
+                                                          IndexedStreamHeader& indexedHeader)
+    {
+        std::memset(&indexedHeader, 0, sizeof(indexedHeader));
+        indexedHeader.frameType = streamHeader.frameType;
+        indexedHeader.subtype = streamHeader.subtype;
+        indexedHeader.maxFrameLength = streamHeader.maxFrameLength;
+        indexedHeader.pixelFormat = streamHeader.pixelFormat;
+        indexedHeader.width = streamHeader.width;
+        indexedHeader.height = streamHeader.height;
+        indexedHeader.horizontalFov = streamHeader.horizontalFov;
+        indexedHeader.verticalFov = streamHeader.verticalFov;
+        indexedHeader.hasConversionCache = streamHeader.hasConversionCache ? 1 : 0;
+        indexedHeader.conversionCache = streamHeader.conversionCache;
+    }
+
+    bool IndexedFrameOutputStream::write_headers(uint64_t frameCount, uint64_t indexOffset)
+    {
+        IndexedFileHeader header;
+        populate_file_header(header, frameCount, indexOffset);
+
+        return write_bytes(&header, sizeof(header)) &&
+               write_bytes(m_streamHeaders.data(), m_streamHeaders.size() * sizeof(IndexedStreamHeader));
+    }
+
+    bool IndexedFrameOutputStream::write_index()
+    {
+        if (!pad_to(sizeof(uint64_t)))
+        {
+            return false;
+        }
+
+        const uint64_t indexOffset = m_position;
+
+        if (!m_index.empty() &&
+            !write_bytes(m_index.data(), m_index.size() * sizeof(IndexedFrameEntry)))
+        {
+            return false;
+        }
+
+        //rewrite the headers with the index's offset and the largest frames,
+        //then leave the file at its end
+        const uint64_t endPosition = m_position;
+        m_position = 0;
+
+        const bool isSuccessful = fseek(m_file, 0, SEEK_SET) == 0 &&
+                                  write_headers(m_index.size(), indexOffset);
+
+        fseek(m_file, 0, SEEK_END);
+        m_position = endPosition;
+        fflush(m_file);
+
+        return isSuccessful;
+    }
+
+}}
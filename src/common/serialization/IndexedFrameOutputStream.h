@@ -0,0 +1,51 @@
+#ifndef INDEXEDFRAMEOUTPUTSTREAM_H
+#define INDEXEDFRAMEOUTPUTSTREAM_H
+
+#include <common/serialization/FrameOutputStream.h>
+#include "IndexedFrameFormat.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace astra { namespace serialization {
+
+    // Writes the indexed recording format, see IndexedFrameFormat.h. Each
+    // staged stream header adds a stream, and they are all written together.
+    // The index is kept in memory and written after the last frame when the
+    // stream is destroyed, so the file is only readable once it is closed.
+    class IndexedFrameOutputStream : public FrameOutputStream
+    {
+    public:
+        IndexedFrameOutputStream(FILE* file);
+        virtual ~IndexedFrameOutputStream() override;
+
+        void stage_frame(Frame& frame) override;
+        void stage_frame_description(FrameDescription& frameDesc) override;
+        void stage_stream_header(StreamHeader& streamHeader) override;
+        bool write_frame() override;
+        bool write_frame_description() override;
+        bool write_stream_header() override;
+
+    private:
+        bool write_bytes(const void* data, size_t byteLength);
+        bool pad_to(uint64_t alignment);
+        void populate_file_header(IndexedFileHeader& header, uint64_t frameCount, uint64_t indexOffset);
+        void populate_stream_header(const StreamHeader& streamHeader, IndexedStreamHeader& indexedHeader);
+        bool write_headers(uint64_t frameCount, uint64_t indexOffset);
+        bool write_index();
+
+        FILE* m_file;
+        uint64_t m_position{ 0 };
+        bool m_headerWritten{ false };
+
+        Frame m_frame;
+        FrameDescription m_frameDescription;
+        std::vector<IndexedStreamHeader> m_streamHeaders;
+
+        std::vector<IndexedFrameEntry> m_index;
+    };
+
+}}
+
+#endif /* INDEXEDFRAMEOUTPUTSTREAM_H */
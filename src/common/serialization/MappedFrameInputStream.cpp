@@ -0,0 +1,385 @@
+#include "MappedFrameInputStream.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace astra { namespace serialization {
+
+    bool is_indexed_recording(const char* path)
+    {
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        char magic[sizeof(INDEXED_RECORDING_MAGIC)];
+        const bool hasMagic = fread(magic, sizeof(magic), 1, file) == 1 &&
+                              has_indexed_recording_magic(magic);
+
+        fclose(file);
+        return hasMagic;
+    }
+
+    MappedFrameInputStream::MappedFrameInputStream(const char* path) :
+        FrameInputStream()
+    {
+        //a recording that was never closed has no index to read it by
+        if (!map_file(path) || !read_index())
+        {
+            unmap_file();
+            throw ResourceNotFoundException(path);
+        }
+    }
+
+    MappedFrameInputStream::~MappedFrameInputStream()
+    {
+        close();
+    }
+
+    void MappedFrameInputStream::close()
+    {
+        unmap_file();
+        m_streamHeaders.clear();
+        m_index = nullptr;
+        m_frameCount = 0;
+        m_frameNumber = 0;
+    }
+
+#ifdef _WIN32
+    bool MappedFrameInputStream::map_file(const char* path)
+    {
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        m_fileHandle = file;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            return false;
+        }
+        m_mappingHandle = mapping;
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFrameInputStream::unmap_file()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mappingHandle != nullptr)
+        {
+            CloseHandle(m_mappingHandle);
+        }
+        if (m_fileHandle != nullptr)
+        {
+            CloseHandle(m_fileHandle);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mappingHandle = nullptr;
+        m_fileHandle = nullptr;
+    }
+#else
+    bool MappedFrameInputStream::map_file(const char* path)
+    {
+        int fileDescriptor = open(path, O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        struct stat stat_buf;
+        if (fstat(fileDescriptor, &stat_buf) != 0 || stat_buf.st_size == 0)
+        {
+            ::close(fileDescriptor);
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(stat_buf.st_size);
+        void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+        //the mapping keeps the file open
+        ::close(fileDescriptor);
+
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = size;
+        return true;
+    }
+
+    void MappedFrameInputStream::unmap_file()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+
+    bool MappedFrameInputStream::read_index()
+    {
+        if (m_size < sizeof(IndexedFileHeader))
+        {
+            return false;
+        }
+
+        const IndexedFileHeader* header = reinterpret_cast<const IndexedFileHeader*>(m_data);
+
+        if (!has_indexed_recording_magic(header->magic) ||
+            header->version != INDEXED_RECORDING_VERSION ||
+            header->streamCount == 0 ||
+            header->indexOffset == 0)
+        {
+            return false;
+        }
+
+        if (header->indexOffset > m_size ||
+            header->indexOffset % sizeof(uint64_t) != 0)
+        {
+            return false;
+        }
+
+        const uint64_t streamHeadersEnd = sizeof(IndexedFileHeader) +
+                                          static_cast<uint64_t>(header->streamCount) * sizeof(IndexedStreamHeader);
+        //the frame count is checked against the room the index has, so a
+        //corrupt count can't overflow the index's size
+        const uint64_t maxFrameCount = (m_size - header->indexOffset) / sizeof(IndexedFrameEntry);
+
+        if (streamHeadersEnd > header->indexOffset ||
+            header->frameCount > maxFrameCount ||
+            header->frameCount > static_cast<uint64_t>(INT_MAX))
+        {
+            return false;
+        }
+
+        const IndexedStreamHeader* streamHeaders =
+            reinterpret_cast<const IndexedStreamHeader*>(m_data + sizeof(IndexedFileHeader));
+
+        m_streamHeaders.resize(header->streamCount);
+        for (uint32_t i = 0; i < header->streamCount; ++i)
+        {
+            const IndexedStreamHeader& indexedHeader = streamHeaders[i];
+            StreamHeader& streamHeader = m_streamHeaders[i];
+
+            streamHeader.frameType = indexedHeader.frameType;
+            streamHeader.subtype = indexedHeader.subtype;
+            streamHeader.maxFrameLength = indexedHeader.maxFrameLength;
+            streamHeader.pixelFormat = indexedHeader.pixelFormat;
+            streamHeader.width = indexedHeader.width;
+            streamHeader.height = indexedHeader.height;
+            streamHeader.horizontalFov = indexedHeader.horizontalFov;
+            streamHeader.verticalFov = indexedHeader.verticalFov;
+            streamHeader.hasConversionCache = indexedHeader.hasConversionCache != 0;
+            streamHeader.conversionCache = indexedHeader.conversionCache;
+        }
+
+        m_index = reinterpret_cast<const IndexedFrameEntry*>(m_data + header->indexOffset);
+        m_frameCount = static_cast<int>(header->frameCount);
+
+        //every frame has to lie between the headers and the index
+        for (int i = 0; i < m_frameCount; ++i)
+        {
+            const IndexedFrameEntry& entry = m_index[i];
+            if (entry.offset < streamHeadersEnd ||
+                entry.offset > header->indexOffset ||
+                entry.byteLength > header->indexOffset - entry.offset ||
+                entry.streamId >= header->streamCount)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool MappedFrameInputStream::read_stream_header(StreamHeader*& streamHeader)
+    {
+        if (!get_stream_header(0, streamHeader))
+        {
+            return false;
+        }
+
+        //like the other formats, the first frame follows the header
+        m_frameNumber = 0;
+
+        return true;
+    }
+
+    int MappedFrameInputStream::get_stream_count()
+    {
+        return static_cast<int>(m_streamHeaders.size());
+    }
+
+    bool MappedFrameInputStream::get_stream_header(int streamId, StreamHeader*& streamHeader)
+    {
+        if (streamId < 0 || streamId >= get_stream_count())
+        {
+            streamHeader = nullptr;
+            return false;
+        }
+
+        streamHeader = &m_streamHeaders[streamId];
+        return true;
+    }
+
+    bool MappedFrameInputStream::read_frame(Frame*& frame)
+    {
+        if (is_end_of_file())
+        {
+            frame = nullptr;
+            return false;
+        }
+
+        const IndexedFrameEntry& entry = m_index[m_frameNumber];
+
+        m_frame.byteLength = entry.byteLength;
+        m_frame.frameIndex = entry.frameIndex;
+        m_frame.streamId = entry.streamId;
+        m_frame.rawFrameWrapper = const_cast<uint8_t*>(m_data + entry.offset);
+
+        frame = &m_frame;
+        ++m_frameNumber;
+
+        return true;
+    }
+
+    bool MappedFrameInputStream::read_frame_description(FrameDescription*& frameDescription)
+    {
+        if (is_end_of_file())
+        {
+            frameDescription = nullptr;
+            return false;
+        }
+
+        const IndexedFrameEntry& entry = m_index[m_frameNumber];
+
+        m_frameDescription.framePeriod = entry.framePeriod;
+        m_frameDescription.bufferLength = entry.byteLength;
+        m_frameDescription.timestamp = entry.timestamp;
+
+        frameDescription = &m_frameDescription;
+
+        return true;
+    }
+
+    bool MappedFrameInputStream::seek(int offset)
+    {
+        //byte offsets can only land on the start of the recording or of a frame
+        const int64_t position = get_position() + offset;
+
+        if (position < 0)
+        {
+            return false;
+        }
+        if (position == 0)
+        {
+            return seek_to_first_frame();
+        }
+
+        const IndexedFrameEntry* end = m_index + m_frameCount;
+        const IndexedFrameEntry* entry =
+            std::lower_bound(m_index, end, static_cast<uint64_t>(position),
+                             [](const IndexedFrameEntry& e, uint64_t p) { return e.offset < p; });
+
+        if (entry == end || entry->offset != static_cast<uint64_t>(position))
+        {
+            return false;
+        }
+
+        m_frameNumber = static_cast<int>(entry - m_index);
+        return true;
+    }
+
+    bool MappedFrameInputStream::seek_to_first_frame()
+    {
+        m_frameNumber = 0;
+        return true;
+    }
+
+    bool MappedFrameInputStream::seek_to_frame(int frameNumber)
+    {
+        if (frameNumber < 0 || frameNumber >= m_frameCount)
+        {
+            return false;
+        }
+
+        m_frameNumber = frameNumber;
+        return true;
+    }
+
+    int MappedFrameInputStream::get_frame_number()
+    {
+        return m_frameNumber;
+    }
+
+    int MappedFrameInputStream::get_frame_count()
+    {
+        return m_frameCount;
+    }
+
+    int64_t MappedFrameInputStream::get_position()
+    {
+        if (is_end_of_file())
+        {
+            return m_size;
+        }
+
+        return m_index[m_frameNumber].offset;
+    }
+
+    bool MappedFrameInputStream::is_end_of_file()
+    {
+        return m_frameNumber >= m_frameCount;
+    }
+
+    int MappedFrameInputStream::get_frame_description_size()
+    {
+        return sizeof(IndexedFrameEntry);
+    }
+
+    int MappedFrameInputStream::get_stream_header_size()
+    {
+        return sizeof(IndexedStreamHeader);
+    }
+
+}}
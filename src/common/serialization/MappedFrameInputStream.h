@@ -0,0 +1,68 @@
+#ifndef MAPPEDFRAMEINPUTSTREAM_H
+#define MAPPEDFRAMEINPUTSTREAM_H
+
+#include <common/serialization/FrameInputStream.h>
+#include "IndexedFrameFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace astra { namespace serialization {
+
+    // true when the file starts like an indexed recording
+    bool is_indexed_recording(const char* path);
+
+    // Reads an indexed recording through a read only mapping of the whole
+    // file. Frames point into the mapping, so they are valid until the
+    // stream is closed, and seeking to a frame is a lookup in the index.
+    class MappedFrameInputStream : public FrameInputStream
+    {
+    public:
+        MappedFrameInputStream(const char* path);
+
+        virtual ~MappedFrameInputStream();
+
+        void close() override final;
+        bool read_stream_header(StreamHeader*& streamHeader) override;
+        int get_stream_count() override;
+        bool get_stream_header(int streamId, StreamHeader*& streamHeader) override;
+        bool read_frame(Frame*& frame) override;
+        bool read_frame_description(FrameDescription*& frameDescription) override;
+        bool seek(int offset) override;
+        bool seek_to_first_frame() override;
+        bool seek_to_frame(int frameNumber) override;
+        int get_frame_number() override;
+        int get_frame_count() override;
+        int64_t get_position() override;
+        bool is_end_of_file() override;
+        int get_frame_description_size() override;
+        int get_stream_header_size() override;
+
+    private:
+        bool map_file(const char* path);
+        void unmap_file();
+        bool read_index();
+
+        const uint8_t* m_data{ nullptr };
+        size_t m_size{ 0 };
+
+#ifdef _WIN32
+        void* m_fileHandle{ nullptr };
+        void* m_mappingHandle{ nullptr };
+#endif
+
+        const IndexedFrameEntry* m_index{ nullptr };
+        int m_frameCount{ 0 };
+
+        //the frame read_frame returns next
+        int m_frameNumber{ 0 };
+
+        Frame m_frame;
+        FrameDescription m_frameDescription;
+        std::vector<StreamHeader> m_streamHeaders;
+    };
+
+}}
+
+#endif /* MAPPEDFRAMEINPUTSTREAM_H */
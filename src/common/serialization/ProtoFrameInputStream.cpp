@@ -6,6 +6,12 @@
 
 #include "pb_util.h"
 
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace astra { namespace serialization {
 
     ProtoFrameInputStream::ProtoFrameInputStream(const char* path) :
@@ -55,17 +61,18 @@ namespace astra { namespace serialization {
 
     bool ProtoFrameInputStream::read_stream_header(StreamHeader*& streamHeader)
     {
-        long filePos = ftell(m_file);
-
-        if (filePos != 0)
+        if (get_position() != 0)
         {
-            fseek(m_file, 0, SEEK_SET);
-            m_inputStream = std::make_unique<FileInputStream>(m_fileDescriptor);
+            seek_to_position(0);
         }
 
         bool isSuccessful = proto::read_delimited_to(m_inputStream.get(), &m_streamHeaderMessage);
 
+        m_streamHeader = StreamHeader();
         m_streamHeader.frameType = m_streamHeaderMessage.frametype();
+        m_frameNumber = 0;
+        m_timestamp = 0;
+        m_hasStreamHeader = isSuccessful;
 
         if (isSuccessful)
         {
@@ -79,12 +86,30 @@ namespace astra { namespace serialization {
         return isSuccessful;
     }
 
+    int ProtoFrameInputStream::get_stream_count()
+    {
+        return m_hasStreamHeader ? 1 : 0;
+    }
+
+    bool ProtoFrameInputStream::get_stream_header(int streamId, StreamHeader*& streamHeader)
+    {
+        if (!m_hasStreamHeader || streamId != 0)
+        {
+            streamHeader = nullptr;
+            return false;
+        }
+
+        streamHeader = &m_streamHeader;
+        return true;
+    }
+
     bool ProtoFrameInputStream::read_frame(Frame*& frame)
     {
         bool isSuccessful = proto::read_delimited_to(m_inputStream.get(), &m_frameMessage);
 
         m_frame.byteLength = m_frameMessage.bytelength();
         m_frame.frameIndex = m_frameMessage.frameindex();
+        m_frame.streamId = 0;
 
         std::string* frameWrapperString = m_frameMessage.mutable_rawframewrapper();
         m_frame.rawFrameWrapper = &(*frameWrapperString)[0];
@@ -92,6 +117,7 @@ namespace astra { namespace serialization {
         if (isSuccessful)
         {
             frame = &m_frame;
+            ++m_frameNumber;
         }
         else
         {
@@ -110,6 +136,14 @@ namespace astra { namespace serialization {
 
         if (isSuccessful)
         {
+            //framePeriod is the rate the frame arrived at, so it came
+            //1 / framePeriod seconds after the one before it
+            if (m_frameDescription.framePeriod > 0)
+            {
+                m_timestamp += static_cast<uint64_t>(1000000 / m_frameDescription.framePeriod);
+            }
+            m_frameDescription.timestamp = m_timestamp;
+
             frameDescription = &m_frameDescription;
         }
         else
@@ -126,13 +160,48 @@ namespace astra { namespace serialization {
 
         int offset = get_stream_header_size() + 4;
 
-        fseek(m_file, offset, SEEK_SET);
-        m_inputStream = std::make_unique<FileInputStream>(m_fileDescriptor);
-        m_positionOffset = ftell(m_file);
+        seek_to_position(offset);
+        m_frameNumber = 0;
+        m_timestamp = 0;
 
         return isSuccessful;
     }
 
+    bool ProtoFrameInputStream::seek_to_frame(int frameNumber)
+    {
+        if (frameNumber < 0)
+        {
+            return false;
+        }
+
+        //frames vary in size and there is no index, so they are read through
+        //from the first one
+        seek_to_first_frame();
+
+        FrameDescription* frameDescription = nullptr;
+        Frame* frame = nullptr;
+        while (m_frameNumber < frameNumber)
+        {
+            if (is_end_of_file() ||
+                !read_frame_description(frameDescription) ||
+                !read_frame(frame))
+            {
+                return false;
+            }
+        }
+
+        return !is_end_of_file();
+    }
+
+    int ProtoFrameInputStream::get_frame_number()
+    {
+        return m_frameNumber;
+    }
+
+    int ProtoFrameInputStream::get_frame_count()
+    {
+        return -1;
+    }
 
     bool ProtoFrameInputStream::seek(int offset)
     {
@@ -147,13 +216,24 @@ namespace astra { namespace serialization {
             return !isSuccessful;
         }
 
-        fseek(m_file, offset, SEEK_CUR);
-        m_inputStream = std::make_unique<FileInputStream>(m_fileDescriptor);
-        m_positionOffset = ftell(m_file);
+        seek_to_position(get_position() + offset);
 
         return isSuccessful;
     }
 
+    void ProtoFrameInputStream::seek_to_position(int64_t position)
+    {
+        //the input stream reads ahead on the descriptor, not through m_file,
+        //so the descriptor is moved and a new stream started from there
+#ifdef _MSC_VER
+        _lseeki64(m_fileDescriptor, position, SEEK_SET);
+#else
+        lseek(m_fileDescriptor, position, SEEK_SET);
+#endif
+        m_inputStream = std::make_unique<FileInputStream>(m_fileDescriptor);
+        m_positionOffset = position;
+    }
+
     int64_t ProtoFrameInputStream::get_position()
     {
         return m_inputStream->ByteCount() + m_positionOffset;
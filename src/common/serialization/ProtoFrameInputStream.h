@@ -26,10 +26,15 @@ namespace astra { namespace serialization {
 
         void close() override final;
         bool read_stream_header(StreamHeader*& streamHeader) override;
+        int get_stream_count() override;
+        bool get_stream_header(int streamId, StreamHeader*& streamHeader) override;
         bool read_frame(Frame*& frame) override;
         bool read_frame_description(FrameDescription*& frameDescription) override;
         bool seek(int offset) override;
         bool seek_to_first_frame() override;
+        bool seek_to_frame(int frameNumber) override;
+        int get_frame_number() override;
+        int get_frame_count() override;
         int64_t get_position() override;
         bool is_end_of_file() override;
         int get_frame_description_size() override;
@@ -38,11 +43,16 @@ namespace astra { namespace serialization {
     private:
         long get_file_size(int fd);
         int get_file_descriptor(FILE* file);
+        void seek_to_position(int64_t position);
 
         FILE* m_file;
         int m_fileDescriptor{-1};
 
-        int m_positionOffset{0};
+        int64_t m_positionOffset{0};
+        int m_frameNumber{0};
+        //added up from the frame periods, the format has no timestamps
+        uint64_t m_timestamp{0};
+        bool m_hasStreamHeader{false};
 
         std::unique_ptr<ZeroCopyInputStream> m_inputStream;
         proto::Frame m_frameMessage;
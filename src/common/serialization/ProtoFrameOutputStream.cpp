@@ -22,7 +22,7 @@ namespace astra { namespace serialization {
         populate_frame_message(frame.byteLength, frame.frameIndex, frame.rawFrameWrapper, frameMessage);
 
         m_frameMessage = frameMessage;
-
+        m_frameStreamId = frame.streamId;
     }
 
     void ProtoFrameOutputStream::stage_frame_description(FrameDescription& frameDesc)
@@ -39,10 +39,16 @@ namespace astra { namespace serialization {
         populate_stream_header_message(streamHeader.frameType, streamHeaderMessage);
 
         m_streamHeaderMessage = streamHeaderMessage;
+        ++m_streamCount;
     }
 
     bool ProtoFrameOutputStream::write_frame()
     {
+        if (m_frameStreamId != 0)
+        {
+            return false;
+        }
+
         return proto::write_delimited_to(m_frameMessage, m_outputStream.get());
     }
 
@@ -53,6 +59,12 @@ namespace astra { namespace serialization {
 
     bool ProtoFrameOutputStream::write_stream_header()
     {
+        //there is nowhere to keep a second stream's header or frames
+        if (m_streamCount != 1)
+        {
+            return false;
+        }
+
         return proto::write_delimited_to(m_streamHeaderMessage, m_outputStream.get());
     }
 
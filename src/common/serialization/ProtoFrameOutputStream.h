@@ -18,6 +18,7 @@ namespace google{namespace protobuf{namespace io{
 
 namespace astra { namespace serialization {
 
+    // Writes the protobuf recording format, which holds a single stream
     class ProtoFrameOutputStream : public FrameOutputStream
     {
     public:
@@ -41,6 +42,9 @@ namespace astra { namespace serialization {
         proto::Frame m_frameMessage;
         proto::FrameDescription m_frameDescriptionMessage;
         proto::StreamHeader m_streamHeaderMessage;
+
+        int m_streamCount{0};
+        int m_frameStreamId{0};
     };
 
 }}
@@ -0,0 +1,354 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <Astra/Plugins/plugin_capi.h>
+#include <common/serialization/FrameStreamReader.h>
+#include <common/serialization/FrameStreamWriter.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace astra::serialization;
+
+namespace {
+
+    const uint64_t FRAME_INTERVAL = 33333; //us
+    const int WIDTH = 160;
+    const int HEIGHT = 120;
+
+    // Depth frames that differ in every pixel from one frame to the next
+    std::vector<std::vector<int16_t>> make_depth_frames(int frameCount)
+    {
+        std::vector<std::vector<int16_t>> frames(frameCount);
+        for (int i = 0; i < frameCount; ++i)
+        {
+            frames[i].resize(WIDTH * HEIGHT);
+            for (int pixel = 0; pixel < WIDTH * HEIGHT; ++pixel)
+            {
+                frames[i][pixel] = static_cast<int16_t>(500 + (pixel * 7 + i * 13) % 3000);
+            }
+        }
+        return frames;
+    }
+
+    conversion_cache_t make_conversion_cache()
+    {
+        conversion_cache_t cache;
+        cache.xzFactor = 1.12f;
+        cache.yzFactor = 0.84f;
+        cache.resolutionX = WIDTH;
+        cache.resolutionY = HEIGHT;
+        cache.halfResX = WIDTH / 2;
+        cache.halfResY = HEIGHT / 2;
+        cache.coeffX = WIDTH / cache.xzFactor;
+        cache.coeffY = HEIGHT / cache.yzFactor;
+        return cache;
+    }
+
+    // Writes the frames as the depth stream's image frame wrappers. Some
+    // frames get trailing bytes, so the frames are not all the same size.
+    bool write_indexed_recording(const std::string& path, const std::vector<std::vector<int16_t>>& frames)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        FrameOutputStream* stream = open_indexed_frame_output_stream(file);
+
+        StreamHeader streamHeader;
+        streamHeader.frameType = ASTRA_STREAM_DEPTH;
+        stream->stage_stream_header(streamHeader);
+        bool isSuccessful = stream->write_stream_header();
+
+        const size_t pixelBytes = WIDTH * HEIGHT * sizeof(int16_t);
+        std::vector<uint8_t> buffer;
+
+        for (size_t i = 0; isSuccessful && i < frames.size(); ++i)
+        {
+            buffer.assign(sizeof(astra_imageframe_wrapper_t) + pixelBytes + (i % 3) * 100, 0);
+
+            astra_imageframe_wrapper_t* wrapper = reinterpret_cast<astra_imageframe_wrapper_t*>(buffer.data());
+            wrapper->frame.metadata.width = WIDTH;
+            wrapper->frame.metadata.height = HEIGHT;
+            wrapper->frame.metadata.pixelFormat = ASTRA_PIXEL_FORMAT_DEPTH_MM;
+            std::memcpy(wrapper->frame_data, frames[i].data(), pixelBytes);
+
+            FrameDescription frameDescription;
+            frameDescription.framePeriod = 30;
+            frameDescription.bufferLength = static_cast<int>(buffer.size());
+            frameDescription.timestamp = i * FRAME_INTERVAL;
+
+            Frame frame;
+            frame.byteLength = static_cast<int>(buffer.size());
+            frame.frameIndex = static_cast<int>(i);
+            frame.rawFrameWrapper = buffer.data();
+
+            stream->stage_frame_description(frameDescription);
+            stream->stage_frame(frame);
+            isSuccessful = stream->write_frame_description() && stream->write_frame();
+        }
+
+        close_frame_output_stream(stream);
+        fclose(file);
+        return isSuccessful;
+    }
+
+    // A stream's frame as the writer gets it from a reader frame
+    astra_frame_t make_astra_frame(std::vector<uint8_t>& buffer, int frameIndex)
+    {
+        astra_frame_t astraFrame;
+        astraFrame.byteLength = buffer.size();
+        astraFrame.frameIndex = frameIndex;
+        astraFrame.data = buffer.data();
+        return astraFrame;
+    }
+
+    bool pixels_match(const Frame& frame, const std::vector<int16_t>& expected)
+    {
+        const astra_imageframe_wrapper_t* wrapper =
+            static_cast<const astra_imageframe_wrapper_t*>(frame.rawFrameWrapper);
+        return std::memcmp(wrapper->frame_data, expected.data(), expected.size() * sizeof(int16_t)) == 0;
+    }
+}
+
+TEST_CASE("Indexed recordings seek to any frame", "[serialization]")
+{
+    const std::string path = "frame_serialization_test.df";
+    const int frameCount = 20;
+
+    const std::vector<std::vector<int16_t>> frames = make_depth_frames(frameCount);
+    REQUIRE(write_indexed_recording(path, frames));
+
+    {
+        std::unique_ptr<FrameInputStream> stream(open_frame_input_stream(path.c_str()));
+        REQUIRE(stream->get_frame_count() == frameCount);
+
+        FrameDescription* frameDescription = nullptr;
+        Frame* frame = nullptr;
+
+        for (int frameNumber : { 13, 2, 19, 0 })
+        {
+            INFO("frame " << frameNumber);
+            REQUIRE(stream->seek_to_frame(frameNumber));
+            REQUIRE(stream->read_frame_description(frameDescription));
+            REQUIRE(frameDescription->timestamp == frameNumber * FRAME_INTERVAL);
+            REQUIRE(stream->read_frame(frame));
+            REQUIRE(frame->frameIndex == frameNumber);
+            REQUIRE(pixels_match(*frame, frames[frameNumber]));
+            REQUIRE(stream->get_frame_number() == frameNumber + 1);
+
+            //frames are read in place, on page boundaries
+            const uintptr_t address = reinterpret_cast<uintptr_t>(frame->rawFrameWrapper);
+            REQUIRE((address % 4096) == 0);
+        }
+
+        REQUIRE_FALSE(stream->seek_to_frame(frameCount));
+        stream->close();
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Indexed recordings that were not closed do not open", "[serialization]")
+{
+    const std::string path = "frame_serialization_test.df";
+
+    FILE* file = fopen(path.c_str(), "wb");
+    REQUIRE(file != nullptr);
+
+    FrameOutputStream* stream = open_indexed_frame_output_stream(file);
+    StreamHeader streamHeader;
+    streamHeader.frameType = ASTRA_STREAM_DEPTH;
+    stream->stage_stream_header(streamHeader);
+    REQUIRE(stream->write_stream_header());
+    fflush(file);
+
+    //the index is only written when the stream is closed
+    REQUIRE_THROWS_AS(open_frame_input_stream(path.c_str()), const ResourceNotFoundException&);
+
+    close_frame_output_stream(stream);
+    fclose(file);
+
+    std::unique_ptr<FrameInputStream> closed(open_frame_input_stream(path.c_str()));
+    REQUIRE(closed->get_frame_count() == 0);
+    REQUIRE(closed->is_end_of_file());
+    closed->close();
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Indexed recordings with a corrupt frame count do not open", "[serialization]")
+{
+    const std::string path = "frame_serialization_test.df";
+    REQUIRE(write_indexed_recording(path, make_depth_frames(2)));
+
+    //offset of IndexedFileHeader::frameCount
+    const long frameCountOffset = 24;
+
+    //counts that reach past the end of the file, wrap the index size around
+    //or don't fit the frame number
+    for (uint64_t frameCount : { uint64_t(3), uint64_t(0x2000000000000002), uint64_t(0x80000000) })
+    {
+        INFO("frame count " << frameCount);
+
+        FILE* file = fopen(path.c_str(), "r+b");
+        REQUIRE(file != nullptr);
+        REQUIRE(fseek(file, frameCountOffset, SEEK_SET) == 0);
+        REQUIRE(fwrite(&frameCount, sizeof(frameCount), 1, file) == 1);
+        fclose(file);
+
+        REQUIRE_THROWS_AS(open_frame_input_stream(path.c_str()), const ResourceNotFoundException&);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Recordings keep each stream's header and interleave their frames", "[serialization]")
+{
+    const std::string path = "frame_serialization_test.df";
+    const int frameCount = 6;
+
+    const std::vector<std::vector<int16_t>> frames = make_depth_frames(frameCount);
+    const conversion_cache_t conversionCache = make_conversion_cache();
+    const size_t pixelBytes = WIDTH * HEIGHT * sizeof(int16_t);
+
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        FrameOutputStream* stream = open_indexed_frame_output_stream(file);
+
+        StreamHeader depthHeader;
+        depthHeader.frameType = ASTRA_STREAM_DEPTH;
+        depthHeader.horizontalFov = 1.0f;
+        depthHeader.verticalFov = 0.75f;
+        depthHeader.hasConversionCache = true;
+        depthHeader.conversionCache = conversionCache;
+
+        StreamHeader handHeader;
+        handHeader.frameType = ASTRA_STREAM_HAND;
+        handHeader.subtype = 2;
+
+        FrameStreamWriter writer(*stream);
+        REQUIRE(writer.add_stream(depthHeader) == 0);
+        REQUIRE(writer.add_stream(handHeader) == 1);
+        REQUIRE(writer.begin_write());
+        REQUIRE(writer.add_stream(handHeader) == -1);
+
+        std::vector<uint8_t> depthBuffer(sizeof(astra_imageframe_wrapper_t) + pixelBytes);
+        astra_imageframe_wrapper_t* depthWrapper = reinterpret_cast<astra_imageframe_wrapper_t*>(depthBuffer.data());
+        depthWrapper->frame.metadata.width = WIDTH;
+        depthWrapper->frame.metadata.height = HEIGHT;
+        depthWrapper->frame.metadata.pixelFormat = ASTRA_PIXEL_FORMAT_DEPTH_MM;
+
+        for (int i = 0; i < frameCount; ++i)
+        {
+            std::memcpy(depthWrapper->frame_data, frames[i].data(), pixelBytes);
+            astra_frame_t depthFrame = make_astra_frame(depthBuffer, i);
+            REQUIRE(writer.write(0, depthFrame));
+
+            //a hand frame for every other depth frame, with one more hand each time
+            if (i % 2 == 1)
+            {
+                const size_t handCount = i / 2 + 1;
+                std::vector<uint8_t> handBuffer(sizeof(astra_handframe_wrapper_t) + handCount * sizeof(astra_handpoint_t));
+                astra_handframe_wrapper_t* handWrapper = reinterpret_cast<astra_handframe_wrapper_t*>(handBuffer.data());
+                handWrapper->frame.handCount = handCount;
+
+                astra_frame_t handFrame = make_astra_frame(handBuffer, i);
+                REQUIRE(writer.write(1, handFrame));
+            }
+        }
+
+        REQUIRE(writer.end_write());
+        close_frame_output_stream(stream);
+        fclose(file);
+    }
+
+    std::unique_ptr<FrameInputStream> stream(open_frame_input_stream(path.c_str()));
+    REQUIRE(stream->get_stream_count() == 2);
+
+    StreamHeader* depthHeader = nullptr;
+    REQUIRE(stream->get_stream_header(0, depthHeader));
+    REQUIRE(depthHeader->frameType == ASTRA_STREAM_DEPTH);
+    REQUIRE(depthHeader->subtype == 0);
+    REQUIRE(depthHeader->horizontalFov == 1.0f);
+    REQUIRE(depthHeader->verticalFov == 0.75f);
+    REQUIRE(depthHeader->hasConversionCache);
+    REQUIRE(std::memcmp(&depthHeader->conversionCache, &conversionCache, sizeof(conversion_cache_t)) == 0);
+    REQUIRE(depthHeader->pixelFormat == ASTRA_PIXEL_FORMAT_DEPTH_MM);
+    REQUIRE(depthHeader->width == WIDTH);
+    REQUIRE(depthHeader->height == HEIGHT);
+    REQUIRE(depthHeader->maxFrameLength == static_cast<int>(sizeof(astra_imageframe_wrapper_t) + pixelBytes));
+
+    //the hand stream's first frame was not the first one written, and it is not an image
+    StreamHeader* handHeader = nullptr;
+    REQUIRE(stream->get_stream_header(1, handHeader));
+    REQUIRE(handHeader->frameType == ASTRA_STREAM_HAND);
+    REQUIRE(handHeader->subtype == 2);
+    REQUIRE_FALSE(handHeader->hasConversionCache);
+    REQUIRE(handHeader->width == 0);
+    REQUIRE(handHeader->maxFrameLength == static_cast<int>(sizeof(astra_handframe_wrapper_t) + 3 * sizeof(astra_handpoint_t)));
+
+    REQUIRE_FALSE(stream->get_stream_header(2, handHeader));
+
+    StreamHeader* firstHeader = nullptr;
+    REQUIRE(stream->read_stream_header(firstHeader));
+    REQUIRE(firstHeader == depthHeader);
+
+    std::vector<int> streamIds;
+    uint64_t lastTimestamp = 0;
+    FrameDescription* frameDescription = nullptr;
+    Frame* frame = nullptr;
+    while (!stream->is_end_of_file() &&
+           stream->read_frame_description(frameDescription) &&
+           stream->read_frame(frame))
+    {
+        INFO("frame " << streamIds.size());
+        REQUIRE(frameDescription->timestamp >= lastTimestamp);
+        lastTimestamp = frameDescription->timestamp;
+        streamIds.push_back(frame->streamId);
+
+        if (frame->streamId == 0)
+        {
+            REQUIRE(pixels_match(*frame, frames[frame->frameIndex]));
+        }
+        else
+        {
+            const astra_handframe_wrapper_t* handWrapper =
+                static_cast<const astra_handframe_wrapper_t*>(frame->rawFrameWrapper);
+            REQUIRE(handWrapper->frame.handCount == static_cast<size_t>(frame->frameIndex / 2 + 1));
+        }
+    }
+
+    REQUIRE(streamIds == std::vector<int>({ 0, 0, 1, 0, 0, 1, 0, 0, 1 }));
+    stream->close();
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Protobuf recordings hold a single stream", "[serialization]")
+{
+    const std::string path = "frame_serialization_test.df";
+
+    FILE* file = fopen(path.c_str(), "wb");
+    REQUIRE(file != nullptr);
+    FrameOutputStream* stream = open_frame_output_stream(file);
+
+    StreamHeader streamHeader;
+    streamHeader.frameType = ASTRA_STREAM_DEPTH;
+
+    FrameStreamWriter writer(*stream);
+    writer.add_stream(streamHeader);
+    writer.add_stream(streamHeader);
+    REQUIRE(writer.begin_write());
+    REQUIRE_FALSE(writer.end_write());
+
+    close_frame_output_stream(stream);
+    fclose(file);
+    std::remove(path.c_str());
+}
@@ -1,6 +1,7 @@
 #include "DepthUtility.h"
 #include <AstraUL/AstraUL.h>
 #include "TrackingData.h"
+#include <algorithm>
 #include <cmath>
 #include <Shiny.h>
 
@@ -8,23 +9,26 @@ namespace astra { namespace plugins { namespace hand {
 
     DepthUtility::DepthUtility(float width, float height, DepthUtilitySettings& settings) :
         m_processingWidth(width),
-        m_processingHeight(height),
-        m_depthSmoothingFactor(settings.depthSmoothingFactor),
-        m_velocityThresholdFactor(settings.velocityThresholdFactor),
-        m_maxDepthJumpPercent(settings.maxDepthJumpPercent),
-        m_erodeSize(settings.erodeSize),
-        m_depthAdjustmentFactor(settings.depthAdjustmentFactor),
-        m_minDepth(settings.minDepth),
-        m_maxDepth(settings.maxDepth)
+        m_processingHeight(height)
     {
         PROFILE_FUNC();
-        m_rectElement = cv::getStructuringElement(cv::MORPH_RECT,
-                                                  cv::Size(m_erodeSize * 2 + 1, m_erodeSize * 2 + 1),
-                                                  cv::Point(m_erodeSize, m_erodeSize));
+        set_settings(settings);
 
         reset();
     }
 
+    void DepthUtility::set_settings(const DepthUtilitySettings& settings)
+    {
+        m_depthSmoothingFactor = settings.depthSmoothingFactor;
+        m_velocityThresholdFactor = settings.velocityThresholdFactor;
+        m_maxDepthJumpPercent = settings.maxDepthJumpPercent;
+        m_depthAdjustmentFactor = settings.depthAdjustmentFactor;
+        m_minDepth = settings.minDepth;
+        m_maxDepth = settings.maxDepth;
+
+        m_erodeSize = settings.erodeSize;
+    }
+
     DepthUtility::~DepthUtility()
     {
         PROFILE_FUNC();
@@ -34,11 +38,11 @@ namespace astra { namespace plugins { namespace hand {
     {
         PROFILE_FUNC();
         m_matDepthFilled = cv::Mat::zeros(m_processingHeight, m_processingWidth, CV_32FC1);
-        m_matDepthFilledMask = cv::Mat::zeros(m_processingHeight, m_processingWidth, CV_8UC1);
         m_matDepthPrevious = cv::Mat::zeros(m_processingHeight, m_processingWidth, CV_32FC1);
         m_matDepthAvg = cv::Mat::zeros(m_processingHeight, m_processingWidth, CV_32FC1);
         m_matDepthVel.create(m_processingHeight, m_processingWidth, CV_32FC1);
         m_matDepthVelErode.create(m_processingHeight, m_processingWidth, CV_32FC1);
+        m_matDepthVelRowMin.create(m_processingHeight, m_processingWidth, CV_32FC1);
 
         for (int i = 0; i < NUM_DEPTH_VEL_CHUNKS; i++)
         {
@@ -46,53 +50,127 @@ namespace astra { namespace plugins { namespace hand {
         }
     }
 
+    void DepthUtility::set_processing_size(const int width, const int height)
+    {
+        if (width == m_processingWidth && height == m_processingHeight)
+        {
+            return;
+        }
+
+        PROFILE_FUNC();
+        m_processingWidth = width;
+        m_processingHeight = height;
+
+        const cv::Size size(width, height);
+
+        resize_state_plane(m_matDepthPrevious, size);
+        resize_state_plane(m_matDepthAvg, size);
+        resize_state_plane(m_matDepthFilled, size);
+
+        m_matDepthVel.create(size, CV_32FC1);
+        m_matDepthVelErode.create(size, CV_32FC1);
+        m_matDepthVelRowMin.create(size, CV_32FC1);
+
+        //sample offsets are recalculated for the new size on the next frame
+        m_sourceWidth = 0;
+        m_sourceHeight = 0;
+    }
+
+    void DepthUtility::resize_state_plane(cv::Mat& plane, const cv::Size& size)
+    {
+        cv::Mat resized;
+        cv::resize(plane, resized, size, 0, 0, CV_INTER_NN);
+        plane = resized;
+    }
+
     void DepthUtility::processDepthToVelocitySignal(DepthFrame& depthFrame,
                                                     cv::Mat& matDepth,
-                                                    cv::Mat& matDepthFullSize,
                                                     cv::Mat& matVelocitySignal)
     {
-        PROFILE_FUNC();
-        int width = depthFrame.resolutionX();
-        int height = depthFrame.resolutionY();
+        processDepthToVelocitySignal(depthFrame.data(),
+                                     depthFrame.resolutionX(),
+                                     depthFrame.resolutionY(),
+                                     matDepth,
+                                     matVelocitySignal);
+    }
 
-        depthFrameToMat(depthFrame, width, height, matDepthFullSize);
+    void DepthUtility::processDepthToVelocitySignal(const int16_t* depthData,
+                                                    const int width,
+                                                    const int height,
+                                                    cv::Mat& matDepth,
+                                                    cv::Mat& matVelocitySignal)
+    {
+        PROFILE_FUNC();
+        process_to_velocity_signal(depthData, width, height, matDepth, matVelocitySignal);
+    }
 
-        if (width == m_processingWidth && height == m_processingHeight)
-        {
-            //target size is original size, just use the same data
-            matDepth = matDepthFullSize;
-        }
-        else
-        {
-            matDepth.create(m_processingHeight, m_processingWidth, CV_32FC1);
-            //convert to the target processing size with nearest neighbor
-            cv::resize(matDepthFullSize, matDepth, matDepth.size(), 0, 0, CV_INTER_NN);
-        }
+    void DepthUtility::processPointsToVelocitySignal(PointFrame& pointFrame,
+                                                     cv::Mat& matDepth,
+                                                     cv::Mat& matVelocitySignal)
+    {
+        processPointsToVelocitySignal(pointFrame.data(),
+                                      pointFrame.resolutionX(),
+                                      pointFrame.resolutionY(),
+                                      matDepth,
+                                      matVelocitySignal);
+    }
 
-        matVelocitySignal = cv::Mat::zeros(m_processingHeight, m_processingWidth, CV_8UC1);
+    void DepthUtility::processPointsToVelocitySignal(const Vector3f* points,
+                                                     const int width,
+                                                     const int height,
+                                                     cv::Mat& matDepth,
+                                                     cv::Mat& matVelocitySignal)
+    {
+        PROFILE_FUNC();
+        process_to_velocity_signal(points, width, height, matDepth, matVelocitySignal);
+    }
 
-        //fill 0 depth pixels with the value from the previous frame
-        fillZeroValues(matDepth, m_matDepthFilled, m_matDepthFilledMask, m_matDepthPrevious);
+    template<typename TSample>
+    void DepthUtility::process_to_velocity_signal(const TSample* samples,
+                                                  const int width,
+                                                  const int height,
+                                                  cv::Mat& matDepth,
+                                                  cv::Mat& matVelocitySignal)
+    {
+        const int processingWidth = static_cast<int>(m_processingWidth);
+        const int processingHeight = static_cast<int>(m_processingHeight);
 
-        //accumulate current frame to average using smoothing factor
+        matDepth.create(processingHeight, processingWidth, CV_32FC1);
+        //every pixel is written by thresholdVelocitySignal
+        matVelocitySignal.create(processingHeight, processingWidth, CV_8UC1);
 
-        cv::accumulateWeighted(m_matDepthFilled, m_matDepthAvg, m_depthSmoothingFactor);
+        update_sample_offsets(width, height);
 
-        filterZeroValuesAndJumps(m_matDepthFilled,
-                                 m_matDepthPrevious,
-                                 m_matDepthAvg,
-                                 m_matDepthFilledMask,
-                                 m_maxDepthJumpPercent);
+        const float smoothingFactor = m_depthSmoothingFactor;
+        const float previousFactor = 1.0f - smoothingFactor;
+        const bool adjustForDepth = m_depthAdjustmentFactor != 0;
 
-        //current minus average, scaled by average = velocity as a percent change
+        //one pass from the depth frame to the velocity, see process_velocity_row
+        for (int y = 0; y < processingHeight; ++y)
+        {
+            const TSample* sourceRow = samples + m_sampleRows[y] * width;
+            float* depthRow = matDepth.ptr<float>(y);
 
-        m_matDepthVel = (m_matDepthFilled - m_matDepthAvg) / m_matDepthAvg;
+            //nearest neighbor downsample, the same samples as cv::resize with CV_INTER_NN
+            for (int x = 0; x < processingWidth; ++x)
+            {
+                depthRow[x] = sample_depth(sourceRow[m_sampleColumns[x]]);
+            }
 
-        adjust_velocities_for_depth(matDepth, m_matDepthVel);
+            process_velocity_row(depthRow,
+                                 m_matDepthPrevious.ptr<float>(y),
+                                 m_matDepthFilled.ptr<float>(y),
+                                 m_matDepthAvg.ptr<float>(y),
+                                 m_matDepthVel.ptr<float>(y),
+                                 m_matDepthVelErode.ptr<float>(y),
+                                 processingWidth,
+                                 smoothingFactor,
+                                 previousFactor,
+                                 adjustForDepth);
+        }
 
         //erode to eliminate single pixel velocity artifacts
-        m_matDepthVelErode = cv::abs(m_matDepthVel);
-        cv::erode(m_matDepthVelErode, m_matDepthVelErode, m_rectElement);
+        erode_velocity(m_matDepthVelErode, m_matDepthVelRowMin, m_erodeSize);
         //cv::dilate(m_matDepthVelErode, m_matDepthVelErode, m_rectElement);
 
         thresholdVelocitySignal(m_matDepthVelErode,
@@ -102,116 +180,147 @@ namespace astra { namespace plugins { namespace hand {
         //analyze_velocities(matDepth, m_matDepthVelErode);
     }
 
-    void DepthUtility::depthFrameToMat(DepthFrame& depthFrameSrc,
-                                       const int width,
-                                       const int height,
-                                       cv::Mat& matTarget)
+    void DepthUtility::process_velocity_row(const float* depthRow,
+                                            float* prevDepthRow,
+                                            float* filledDepthRow,
+                                            float* avgRow,
+                                            float* velRow,
+                                            float* absVelRow,
+                                            const int width,
+                                            const float smoothingFactor,
+                                            const float previousFactor,
+                                            const bool adjustForDepth)
     {
-        PROFILE_FUNC();
-        //ensure initialized
-        matTarget.create(height, width, CV_32FC1);
+        const float maxDepthJumpPercent = m_maxDepthJumpPercent;
+        const float depthAdjustmentFactor = m_depthAdjustmentFactor;
+        const float minDepth = m_minDepth;
+        const float maxDepth = m_maxDepth;
 
-        const int16_t* depthData = depthFrameSrc.data();
-
-        for (int y = 0; y < height; ++y)
+        //branch free so the compiler can vectorize it
+        for (int x = 0; x < width; ++x)
         {
-            float* row = matTarget.ptr<float>(y);
-            for (int x = 0; x < width; ++x)
+            const float depth = depthRow[x];
+            const float previousDepth = prevDepthRow[x];
+
+            //fill 0 depth pixels with the value from the previous frame
+            const bool isFilled = depth == 0;
+            const float filledDepth = isFilled ? previousDepth : depth;
+
+            //accumulate current frame to average using smoothing factor
+            //(same arithmetic as cv::accumulateWeighted)
+            float avg = filledDepth * smoothingFactor + avgRow[x] * previousFactor;
+
+            //calculate percent change since last frame
+            const float deltaPercent = (filledDepth - previousDepth) / previousDepth;
+
+            //suppress signal if either current or previous pixel are invalid
+            const bool isZeroDepth = (0 == filledDepth || 0 == previousDepth);
+
+            //suppress signal when a pixel jumps a long distance from near to far
+            const bool isJumpingAway = std::fabs(deltaPercent) > maxDepthJumpPercent && deltaPercent > 0;
+
+            //set the average to the current depth, and set velocity to zero
+            //this suppresses the velocity signal for edge jumping artifacts
+            //(including when the pixel was artificially filled)
+            avg = (isZeroDepth || isFilled || isJumpingAway) ? filledDepth : avg;
+
+            //current minus average, scaled by average = velocity as a percent change
+            //(cv::divide yields 0 for a 0 divisor)
+            float velocity = avg != 0 ? (filledDepth - avg) / avg : 0.0f;
+
+            if (adjustForDepth)
             {
-                float depth = static_cast<float>(*depthData);
-                *row = depth;
-                ++row;
-                ++depthData;
+                const bool inRange = depth > minDepth && depth < maxDepth;
+                const float adjustedVelocity = velocity / ((depth / 1000.0f) * depthAdjustmentFactor);
+                velocity = depth == 0 ? velocity : (inRange ? adjustedVelocity : 0.0f);
             }
+
+            filledDepthRow[x] = filledDepth;
+            prevDepthRow[x] = filledDepth;
+            avgRow[x] = avg;
+            velRow[x] = velocity;
+            absVelRow[x] = std::fabs(velocity);
         }
     }
 
-    void DepthUtility::fillZeroValues(cv::Mat& matDepth,
-                                      cv::Mat& matDepthFilled,
-                                      cv::Mat& matDepthFilledMask,
-                                      cv::Mat& matDepthPrevious)
+    void DepthUtility::erode_velocity(cv::Mat& matVelocity, cv::Mat& matRowMin, const int radius)
     {
         PROFILE_FUNC();
-        int width = matDepth.cols;
-        int height = matDepth.rows;
+        if (radius <= 0)
+        {
+            return;
+        }
+
+        const int width = matVelocity.cols;
+        const int height = matVelocity.rows;
 
+        //the same as cv::erode with a square element, as a minimum along each
+        //row and then along each column. Pixels outside the plane are ignored.
         for (int y = 0; y < height; ++y)
         {
-            float* depthRow = matDepth.ptr<float>(y);
-            float* prevDepthRow = matDepthPrevious.ptr<float>(y);
-            float* filledDepthRow = matDepthFilled.ptr<float>(y);
-            uint8_t* filledDepthMaskRow = matDepthFilledMask.ptr<uint8_t>(y);
+            const float* velocityRow = matVelocity.ptr<float>(y);
+            float* rowMinRow = matRowMin.ptr<float>(y);
 
             for (int x = 0; x < width; ++x)
             {
-                float depth = *depthRow;
+                const int endX = std::min(width - 1, x + radius);
+                float minVelocity = velocityRow[std::max(0, x - radius)];
 
-                if (depth == 0)
-                {
-                    depth = *prevDepthRow;
-                    *filledDepthMaskRow = FillMaskType::Filled;
-                }
-                else
+                for (int neighborX = std::max(0, x - radius) + 1; neighborX <= endX; ++neighborX)
                 {
-                    *filledDepthMaskRow = FillMaskType::Normal;
+                    minVelocity = std::min(minVelocity, velocityRow[neighborX]);
                 }
-
-                *filledDepthRow = depth;
-
-                ++depthRow;
-                ++prevDepthRow;
-                ++filledDepthRow;
-                ++filledDepthMaskRow;
+                rowMinRow[x] = minVelocity;
             }
         }
-    }
-
-    void DepthUtility::filterZeroValuesAndJumps(cv::Mat& matDepth,
-                                                cv::Mat& matDepthPrevious,
-                                                cv::Mat& matDepthAvg,
-                                                cv::Mat& matDepthFilledMask,
-                                                const float maxDepthJumpPercent)
-    {
-        PROFILE_FUNC();
-        int width = matDepth.cols;
-        int height = matDepth.rows;
 
         for (int y = 0; y < height; ++y)
         {
-            float* depthRow = matDepth.ptr<float>(y);
-            float* prevDepthRow = matDepthPrevious.ptr<float>(y);
-            float* avgRow = matDepthAvg.ptr<float>(y);
-            uint8_t* filledDepthMaskRow = matDepthFilledMask.ptr<uint8_t>(y);
+            const int endY = std::min(height - 1, y + radius);
+            float* velocityRow = matVelocity.ptr<float>(y);
+
+            std::copy_n(matRowMin.ptr<float>(std::max(0, y - radius)), width, velocityRow);
 
-            for (int x = 0; x < width; ++x, ++depthRow, ++prevDepthRow, ++filledDepthMaskRow)
+            for (int neighborY = std::max(0, y - radius) + 1; neighborY <= endY; ++neighborY)
             {
-                float depth = *depthRow;
-                float previousDepth = *prevDepthRow;
-                uint8_t fillType = *filledDepthMaskRow;
+                const float* rowMinRow = matRowMin.ptr<float>(neighborY);
 
-                //calculate percent change since last frame
-                float deltaPercent = (depth - previousDepth) / previousDepth;
-                float absDeltaPercent = std::fabs(deltaPercent);
-                bool movingAway = deltaPercent > 0;
+                for (int x = 0; x < width; ++x)
+                {
+                    velocityRow[x] = std::min(velocityRow[x], rowMinRow[x]);
+                }
+            }
+        }
+    }
 
-                //suppress signal if either current or previous pixel are invalid
-                bool isZeroDepth = (0 == depth || 0 == previousDepth);
+    void DepthUtility::update_sample_offsets(const int width, const int height)
+    {
+        if (width == m_sourceWidth && height == m_sourceHeight)
+        {
+            return;
+        }
 
-                //suppress signal when a pixel was artificially filled
-                bool isFilled = (fillType == FillMaskType::Filled);
+        PROFILE_FUNC();
+        m_sourceWidth = width;
+        m_sourceHeight = height;
 
-                //suppress signal when a pixel jumps a long distance from near to far
-                bool isJumpingAway = (absDeltaPercent > maxDepthJumpPercent && movingAway);
+        const int processingWidth = static_cast<int>(m_processingWidth);
+        const int processingHeight = static_cast<int>(m_processingHeight);
 
-                if (isZeroDepth || isFilled || isJumpingAway)
-                {
-                    //set the average to the current depth, and set velocity to zero
-                    //this suppresses the velocity signal for edge jumping artifacts
-                    avgRow[x] = depth;
-                }
+        //matches the nearest neighbor offsets of cv::resize
+        const double inverseScaleX = static_cast<double>(width) / processingWidth;
+        const double inverseScaleY = static_cast<double>(height) / processingHeight;
 
-                *prevDepthRow = depth;
-            }
+        m_sampleColumns.resize(processingWidth);
+        for (int x = 0; x < processingWidth; ++x)
+        {
+            m_sampleColumns[x] = std::min(width - 1, static_cast<int>(std::floor(x * inverseScaleX)));
+        }
+
+        m_sampleRows.resize(processingHeight);
+        for (int y = 0; y < processingHeight; ++y)
+        {
+            m_sampleRows[y] = std::min(height - 1, static_cast<int>(std::floor(y * inverseScaleY)));
         }
     }
 
@@ -245,42 +354,6 @@ namespace astra { namespace plugins { namespace hand {
         }
     }
 
-    void DepthUtility::adjust_velocities_for_depth(cv::Mat& matDepth, cv::Mat& matVelocityFiltered)
-    {
-        PROFILE_FUNC();
-        if (m_depthAdjustmentFactor == 0)
-        {
-            return;
-        }
-
-        int width = matDepth.cols;
-        int height = matDepth.rows;
-
-        for (int y = 0; y < height; ++y)
-        {
-            float* depthRow = matDepth.ptr<float>(y);
-            float* velFilteredRow = matVelocityFiltered.ptr<float>(y);
-
-            for (int x = 0; x < width; ++x, ++depthRow, ++velFilteredRow)
-            {
-                float depth = *depthRow;
-                if (depth != 0.0f)
-                {
-                    float& velFiltered = *velFilteredRow;
-                    if (depth > m_minDepth && depth < m_maxDepth)
-                    {
-                        float depthM = depth / 1000.0f;
-                        velFiltered /= depthM * m_depthAdjustmentFactor;
-                    }
-                    else
-                    {
-                        velFiltered = 0;
-                    }
-                }
-            }
-        }
-    }
-
     int DepthUtility::depth_to_chunk_index(float depth)
     {
         PROFILE_FUNC();
@@ -4,6 +4,7 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include <AstraUL/AstraUL.h>
 #include "HandSettings.h"
+#include <vector>
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -15,61 +16,96 @@ namespace astra { namespace plugins { namespace hand {
 
         void processDepthToVelocitySignal(DepthFrame& depthFrame,
                                           cv::Mat& matDepth,
-                                          cv::Mat& matDepthFullSize,
                                           cv::Mat& matVelocitySignal);
+
+        void processDepthToVelocitySignal(const int16_t* depthData,
+                                          const int width,
+                                          const int height,
+                                          cv::Mat& matDepth,
+                                          cv::Mat& matVelocitySignal);
+
+        //the same signal from a point frame, the depth of each pixel is its z
+        void processPointsToVelocitySignal(PointFrame& pointFrame,
+                                           cv::Mat& matDepth,
+                                           cv::Mat& matVelocitySignal);
+
+        void processPointsToVelocitySignal(const Vector3f* points,
+                                           const int width,
+                                           const int height,
+                                           cv::Mat& matDepth,
+                                           cv::Mat& matVelocitySignal);
         void reset();
 
+        //takes effect from the next frame, the running depth average is kept
+        void set_settings(const DepthUtilitySettings& settings);
+
+        //keeps the running depth average across the switch, resampled to the new size
+        void set_processing_size(const int width, const int height);
+
         const cv::Mat& matDepthVel() const { return m_matDepthVel; }
         const cv::Mat& matDepthAvg() const { return m_matDepthAvg; }
         const cv::Mat& matDepthVelErode() const { return m_matDepthVelErode; }
         const cv::Mat& matDepthFilled() const { return m_matDepthFilled; }
 
     private:
+        static float sample_depth(const int16_t& depth) { return static_cast<float>(depth); }
+        static float sample_depth(const Vector3f& point) { return point.z; }
+
+        template<typename TSample>
+        void process_to_velocity_signal(const TSample* samples,
+                                        const int width,
+                                        const int height,
+                                        cv::Mat& matDepth,
+                                        cv::Mat& matVelocitySignal);
+
+        static void resize_state_plane(cv::Mat& plane, const cv::Size& size);
+
+        void update_sample_offsets(const int width, const int height);
+
+        //fills zero depth from the previous frame, accumulates the average,
+        //suppresses filled pixels and jumps, and computes the depth adjusted
+        //velocity of one row in a single pass
+        void process_velocity_row(const float* depthRow,
+                                  float* prevDepthRow,
+                                  float* filledDepthRow,
+                                  float* avgRow,
+                                  float* velRow,
+                                  float* absVelRow,
+                                  const int width,
+                                  const float smoothingFactor,
+                                  const float previousFactor,
+                                  const bool adjustForDepth);
+
+        //erodes in place with a square element radius pixels from its center,
+        //matRowMin holds the minimum along each row
+        static void erode_velocity(cv::Mat& matVelocity, cv::Mat& matRowMin, const int radius);
 
-        enum FillMaskType
-        {
-            Normal = 0,
-            Filled = 1
-        };
-        static void depthFrameToMat(DepthFrame& depthFrameSrc,
-                                    const int width,
-                                    const int height,
-                                    cv::Mat& matTarget);
-
-        static void fillZeroValues(cv::Mat& matDepth,
-                                   cv::Mat& matDepthFilled,
-                                   cv::Mat& matDepthFilledMask,
-                                   cv::Mat& matDepthPrevious);
-
-        static void filterZeroValuesAndJumps(cv::Mat& depthCurrent,
-                                             cv::Mat& depthPrev,
-                                             cv::Mat& depthAvg,
-                                             cv::Mat& matDepthFilledMask,
-                                             const float maxDepthJumpPercent);
         void thresholdVelocitySignal(cv::Mat& matVelocityFiltered,
                                      cv::Mat& matVelocitySignal,
                                      const float velocityThresholdFactor);
 
-        void adjust_velocities_for_depth(cv::Mat& matDepth,
-                                         cv::Mat& matVelocityFiltered);
-
         int depth_to_chunk_index(float depth);
 
         void analyze_velocities(cv::Mat& matDepth,
                                 cv::Mat& matVelocityFiltered);
 
-        const float m_processingWidth;
-        const float m_processingHeight;
+        float m_processingWidth;
+        float m_processingHeight;
 
-        cv::Mat m_rectElement;
         cv::Mat m_rectElement2;
         cv::Mat m_matDepthOriginal;
         cv::Mat m_matDepthPrevious;
         cv::Mat m_matDepthFilled;
-        cv::Mat m_matDepthFilledMask;
         cv::Mat m_matDepthAvg;
         cv::Mat m_matDepthVel;
         cv::Mat m_matDepthVelErode;
+        cv::Mat m_matDepthVelRowMin;
+
+        //source pixel of each processing pixel, per frame size
+        std::vector<int> m_sampleColumns;
+        std::vector<int> m_sampleRows;
+        int m_sourceWidth{ 0 };
+        int m_sourceHeight{ 0 };
 
         float m_depthSmoothingFactor;
         float m_velocityThresholdFactor;
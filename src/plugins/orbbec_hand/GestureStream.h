@@ -0,0 +1,30 @@
+#ifndef GESTURESTREAM_H
+#define GESTURESTREAM_H
+
+#include <Astra/Plugins/SingleBinStream.h>
+#include <AstraUL/streams/gesture_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // Gestures the trajectory analyzers recognize, so clients do not have to
+    // compare hand frames. A frame is written for every tracked frame, and
+    // most have no events.
+    class GestureStream : public SingleBinStream<astra_gestureframe_wrapper_t>
+    {
+    public:
+        GestureStream(PluginServiceProxy& pluginService,
+                      astra_streamset_t streamSet,
+                      size_t maxEventCount)
+            : SingleBinStream(pluginService,
+                              streamSet,
+                              StreamDescription(ASTRA_STREAM_GESTURE,
+                                                DEFAULT_SUBTYPE),
+                              sizeof(astra_gesture_event_t) * maxEventCount)
+        { }
+    };
+
+}}}
+
+#endif /* GESTURESTREAM_H */
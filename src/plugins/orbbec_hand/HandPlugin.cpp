@@ -60,7 +60,9 @@ namespace astra { namespace plugins { namespace hand {
                                                astra_stream_t streamHandle,
                                                astra_stream_desc_t streamDesc)
     {
+        //only track sensor depth, not the derived subtypes published by other plugins
         if (streamDesc.type == ASTRA_STREAM_DEPTH &&
+            streamDesc.subtype == DEFAULT_SUBTYPE &&
             m_streamTrackerMap.find(streamHandle) == m_streamTrackerMap.end())
         {
             StreamDescription depthDescription = streamDesc;
@@ -68,7 +70,8 @@ namespace astra { namespace plugins { namespace hand {
             HandTracker* tracker = new HandTracker(pluginService(),
                                                    setHandle,
                                                    depthDescription,
-                                                   m_settings);
+                                                   m_settings,
+                                                   HANDPLUGIN_CONFIG_FILE);
 
             m_streamTrackerMap[streamHandle] = tracker;
         }
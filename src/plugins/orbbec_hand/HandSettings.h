@@ -1,6 +1,7 @@
 #ifndef HANDSETTINGS_H
 #define HANDSETTINGS_H
 
+#include <cstdint>
 #include <string>
 
 namespace astra { namespace plugins { namespace hand {
@@ -90,6 +91,22 @@ namespace astra { namespace plugins { namespace hand {
         float secondChanceMinDistance{ 100.0f };
         float mergePointDistance { 100.0f }; //mm
         int maxHandPointUpdatesPerFrame { 10 };
+
+        //update active points from a window of the full size depth frame
+        //around each point, sampled at the smallest stride that keeps the
+        //window to about maxWindowUpdatePixels on a side
+        bool windowUpdateEnabled{ false };
+        float windowUpdateSize{ 800.0f }; //mm
+        int maxWindowUpdatePixels{ 192 };
+    };
+
+    //streams a hand tracker reads its frames from
+    enum class HandTrackerInput
+    {
+        //the point stream, the depth of each pixel is its z
+        Points,
+        //a depth stream of inputDepthSubtype, converted to world points by the tracker
+        Depth
     };
 
     struct HandSettings
@@ -97,11 +114,42 @@ namespace astra { namespace plugins { namespace hand {
         int processingSizeWidth{ 160 };
         int processingSizeHeight{ 120 };
 
+        //let the tracker lower the processing size to stay within the frame budget,
+        //and use the coarse size while it is only looking for new hands
+        bool adaptiveProcessingSize{ false };
+        int coarseProcessingSizeWidth{ 80 };
+        int coarseProcessingSizeHeight{ 60 };
+        float processingFrameBudget{ 8.0f }; //ms
+
+        //reload the settings file when it changes on disk
+        bool watchSettingsFile{ false };
+
+        //hand frames hold up to this many hands, read when the hand stream is created
+        int maxHandCount{ 10 };
+        //report maxHandCount entries every frame, the unused ones not tracking,
+        //for clients that scan a fixed number of entries instead of the hand count
+        bool padHandFrames{ false };
+
+        //read when the tracker is created. "points" or "depth" in the settings file
+        HandTrackerInput input{ HandTrackerInput::Points };
+        //depth subtype read in the depth mode, e.g. 2 for ASTRA_DEPTH_SUBTYPE_FILTERED
+        int inputDepthSubtype{ 0 };
+
         DepthUtilitySettings depthUtilitySettings;
         PointProcessorSettings pointProcessorSettings;
     };
 
     HandSettings parse_settings(std::string path);
+
+    //reads a whole settings file, keys it leaves out get their defaults.
+    //settings are left as they are if the file cannot be read or parsed
+    bool parse_settings_file(const std::string& path, HandSettings& settings);
+
+    //applies the keys in a TOML snippet, e.g. "[pointprocessor]\nmaxHandPointUpdatesPerFrame = 5",
+    //on top of settings. settings are left as they are if the snippet does not parse
+    bool update_settings(const std::string& text, HandSettings& settings);
+
+    bool get_settings_file_time(const std::string& path, int64_t& modifiedTime);
 }}}
 
 #endif // HANDSETTINGS_H
@@ -1,5 +1,7 @@
 #include "HandStream.h"
+#include "HandSettings.h"
 #include <AstraUL/streams/hand_parameters.h>
+#include <Astra/Plugins/PluginLogger.h>
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -13,6 +15,12 @@ namespace astra { namespace plugins { namespace hand {
         case ASTRA_PARAMETER_HAND_INCLUDE_CANDIDATE_POINTS:
             set_include_candidates(inByteLength, inData);
             break;
+        case ASTRA_PARAMETER_HAND_PROCESSING_SIZE:
+            set_processing_size_parameter(inByteLength, inData);
+            break;
+        case ASTRA_PARAMETER_HAND_ADAPTIVE_PROCESSING_SIZE:
+            set_adaptive_processing_size_parameter(inByteLength, inData);
+            break;
         }
     }
 
@@ -25,6 +33,47 @@ namespace astra { namespace plugins { namespace hand {
         case ASTRA_PARAMETER_HAND_INCLUDE_CANDIDATE_POINTS:
             get_include_candidates(parameterBin);
             break;
+        case ASTRA_PARAMETER_HAND_PROCESSING_SIZE:
+            get_processing_size_parameter(parameterBin);
+            break;
+        case ASTRA_PARAMETER_HAND_ADAPTIVE_PROCESSING_SIZE:
+            get_adaptive_processing_size_parameter(parameterBin);
+            break;
+        case ASTRA_PARAMETER_HAND_MAX_HAND_COUNT:
+            get_max_hand_count_parameter(parameterBin);
+            break;
+        }
+    }
+
+    void HandStream::on_invoke(astra_streamconnection_t connection,
+                               astra_command_id commandId,
+                               size_t inByteLength,
+                               astra_parameter_data_t inData,
+                               astra_parameter_bin_t& parameterBin)
+    {
+        switch (commandId)
+        {
+        case ASTRA_COMMAND_HAND_UPDATE_SETTINGS:
+            queue_settings_update(inByteLength, inData, parameterBin);
+            break;
+        case ASTRA_COMMAND_HAND_RELOAD_SETTINGS:
+            m_reloadSettingsRequested = true;
+            break;
+        }
+    }
+
+    void HandStream::get_max_hand_count_parameter(astra_parameter_bin_t& parameterBin)
+    {
+        int32_t maxHandCount = static_cast<int32_t>(m_maxHandCount);
+        size_t resultByteLength = sizeof(int32_t);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            memcpy(parameterData, &maxHandCount, resultByteLength);
         }
     }
 
@@ -52,4 +101,98 @@ namespace astra { namespace plugins { namespace hand {
             set_include_candidate_points(newIncludeCandidatePoints);
         }
     }
-}}}
\ No newline at end of file
+
+    void HandStream::get_processing_size_parameter(astra_parameter_bin_t& parameterBin)
+    {
+        size_t resultByteLength = sizeof(astra_hand_processing_size_t);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            memcpy(parameterData, &m_processingSize, resultByteLength);
+        }
+    }
+
+    void HandStream::set_processing_size_parameter(size_t inByteLength, astra_parameter_data_t& inData)
+    {
+        if (inByteLength >= sizeof(astra_hand_processing_size_t))
+        {
+            astra_hand_processing_size_t newProcessingSize;
+            memcpy(&newProcessingSize, inData, sizeof(astra_hand_processing_size_t));
+
+            //the debug stream's frames are sized for the largest processing size
+            if (newProcessingSize.width <= 0 ||
+                newProcessingSize.height <= 0 ||
+                newProcessingSize.width > m_maxProcessingSize.width ||
+                newProcessingSize.height > m_maxProcessingSize.height)
+            {
+                LOG_WARN("HandStream", "ignoring unsupported processing size %dx%d",
+                         newProcessingSize.width,
+                         newProcessingSize.height);
+                return;
+            }
+
+            set_processing_size(newProcessingSize);
+        }
+    }
+
+    void HandStream::get_adaptive_processing_size_parameter(astra_parameter_bin_t& parameterBin)
+    {
+        size_t resultByteLength = sizeof(bool);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            memcpy(parameterData, &m_adaptiveProcessingSize, resultByteLength);
+        }
+    }
+
+    void HandStream::set_adaptive_processing_size_parameter(size_t inByteLength, astra_parameter_data_t& inData)
+    {
+        if (inByteLength >= sizeof(bool))
+        {
+            bool newAdaptiveProcessingSize;
+            memcpy(&newAdaptiveProcessingSize, inData, sizeof(bool));
+
+            set_adaptive_processing_size(newAdaptiveProcessingSize);
+        }
+    }
+
+    void HandStream::queue_settings_update(size_t inByteLength,
+                                           astra_parameter_data_t& inData,
+                                           astra_parameter_bin_t& parameterBin)
+    {
+        std::string settingsUpdate(static_cast<const char*>(inData), inByteLength);
+
+        //check the update parses now, so the client hears about errors, and
+        //leave applying it to the tracker between frames
+        HandSettings parsedSettings;
+        bool accepted = update_settings(settingsUpdate, parsedSettings);
+
+        if (accepted)
+        {
+            m_pendingSettingsUpdates.push_back(settingsUpdate);
+        }
+        else
+        {
+            LOG_WARN("HandStream", "ignoring settings update that does not parse");
+        }
+
+        size_t resultByteLength = sizeof(bool);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            memcpy(parameterData, &accepted, resultByteLength);
+        }
+    }
+}}}
@@ -6,6 +6,8 @@
 #include <AstraUL/astraul_ctypes.h>
 #include <AstraUL/Plugins/stream_types.h>
 #include <Shiny.h>
+#include <string>
+#include <vector>
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -14,19 +16,47 @@ namespace astra { namespace plugins { namespace hand {
     public:
         HandStream(PluginServiceProxy& pluginService,
                    astra_streamset_t streamSet,
-                   size_t maxHandCount)
+                   size_t maxHandCount,
+                   astra_hand_processing_size_t processingSize,
+                   astra_hand_processing_size_t maxProcessingSize,
+                   bool adaptiveProcessingSize)
             : SingleBinStream(pluginService,
                               streamSet,
                               StreamDescription(ASTRA_STREAM_HAND,
                                                 DEFAULT_SUBTYPE),
-                              sizeof(astra_handpoint_t) * maxHandCount)
+                              sizeof(astra_handpoint_t) * maxHandCount),
+              m_maxHandCount(maxHandCount),
+              m_processingSize(processingSize),
+              m_maxProcessingSize(maxProcessingSize),
+              m_adaptiveProcessingSize(adaptiveProcessingSize)
         { }
 
+        size_t max_hand_count() const { return m_maxHandCount; }
+
         bool include_candidate_points() const { return m_includeCandidatePoints; }
         void set_include_candidate_points(bool includeCandidatePoints)
         {
             m_includeCandidatePoints = includeCandidatePoints;
         }
+
+        //requested processing size, in adaptive mode the largest one used
+        const astra_hand_processing_size_t& processing_size() const { return m_processingSize; }
+        void set_processing_size(const astra_hand_processing_size_t& processingSize)
+        {
+            m_processingSize = processingSize;
+        }
+
+        bool adaptive_processing_size() const { return m_adaptiveProcessingSize; }
+        void set_adaptive_processing_size(bool adaptiveProcessingSize)
+        {
+            m_adaptiveProcessingSize = adaptiveProcessingSize;
+        }
+
+        //settings updates received since the last frame, in the order they arrived
+        std::vector<std::string>& pending_settings_updates() { return m_pendingSettingsUpdates; }
+
+        bool reload_settings_requested() const { return m_reloadSettingsRequested; }
+        void clear_reload_settings_request() { m_reloadSettingsRequested = false; }
     protected:
         virtual void on_set_parameter(astra_streamconnection_t connection,
                                       astra_parameter_id id,
@@ -36,9 +66,21 @@ namespace astra { namespace plugins { namespace hand {
         virtual void on_get_parameter(astra_streamconnection_t connection,
                                       astra_parameter_id id,
                                       astra_parameter_bin_t& parameterBin) override;
+
+        virtual void on_invoke(astra_streamconnection_t connection,
+                               astra_command_id commandId,
+                               size_t inByteLength,
+                               astra_parameter_data_t inData,
+                               astra_parameter_bin_t& parameterBin) override;
     private:
+        void get_max_hand_count_parameter(astra_parameter_bin_t& parameterBin);
         void get_include_candidates(astra_parameter_bin_t& parameterBin);
         void set_include_candidates(size_t inByteLength, astra_parameter_data_t& inData);
+        void get_processing_size_parameter(astra_parameter_bin_t& parameterBin);
+        void set_processing_size_parameter(size_t inByteLength, astra_parameter_data_t& inData);
+        void get_adaptive_processing_size_parameter(astra_parameter_bin_t& parameterBin);
+        void set_adaptive_processing_size_parameter(size_t inByteLength, astra_parameter_data_t& inData);
+        void queue_settings_update(size_t inByteLength, astra_parameter_data_t& inData, astra_parameter_bin_t& parameterBin);
 
         virtual void on_connection_removed(astra_bin_t bin,
                                            astra_streamconnection_t connection) override
@@ -51,7 +93,13 @@ namespace astra { namespace plugins { namespace hand {
             #endif
         }
 
+        size_t m_maxHandCount;
         bool m_includeCandidatePoints{ false };
+        astra_hand_processing_size_t m_processingSize;
+        astra_hand_processing_size_t m_maxProcessingSize;
+        bool m_adaptiveProcessingSize;
+        std::vector<std::string> m_pendingSettingsUpdates;
+        bool m_reloadSettingsRequested{ false };
     };
 
 }}}
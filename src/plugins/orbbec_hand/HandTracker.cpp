@@ -9,57 +9,147 @@
 #include <AstraUL/astraul_ctypes.h>
 #include <Astra/Plugins/PluginKit.h>
 #include <Shiny.h>
+#include <chrono>
 
 namespace astra { namespace plugins { namespace hand {
 
         using namespace std;
 
+        namespace {
+
+            //a busy scene only has a handful of points to update per frame
+            const size_t MAX_TRACKING_THREADS = 4;
+
+            //the debug stream's frames are allocated up front for the largest
+            //processing size a client may switch to
+            const int MAX_PROCESSING_SIZE_WIDTH = 320;
+            const int MAX_PROCESSING_SIZE_HEIGHT = 240;
+
+            //frames between checks of the settings file when it is watched
+            const int SETTINGS_FILE_CHECK_INTERVAL = 30;
+
+            //processing pixels have to map to whole, square blocks of depth pixels
+            bool is_valid_processing_size(const cv::Size& depthSize, const cv::Size& processingSize)
+            {
+                if (processingSize.width <= 0 ||
+                    processingSize.height <= 0 ||
+                    depthSize.width % processingSize.width != 0 ||
+                    depthSize.height % processingSize.height != 0)
+                {
+                    return false;
+                }
+
+                return depthSize.width / processingSize.width == depthSize.height / processingSize.height;
+            }
+
+            astra_stream_subtype_t input_depth_subtype(const HandSettings& settings, StreamDescription& depthDesc)
+            {
+                if (settings.input == HandTrackerInput::Depth)
+                {
+                    return static_cast<astra_stream_subtype_t>(settings.inputDepthSubtype);
+                }
+
+                return depthDesc.subtype();
+            }
+
+            size_t tracking_thread_count()
+            {
+#if defined(SHINY_IS_COMPILED) && SHINY_IS_COMPILED
+                //the profiler's call tree can only be entered from one thread
+                return 1;
+#else
+                return MIN(MAX_TRACKING_THREADS, parallel::WorkerPool::default_thread_count());
+#endif
+            }
+        }
+
         HandTracker::HandTracker(PluginServiceProxy& pluginService,
                                  astra_streamset_t streamSet,
                                  StreamDescription& depthDesc,
-                                 HandSettings& settings) :
+                                 const HandSettings& settings,
+                                 const std::string& settingsPath) :
+            m_input(settings.input),
+            m_inputDepthSubtype(input_depth_subtype(settings, depthDesc)),
             m_streamset(get_uri_for_streamset(pluginService, streamSet)),
             m_reader(m_streamset.create_reader()),
-            m_depthStream(m_reader.stream<DepthStream>(depthDesc.subtype())),
+            m_depthStream(m_reader.stream<DepthStream>(m_inputDepthSubtype)),
             m_settings(settings),
+            m_settingsPath(settingsPath),
             m_pluginService(pluginService),
-            m_depthUtility(settings.processingSizeWidth, settings.processingSizeHeight, settings.depthUtilitySettings),
-            m_pointProcessor(settings.pointProcessorSettings),
+            m_depthUtility(settings.processingSizeWidth, settings.processingSizeHeight, m_settings.depthUtilitySettings),
+            m_workerPool(tracking_thread_count()),
+            m_pointProcessor(m_settings.pointProcessorSettings, m_workerPool),
+            m_trackingPipeline(m_pointProcessor, m_settings.pointProcessorSettings),
             m_processingSizeWidth(settings.processingSizeWidth),
-            m_processingSizeHeight(settings.processingSizeHeight)
-
+            m_processingSizeHeight(settings.processingSizeHeight),
+            m_maxProcessingSize(MAX(MAX_PROCESSING_SIZE_WIDTH, settings.processingSizeWidth),
+                                MAX(MAX_PROCESSING_SIZE_HEIGHT, settings.processingSizeHeight)),
+            m_processingSizeController(cv::Size(settings.processingSizeWidth, settings.processingSizeHeight),
+                                       cv::Size(settings.coarseProcessingSizeWidth, settings.coarseProcessingSizeHeight),
+                                       settings.processingFrameBudget,
+                                       settings.adaptiveProcessingSize)
         {
             PROFILE_FUNC();
 
+            get_settings_file_time(m_settingsPath, m_settingsFileTime);
+
             create_streams(m_pluginService, streamSet);
-            m_depthStream.start();
 
-            m_reader.stream<PointStream>().start();
+            //one subscription, the other stream's frames would go unused
+            if (m_input == HandTrackerInput::Depth)
+            {
+                LOG_INFO("HandTracker", "reading depth subtype %d", static_cast<int>(m_inputDepthSubtype));
+                m_depthStream.start();
+            }
+            else
+            {
+                LOG_INFO("HandTracker", "reading the point stream");
+                m_reader.stream<PointStream>().start();
+            }
+
             m_reader.addListener(*this);
         }
 
         HandTracker::~HandTracker()
         {
             PROFILE_FUNC();
-            if (m_worldPoints != nullptr)
-            {
-                delete[] m_worldPoints;
-                m_worldPoints = nullptr;
-            }
         }
 
         void HandTracker::create_streams(PluginServiceProxy& pluginService, astra_streamset_t streamSet)
         {
             PROFILE_FUNC();
             LOG_INFO("HandTracker", "creating hand streams");
-            auto hs = make_stream<HandStream>(pluginService, streamSet, ASTRA_HANDS_MAX_HAND_COUNT);
+            const cv::Size& requestedSize = m_processingSizeController.requested_size();
+
+            astra_hand_processing_size_t processingSize;
+            processingSize.width = requestedSize.width;
+            processingSize.height = requestedSize.height;
+
+            astra_hand_processing_size_t maxProcessingSize;
+            maxProcessingSize.width = m_maxProcessingSize.width;
+            maxProcessingSize.height = m_maxProcessingSize.height;
+
+            size_t maxHandCount = MAX(1, m_settings.maxHandCount);
+            LOG_INFO("HandTracker", "hand frames hold up to %d hands", static_cast<int>(maxHandCount));
+
+            auto hs = make_stream<HandStream>(pluginService,
+                                              streamSet,
+                                              maxHandCount,
+                                              processingSize,
+                                              maxProcessingSize,
+                                              m_processingSizeController.adaptive());
             m_handStream = std::unique_ptr<HandStream>(std::move(hs));
 
+            auto gs = make_stream<GestureStream>(pluginService,
+                                                 streamSet,
+                                                 ASTRA_GESTURES_MAX_EVENT_COUNT);
+            m_gestureStream = std::unique_ptr<GestureStream>(std::move(gs));
+
             const int bytesPerPixel = 3;
             auto dhs = make_stream<DebugHandStream>(pluginService,
                                                     streamSet,
-                                                    m_processingSizeWidth,
-                                                    m_processingSizeHeight,
+                                                    m_maxProcessingSize.width,
+                                                    m_maxProcessingSize.height,
                                                     bytesPerPixel);
             m_debugImageStream = std::unique_ptr<DebugHandStream>(std::move(dhs));
         }
@@ -68,11 +158,19 @@ namespace astra { namespace plugins { namespace hand {
         {
             PROFILE_FUNC();
             if (m_handStream->has_connections() ||
+                m_gestureStream->has_connections() ||
                 m_debugImageStream->has_connections())
             {
-                DepthFrame depthFrame = frame.get<DepthFrame>();
-                PointFrame pointFrame = frame.get<PointFrame>();
-                update_tracking(depthFrame, pointFrame);
+                if (m_input == HandTrackerInput::Depth)
+                {
+                    DepthFrame depthFrame = frame.get<DepthFrame>(m_inputDepthSubtype);
+                    update_tracking(depthFrame);
+                }
+                else
+                {
+                    PointFrame pointFrame = frame.get<PointFrame>();
+                    update_tracking(pointFrame);
+                }
             }
 
             PROFILE_UPDATE();
@@ -85,178 +183,289 @@ namespace astra { namespace plugins { namespace hand {
             m_pointProcessor.reset();
         }
 
-        void HandTracker::update_tracking(DepthFrame& depthFrame, PointFrame& pointFrame)
+        void HandTracker::update_tracking(DepthFrame& depthFrame)
         {
             PROFILE_FUNC();
+            auto frameStart = std::chrono::steady_clock::now();
+            const cv::Size frameSize(depthFrame.resolutionX(), depthFrame.resolutionY());
+
+            apply_pending_settings();
+
             if (!m_debugImageStream->pause_input())
             {
-                m_depthUtility.processDepthToVelocitySignal(depthFrame, m_matDepth, m_matDepthFullSize, m_matVelocitySignal);
+                update_processing_size(frameSize);
+                m_depthUtility.processDepthToVelocitySignal(depthFrame, m_matDepth, m_matVelocitySignal);
             }
 
-            track_points(m_matDepth, m_matDepthFullSize, m_matVelocitySignal, pointFrame.data());
+            calculate_world_points(depthFrame);
 
-            //use same frameIndex as source depth frame
-            astra_frame_index_t frameIndex = depthFrame.frameIndex();
+            update_tracking(frameSize, m_depthWorldPoints.data(), depthFrame.frameIndex(), frameStart);
+        }
 
+        void HandTracker::update_tracking(PointFrame& pointFrame)
+        {
+            PROFILE_FUNC();
+            auto frameStart = std::chrono::steady_clock::now();
+            const cv::Size frameSize(pointFrame.resolutionX(), pointFrame.resolutionY());
+
+            apply_pending_settings();
+
+            if (!m_debugImageStream->pause_input())
+            {
+                update_processing_size(frameSize);
+                m_depthUtility.processPointsToVelocitySignal(pointFrame, m_matDepth, m_matVelocitySignal);
+            }
+
+            update_tracking(frameSize, pointFrame.data(), pointFrame.frameIndex(), frameStart);
+        }
+
+        void HandTracker::update_tracking(const cv::Size& frameSize,
+                                          const Vector3f* fullSizeWorldPoints,
+                                          astra_frame_index_t frameIndex,
+                                          std::chrono::steady_clock::time_point frameStart)
+        {
+            m_fullSize = frameSize;
+
+            track_points(m_matDepth, m_fullSize, m_matVelocitySignal, fullSizeWorldPoints);
+
+            std::chrono::duration<float, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+            m_processingSizeController.update(frameTime.count(), m_pointProcessor.get_trackedPoints().size());
+
+            //hand frames use the same frameIndex as the source frame
             if (m_handStream->has_connections())
             {
                 generate_hand_frame(frameIndex);
             }
 
+            //written for every tracked frame, most without events. A reader only
+            //raises a frame once all of its started streams have a new one, so a
+            //reader of both hands and gestures would otherwise wait for a gesture.
+            if (m_gestureStream->has_connections())
+            {
+                auto sinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(frameStart.time_since_epoch());
+                generate_gesture_frame(frameIndex, sinceEpoch.count());
+            }
+
             if (m_debugImageStream->has_connections())
             {
                 generate_hand_debug_image_frame(frameIndex);
             }
         }
 
-        void HandTracker::track_points(cv::Mat& matDepth,
-                                       cv::Mat& matDepthFullSize,
-                                       cv::Mat& matVelocitySignal,
-                                       const Vector3f* fullSizeWorldPoints)
+        void HandTracker::calculate_world_points(DepthFrame& depthFrame)
         {
             PROFILE_FUNC();
+            const int width = depthFrame.resolutionX();
+            const int height = depthFrame.resolutionY();
+            const int16_t* depthData = depthFrame.data();
+
+            m_depthWorldPoints.resize(width * height);
+            Vector3f* points = m_depthWorldPoints.data();
 
-            m_layerSegmentation = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_layerScore = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_layerEdgeDistance = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_debugUpdateSegmentation = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_debugCreateSegmentation = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_debugRefineSegmentation = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_updateForegroundSearched = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_createForegroundSearched = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_refineForegroundSearched = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_debugUpdateScore = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_debugCreateScore = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_matDepthWindow = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_refineSegmentation = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_refineScore = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_refineEdgeDistance = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_debugUpdateScoreValue = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_debugCreateScoreValue = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_debugRefineScoreValue = cv::Mat::zeros(matDepth.size(), CV_32FC1);
-            m_debugCreateTestPassMap = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_debugUpdateTestPassMap = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-            m_debugRefineTestPassMap = cv::Mat::zeros(matDepth.size(), CV_8UC1);
-
-            int numPoints = matDepth.cols * matDepth.rows;
-            if (m_worldPoints == nullptr || m_numWorldPoints != numPoints)
-            {
-                if (m_worldPoints != nullptr)
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x, ++points, ++depthData)
                 {
-                    delete[] m_worldPoints;
-                    m_worldPoints = nullptr;
+                    *points = Vector3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(*depthData));
                 }
+            }
 
-                m_numWorldPoints = numPoints;
-                m_worldPoints = new astra::Vector3f[numPoints];
-            }
-
-            const conversion_cache_t depthToWorldData = m_depthStream.depth_to_world_data();
-
-            bool debugLayersEnabled = m_debugImageStream->has_connections();
-            bool enabledTestPassMap = m_debugImageStream->view_type() == DEBUG_HAND_VIEW_TEST_PASS_MAP;
-
-            TrackingMatrices updateMatrices(matDepthFullSize,
-                                            matDepth,
-                                            m_matArea,
-                                            m_matAreaSqrt,
-                                            matVelocitySignal,
-                                            m_updateForegroundSearched,
-                                            m_layerSegmentation,
-                                            m_layerScore,
-                                            m_layerEdgeDistance,
-                                            m_layerIntegralArea,
-                                            m_layerTestPassMap,
-                                            m_debugUpdateSegmentation,
-                                            m_debugUpdateScore,
-                                            m_debugUpdateScoreValue,
-                                            m_debugUpdateTestPassMap,
-                                            enabledTestPassMap,
-                                            fullSizeWorldPoints,
-                                            m_worldPoints,
-                                            debugLayersEnabled,
-                                            m_depthStream.coordinateMapper(),
-                                            depthToWorldData);
+            //converted in place, z stays the depth the velocity signal was made from
+            m_depthStream.coordinateMapper().convert_depth_to_world(m_depthWorldPoints.data(),
+                                                                    m_depthWorldPoints.data(),
+                                                                    m_depthWorldPoints.size());
+        }
 
-            if (!m_debugImageStream->pause_input())
+        void HandTracker::apply_pending_settings()
+        {
+            std::vector<std::string>& updates = m_handStream->pending_settings_updates();
+            const bool reloadFile = m_handStream->reload_settings_requested() || settings_file_changed();
+
+            if (!reloadFile && updates.empty())
             {
-                m_pointProcessor.initialize_common_calculations(updateMatrices);
-            }
-
-            //Update existing points first so that if we lose a point, we might recover it in the "add new" stage below
-            //without having at least one frame of a lost point.
-
-            m_pointProcessor.updateTrackedPoints(updateMatrices);
-
-            m_pointProcessor.removeDuplicatePoints();
-
-            TrackingMatrices createMatrices(matDepthFullSize,
-                                            matDepth,
-                                            m_matArea,
-                                            m_matAreaSqrt,
-                                            matVelocitySignal,
-                                            m_createForegroundSearched,
-                                            m_layerSegmentation,
-                                            m_layerScore,
-                                            m_layerEdgeDistance,
-                                            m_layerIntegralArea,
-                                            m_layerTestPassMap,
-                                            m_debugCreateSegmentation,
-                                            m_debugCreateScore,
-                                            m_debugCreateScoreValue,
-                                            m_debugCreateTestPassMap,
-                                            enabledTestPassMap,
-                                            fullSizeWorldPoints,
-                                            m_worldPoints,
-                                            debugLayersEnabled,
-                                            m_depthStream.coordinateMapper(),
-                                            depthToWorldData);
-
-            //add new points (unless already tracking)
-            if (!m_debugImageStream->use_mouse_probe())
+                return;
+            }
+
+            PROFILE_FUNC();
+            HandSettings settings = m_settings;
+
+            if (reloadFile)
+            {
+                if (parse_settings_file(m_settingsPath, settings))
+                {
+                    LOG_INFO("HandTracker", "reloaded settings from %s", m_settingsPath.c_str());
+                }
+                else
+                {
+                    LOG_WARN("HandTracker", "could not reload settings from %s, keeping the current ones", m_settingsPath.c_str());
+                }
+                m_handStream->clear_reload_settings_request();
+            }
+
+            //updates were checked when they arrived, later ones win
+            for (const std::string& update : updates)
+            {
+                update_settings(update, settings);
+            }
+            updates.clear();
+
+            apply_settings(settings);
+        }
+
+        bool HandTracker::settings_file_changed()
+        {
+            if (!m_settings.watchSettingsFile || --m_framesUntilSettingsFileCheck > 0)
+            {
+                return false;
+            }
+
+            m_framesUntilSettingsFileCheck = SETTINGS_FILE_CHECK_INTERVAL;
+
+            int64_t fileTime;
+            if (!get_settings_file_time(m_settingsPath, fileTime) || fileTime == m_settingsFileTime)
+            {
+                return false;
+            }
+
+            m_settingsFileTime = fileTime;
+            return true;
+        }
+
+        void HandTracker::apply_settings(const HandSettings& settings)
+        {
+            const HandSettings previous = m_settings;
+
+            //the point processor and segmentation read the snapshot through a
+            //reference, so replacing it is enough for them. Trajectories already
+            //being analyzed keep the settings they started with
+            m_settings = settings;
+
+            m_depthUtility.set_settings(m_settings.depthUtilitySettings);
+
+            m_processingSizeController.set_coarse_size(cv::Size(m_settings.coarseProcessingSizeWidth,
+                                                                m_settings.coarseProcessingSizeHeight));
+            m_processingSizeController.set_frame_budget(m_settings.processingFrameBudget);
+
+            //the processing size goes through the hand stream like a client's
+            //request, so it is checked against the depth frame before use
+            if (m_settings.processingSizeWidth != previous.processingSizeWidth ||
+                m_settings.processingSizeHeight != previous.processingSizeHeight)
+            {
+                if (m_settings.processingSizeWidth > m_maxProcessingSize.width ||
+                    m_settings.processingSizeHeight > m_maxProcessingSize.height)
+                {
+                    LOG_WARN("HandTracker", "ignoring processing size %dx%d larger than %dx%d",
+                             m_settings.processingSizeWidth,
+                             m_settings.processingSizeHeight,
+                             m_maxProcessingSize.width,
+                             m_maxProcessingSize.height);
+                }
+                else
+                {
+                    astra_hand_processing_size_t processingSize;
+                    processingSize.width = m_settings.processingSizeWidth;
+                    processingSize.height = m_settings.processingSizeHeight;
+                    m_handStream->set_processing_size(processingSize);
+                }
+            }
+
+            if (m_settings.adaptiveProcessingSize != previous.adaptiveProcessingSize)
             {
-                cv::Point seedPosition;
-                cv::Point nextSearchStart(0, 0);
-                while (segmentation::find_next_velocity_seed_pixel(matVelocitySignal, m_createForegroundSearched, seedPosition, nextSearchStart))
+                m_handStream->set_adaptive_processing_size(m_settings.adaptiveProcessingSize);
+            }
+        }
+
+        void HandTracker::update_processing_size(const cv::Size& depthSize)
+        {
+            PROFILE_FUNC();
+            const astra_hand_processing_size_t& streamSize = m_handStream->processing_size();
+            const cv::Size requestedSize(streamSize.width, streamSize.height);
+
+            if (requestedSize != m_processingSizeController.requested_size())
+            {
+                if (is_valid_processing_size(depthSize, requestedSize))
                 {
-                    m_pointProcessor.updateTrackedPointOrCreateNewPointFromSeedPosition(createMatrices, seedPosition);
+                    LOG_INFO("HandTracker", "processing size changed to %dx%d", requestedSize.width, requestedSize.height);
+                    m_processingSizeController.set_requested_size(requestedSize);
                 }
+                else
+                {
+                    LOG_WARN("HandTracker", "processing size %dx%d does not evenly divide the %dx%d depth frame",
+                             requestedSize.width,
+                             requestedSize.height,
+                             depthSize.width,
+                             depthSize.height);
+
+                    //report the size still in use
+                    const cv::Size& currentSize = m_processingSizeController.requested_size();
+                    astra_hand_processing_size_t processingSize;
+                    processingSize.width = currentSize.width;
+                    processingSize.height = currentSize.height;
+                    m_handStream->set_processing_size(processingSize);
+                }
+            }
+
+            m_processingSizeController.set_adaptive(m_handStream->adaptive_processing_size());
+
+            cv::Size processingSize = m_processingSizeController.size();
+            if (!is_valid_processing_size(depthSize, processingSize))
+            {
+                //a coarser level may not fit the depth frame when the requested size does
+                processingSize = m_processingSizeController.requested_size();
+            }
+
+            apply_processing_size(processingSize);
+        }
+
+        void HandTracker::apply_processing_size(const cv::Size& processingSize)
+        {
+            const cv::Size currentSize(m_processingSizeWidth, m_processingSizeHeight);
+            if (processingSize == currentSize)
+            {
+                return;
+            }
+
+            PROFILE_FUNC();
+            m_pointProcessor.rescale_points(currentSize, processingSize);
+            m_depthUtility.set_processing_size(processingSize.width, processingSize.height);
+
+            m_processingSizeWidth = processingSize.width;
+            m_processingSizeHeight = processingSize.height;
+        }
+
+        void HandTracker::track_points(cv::Mat& matDepth,
+                                       const cv::Size& fullSize,
+                                       cv::Mat& matVelocitySignal,
+                                       const Vector3f* fullSizeWorldPoints)
+        {
+            PROFILE_FUNC();
+
+            TrackingFrame frame(matDepth,
+                                matVelocitySignal,
+                                fullSize,
+                                fullSizeWorldPoints,
+                                m_depthStream.coordinateMapper(),
+                                m_depthStream.depth_to_world_data());
+
+            //debug planes and the mouse probe only exist while the debug stream is viewed
+            frame.debugLayersEnabled = m_debugImageStream->has_connections();
+            frame.enableTestPassMap = m_debugImageStream->view_type() == DEBUG_HAND_VIEW_TEST_PASS_MAP;
+            frame.updateCommonCalculations = !m_debugImageStream->pause_input();
+            bool useMouseProbe = frame.debugLayersEnabled && m_debugImageStream->use_mouse_probe();
+
+            if (!useMouseProbe)
+            {
+                m_trackingPipeline.track(frame);
             }
             else
             {
-                debug_spawn_point(createMatrices);
-            }
-
-            debug_probe_point(createMatrices);
-
-            //remove old points
-            m_pointProcessor.removeOldOrDeadPoints();
-
-            TrackingMatrices refinementMatrices(matDepthFullSize,
-                                                m_matDepthWindow,
-                                                m_matArea,
-                                                m_matAreaSqrt,
-                                                matVelocitySignal,
-                                                m_refineForegroundSearched,
-                                                m_refineSegmentation,
-                                                m_refineScore,
-                                                m_refineEdgeDistance,
-                                                m_layerIntegralArea,
-                                                m_layerTestPassMap,
-                                                m_debugRefineSegmentation,
-                                                m_debugRefineScore,
-                                                m_debugRefineScoreValue,
-                                                m_debugRefineTestPassMap,
-                                                enabledTestPassMap,
-                                                fullSizeWorldPoints,
-                                                m_worldPoints,
-                                                false,
-                                                m_depthStream.coordinateMapper(),
-                                                depthToWorldData);
-
-            m_pointProcessor.update_full_resolution_points(refinementMatrices);
-
-            m_pointProcessor.update_trajectories();
+                //points are only added where the mouse points
+                m_trackingPipeline.track(frame, [this](TrackingMatrices& createMatrices)
+                {
+                    debug_spawn_point(createMatrices);
+                    debug_probe_point(createMatrices);
+                });
+            }
         }
 
         void HandTracker::debug_probe_point(TrackingMatrices& matrices)
@@ -268,11 +477,12 @@ namespace astra { namespace plugins { namespace hand {
 
             cv::Point probePosition = get_mouse_probe_position();
 
+            TrackingArena& arena = m_trackingPipeline.arena();
             cv::Mat& matDepth = matrices.depth;
 
             float depth = matDepth.at<float>(probePosition);
-            float score = m_debugCreateScoreValue.at<float>(probePosition);
-            float edgeDist = m_layerEdgeDistance.at<float>(probePosition);
+            float score = arena.debugCreateScoreValue.at<float>(probePosition);
+            float edgeDist = arena.layerEdgeDistance.at<float>(probePosition);
 
             auto segmentationSettings = m_settings.pointProcessorSettings.segmentationSettings;
 
@@ -361,7 +571,6 @@ namespace astra { namespace plugins { namespace hand {
             if (handFrame != nullptr)
             {
                 handFrame->frame.handpoints = reinterpret_cast<astra_handpoint_t*>(&(handFrame->frame_data));
-                handFrame->frame.handCount = ASTRA_HANDS_MAX_HAND_COUNT;
 
                 update_hand_frame(m_pointProcessor.get_trackedPoints(), handFrame->frame);
 
@@ -371,6 +580,56 @@ namespace astra { namespace plugins { namespace hand {
             }
         }
 
+        void HandTracker::generate_gesture_frame(astra_frame_index_t frameIndex, uint64_t timestamp)
+        {
+            PROFILE_FUNC();
+
+            astra_gestureframe_wrapper_t* gestureFrame = m_gestureStream->begin_write(frameIndex);
+
+            if (gestureFrame != nullptr)
+            {
+                const vector<GestureEvent>& events = m_pointProcessor.gesture_events();
+                if (events.size() > ASTRA_GESTURES_MAX_EVENT_COUNT)
+                {
+                    LOG_WARN("HandTracker", "dropped %d gesture events in frame %d",
+                             static_cast<int>(events.size() - ASTRA_GESTURES_MAX_EVENT_COUNT),
+                             frameIndex);
+                }
+
+                gestureFrame->frame.events = reinterpret_cast<astra_gesture_event_t*>(&(gestureFrame->frame_data));
+                gestureFrame->frame.eventCount = MIN(events.size(), ASTRA_GESTURES_MAX_EVENT_COUNT);
+
+                for (size_t i = 0; i < gestureFrame->frame.eventCount; ++i)
+                {
+                    const GestureEvent& internalEvent = events[i];
+                    astra_gesture_event_t& event = gestureFrame->frame.events[i];
+
+                    event.trackingId = internalEvent.trackingId;
+                    event.type = convert_gesture_type(internalEvent.type);
+                    event.frameIndex = frameIndex;
+                    event.timestamp = timestamp;
+
+                    cv::Point3f worldPosition = internalEvent.worldPosition;
+                    copy_position(worldPosition, event.worldPosition);
+                }
+
+                m_gestureStream->end_write();
+            }
+        }
+
+        astra_gesture_type_t HandTracker::convert_gesture_type(GestureType type)
+        {
+            switch (type)
+            {
+            case WaveGesture:
+                return ASTRA_GESTURE_WAVE;
+            case SteadyGesture:
+                return ASTRA_GESTURE_STEADY;
+            default:
+                return ASTRA_GESTURE_INFLECTION;
+            }
+        }
+
         void HandTracker::generate_hand_debug_image_frame(astra_frame_index_t frameIndex)
         {
             PROFILE_FUNC();
@@ -397,7 +656,7 @@ namespace astra { namespace plugins { namespace hand {
         {
             PROFILE_FUNC();
             int handIndex = 0;
-            int maxHandCount = frame.handCount;
+            int maxHandCount = static_cast<int>(m_handStream->max_hand_count());
 
             bool includeCandidates = m_handStream->include_candidate_points();
 
@@ -428,10 +687,17 @@ namespace astra { namespace plugins { namespace hand {
                     point.status = convert_hand_status(status, pointType);
                 }
             }
-            for (int i = handIndex; i < maxHandCount; ++i)
+
+            frame.handCount = handIndex;
+
+            if (m_settings.padHandFrames)
             {
-                astra_handpoint_t& point = frame.handpoints[i];
-                reset_hand_point(point);
+                for (int i = handIndex; i < maxHandCount; ++i)
+                {
+                    astra_handpoint_t& point = frame.handpoints[i];
+                    reset_hand_point(point);
+                }
+                frame.handCount = maxHandCount;
             }
         }
 
@@ -490,7 +756,7 @@ namespace astra { namespace plugins { namespace hand {
         {
             PROFILE_FUNC();
 
-            float resizeFactor = m_matDepthFullSize.cols / static_cast<float>(m_matDepth.cols);
+            float resizeFactor = m_fullSize.width / static_cast<float>(m_matDepth.cols);
             ScalingCoordinateMapper mapper(m_depthStream.depth_to_world_data(), resizeFactor);
 
             RGBPixel color(255, 0, 255);
@@ -501,16 +767,18 @@ namespace astra { namespace plugins { namespace hand {
 
             cv::Point probePosition = get_mouse_probe_position();
 
-            std::vector<astra::Vector2i> points;
+            TrackingArena& arena = m_trackingPipeline.arena();
+            const CircleOffsetTable& offsets = arena.scratch.circleOffsets;
+            std::vector<astra::Vector2i>& points = arena.scratch.circlePoints;
 
-            segmentation::get_circumference_points(m_matDepth, probePosition, foregroundRadius1, mapper, points);
+            segmentation::get_circumference_points(m_matDepth, probePosition, foregroundRadius1, mapper, offsets, points);
 
             for (auto p : points)
             {
                 mark_image_pixel(imageFrame, color, p);
             }
 
-            segmentation::get_circumference_points(m_matDepth, probePosition, foregroundRadius2, mapper, points);
+            segmentation::get_circumference_points(m_matDepth, probePosition, foregroundRadius2, mapper, offsets, points);
 
             for (auto p : points)
             {
@@ -534,6 +802,7 @@ namespace astra { namespace plugins { namespace hand {
             RGBPixel testPassColor(0, 255, 128);
 
             DebugHandViewType view = m_debugImageStream->view_type();
+            TrackingArena& arena = m_trackingPipeline.arena();
 
             switch (view)
             {
@@ -560,13 +829,13 @@ namespace astra { namespace plugins { namespace hand {
                                                   colorFrame);
                 break;
             case DEBUG_HAND_VIEW_UPDATE_SEGMENTATION:
-                m_debugVisualizer.showNormArray<char>(m_debugUpdateSegmentation,
-                                                      m_debugUpdateSegmentation,
+                m_debugVisualizer.showNormArray<char>(arena.debugUpdateSegmentation,
+                                                      arena.debugUpdateSegmentation,
                                                       colorFrame);
                 break;
             case DEBUG_HAND_VIEW_CREATE_SEGMENTATION:
-                            m_debugVisualizer.showNormArray<char>(m_debugCreateSegmentation,
-                                                      m_debugCreateSegmentation,
+                            m_debugVisualizer.showNormArray<char>(arena.debugCreateSegmentation,
+                                                      arena.debugCreateSegmentation,
                                                       colorFrame);
                 break;
             case DEBUG_HAND_VIEW_UPDATE_SEARCHED:
@@ -575,22 +844,22 @@ namespace astra { namespace plugins { namespace hand {
                                                colorFrame);
                 break;
             case DEBUG_HAND_VIEW_CREATE_SCORE:
-                m_debugVisualizer.showNormArray<float>(m_debugCreateScore,
-                                                       m_debugCreateSegmentation,
+                m_debugVisualizer.showNormArray<float>(arena.debugCreateScore,
+                                                       arena.debugCreateSegmentation,
                                                        colorFrame);
                 break;
             case DEBUG_HAND_VIEW_UPDATE_SCORE:
-                m_debugVisualizer.showNormArray<float>(m_debugUpdateScore,
-                                                       m_debugUpdateSegmentation,
+                m_debugVisualizer.showNormArray<float>(arena.debugUpdateScore,
+                                                       arena.debugUpdateSegmentation,
                                                        colorFrame);
                 break;
             case DEBUG_HAND_VIEW_HANDWINDOW:
-                m_debugVisualizer.showDepthMat(m_matDepthWindow,
+                m_debugVisualizer.showDepthMat(arena.depthWindow,
                                                colorFrame);
                 break;
             case DEBUG_HAND_VIEW_TEST_PASS_MAP:
-                m_debugVisualizer.showNormArray<char>(m_debugCreateTestPassMap,
-                                                      m_debugCreateTestPassMap,
+                m_debugVisualizer.showNormArray<char>(arena.debugCreateTestPassMap,
+                                                      arena.debugCreateTestPassMap,
                                                       colorFrame);
                 break;
             }
@@ -604,13 +873,13 @@ namespace astra { namespace plugins { namespace hand {
             {
                 if (view == DEBUG_HAND_VIEW_CREATE_SEARCHED)
                 {
-                    m_debugVisualizer.overlayMask(m_createForegroundSearched, colorFrame, searchedColor, PixelType::Searched);
-                    m_debugVisualizer.overlayMask(m_createForegroundSearched, colorFrame, searchedColor2, PixelType::SearchedFromOutOfRange);
+                    m_debugVisualizer.overlayMask(arena.createForegroundSearched, colorFrame, searchedColor, PixelType::Searched);
+                    m_debugVisualizer.overlayMask(arena.createForegroundSearched, colorFrame, searchedColor2, PixelType::SearchedFromOutOfRange);
                 }
                 else if (view == DEBUG_HAND_VIEW_UPDATE_SEARCHED)
                 {
-                    m_debugVisualizer.overlayMask(m_updateForegroundSearched, colorFrame, searchedColor, PixelType::Searched);
-                    m_debugVisualizer.overlayMask(m_updateForegroundSearched, colorFrame, searchedColor2, PixelType::SearchedFromOutOfRange);
+                    m_debugVisualizer.overlayMask(arena.updateForegroundSearched, colorFrame, searchedColor, PixelType::Searched);
+                    m_debugVisualizer.overlayMask(arena.updateForegroundSearched, colorFrame, searchedColor2, PixelType::SearchedFromOutOfRange);
                 }
 
                 m_debugVisualizer.overlayMask(m_matVelocitySignal, colorFrame, foregroundColor, PixelType::Foreground);
@@ -11,10 +11,17 @@
 #include "PointProcessor.h"
 #include "ScalingCoordinateMapper.h"
 #include "HandStream.h"
+#include "GestureStream.h"
 #include "DebugHandStream.h"
 #include "DebugVisualizer.h"
 #include "HandSettings.h"
+#include "TrackingArena.h"
+#include "TrackingPipeline.h"
+#include "ProcessingSizeController.h"
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -24,7 +31,8 @@ namespace astra { namespace plugins { namespace hand {
         HandTracker(PluginServiceProxy& pluginService,
                     astra_streamset_t streamSet,
                     StreamDescription& depthDesc,
-                    HandSettings& settings);
+                    const HandSettings& settings,
+                    const std::string& settingsPath);
 
         virtual ~HandTracker();
         virtual void on_frame_ready(StreamReader& reader, Frame& frame) override;
@@ -32,6 +40,8 @@ namespace astra { namespace plugins { namespace hand {
         void create_streams(PluginServiceProxy& pluginService, astra_streamset_t streamSet);
         void reset();
         void generate_hand_frame(astra_frame_index_t frameIndex);
+        void generate_gesture_frame(astra_frame_index_t frameIndex, uint64_t timestamp);
+        static astra_gesture_type_t convert_gesture_type(GestureType type);
         static void copy_position(cv::Point3f& source, astra_vector3f_t& target);
         static astra_handstatus_t convert_hand_status(TrackingStatus status, TrackedPointType type);
         static void reset_hand_point(astra_handpoint_t& point);
@@ -39,14 +49,25 @@ namespace astra { namespace plugins { namespace hand {
         void overlay_circle(_astra_imageframe& imageFrame);
         void update_debug_image_frame(_astra_imageframe& astraColorframe);
         void generate_hand_debug_image_frame(astra_frame_index_t frameIndex);
-        void update_tracking(DepthFrame& depthFrame, PointFrame& pointFrame);
+        void update_tracking(DepthFrame& depthFrame);
+        void update_tracking(PointFrame& pointFrame);
+        void update_tracking(const cv::Size& frameSize,
+                             const Vector3f* fullSizeWorldPoints,
+                             astra_frame_index_t frameIndex,
+                             std::chrono::steady_clock::time_point frameStart);
+        void calculate_world_points(DepthFrame& depthFrame);
+        void apply_pending_settings();
+        bool settings_file_changed();
+        void apply_settings(const HandSettings& settings);
+        void update_processing_size(const cv::Size& depthSize);
+        void apply_processing_size(const cv::Size& processingSize);
         void update_hand_frame(std::vector<TrackedPoint>& internalTrackedPoints, _astra_handframe& frame);
 
         void debug_probe_point(TrackingMatrices& matrices);
         void debug_spawn_point(TrackingMatrices& matrices);
 
         void track_points(cv::Mat& matDepth,
-                          cv::Mat& matDepthFullSize,
+                          const cv::Size& fullSize,
                           cv::Mat& matForeground,
                           const Vector3f* worldPoints);
         cv::Point get_mouse_probe_position();
@@ -54,17 +75,32 @@ namespace astra { namespace plugins { namespace hand {
 
         //fields
 
+        //read when the tracker is created, see HandSettings::input
+        const HandTrackerInput m_input;
+        const astra_stream_subtype_t m_inputDepthSubtype;
+
         StreamSet m_streamset;
         StreamReader m_reader;
+        //only started in the depth input mode, the point stream's world
+        //coordinates are always converted with its conversion data
         DepthStream m_depthStream;
 
-        HandSettings& m_settings;
+        //this tracker's snapshot, replaced between frames when settings are updated
+        HandSettings m_settings;
+        std::string m_settingsPath;
+        int64_t m_settingsFileTime{ 0 };
+        int m_framesUntilSettingsFileCheck{ 0 };
+
         PluginServiceProxy& m_pluginService;
         DepthUtility m_depthUtility;
+        parallel::WorkerPool m_workerPool;
         PointProcessor m_pointProcessor;
 
+        //size the current frame is processed at
         float m_processingSizeWidth;
         float m_processingSizeHeight;
+        cv::Size m_maxProcessingSize;
+        ProcessingSizeController m_processingSizeController;
 
         using ColorStreamPtr = std::unique_ptr<DebugHandStream>;
         ColorStreamPtr m_debugImageStream;
@@ -72,40 +108,17 @@ namespace astra { namespace plugins { namespace hand {
         using HandStreamPtr = std::unique_ptr<HandStream>;
         HandStreamPtr m_handStream;
 
+        using GestureStreamPtr = std::unique_ptr<GestureStream>;
+        GestureStreamPtr m_gestureStream;
+
         cv::Mat m_matDepth;
-        cv::Mat m_matDepthFullSize;
-        cv::Mat m_matDepthWindow;
         cv::Mat m_matVelocitySignal;
-        cv::Mat m_matArea;
-        cv::Mat m_matAreaSqrt;
-        cv::Mat m_layerIntegralArea;
-        cv::Mat m_debugUpdateSegmentation;
-        cv::Mat m_debugCreateSegmentation;
-        cv::Mat m_debugRefineSegmentation;
-        cv::Mat m_updateForegroundSearched;
-        cv::Mat m_createForegroundSearched;
-        cv::Mat m_debugUpdateScore;
-        cv::Mat m_debugCreateScore;
-        cv::Mat m_debugRefineScore;
-        cv::Mat m_debugUpdateScoreValue;
-        cv::Mat m_debugCreateScoreValue;
-        cv::Mat m_debugRefineScoreValue;
-        cv::Mat m_debugCreateTestPassMap;
-        cv::Mat m_debugUpdateTestPassMap;
-        cv::Mat m_debugRefineTestPassMap;
-
-        cv::Mat m_layerSegmentation;
-        cv::Mat m_layerScore;
-        cv::Mat m_layerEdgeDistance;
-        cv::Mat m_layerTestPassMap;
-
-        cv::Mat m_refineForegroundSearched;
-        cv::Mat m_refineSegmentation;
-        cv::Mat m_refineScore;
-        cv::Mat m_refineEdgeDistance;
-
-        astra::Vector3f* m_worldPoints { nullptr };
-        int m_numWorldPoints { 0 };
+        cv::Size m_fullSize;
+
+        //world points of the depth input mode's frame
+        std::vector<Vector3f> m_depthWorldPoints;
+
+        TrackingPipeline m_trackingPipeline;
 
         DebugVisualizer m_debugVisualizer;
     };
@@ -5,10 +5,47 @@
 
 namespace astra { namespace plugins { namespace hand {
 
-    PointProcessor::PointProcessor(PointProcessorSettings& settings) :
-        m_settings(settings)
+    namespace {
+
+        //searched marks from each worker are combined this way so the merged
+        //plane does not depend on which worker finished first
+        void merge_searched(const cv::Mat& workerSearched, cv::Mat& searched)
+        {
+            const int width = searched.cols;
+            const int height = searched.rows;
+
+            for (int y = 0; y < height; ++y)
+            {
+                const uint8_t* workerRow = workerSearched.ptr<uint8_t>(y);
+                uint8_t* searchedRow = searched.ptr<uint8_t>(y);
+
+                for (int x = 0; x < width; ++x)
+                {
+                    searchedRow[x] = MAX(searchedRow[x], workerRow[x]);
+                }
+            }
+        }
+
+        //window sizes in window pixels are rounded up to this
+        const int WINDOW_SIZE_STEP = 16;
+
+        int round_up_window_size(float size)
+        {
+            const int steps = static_cast<int>(std::ceil(size / WINDOW_SIZE_STEP));
+            return MAX(1, steps) * WINDOW_SIZE_STEP;
+        }
+
+        //gestures a frame usually has at most, so events do not allocate while tracking
+        const size_t RESERVED_GESTURE_EVENTS = 32;
+    }
+
+    PointProcessor::PointProcessor(PointProcessorSettings& settings, parallel::WorkerPool& workerPool) :
+        m_settings(settings),
+        m_workerPool(workerPool),
+        m_workspaces(workerPool.thread_count() - 1)
     {
         PROFILE_FUNC();
+        m_gestureEvents.reserve(RESERVED_GESTURE_EVENTS);
     }
 
     PointProcessor::~PointProcessor()
@@ -28,10 +65,11 @@ namespace astra { namespace plugins { namespace hand {
 
         cv::Size depthSize = matrices.depth.size();
 
-        areaMatrix = cv::Mat::zeros(depthSize, CV_32FC1);
-        areaSqrtMatrix = cv::Mat::zeros(depthSize, CV_32FC1);
+        //every pixel is written below
+        areaMatrix.create(depthSize, CV_32FC1);
+        areaSqrtMatrix.create(depthSize, CV_32FC1);
 
-        int fullSizeWidth = matrices.depthFullSize.cols;
+        int fullSizeWidth = matrices.fullSize.width;
         int width = depthSize.width;
         int height = depthSize.height;
 
@@ -40,41 +78,35 @@ namespace astra { namespace plugins { namespace hand {
         float scale = mapper.scale();
         int intScale = static_cast<int>(scale);
 
+        //where pixel (0, 0) samples the full size frame
+        int fullSizeLeft = static_cast<int>(offsetX * scale + 0.5f);
+        int fullSizeTop = static_cast<int>(offsetY * scale + 0.5f);
+
+        //the point stream converts full size pixel X to (X / resolutionX - .5) * depth * xzFactor,
+        //so the world space step from a sampled point to the next pixel's corner grows linearly
+        //with depth. The area is depth squared times a per frame factor, with no conversion per pixel
+        float stepX = (scale + offsetX * scale - fullSizeLeft) * depthToWorldData.xzFactor / depthToWorldData.resolutionX;
+        float stepY = (scale + offsetY * scale - fullSizeTop) * depthToWorldData.yzFactor / depthToWorldData.resolutionY;
+        float areaFactor = fabs(stepX * stepY);
+        float areaSqrtFactor = sqrt(areaFactor);
+
         for (int y = 0; y < height; ++y)
         {
             float* areaRow = areaMatrix.ptr<float>(y);
             float* areaSqrtRow = areaSqrtMatrix.ptr<float>(y);
+            const Vector3f* fullSizeRow = fullSizeWorldPoints +
+                                          (fullSizeTop + y * intScale) * fullSizeWidth +
+                                          fullSizeLeft;
 
-            for (int x = 0; x < width; ++x, ++worldPoints, ++areaRow, ++areaSqrtRow)
+            for (int x = 0; x < width; ++x, ++worldPoints)
             {
-                int fullSizeIndex = (x + y * fullSizeWidth) * intScale;
-                const Vector3f& p = fullSizeWorldPoints[fullSizeIndex];
+                const Vector3f& p = fullSizeRow[x * intScale];
                 *worldPoints = p;
-                const float depth = p.z;
-
-                if (depth != 0)
-                {
-                    float depthX = (x + 1 + offsetX) * scale;
-                    float depthY = (y + 1 + offsetY) * scale;
-                    float normalizedX = depthX / depthToWorldData.resolutionX - .5f;
-                    float normalizedY = .5f - depthY / depthToWorldData.resolutionY;
 
-                    float wx = normalizedX * depth * depthToWorldData.xzFactor;
-                    float wy = normalizedY * depth * depthToWorldData.yzFactor;
-
-                    float deltaX = wx - p.x;
-                    float deltaY = wy - p.y;
-
-                    float area = fabs(deltaX * deltaY);
-
-                    *areaRow = area;
-                    *areaSqrtRow = sqrt(area);
-                }
-                else
-                {
-                    *areaRow = 0;
-                    *areaSqrtRow = 0;
-                }
+                //no depth gives no area
+                const float depth = p.z;
+                areaRow[x] = depth * depth * areaFactor;
+                areaSqrtRow[x] = depth * areaSqrtFactor;
             }
         }
     }
@@ -92,23 +124,36 @@ namespace astra { namespace plugins { namespace hand {
         PROFILE_FUNC();
         auto scalingMapper = get_scaling_mapper(matrices);
 
+        m_matchGridValid = false;
+        m_updateIndices.clear();
+
         //give priority updates to active points
-        for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end(); ++iter)
+        for (size_t i = 0; i < m_trackedPoints.size(); ++i)
         {
-            TrackedPoint& trackedPoint = *iter;
-            if (trackedPoint.pointType == TrackedPointType::ActivePoint)
+            TrackedPoint& trackedPoint = m_trackedPoints[i];
+            if (trackedPoint.pointType != TrackedPointType::ActivePoint)
+            {
+                continue;
+            }
+
+            //points that are locked on are updated from their own window of
+            //the full size frame, the rest from the downscaled frame
+            bool windowUpdated = m_settings.windowUpdateEnabled &&
+                                 trackedPoint.trackingStatus == TrackingStatus::Tracking &&
+                                 update_tracked_point_in_window(matrices, trackedPoint);
+
+            if (!windowUpdated)
             {
-                updateTrackedPoint(matrices, scalingMapper, trackedPoint);
+                m_updateIndices.push_back(i);
             }
         }
 
         int numUpdatedPoints = 0;
-        for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end(); ++iter)
+        for (size_t i = 0; i < m_trackedPoints.size(); ++i)
         {
-            TrackedPoint& trackedPoint = *iter;
-            if (trackedPoint.pointType != TrackedPointType::ActivePoint)
+            if (m_trackedPoints[i].pointType != TrackedPointType::ActivePoint)
             {
-                updateTrackedPoint(matrices, scalingMapper, trackedPoint);
+                m_updateIndices.push_back(i);
             }
             ++numUpdatedPoints;
             if (numUpdatedPoints > m_settings.maxHandPointUpdatesPerFrame)
@@ -116,6 +161,209 @@ namespace astra { namespace plugins { namespace hand {
                 break;
             }
         }
+
+        //debug layers accumulate every segmentation in order, so they stay serial
+        const bool runInParallel = !matrices.debugLayersEnabled &&
+                                   !m_workspaces.empty() &&
+                                   m_updateIndices.size() > 1;
+
+        if (!runInParallel)
+        {
+            for (size_t index : m_updateIndices)
+            {
+                updateTrackedPoint(matrices, scalingMapper, m_trackedPoints[index]);
+            }
+            return;
+        }
+
+        //each point segments independently of the others' updates, so the
+        //segmentation runs in parallel and the results are applied in the
+        //same order as the serial path
+        segment_tracked_points_in_parallel(matrices, scalingMapper);
+
+        for (size_t i = 0; i < m_updateIndices.size(); ++i)
+        {
+            apply_tracked_point_update(matrices,
+                                       scalingMapper,
+                                       m_trackedPoints[m_updateIndices[i]],
+                                       m_pointUpdates[i]);
+        }
+    }
+
+    void PointProcessor::segment_tracked_points_in_parallel(TrackingMatrices& matrices,
+                                                            ScalingCoordinateMapper& scalingMapper)
+    {
+        PROFILE_FUNC();
+        const int pointCount = static_cast<int>(m_updateIndices.size());
+        const int slotCount = MIN(pointCount, static_cast<int>(m_workspaces.size()) + 1);
+
+        if (m_pointUpdates.size() < m_updateIndices.size())
+        {
+            m_pointUpdates.resize(m_updateIndices.size());
+        }
+
+        const cv::Size size = matrices.depth.size();
+        for (int slot = 1; slot < slotCount; ++slot)
+        {
+            m_workspaces[slot - 1].begin_frame(size);
+        }
+
+        //points are dealt out to slots in a fixed stride, so each slot owns
+        //its planes and the work done per slot never depends on timing
+        auto segmentSlot = [&](int slot)
+        {
+            if (slot == 0)
+            {
+                for (int i = 0; i < pointCount; i += slotCount)
+                {
+                    segment_tracked_point_update(matrices, scalingMapper, m_trackedPoints[m_updateIndices[i]], m_pointUpdates[i]);
+                }
+                return;
+            }
+
+            LayerWorkspace& workspace = m_workspaces[slot - 1];
+            TrackingMatrices workerMatrices(matrices.fullSize,
+                                            matrices.depth,
+                                            matrices.area,
+                                            matrices.areaSqrt,
+                                            matrices.velocitySignal,
+                                            workspace.foregroundSearched,
+                                            workspace.layerSegmentation,
+                                            workspace.layerScore,
+                                            workspace.layerEdgeDistance,
+                                            workspace.layerIntegralArea,
+                                            workspace.layerTestPassMap,
+                                            matrices.debugSegmentation,
+                                            matrices.debugScore,
+                                            matrices.debugScoreValue,
+                                            matrices.debugTestPassMap,
+                                            matrices.enableTestPassMap,
+                                            matrices.fullSizeWorldPoints,
+                                            matrices.worldPoints,
+                                            false,
+                                            matrices.fullSizeMapper,
+                                            matrices.depthToWorldData,
+                                            workspace.scratch);
+
+            for (int i = slot; i < pointCount; i += slotCount)
+            {
+                segment_tracked_point_update(workerMatrices, scalingMapper, m_trackedPoints[m_updateIndices[i]], m_pointUpdates[i]);
+            }
+        };
+
+        m_workerPool.run(slotCount, segmentSlot);
+
+        for (int slot = 1; slot < slotCount; ++slot)
+        {
+            merge_searched(m_workspaces[slot - 1].foregroundSearched, matrices.foregroundSearched);
+        }
+    }
+
+    bool PointProcessor::update_tracked_point_in_window(TrackingMatrices& matrices,
+                                                        TrackedPoint& trackedPoint)
+    {
+        PROFILE_FUNC();
+        const cv::Point3f worldPosition = trackedPoint.worldPosition;
+        if (worldPosition.z == 0)
+        {
+            return false;
+        }
+
+        const conversion_cache_t& depthToWorldData = matrices.depthToWorldData;
+        const float resizeFactor = get_resize_factor(matrices);
+        const int fullSizeWidth = matrices.fullSize.width;
+        const int fullSizeHeight = matrices.fullSize.height;
+
+        //full size pixels the window spans at the point's depth
+        const float fullSizeWindowWidth = m_settings.windowUpdateSize * depthToWorldData.resolutionX /
+                                          (worldPosition.z * depthToWorldData.xzFactor);
+        const float fullSizeWindowHeight = m_settings.windowUpdateSize * depthToWorldData.resolutionY /
+                                           (worldPosition.z * depthToWorldData.yzFactor);
+
+        const float maxWindowPixels = static_cast<float>(MAX(1, m_settings.maxWindowUpdatePixels));
+        const int stride = MAX(1, static_cast<int>(std::ceil(MAX(fullSizeWindowWidth, fullSizeWindowHeight) / maxWindowPixels)));
+
+        if (stride >= resizeFactor)
+        {
+            //the window would be no finer than the downscaled frame
+            return false;
+        }
+
+        const int windowWidth = MIN(fullSizeWidth / stride,
+                                    round_up_window_size(fullSizeWindowWidth / stride));
+        const int windowHeight = MIN(fullSizeHeight / stride,
+                                     round_up_window_size(fullSizeWindowHeight / stride));
+
+        //centered on the point, in whole strides so the window's pixels line
+        //up with the downscaled frame's
+        const cv::Point3f center = cv_convert_world_to_depth(depthToWorldData, worldPosition);
+        const int windowLeft = stride * MAX(0, MIN(fullSizeWidth / stride - windowWidth,
+                                                   static_cast<int>(center.x) / stride - windowWidth / 2));
+        const int windowTop = stride * MAX(0, MIN(fullSizeHeight / stride - windowHeight,
+                                                  static_cast<int>(center.y) / stride - windowHeight / 2));
+
+        WindowWorkspace& window = m_windowWorkspace;
+        window.begin_window(cv::Size(windowWidth, windowHeight));
+
+        for (int y = 0; y < windowHeight; ++y)
+        {
+            const astra::Vector3f* fullSizeRow = matrices.fullSizeWorldPoints + (windowTop + y * stride) * fullSizeWidth + windowLeft;
+            float* windowRow = window.depth.ptr<float>(y);
+
+            for (int x = 0; x < windowWidth; ++x)
+            {
+                windowRow[x] = fullSizeRow[x * stride].z;
+            }
+        }
+
+        LayerWorkspace& layers = window.layers;
+        TrackingMatrices windowMatrices(matrices.fullSize,
+                                        window.depth,
+                                        window.area,
+                                        window.areaSqrt,
+                                        window.velocitySignal,
+                                        layers.foregroundSearched,
+                                        layers.layerSegmentation,
+                                        layers.layerScore,
+                                        layers.layerEdgeDistance,
+                                        layers.layerIntegralArea,
+                                        layers.layerTestPassMap,
+                                        matrices.debugSegmentation,
+                                        matrices.debugScore,
+                                        matrices.debugScoreValue,
+                                        matrices.debugTestPassMap,
+                                        matrices.enableTestPassMap,
+                                        matrices.fullSizeWorldPoints,
+                                        window.worldPoints.data(),
+                                        false,
+                                        matrices.fullSizeMapper,
+                                        matrices.depthToWorldData,
+                                        layers.scratch);
+
+        windowMatrices.set_window(cv::Point(windowLeft, windowTop), stride);
+
+        auto windowMapper = get_scaling_mapper(windowMatrices);
+        calculate_area(windowMatrices, windowMapper);
+
+        //update a copy in window pixels. The reference area is the size of a
+        //pixel, so it scales with the pixel spacing.
+        TrackedPoint windowPoint = trackedPoint;
+        const cv::Point3f windowPosition = windowMapper.convert_world_to_depth(worldPosition);
+        windowPoint.position.x = MAX(0, MIN(windowWidth - 1, static_cast<int>(windowPosition.x)));
+        windowPoint.position.y = MAX(0, MIN(windowHeight - 1, static_cast<int>(windowPosition.y)));
+        windowPoint.referenceAreaSqrt = trackedPoint.referenceAreaSqrt * stride / resizeFactor;
+
+        updateTrackedPoint(windowMatrices, windowMapper, windowPoint);
+
+        const int fullSizeX = windowLeft + windowPoint.position.x * stride;
+        const int fullSizeY = windowTop + windowPoint.position.y * stride;
+
+        trackedPoint = windowPoint;
+        trackedPoint.position.x = MIN(matrices.depth.cols - 1, static_cast<int>(fullSizeX / resizeFactor));
+        trackedPoint.position.y = MIN(matrices.depth.rows - 1, static_cast<int>(fullSizeY / resizeFactor));
+        trackedPoint.referenceAreaSqrt = windowPoint.referenceAreaSqrt * resizeFactor / stride;
+
+        return true;
     }
 
     void PointProcessor::updateTrackedPoint(TrackingMatrices& matrices,
@@ -123,11 +371,26 @@ namespace astra { namespace plugins { namespace hand {
                                             TrackedPoint& trackedPoint)
     {
         PROFILE_FUNC();
-        const float width = matrices.depth.cols;
-        const float height = matrices.depth.rows;
-
         ++trackedPoint.inactiveFrameCount;
 
+        cv::Point newTargetPoint = segment_tracked_point(matrices, trackedPoint);
+
+        validateAndUpdateTrackedPoint(matrices, scalingMapper, trackedPoint, newTargetPoint);
+
+        //lost a tracked point, try to guess the position using previous position delta for second chance to recover
+        cv::Point recoveryPoint;
+        if (trackedPoint.trackingStatus != TrackingStatus::Tracking &&
+            newTargetPoint == segmentation::INVALID_POINT &&
+            segment_second_chance(matrices, scalingMapper, trackedPoint, recoveryPoint))
+        {
+            apply_second_chance(matrices, scalingMapper, trackedPoint, recoveryPoint);
+        }
+    }
+
+    cv::Point PointProcessor::segment_tracked_point(TrackingMatrices& matrices,
+                                                    const TrackedPoint& trackedPoint)
+    {
+        PROFILE_FUNC();
         TrackingData updateTrackingData(matrices,
                                         trackedPoint.position,
                                         trackedPoint.worldPosition,
@@ -136,51 +399,94 @@ namespace astra { namespace plugins { namespace hand {
                                         m_settings.segmentationSettings,
                                         TEST_PHASE_UPDATE);
 
-        cv::Point newTargetPoint = segmentation::track_point_from_seed(updateTrackingData);
-
-        validateAndUpdateTrackedPoint(matrices, scalingMapper, trackedPoint, newTargetPoint);
+        return segmentation::track_point_from_seed(updateTrackingData);
+    }
 
-        //lost a tracked point, try to guess the position using previous position delta for second chance to recover
+    bool PointProcessor::segment_second_chance(TrackingMatrices& matrices,
+                                               ScalingCoordinateMapper& scalingMapper,
+                                               const TrackedPoint& trackedPoint,
+                                               cv::Point& recoveryPoint)
+    {
+        PROFILE_FUNC();
+        const float width = matrices.depth.cols;
+        const float height = matrices.depth.rows;
 
         auto xyDelta = trackedPoint.worldDeltaPosition;
         xyDelta.z = 0;
         double xyDeltaNorm = cv::norm(xyDelta);
-        if (trackedPoint.trackingStatus != TrackingStatus::Tracking &&
-            newTargetPoint == segmentation::INVALID_POINT &&
-            xyDeltaNorm > m_settings.secondChanceMinDistance)
+        if (xyDeltaNorm <= m_settings.secondChanceMinDistance)
         {
-            auto movementDirection = xyDelta * (1.0f / xyDeltaNorm);
-            float maxSegmentationDist = m_settings.segmentationSettings.maxSegmentationDist;
-            auto estimatedWorldPosition = trackedPoint.worldPosition + movementDirection * maxSegmentationDist;
+            return false;
+        }
 
-            cv::Point3f estimatedPosition = scalingMapper.convert_world_to_depth(estimatedWorldPosition);
+        auto movementDirection = xyDelta * (1.0f / xyDeltaNorm);
+        float maxSegmentationDist = m_settings.segmentationSettings.maxSegmentationDist;
+        auto estimatedWorldPosition = trackedPoint.worldPosition + movementDirection * maxSegmentationDist;
 
-            cv::Point seedPosition;
-            seedPosition.x = MAX(0, MIN(width - 1, static_cast<int>(estimatedPosition.x)));
-            seedPosition.y = MAX(0, MIN(height - 1, static_cast<int>(estimatedPosition.y)));
+        cv::Point3f estimatedPosition = scalingMapper.convert_world_to_depth(estimatedWorldPosition);
 
-            TrackingData recoverTrackingData(matrices,
-                                             seedPosition,
-                                             estimatedWorldPosition,
-                                             trackedPoint.referenceAreaSqrt,
-                                             VELOCITY_POLICY_IGNORE,
-                                             m_settings.segmentationSettings,
-                                             TEST_PHASE_UPDATE);
+        cv::Point seedPosition;
+        seedPosition.x = MAX(0, MIN(width - 1, static_cast<int>(estimatedPosition.x)));
+        seedPosition.y = MAX(0, MIN(height - 1, static_cast<int>(estimatedPosition.y)));
 
-            newTargetPoint = segmentation::track_point_from_seed(recoverTrackingData);
+        TrackingData recoverTrackingData(matrices,
+                                         seedPosition,
+                                         estimatedWorldPosition,
+                                         trackedPoint.referenceAreaSqrt,
+                                         VELOCITY_POLICY_IGNORE,
+                                         m_settings.segmentationSettings,
+                                         TEST_PHASE_UPDATE);
 
-            //test for invalid point here so we don't increment failed test counts
-            //for second chance recovery
-            if (newTargetPoint != segmentation::INVALID_POINT)
-            {
-                validateAndUpdateTrackedPoint(matrices, scalingMapper, trackedPoint, newTargetPoint);
-            }
+        recoveryPoint = segmentation::track_point_from_seed(recoverTrackingData);
+        return true;
+    }
 
-            if (trackedPoint.trackingStatus == TrackingStatus::Tracking)
-            {
-                LOG_TRACE("PointProcessor", "updateTrackedPoint 2nd chance recovered #%d",
-                              trackedPoint.trackingId);
-            }
+    void PointProcessor::apply_second_chance(TrackingMatrices& matrices,
+                                             ScalingCoordinateMapper& scalingMapper,
+                                             TrackedPoint& trackedPoint,
+                                             const cv::Point& recoveryPoint)
+    {
+        //test for invalid point here so we don't increment failed test counts
+        //for second chance recovery
+        if (recoveryPoint != segmentation::INVALID_POINT)
+        {
+            validateAndUpdateTrackedPoint(matrices, scalingMapper, trackedPoint, recoveryPoint);
+        }
+
+        if (trackedPoint.trackingStatus == TrackingStatus::Tracking)
+        {
+            LOG_TRACE("PointProcessor", "updateTrackedPoint 2nd chance recovered #%d",
+                          trackedPoint.trackingId);
+        }
+    }
+
+    void PointProcessor::segment_tracked_point_update(TrackingMatrices& matrices,
+                                                      ScalingCoordinateMapper& scalingMapper,
+                                                      const TrackedPoint& trackedPoint,
+                                                      PointUpdate& update)
+    {
+        update.targetPoint = segment_tracked_point(matrices, trackedPoint);
+
+        //an invalid target leaves the point's position untouched, so the second
+        //chance guess can be segmented before the point is validated. It is
+        //dropped again if validation keeps the point tracking.
+        update.hasRecovery = update.targetPoint == segmentation::INVALID_POINT &&
+                             segment_second_chance(matrices, scalingMapper, trackedPoint, update.recoveryPoint);
+    }
+
+    void PointProcessor::apply_tracked_point_update(TrackingMatrices& matrices,
+                                                    ScalingCoordinateMapper& scalingMapper,
+                                                    TrackedPoint& trackedPoint,
+                                                    const PointUpdate& update)
+    {
+        PROFILE_FUNC();
+        ++trackedPoint.inactiveFrameCount;
+
+        validateAndUpdateTrackedPoint(matrices, scalingMapper, trackedPoint, update.targetPoint);
+
+        if (trackedPoint.trackingStatus != TrackingStatus::Tracking && update.hasRecovery)
+        {
+            apply_second_chance(matrices, scalingMapper, trackedPoint, update.recoveryPoint);
         }
     }
 
@@ -188,9 +494,31 @@ namespace astra { namespace plugins { namespace hand {
     {
         PROFILE_FUNC();
         m_trackedPoints.clear();
+        m_gestureEvents.clear();
+        m_matchGridValid = false;
         m_nextTrackingId = 0;
     }
 
+    void PointProcessor::rescale_points(const cv::Size& fromSize, const cv::Size& toSize)
+    {
+        PROFILE_FUNC();
+        const float scaleX = toSize.width / static_cast<float>(fromSize.width);
+        const float scaleY = toSize.height / static_cast<float>(fromSize.height);
+        m_matchGridValid = false;
+
+        for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end(); ++iter)
+        {
+            TrackedPoint& trackedPoint = *iter;
+
+            //scale the pixel centers, as update_full_resolution_points does
+            int x = static_cast<int>((trackedPoint.position.x + 0.5f) * scaleX);
+            int y = static_cast<int>((trackedPoint.position.y + 0.5f) * scaleY);
+
+            trackedPoint.position.x = MAX(0, MIN(toSize.width - 1, x));
+            trackedPoint.position.y = MAX(0, MIN(toSize.height - 1, y));
+        }
+    }
+
     void PointProcessor::update_full_resolution_points(TrackingMatrices& matrices)
     {
         PROFILE_FUNC();
@@ -204,7 +532,7 @@ namespace astra { namespace plugins { namespace hand {
             trackedPoint.fullSizePosition.x = (trackedPoint.position.x + 0.5) * resizeFactor;
             trackedPoint.fullSizePosition.y = (trackedPoint.position.y + 0.5) * resizeFactor;
 
-            bool resizeNeeded = matrices.depthFullSize.cols != matrices.depth.cols;
+            bool resizeNeeded = matrices.fullSize.width != matrices.depth.cols;
 
             bool processRefinedPosition = false;
 
@@ -236,6 +564,8 @@ namespace astra { namespace plugins { namespace hand {
     void PointProcessor::update_trajectories()
     {
         PROFILE_FUNC();
+        m_gestureEvents.clear();
+
         for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end(); ++iter)
         {
             //TODO take this and make it a method on TrackedPoint
@@ -246,13 +576,13 @@ namespace astra { namespace plugins { namespace hand {
             if (it == m_trajectories.end())
             {
                 TrajectoryAnalyzer analyzer(trackingId, m_settings.trajectoryAnalyzerSettings);
-                analyzer.update(trackedPoint);
+                analyzer.update(trackedPoint, m_gestureEvents);
                 m_trajectories.insert(std::make_pair(trackingId, analyzer));
             }
             else
             {
                 TrajectoryAnalyzer& analyzer = it->second;
-                analyzer.update(trackedPoint);
+                analyzer.update(trackedPoint, m_gestureEvents);
 
                 if (analyzer.isWaveGesture())
                 {
@@ -274,8 +604,8 @@ namespace astra { namespace plugins { namespace hand {
             return trackedPoint.worldPosition;
         }
 
-        int fullWidth = matrices.depthFullSize.cols;
-        int fullHeight = matrices.depthFullSize.rows;
+        int fullWidth = matrices.fullSize.width;
+        int fullHeight = matrices.fullSize.height;
         int processingWidth = matrices.depth.cols;
         int processingHeight = matrices.depth.rows;
 
@@ -292,15 +622,23 @@ namespace astra { namespace plugins { namespace hand {
             return trackedPoint.worldPosition;
         }
 
-        //Create a window into the full size data
-        cv::Mat roi = matrices.depthFullSize(cv::Rect(windowLeft, windowTop, processingWidth, processingHeight));
-        //copyTo for now so .at works with local coords in functions that use it
-        roi.copyTo(matrices.depth);
+        //copy a window of the full size depth so .at works with local coords in functions that use it
+        matrices.depth.create(processingHeight, processingWidth, CV_32FC1);
+        for (int y = 0; y < processingHeight; ++y)
+        {
+            const astra::Vector3f* fullSizeRow = matrices.fullSizeWorldPoints + (windowTop + y) * fullWidth + windowLeft;
+            float* windowRow = matrices.depth.ptr<float>(y);
+
+            for (int x = 0; x < processingWidth; ++x)
+            {
+                windowRow[x] = fullSizeRow[x].z;
+            }
+        }
 
         //initialize_common_calculations(matrices);
-        ScalingCoordinateMapper roiMapper(matrices.depthToWorldData, 1.0, windowLeft, windowTop);
+        matrices.set_window(cv::Point(windowLeft, windowTop), 1);
 
-        calculate_area(matrices, roiMapper);
+        calculate_area(matrices, get_scaling_mapper(matrices));
 
         TrackingData refinementTrackingData(matrices,
                                             roiPosition,
@@ -320,7 +658,7 @@ namespace astra { namespace plugins { namespace hand {
         int refinedFullSizeX = targetPoint.x + windowLeft;
         int refinedFullSizeY = targetPoint.y + windowTop;
 
-        float refinedDepth = matrices.depthFullSize.at<float>(refinedFullSizeY, refinedFullSizeX);
+        float refinedDepth = matrices.fullSizeWorldPoints[refinedFullSizeX + refinedFullSizeY * fullWidth].z;
 
         if (refinedDepth == 0)
         {
@@ -490,16 +828,48 @@ namespace astra { namespace plugins { namespace hand {
         }
     }
 
+    void PointProcessor::build_point_grid(float cellSize)
+    {
+        m_pointGrid.begin(cellSize);
+        for (size_t i = 0; i < m_trackedPoints.size(); ++i)
+        {
+            const TrackedPoint& trackedPoint = m_trackedPoints[i];
+            if (trackedPoint.trackingStatus != TrackingStatus::Dead)
+            {
+                m_pointGrid.add(i, trackedPoint.worldPosition);
+            }
+        }
+        m_pointGrid.finish();
+    }
+
     void PointProcessor::removeDuplicatePoints()
     {
         PROFILE_FUNC();
+        m_matchGridValid = false;
 
-        for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end(); ++iter)
+        if (m_settings.mergePointDistance <= 0)
+        {
+            return;
+        }
+
+        //points only change status and id while merging, not position, so one
+        //grid serves the whole pass. Neighbors come back in index order, which
+        //keeps the merges the same as comparing every pair in order
+        build_point_grid(m_settings.mergePointDistance);
+
+        for (size_t i = 0; i < m_trackedPoints.size(); ++i)
         {
-            TrackedPoint& tracked = *iter;
-            for (auto otherIter = m_trackedPoints.begin(); otherIter != m_trackedPoints.end(); ++otherIter)
+            TrackedPoint& tracked = m_trackedPoints[i];
+            if (tracked.trackingStatus == TrackingStatus::Dead)
             {
-                TrackedPoint& otherTracked = *otherIter;
+                continue;
+            }
+
+            m_pointGrid.find_near(tracked.worldPosition, m_nearPoints);
+
+            for (size_t otherIndex : m_nearPoints)
+            {
+                TrackedPoint& otherTracked = m_trackedPoints[otherIndex];
                 bool bothNotDead = tracked.trackingStatus != TrackingStatus::Dead && otherTracked.trackingStatus != TrackingStatus::Dead;
                 float pointDist = cv::norm(tracked.worldPosition - otherTracked.worldPosition);
                 if (tracked.trackingId != otherTracked.trackingId &&
@@ -521,9 +891,13 @@ namespace astra { namespace plugins { namespace hand {
     void PointProcessor::removeOldOrDeadPoints()
     {
         PROFILE_FUNC();
-        for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end();)
+        m_matchGridValid = false;
+
+        //compact the survivors in one pass, keeping their order
+        size_t keptCount = 0;
+        for (size_t i = 0; i < m_trackedPoints.size(); ++i)
         {
-            TrackedPoint& tracked = *iter;
+            TrackedPoint& tracked = m_trackedPoints[i];
 
             int max = m_settings.maxInactiveFramesForCandidatePoints;
             if (tracked.pointType == TrackedPointType::ActivePoint)
@@ -541,14 +915,70 @@ namespace astra { namespace plugins { namespace hand {
             if (tracked.inactiveFrameCount > max || tracked.trackingStatus == TrackingStatus::Dead)
             {
                 m_trajectories.erase(tracked.trackingId);
-
-                iter = m_trackedPoints.erase(iter);
             }
             else
             {
-                ++iter;
+                if (keptCount != i)
+                {
+                    m_trackedPoints[keptCount] = tracked;
+                }
+                ++keptCount;
+            }
+        }
+
+        m_trackedPoints.resize(keptCount, TrackedPoint(cv::Point(), cv::Point3f(), 0));
+    }
+
+    int PointProcessor::find_matching_point(const cv::Point3f& worldPosition)
+    {
+        const float maxMatchDist = MAX(m_settings.maxMatchDistDefault, m_settings.maxMatchDistLostActive);
+        if (maxMatchDist <= 0)
+        {
+            //no point can be that close, and grid cells need a positive size
+            m_matchGridExtras.clear();
+            return -1;
+        }
+
+        if (!m_matchGridValid)
+        {
+            build_point_grid(maxMatchDist);
+            m_matchGridExtras.clear();
+            m_matchGridValid = true;
+        }
+
+        m_pointGrid.find_near(worldPosition, m_nearPoints);
+
+        //points added or recovered since the grid was built
+        m_nearPoints.insert(m_nearPoints.end(), m_matchGridExtras.begin(), m_matchGridExtras.end());
+
+        int matchIndex = -1;
+        float matchDist = 0;
+        for (size_t index : m_nearPoints)
+        {
+            const TrackedPoint& trackedPoint = m_trackedPoints[index];
+            if (trackedPoint.trackingStatus == TrackingStatus::Dead)
+            {
+                continue;
+            }
+
+            float maxDist = m_settings.maxMatchDistDefault;
+            if (trackedPoint.trackingStatus == TrackingStatus::Lost &&
+                trackedPoint.pointType == TrackedPointType::ActivePoint)
+            {
+                maxDist = m_settings.maxMatchDistLostActive;
+            }
+
+            //the nearest point wins, ties go to the older point
+            float dist = cv::norm(trackedPoint.worldPosition - worldPosition);
+            if (dist < maxDist &&
+                (matchIndex < 0 || dist < matchDist || (dist == matchDist && static_cast<int>(index) < matchIndex)))
+            {
+                matchIndex = static_cast<int>(index);
+                matchDist = dist;
             }
         }
+
+        return matchIndex;
     }
 
     void PointProcessor::updateTrackedPointOrCreateNewPointFromSeedPosition(TrackingMatrices& matrices,
@@ -590,51 +1020,40 @@ namespace astra { namespace plugins { namespace hand {
             return;
         }
 
-        bool existingPoint = false;
-
         float depth = matrices.depth.at<float>(targetPoint);
 
         cv::Point3f worldPosition = scalingMapper.convert_depth_to_world(targetPoint.x,
                                                                          targetPoint.y,
                                                                          depth);
 
-        for (auto iter = m_trackedPoints.begin(); iter != m_trackedPoints.end(); ++iter)
+        int matchIndex = find_matching_point(worldPosition);
+        if (matchIndex >= 0)
         {
-            TrackedPoint& trackedPoint = *iter;
-            if (trackedPoint.trackingStatus != TrackingStatus::Dead)
+            TrackedPoint& trackedPoint = m_trackedPoints[matchIndex];
+            bool lostPoint = trackedPoint.trackingStatus == TrackingStatus::Lost;
+
+            trackedPoint.inactiveFrameCount = 0;
+            if (lostPoint)
             {
-                float dist = cv::norm(trackedPoint.worldPosition - worldPosition);
-                float maxDist = m_settings.maxMatchDistDefault;
-                bool lostPoint = trackedPoint.trackingStatus == TrackingStatus::Lost;
-                if (lostPoint && trackedPoint.pointType == TrackedPointType::ActivePoint)
-                {
-                    maxDist = m_settings.maxMatchDistLostActive;
-                }
-                if (dist < maxDist)
-                {
-                    trackedPoint.inactiveFrameCount = 0;
-                    if (lostPoint)
-                    {
-                        //Recover a lost point -- move it to the recovery position
-                        trackedPoint.position = targetPoint;
-                        trackedPoint.referenceAreaSqrt = matrices.areaSqrt.at<float>(trackedPoint.position);
+                //Recover a lost point -- move it to the recovery position
+                trackedPoint.position = targetPoint;
+                trackedPoint.referenceAreaSqrt = matrices.areaSqrt.at<float>(trackedPoint.position);
 
-                        trackedPoint.worldPosition = worldPosition;
-                        trackedPoint.worldDeltaPosition = cv::Point3f();
+                trackedPoint.worldPosition = worldPosition;
+                trackedPoint.worldDeltaPosition = cv::Point3f();
 
-                        LOG_TRACE("PointProcessor", "createCycle: Recovered #%d",
-                                        trackedPoint.trackingId);
+                LOG_TRACE("PointProcessor", "createCycle: Recovered #%d",
+                                trackedPoint.trackingId);
 
-                        //it could be faulty recovery, so start out in probation just like a new point
-                        start_probation(trackedPoint);
-                    }
-                    trackedPoint.trackingStatus = TrackingStatus::Tracking;
-                    existingPoint = true;
-                    break;
-                }
+                //it could be faulty recovery, so start out in probation just like a new point
+                start_probation(trackedPoint);
+
+                //it moved away from its grid cell
+                m_matchGridExtras.push_back(matchIndex);
             }
+            trackedPoint.trackingStatus = TrackingStatus::Tracking;
         }
-        if (!existingPoint)
+        else
         {
             LOG_TRACE("PointProcessor", "createCycle: Created new point #%d",
                            m_nextTrackingId);
@@ -644,6 +1063,7 @@ namespace astra { namespace plugins { namespace hand {
             newPoint.trackingStatus = TrackingStatus::Tracking;
             ++m_nextTrackingId;
             m_trackedPoints.push_back(newPoint);
+            m_matchGridExtras.push_back(m_trackedPoints.size() - 1);
             start_probation(newPoint);
         }
     }
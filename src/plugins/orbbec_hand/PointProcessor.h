@@ -8,6 +8,7 @@
 #include "HandSettings.h"
 #include <unordered_map>
 #include "TrajectoryAnalyzer.h"
+#include <common/parallel/WorkerPool.h>
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -16,7 +17,7 @@ namespace astra { namespace plugins { namespace hand {
     class PointProcessor
     {
     public:
-        PointProcessor(PointProcessorSettings& settings);
+        PointProcessor(PointProcessorSettings& settings, parallel::WorkerPool& workerPool);
         virtual ~PointProcessor();
 
         void initialize_common_calculations(TrackingMatrices& matrices);
@@ -33,14 +34,51 @@ namespace astra { namespace plugins { namespace hand {
 
         std::vector<TrackedPoint>& get_trackedPoints() { return m_trackedPoints; }
 
+        //gestures recognized by the last update_trajectories, in point order
+        const std::vector<GestureEvent>& gesture_events() const { return m_gestureEvents; }
+
         void reset();
 
+        //moves tracked points to the same depth pixels at a new processing size
+        void rescale_points(const cv::Size& fromSize, const cv::Size& toSize);
+
     private:
+        //segmentation results for one tracked point, computed before the
+        //point itself is updated
+        struct PointUpdate
+        {
+            cv::Point targetPoint;
+            cv::Point recoveryPoint;
+            bool hasRecovery;
+        };
+
         cv::Point3f smooth_world_positions(const cv::Point3f& oldWorldPosition, const cv::Point3f& newWorldPosition);
         void calculate_area(TrackingMatrices& matrices, ScalingCoordinateMapper mapper);
+        bool update_tracked_point_in_window(TrackingMatrices& matrices,
+                                            TrackedPoint& trackedPoint);
         void updateTrackedPoint(TrackingMatrices& matrices,
                                 ScalingCoordinateMapper& scalingMapper,
                                 TrackedPoint& trackedPoint);
+        cv::Point segment_tracked_point(TrackingMatrices& matrices,
+                                        const TrackedPoint& trackedPoint);
+        bool segment_second_chance(TrackingMatrices& matrices,
+                                   ScalingCoordinateMapper& scalingMapper,
+                                   const TrackedPoint& trackedPoint,
+                                   cv::Point& recoveryPoint);
+        void apply_second_chance(TrackingMatrices& matrices,
+                                 ScalingCoordinateMapper& scalingMapper,
+                                 TrackedPoint& trackedPoint,
+                                 const cv::Point& recoveryPoint);
+        void segment_tracked_points_in_parallel(TrackingMatrices& matrices,
+                                                ScalingCoordinateMapper& scalingMapper);
+        void segment_tracked_point_update(TrackingMatrices& matrices,
+                                          ScalingCoordinateMapper& scalingMapper,
+                                          const TrackedPoint& trackedPoint,
+                                          PointUpdate& update);
+        void apply_tracked_point_update(TrackingMatrices& matrices,
+                                        ScalingCoordinateMapper& scalingMapper,
+                                        TrackedPoint& trackedPoint,
+                                        const PointUpdate& update);
 
         cv::Point3f get_refined_high_res_position(TrackingMatrices& matrices,
                                                   const TrackedPoint& trackedPoint);
@@ -52,18 +90,39 @@ namespace astra { namespace plugins { namespace hand {
         void start_probation(TrackedPoint& trackedPoint);
         void end_probation(TrackedPoint& trackedPoint);
         void update_tracked_point_data(TrackingMatrices& matrices, ScalingCoordinateMapper& scalingMapper, TrackedPoint& trackedPoint, const cv::Point& newTargetPoint);
+        void build_point_grid(float cellSize);
+        int find_matching_point(const cv::Point3f& worldPosition);
         void update_tracked_point_from_world_position(TrackedPoint& trackedPoint,
                                                       const cv::Point3f& newWorldPosition,
                                                       const float resizeFactor,
                                                       const conversion_cache_t& depthToWorldData);
 
         PointProcessorSettings& m_settings;
+        parallel::WorkerPool& m_workerPool;
+
+        //planes for every worker but the calling thread, which uses the
+        //matrices it was given
+        std::vector<LayerWorkspace> m_workspaces;
+        //planes for updating active points from the full size frame
+        WindowWorkspace m_windowWorkspace;
+        std::vector<size_t> m_updateIndices;
+        std::vector<PointUpdate> m_pointUpdates;
 
         int m_nextTrackingId{ 0 };
-        //TODO consider std::list<TrackedPoint>
+        //kept in creation order, which decides update priority and the order
+        //hands are reported in
         std::vector<TrackedPoint> m_trackedPoints;
 
+        //live points by world position, for merging and for matching seeds.
+        //The matching grid is built on the first seed after the points move
+        //and points a seed adds or recovers are checked on the side
+        PointGrid m_pointGrid;
+        bool m_matchGridValid{ false };
+        std::vector<size_t> m_matchGridExtras;
+        std::vector<size_t> m_nearPoints;
+
         std::unordered_map<int, TrajectoryAnalyzer> m_trajectories;
+        std::vector<GestureEvent> m_gestureEvents;
     };
 
 }}}
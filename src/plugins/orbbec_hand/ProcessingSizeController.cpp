@@ -0,0 +1,178 @@
+#include "ProcessingSizeController.h"
+#include <Shiny.h>
+
+namespace astra { namespace plugins { namespace hand {
+
+    namespace {
+
+        const float FRAME_TIME_SMOOTHING_FACTOR = 0.1f;
+
+        //frames to measure a level before it may be left again
+        const int MIN_FRAMES_AT_LEVEL = 15;
+
+        //frames without any tracked point before dropping to the coarse size
+        const int MIN_FRAMES_WITHOUT_POINTS = 15;
+
+        //only step up when the estimate leaves some room, so a level that
+        //barely fits is not left and re-entered every few frames
+        const float STEP_UP_BUDGET_FACTOR = 0.75f;
+
+        bool is_smaller(const cv::Size& a, const cv::Size& b)
+        {
+            return a.width < b.width && a.height < b.height;
+        }
+    }
+
+    ProcessingSizeController::ProcessingSizeController(const cv::Size& requestedSize,
+                                                       const cv::Size& coarseSize,
+                                                       float frameBudget,
+                                                       bool adaptive)
+        : m_requestedSize(requestedSize),
+          m_coarseSize(coarseSize),
+          m_frameBudget(frameBudget),
+          m_adaptive(adaptive)
+    {
+        build_levels();
+    }
+
+    void ProcessingSizeController::set_requested_size(const cv::Size& requestedSize)
+    {
+        if (requestedSize == m_requestedSize)
+        {
+            return;
+        }
+
+        m_requestedSize = requestedSize;
+        build_levels();
+    }
+
+    void ProcessingSizeController::set_adaptive(bool adaptive)
+    {
+        if (adaptive == m_adaptive)
+        {
+            return;
+        }
+
+        m_adaptive = adaptive;
+        build_levels();
+    }
+
+    void ProcessingSizeController::set_coarse_size(const cv::Size& coarseSize)
+    {
+        if (coarseSize == m_coarseSize)
+        {
+            return;
+        }
+
+        m_coarseSize = coarseSize;
+        build_levels();
+    }
+
+    void ProcessingSizeController::build_levels()
+    {
+        m_levels.clear();
+        m_levels.push_back(m_requestedSize);
+
+        if (m_adaptive && is_smaller(m_coarseSize, m_requestedSize))
+        {
+            //halve while the result still divides evenly and is above the coarse size
+            cv::Size level = m_requestedSize;
+            while (level.width % 2 == 0 &&
+                   level.height % 2 == 0 &&
+                   is_smaller(m_coarseSize, cv::Size(level.width / 2, level.height / 2)))
+            {
+                level = cv::Size(level.width / 2, level.height / 2);
+                m_levels.insert(m_levels.begin(), level);
+            }
+            m_levels.insert(m_levels.begin(), m_coarseSize);
+        }
+
+        m_levelPointTimes.assign(m_levels.size(), 0.0f);
+        m_framesAtLevel = 0;
+
+        //without points the adaptive search starts coarse, with points at the
+        //requested size until the budget says otherwise
+        m_level = m_trackedPointCount == 0 ? 0 : m_levels.size() - 1;
+    }
+
+    void ProcessingSizeController::select_level(size_t level)
+    {
+        if (level != m_level)
+        {
+            m_level = level;
+            m_framesAtLevel = 0;
+        }
+    }
+
+    float ProcessingSizeController::estimated_frame_time(size_t level, size_t trackedPointCount) const
+    {
+        float pointTime = m_levelPointTimes[level];
+        if (pointTime == 0)
+        {
+            //not measured yet, scale the current level's time by the pixel count
+            const float pixelRatio = m_levels[level].area() / static_cast<float>(m_levels[m_level].area());
+            pointTime = m_levelPointTimes[m_level] * pixelRatio;
+        }
+
+        return pointTime * (trackedPointCount + 1);
+    }
+
+    void ProcessingSizeController::update(float frameTime, size_t trackedPointCount)
+    {
+        PROFILE_FUNC();
+        const bool pointCountIncreased = trackedPointCount > m_trackedPointCount;
+        const size_t measuredPointCount = m_trackedPointCount;
+        m_trackedPointCount = trackedPointCount;
+
+        if (m_levels.size() == 1)
+        {
+            return;
+        }
+
+        //the frame just measured tracked the points known before it
+        const float pointTime = frameTime / (measuredPointCount + 1);
+        float& levelPointTime = m_levelPointTimes[m_level];
+        if (levelPointTime == 0)
+        {
+            levelPointTime = pointTime;
+        }
+        else
+        {
+            levelPointTime = levelPointTime * (1 - FRAME_TIME_SMOOTHING_FACTOR) +
+                             pointTime * FRAME_TIME_SMOOTHING_FACTOR;
+        }
+
+        ++m_framesAtLevel;
+
+        if (trackedPointCount == 0)
+        {
+            ++m_framesWithoutPoints;
+            if (m_framesWithoutPoints >= MIN_FRAMES_WITHOUT_POINTS)
+            {
+                select_level(0);
+            }
+            return;
+        }
+
+        m_framesWithoutPoints = 0;
+
+        //new points are picked up at once, otherwise let the measurement settle
+        if (!pointCountIncreased && m_framesAtLevel < MIN_FRAMES_AT_LEVEL)
+        {
+            return;
+        }
+
+        size_t level = 0;
+        for (size_t i = 1; i < m_levels.size(); ++i)
+        {
+            const float budget = i > m_level ? m_frameBudget * STEP_UP_BUDGET_FACTOR : m_frameBudget;
+            if (estimated_frame_time(i, trackedPointCount) <= budget)
+            {
+                level = i;
+            }
+        }
+
+        select_level(level);
+    }
+
+}}}
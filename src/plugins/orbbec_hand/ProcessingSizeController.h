@@ -0,0 +1,62 @@
+#ifndef PROCESSINGSIZECONTROLLER_H
+#define PROCESSINGSIZECONTROLLER_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // Picks the size each frame is processed at. A fixed size is used as
+    // requested. In adaptive mode the tracker looks for new hands at the
+    // coarse size, and while points are tracked uses the largest level,
+    // halving down from the requested size, whose frame time fits the budget.
+    class ProcessingSizeController
+    {
+    public:
+        ProcessingSizeController(const cv::Size& requestedSize,
+                                 const cv::Size& coarseSize,
+                                 float frameBudget,
+                                 bool adaptive);
+
+        const cv::Size& requested_size() const { return m_requestedSize; }
+        void set_requested_size(const cv::Size& requestedSize);
+
+        bool adaptive() const { return m_adaptive; }
+        void set_adaptive(bool adaptive);
+
+        void set_coarse_size(const cv::Size& coarseSize);
+        void set_frame_budget(float frameBudget) { m_frameBudget = frameBudget; }
+
+        //size to process the next frame at
+        const cv::Size& size() const { return m_levels[m_level]; }
+
+        //levels from coarse to the requested size
+        const std::vector<cv::Size>& levels() const { return m_levels; }
+
+        //feeds back how long the last frame took at size(), in ms, and how
+        //many points it tracked, then picks the size of the next frame
+        void update(float frameTime, size_t trackedPointCount);
+
+    private:
+        void build_levels();
+        void select_level(size_t level);
+        float estimated_frame_time(size_t level, size_t trackedPointCount) const;
+
+        cv::Size m_requestedSize;
+        cv::Size m_coarseSize;
+        float m_frameBudget;
+        bool m_adaptive;
+
+        std::vector<cv::Size> m_levels;
+        //smoothed frame time per tracked point (plus one for the search for
+        //new points) at each level, 0 until the level has been measured
+        std::vector<float> m_levelPointTimes;
+        size_t m_level{ 0 };
+        int m_framesAtLevel{ 0 };
+        int m_framesWithoutPoints{ 0 };
+        size_t m_trackedPointCount{ 0 };
+    };
+
+}}}
+
+#endif // PROCESSINGSIZECONTROLLER_H
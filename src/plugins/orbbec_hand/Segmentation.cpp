@@ -1,7 +1,10 @@
 #include "TrackingData.h"
-#include <queue>
 #include "ScalingCoordinateMapper.h"
 #include <cmath>
+#include <cfloat>
+#include <climits>
+#include <algorithm>
+#include <utility>
 #include "Segmentation.h"
 #include "constants.h"
 #include <Shiny.h>
@@ -11,28 +14,15 @@
 
 namespace astra { namespace plugins { namespace hand { namespace segmentation {
 
-    struct PointTTL
+    //called for every pixel a flood fill reaches, so it stays out of the profiler
+    static inline void enqueue_neighbors(VisitedMap& visited,
+                                         PointQueue& pointQueue,
+                                         const PointTTL& pt)
     {
-        int x;
-        int y;
-        float ttl;
-
-        PointTTL(int x, int y, float ttl) :
-            x(x),
-            y(y),
-            ttl(ttl)
-        { }
-    };
-
-    static void enqueue_neighbors(cv::Mat& matVisited,
-                                 std::queue<PointTTL>& pointQueue,
-                                 const PointTTL& pt)
-    {
-        PROFILE_FUNC();
-        const int& x = pt.x;
-        const int& y = pt.y;
-        const int width = matVisited.cols;
-        const int height = matVisited.rows;
+        const int x = pt.x;
+        const int y = pt.y;
+        const int width = visited.width();
+        const int height = visited.height();
 
         if (x < 1 || x > width - 2 ||
             y < 1 || y > height - 2)
@@ -40,42 +30,34 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
             return;
         }
 
-        const float& ttlRef = pt.ttl;
+        const int index = x + y * width;
+        const float ttl = pt.ttl;
 
-        char& rightVisited = matVisited.at<char>(y, x+1);
-        if (0 == rightVisited)
+        if (visited.visit(index + 1))
         {
-            rightVisited = 1;
-            pointQueue.push(PointTTL(x+1, y, ttlRef));
+            pointQueue.push(PointTTL(x+1, y, ttl));
         }
 
-        char& leftVisited = matVisited.at<char>(y, x-1);
-        if (0 == leftVisited)
+        if (visited.visit(index - 1))
         {
-            leftVisited = 1;
-            pointQueue.push(PointTTL(x-1, y, ttlRef));
+            pointQueue.push(PointTTL(x-1, y, ttl));
         }
 
-        char& downVisited = matVisited.at<char>(y+1, x);
-        if (0 == downVisited)
+        if (visited.visit(index + width))
         {
-            downVisited = 1;
-            pointQueue.push(PointTTL(x, y+1, ttlRef));
+            pointQueue.push(PointTTL(x, y+1, ttl));
         }
 
-        char& upVisited = matVisited.at<char>(y-1, x);
-        if (0 == upVisited)
+        if (visited.visit(index - width))
         {
-            upVisited = 1;
-            pointQueue.push(PointTTL(x, y-1, ttlRef));
+            pointQueue.push(PointTTL(x, y-1, ttl));
         }
     }
 
     static cv::Point find_nearest_in_range_pixel(TrackingData& data,
-                                                cv::Mat& matVisited)
+                                                VisitedMap& visited)
     {
         PROFILE_FUNC();
-        assert(matVisited.size() == data.matrices.depth.size());
         const float referenceAreaSqrt = data.referenceAreaSqrt;
         if (referenceAreaSqrt == 0)
         {
@@ -87,31 +69,32 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         const float maxSegmentationDist = data.settings.maxSegmentationDist;
         cv::Mat& depthMatrix = data.matrices.depth;
         cv::Mat& searchedMatrix = data.matrices.foregroundSearched;
+        const int width = depthMatrix.cols;
 
-        std::queue<PointTTL> pointQueue;
+        PointQueue& pointQueue = data.matrices.scratch.pointQueue;
+        pointQueue.clear();
 
         pointQueue.push(PointTTL(data.seedPosition.x,
                                  data.seedPosition.y,
                                  maxSegmentationDist));
 
-        matVisited.at<char>(data.seedPosition) = 1;
+        visited.visit(data.seedPosition.x + data.seedPosition.y * width);
 
         while (!pointQueue.empty())
         {
-            PointTTL pt = pointQueue.front();
+            const PointTTL pt = pointQueue.front();
             pointQueue.pop();
-            const int& x = pt.x;
-            const int& y = pt.y;
-            float& ttlRef = pt.ttl;
+            const int x = pt.x;
+            const int y = pt.y;
 
-            if (ttlRef <= 0)
+            if (pt.ttl <= 0)
             {
                 continue;
             }
 
-            searchedMatrix.at<char>(y, x) = PixelType::SearchedFromOutOfRange;
+            searchedMatrix.ptr<uint8_t>(y)[x] = PixelType::SearchedFromOutOfRange;
 
-            float depth = depthMatrix.at<float>(y, x);
+            const float depth = depthMatrix.ptr<float>(y)[x];
             bool pointInRange = depth != 0 && depth > minDepth && depth < maxDepth;
 
             if (pointInRange)
@@ -119,27 +102,29 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
                 return cv::Point(x, y);
             }
 
-            ttlRef -= referenceAreaSqrt;
-
-            enqueue_neighbors(matVisited, pointQueue, pt);
+            enqueue_neighbors(visited, pointQueue, PointTTL(x, y, pt.ttl - referenceAreaSqrt));
         }
 
         return INVALID_POINT;
     }
 
-    static float segment_foreground_and_get_average_depth(TrackingData& data)
+    float segment_foreground_and_get_average_depth(TrackingData& data)
     {
         PROFILE_FUNC();
         const float& maxSegmentationDist = data.settings.maxSegmentationDist;
-        const SegmentationVelocityPolicy& velocitySignalPolicy = data.velocityPolicy;
+        const bool resetTtlOnVelocity = data.velocityPolicy == VELOCITY_POLICY_RESET_TTL;
         const float seedDepth = data.matrices.depth.at<float>(data.seedPosition);
         const float referenceAreaSqrt = data.referenceAreaSqrt;
         cv::Mat& depthMatrix = data.matrices.depth;
         cv::Mat& velocitySignalMatrix = data.matrices.velocitySignal;
         cv::Mat& segmentationMatrix = data.matrices.layerSegmentation;
         cv::Mat& searchedMatrix = data.matrices.foregroundSearched;
+        const cv::Size size = depthMatrix.size();
 
-        std::queue<PointTTL> pointQueue;
+        segmentationMatrix.create(size, CV_8UC1);
+        clear_plane(segmentationMatrix);
+
+        PointQueue& pointQueue = data.matrices.scratch.pointQueue;
 
         double totalDepth = 0;
         int depthCount = 0;
@@ -151,14 +136,23 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         const float minDepth = data.referenceWorldPosition.z - bandwidthDepth;
         const float maxDepth = data.referenceWorldPosition.z + data.settings.segmentationBandwidthDepthFar;
 
-        cv::Mat matVisited = cv::Mat::zeros(depthMatrix.size(), CV_8UC1);
+        VisitedMap& visited = data.matrices.scratch.visited;
+        if (visited.width() != size.width || visited.height() != size.height)
+        {
+            visited.allocate(size);
+        }
+        //the nearest pixel search and the fill share one generation, so the
+        //fill does not revisit pixels the search already passed through
+        visited.begin_fill();
+
+        data.matrices.layerBounds = cv::Rect();
 
         cv::Point seedPosition = data.seedPosition;
 
         bool seedInRange = seedDepth != 0 && seedDepth > minDepth && seedDepth < maxDepth;
         if (!seedInRange)
         {
-            seedPosition = find_nearest_in_range_pixel(data, matVisited);
+            seedPosition = find_nearest_in_range_pixel(data, visited);
             if (seedPosition == INVALID_POINT)
             {
                 //No in range pixels found, no foreground to set
@@ -166,53 +160,68 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
             }
         }
 
+        //the nearest pixel search may have left entries behind
+        pointQueue.clear();
         pointQueue.push(PointTTL(seedPosition.x,
                                  seedPosition.y,
                                  maxSegmentationDist));
 
-        matVisited.at<char>(seedPosition) = 1;
+        visited.visit(seedPosition.x + seedPosition.y * size.width);
+
+        //every dequeued pixel is written to the segmentation
+        int minX = seedPosition.x;
+        int maxX = seedPosition.x;
+        int minY = seedPosition.y;
+        int maxY = seedPosition.y;
 
         while (!pointQueue.empty())
         {
-            PointTTL pt = pointQueue.front();
+            const PointTTL pt = pointQueue.front();
             pointQueue.pop();
-            const int& x = pt.x;
-            const int& y = pt.y;
-            float& ttlRef = pt.ttl;
+            const int x = pt.x;
+            const int y = pt.y;
+            float ttl = pt.ttl;
+
+            minX = MIN(minX, x);
+            maxX = MAX(maxX, x);
+            minY = MIN(minY, y);
+            maxY = MAX(maxY, y);
 
-            if (velocitySignalPolicy == VELOCITY_POLICY_RESET_TTL &&
-                velocitySignalMatrix.at<char>(y, x) == PixelType::Foreground)
+            uint8_t* segmentationRow = segmentationMatrix.ptr<uint8_t>(y);
+
+            if (resetTtlOnVelocity &&
+                velocitySignalMatrix.ptr<uint8_t>(y)[x] == PixelType::Foreground)
             {
-                ttlRef = maxSegmentationDist;
+                ttl = maxSegmentationDist;
             }
 
-            float depth = depthMatrix.at<float>(y, x);
+            const float depth = depthMatrix.ptr<float>(y)[x];
             bool pointOutOfRange = depth == 0 ||
                                    depth < minDepth ||
                                    depth > maxDepth;
 
-            if (ttlRef <= 0)
+            if (ttl <= 0)
             {
-                segmentationMatrix.at<char>(y, x) = PixelType::ForegroundOutOfRangeEdge;
+                segmentationRow[x] = PixelType::ForegroundOutOfRangeEdge;
                 continue;
             }
             else if (pointOutOfRange)
             {
-                segmentationMatrix.at<char>(y, x) = PixelType::ForegroundNaturalEdge;
+                segmentationRow[x] = PixelType::ForegroundNaturalEdge;
                 continue;
             }
 
             totalDepth += depth;
             ++depthCount;
 
-            searchedMatrix.at<char>(y, x) = PixelType::Searched;
-            segmentationMatrix.at<char>(y, x) = PixelType::Foreground;
-
-            ttlRef -= referenceAreaSqrt;
+            searchedMatrix.ptr<uint8_t>(y)[x] = PixelType::Searched;
+            segmentationRow[x] = PixelType::Foreground;
 
-            enqueue_neighbors(matVisited, pointQueue, pt);
+            enqueue_neighbors(visited, pointQueue, PointTTL(x, y, ttl - referenceAreaSqrt));
         }
 
+        data.matrices.layerBounds = cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+
         if (depthCount > 0)
         {
             float averageDepth = static_cast<float>(totalDepth / depthCount);
@@ -224,7 +233,9 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         }
     }
 
-    void calculate_layer_score(TrackingData& data, const float layerAverageDepth)
+    void calculate_layer_score(TrackingData& data,
+                               const float layerAverageDepth,
+                               const cv::Rect& scoreBounds)
     {
         PROFILE_FUNC();
         cv::Mat& edgeDistanceMatrix = data.matrices.layerEdgeDistance;
@@ -235,9 +246,10 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         cv::Mat& layerScoreMatrix = data.matrices.layerScore;
         const float pointInertiaFactor = data.settings.pointInertiaFactor;
         const float pointInertiaRadius = data.settings.pointInertiaRadius;
-        const astra::Vector3f* worldPoints = data.matrices.worldPoints;
+        const astra::Vector3f* worldPointsStart = data.matrices.worldPoints;
 
-        layerScoreMatrix = cv::Mat::zeros(data.matrices.depth.size(), CV_32FC1);
+        //only pixels within the score bounds are written below
+        layerScoreMatrix.create(data.matrices.depth.size(), CV_32FC1);
 
         ScalingCoordinateMapper mapper = get_scaling_mapper(data.matrices);
 
@@ -246,23 +258,34 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
                                                     data.referenceWorldPosition.z);
 
         int width = data.matrices.depth.cols;
-        int height = data.matrices.depth.rows;
 
-        int edgeRadius = mapper.scale() * width / 32;
-        int minX = edgeRadius - 1;
-        int maxX = width - edgeRadius;
-        int minY = edgeRadius - 1;
-        int maxY = height - edgeRadius;
+        //pixels near the edges of the full size frame are excluded. When the
+        //depth plane is a window, its own edges are not the frame's.
+        const float scale = mapper.scale();
+        const cv::Size& fullSize = data.matrices.fullSize;
+        const int originX = static_cast<int>(data.matrices.windowOffset.x / scale);
+        const int originY = static_cast<int>(data.matrices.windowOffset.y / scale);
 
-        for (int y = 0; y < height; y++)
-        {
-            float* edgeDistanceRow = edgeDistanceMatrix.ptr<float>(y);
-            float* layerScoreRow = layerScoreMatrix.ptr<float>(y);
+        int edgeRadius = fullSize.width / 32;
+        int minX = edgeRadius - 1 - originX;
+        int maxX = static_cast<int>(fullSize.width / scale) - edgeRadius - originX;
+        int minY = edgeRadius - 1 - originY;
+        int maxY = static_cast<int>(fullSize.height / scale) - edgeRadius - originY;
+
+        const int startX = scoreBounds.x;
+        const int endX = scoreBounds.x + scoreBounds.width;
+        const int endY = scoreBounds.y + scoreBounds.height;
 
-            for (int x = 0; x < width; ++x,
-                                       ++worldPoints,
-                                       ++edgeDistanceRow,
-                                       ++layerScoreRow)
+        for (int y = scoreBounds.y; y < endY; y++)
+        {
+            const astra::Vector3f* worldPoints = worldPointsStart + y * width + startX;
+            float* edgeDistanceRow = edgeDistanceMatrix.ptr<float>(y) + startX;
+            float* layerScoreRow = layerScoreMatrix.ptr<float>(y) + startX;
+
+            for (int x = startX; x < endX; ++x,
+                                           ++worldPoints,
+                                           ++edgeDistanceRow,
+                                           ++layerScoreRow)
             {
                 astra::Vector3f worldPosition = *worldPoints;
                 if (worldPosition.z != 0 && x > minX && x < maxX && y > minY && y < maxY)
@@ -358,6 +381,7 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
 
         float area = count_neighborhood_area_integral(matrices.depth,
                                                       integralArea,
+                                                      matrices.layerBounds,
                                                       point,
                                                       settings.areaBandwidth,
                                                       scalingMapper);
@@ -488,6 +512,138 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         return percentNaturalEdges;
     }
 
+    void calculate_integral_edges(cv::Mat& segmentationMatrix,
+                                  const cv::Rect& layerBounds,
+                                  cv::Mat& integralNaturalEdges,
+                                  cv::Mat& integralEdges)
+    {
+        PROFILE_FUNC();
+        const int width = segmentationMatrix.cols;
+        const int height = segmentationMatrix.rows;
+
+        //only the bounds are written below, see sum_integral_window
+        integralNaturalEdges.create(height + 1, width + 1, CV_32SC1);
+        integralEdges.create(height + 1, width + 1, CV_32SC1);
+
+        const int startX = layerBounds.x;
+        const int endX = layerBounds.x + layerBounds.width;
+        const int endY = layerBounds.y + layerBounds.height;
+
+        for (int y = layerBounds.y; y < endY; y++)
+        {
+            const uint8_t* segmentationRow = segmentationMatrix.ptr<uint8_t>(y);
+            const int32_t* lastNaturalRow = y > layerBounds.y ? integralNaturalEdges.ptr<int32_t>(y) : nullptr;
+            const int32_t* lastEdgeRow = y > layerBounds.y ? integralEdges.ptr<int32_t>(y) : nullptr;
+            int32_t* naturalRow = integralNaturalEdges.ptr<int32_t>(y + 1);
+            int32_t* edgeRow = integralEdges.ptr<int32_t>(y + 1);
+
+            int32_t rowNaturalCount = 0;
+            int32_t rowEdgeCount = 0;
+
+            for (int x = startX; x < endX; ++x)
+            {
+                const uint8_t segmentation = segmentationRow[x];
+                if (segmentation == PixelType::ForegroundNaturalEdge)
+                {
+                    ++rowNaturalCount;
+                    ++rowEdgeCount;
+                }
+                else if (segmentation == PixelType::ForegroundOutOfRangeEdge)
+                {
+                    ++rowEdgeCount;
+                }
+
+                naturalRow[x + 1] = rowNaturalCount;
+                edgeRow[x + 1] = rowEdgeCount;
+                if (lastNaturalRow != nullptr)
+                {
+                    naturalRow[x + 1] += lastNaturalRow[x + 1];
+                    edgeRow[x + 1] += lastEdgeRow[x + 1];
+                }
+            }
+        }
+    }
+
+    //count of the pixels left of column and above row, when only the bounds
+    //of the integral were written. Edges never lie outside the bounds.
+    static inline int32_t integral_count_before(const cv::Mat& integral,
+                                                const cv::Rect& integralBounds,
+                                                int column,
+                                                int row)
+    {
+        if (integralBounds.area() == 0 ||
+            column <= integralBounds.x || row <= integralBounds.y)
+        {
+            return 0;
+        }
+
+        column = MIN(column, integralBounds.x + integralBounds.width);
+        row = MIN(row, integralBounds.y + integralBounds.height);
+
+        return integral.ptr<int32_t>(row)[column];
+    }
+
+    static inline int32_t sum_integral_window(const cv::Mat& integral,
+                                              const cv::Rect& integralBounds,
+                                              int x0,
+                                              int y0,
+                                              int x1,
+                                              int y1)
+    {
+        //inclusive window, offset by the integral's padding row and column
+        return integral_count_before(integral, integralBounds, x1 + 1, y1 + 1)
+             - integral_count_before(integral, integralBounds, x1 + 1, y0)
+             - integral_count_before(integral, integralBounds, x0, y1 + 1)
+             + integral_count_before(integral, integralBounds, x0, y0);
+    }
+
+    float get_percent_natural_edges_integral(cv::Mat& matDepth,
+                                             cv::Mat& integralNaturalEdges,
+                                             cv::Mat& integralEdges,
+                                             const cv::Rect& integralBounds,
+                                             const cv::Point& center,
+                                             const float bandwidth,
+                                             const ScalingCoordinateMapper& mapper)
+    {
+        PROFILE_FUNC();
+        int width = matDepth.cols;
+        int height = matDepth.rows;
+        if (center.x < 0 || center.y < 0 ||
+            center.x >= width || center.y >= height)
+        {
+            return 0;
+        }
+
+        float startingDepth = matDepth.at<float>(center);
+
+        cv::Point topLeft = mapper.offset_pixel_location_by_mm(center, -bandwidth, bandwidth, startingDepth);
+
+        int offsetX = center.x - topLeft.x;
+        int offsetY = center.y - topLeft.y;
+        cv::Point bottomRight(center.x + offsetX, center.y + offsetY);
+
+        int32_t x0 = MAX(0, topLeft.x);
+        int32_t y0 = MAX(0, topLeft.y);
+        int32_t x1 = MIN(width - 1, bottomRight.x);
+        int32_t y1 = MIN(height - 1, bottomRight.y);
+
+        if (x0 > x1 || y0 > y1)
+        {
+            return 0;
+        }
+
+        int naturalEdgeCount = sum_integral_window(integralNaturalEdges, integralBounds, x0, y0, x1, y1);
+        int totalEdgeCount = sum_integral_window(integralEdges, integralBounds, x0, y0, x1, y1);
+
+        float percentNaturalEdges = 0;
+        if (totalEdgeCount > 0)
+        {
+            percentNaturalEdges = naturalEdgeCount / static_cast<float>(totalEdgeCount);
+        }
+
+        return percentNaturalEdges;
+    }
+
     bool test_natural_edges(TrackingMatrices& matrices,
                             NaturalEdgeTestSettings& settings,
                             const cv::Point& targetPoint,
@@ -497,11 +653,13 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         PROFILE_FUNC();
 
         auto scalingMapper = get_scaling_mapper(matrices);
-        float percentNaturalEdges = get_percent_natural_edges(matrices.depth,
-                                                              matrices.layerSegmentation,
-                                                              targetPoint,
-                                                              settings.naturalEdgeBandwidth,
-                                                              scalingMapper);
+        float percentNaturalEdges = get_percent_natural_edges_integral(matrices.depth,
+                                                                       matrices.scratch.integralNaturalEdges,
+                                                                       matrices.scratch.integralEdges,
+                                                                       matrices.layerBounds,
+                                                                       targetPoint,
+                                                                       settings.naturalEdgeBandwidth,
+                                                                       scalingMapper);
 
         float minPercentNaturalEdges = settings.minPercentNaturalEdges;
 
@@ -534,13 +692,15 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         PROFILE_FUNC();
         auto scalingMapper = get_scaling_mapper(matrices);
 
-        std::vector<astra::Vector2i>& points = matrices.layerCirclePoints;
+        const CircleOffsetTable& offsets = matrices.scratch.circleOffsets;
+        std::vector<astra::Vector2i>& points = matrices.scratch.circlePoints;
 
         float percentForeground1 = get_max_sequential_circumference_percentage(matrices.depth,
                                                                                matrices.layerSegmentation,
                                                                                targetPoint,
                                                                                settings.foregroundRadius1,
                                                                                scalingMapper,
+                                                                               offsets,
                                                                                points);
 
         float percentForeground2 = get_max_sequential_circumference_percentage(matrices.depth,
@@ -548,6 +708,7 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
                                                                                targetPoint,
                                                                                settings.foregroundRadius2,
                                                                                scalingMapper,
+                                                                               offsets,
                                                                                points);
 
         float minPercent1 = settings.foregroundRadiusMinPercent1;
@@ -602,26 +763,30 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         cv::Mat& segmentationMatrix = matrices.layerSegmentation;
         cv::Mat& areaMatrix = matrices.area;
         cv::Mat& integralAreaMatrix = matrices.layerIntegralArea;
-        integralAreaMatrix = cv::Mat::zeros(matrices.depth.size(), CV_32FC1);
+        //only pixels within the layer bounds are written below. Foreground
+        //never lies outside them, so lookups clamp into the bounds instead.
+        integralAreaMatrix.create(matrices.depth.size(), CV_32FC1);
 
-        int width = matrices.depth.cols;
-        int height = matrices.depth.rows;
+        const cv::Rect& bounds = matrices.layerBounds;
+        const int startX = bounds.x;
+        const int endX = bounds.x + bounds.width;
+        const int endY = bounds.y + bounds.height;
 
         float* lastIntegralAreaRow = nullptr;
-        for (int y = 0; y < height; y++)
+        for (int y = bounds.y; y < endY; y++)
         {
-            char* segmentationRow = segmentationMatrix.ptr<char>(y);
-            float* areaRow = areaMatrix.ptr<float>(y);
-            float* integralAreaRow = integralAreaMatrix.ptr<float>(y);
+            char* segmentationRow = segmentationMatrix.ptr<char>(y) + startX;
+            float* areaRow = areaMatrix.ptr<float>(y) + startX;
+            float* integralAreaRow = integralAreaMatrix.ptr<float>(y) + startX;
             float* integralAreaRowStart = integralAreaRow;
 
             float leftArea = 0;
             float upLeftArea = 0;
 
-            for (int x = 0; x < width; ++x,
-                                       ++areaRow,
-                                       ++integralAreaRow,
-                                       ++segmentationRow)
+            for (int x = startX; x < endX; ++x,
+                                           ++areaRow,
+                                           ++integralAreaRow,
+                                           ++segmentationRow)
             {
                 float upArea = 0;
                 if (lastIntegralAreaRow != nullptr)
@@ -653,12 +818,12 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
 
     bool test_single_point(TrackingData& data, cv::Point seedPosition)
     {
-        auto matrices = data.matrices;
+        TrackingMatrices& matrices = data.matrices;
 
         auto areaTestSettings = data.settings.areaTestSettings;
         auto circumferenceTestSettings = data.settings.circumferenceTestSettings;
         auto naturalEdgeTestSettings = data.settings.naturalEdgeTestSettings;
-        auto integralArea = matrices.layerIntegralArea;
+        cv::Mat& integralArea = matrices.layerIntegralArea;
 
         TestPhase phase = data.phase;
         TestBehavior outputTestLog = TEST_BEHAVIOR_NONE;
@@ -698,11 +863,11 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
     ForegroundStatus create_test_pass_from_foreground(TrackingData& data)
     {
         PROFILE_FUNC();
-        auto matrices = data.matrices;
+        TrackingMatrices& matrices = data.matrices;
         cv::Mat& segmentationMatrix = matrices.layerSegmentation;
         cv::Mat& testPassMatrix = matrices.layerTestPassMap;
 
-        testPassMatrix = cv::Mat::zeros(segmentationMatrix.size(), CV_8UC1);
+        testPassMatrix.create(segmentationMatrix.size(), CV_8UC1);
 
         int width = matrices.depth.cols;
         int height = matrices.depth.rows;
@@ -711,7 +876,7 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         auto circumferenceTestSettings = data.settings.circumferenceTestSettings;
         auto naturalEdgeTestSettings = data.settings.naturalEdgeTestSettings;
 
-        auto integralArea = matrices.layerIntegralArea;
+        cv::Mat& integralArea = matrices.layerIntegralArea;
 
         TestPhase phase = data.phase;
         TestBehavior outputTestLog = TEST_BEHAVIOR_NONE;
@@ -730,18 +895,32 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
             xskip = 2;
             yskip = 2;
         }
-        const int maxY = height - yskip;
 
-        for (int y = 0; y <= maxY; y += yskip)
+        //foreground only lies within the layer bounds. Stay on the same grid
+        //as a scan of the whole layer so the same pixels are tested.
+        const cv::Rect& bounds = matrices.layerBounds;
+        const int startX = bounds.x - bounds.x % xskip;
+        const int startY = bounds.y - bounds.y % yskip;
+        const int endX = bounds.x + bounds.width;
+        const int maxY = MIN(height - yskip, bounds.y + bounds.height - 1);
+
+        //a downscaled test pass also writes one pixel right and below
+        const cv::Rect writtenBounds(startX,
+                                     startY,
+                                     MIN(width, endX + 1) - startX,
+                                     MIN(height, bounds.y + bounds.height + 1) - startY);
+        clear_plane(testPassMatrix, writtenBounds);
+
+        for (int y = startY; y <= maxY; y += yskip)
         {
-            char* segmentationRow = segmentationMatrix.ptr<char>(y);
-            char* testPassRow = testPassMatrix.ptr<char>(y);
-            char* testPassRowNext = testPassMatrix.ptr<char>(y+1);
-
-            for (int x = 0; x < width; x += xskip,
-                                       segmentationRow += xskip,
-                                       testPassRow += xskip,
-                                       testPassRowNext += xskip)
+            char* segmentationRow = segmentationMatrix.ptr<char>(y) + startX;
+            char* testPassRow = testPassMatrix.ptr<char>(y) + startX;
+            char* testPassRowNext = testPassMatrix.ptr<char>(y+1) + startX;
+
+            for (int x = startX; x < endX; x += xskip,
+                                           segmentationRow += xskip,
+                                           testPassRow += xskip,
+                                           testPassRowNext += xskip)
             {
                 if (*segmentationRow != PixelType::Foreground)
                 {
@@ -792,42 +971,155 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         return status;
     }
 
-    cv::Point track_point_from_seed(TrackingData& data)
+    static void update_debug_layers(TrackingMatrices& matrices)
+    {
+        PROFILE_FUNC();
+        cv::Mat& matScore = matrices.layerScore;
+        const uint8_t layerCount = static_cast<uint8_t>(MIN(255, matrices.layerCount));
+
+        //the layer planes are only written within the layer bounds, plus
+        //the column and row after them for the score and test pass
+        const cv::Rect& bounds = matrices.layerBounds;
+        const int startX = bounds.x;
+        const int endX = MIN(matScore.cols, bounds.x + bounds.width + 1);
+        const int endY = MIN(matScore.rows, bounds.y + bounds.height + 1);
+
+        //tag this layer's foreground and test pass pixels with the layer count
+        //and find the range of the scored pixels for normalization
+        float minScore = 0;
+        float maxScore = 0;
+        bool hasScore = false;
+
+        for (int y = bounds.y; y < endY; y++)
+        {
+            const uint8_t* segmentationRow = matrices.layerSegmentation.ptr<uint8_t>(y);
+            const uint8_t* testPassRow = matrices.layerTestPassMap.ptr<uint8_t>(y);
+            const float* scoreRow = matScore.ptr<float>(y);
+            uint8_t* debugSegmentationRow = matrices.debugSegmentation.ptr<uint8_t>(y);
+            uint8_t* debugTestPassRow = matrices.debugTestPassMap.ptr<uint8_t>(y);
+
+            for (int x = startX; x < endX; ++x)
+            {
+                if (segmentationRow[x] != 0)
+                {
+                    debugSegmentationRow[x] |= layerCount;
+                }
+                if (testPassRow[x] != 0)
+                {
+                    debugTestPassRow[x] |= layerCount;
+                }
+
+                const float score = scoreRow[x];
+                if (score >= 1)
+                {
+                    minScore = hasScore ? MIN(minScore, score) : score;
+                    maxScore = hasScore ? MAX(maxScore, score) : score;
+                    hasScore = true;
+                }
+            }
+        }
+
+        if (!hasScore)
+        {
+            return;
+        }
+
+        //same mapping as cv::normalize with NORM_MINMAX to [0, 1]
+        const double range = static_cast<double>(maxScore) - minScore;
+        const double scale = range > DBL_EPSILON ? 1.0 / range : 0.0;
+        const double shift = -minScore * scale;
+
+        for (int y = bounds.y; y < endY; y++)
+        {
+            const float* scoreRow = matScore.ptr<float>(y);
+            float* scoreValueRow = matrices.debugScoreValue.ptr<float>(y);
+            float* normalizedScoreRow = matrices.debugScore.ptr<float>(y);
+
+            for (int x = startX; x < endX; ++x)
+            {
+                const float score = scoreRow[x];
+                if (score >= 1)
+                {
+                    scoreValueRow[x] = score;
+                    normalizedScoreRow[x] = static_cast<float>(score * scale + shift);
+                }
+            }
+        }
+    }
+
+    //debug layers are recorded by a separate instantiation of the tracking
+    //path so the production instantiation carries no debug branches or writes
+    template<bool DebugLayersEnabled>
+    struct DebugLayerRecorder
+    {
+        static void record(TrackingMatrices&) { }
+    };
+
+    template<>
+    struct DebugLayerRecorder<true>
+    {
+        static void record(TrackingMatrices& matrices)
+        {
+            ++matrices.layerCount;
+
+            update_debug_layers(matrices);
+        }
+    };
+
+    template<bool DebugLayersEnabled>
+    static cv::Point track_point_from_seed_impl(TrackingData& data)
     {
         PROFILE_FUNC();
         cv::Size size = data.matrices.depth.size();
-        data.matrices.layerSegmentation = cv::Mat::zeros(size, CV_8UC1);
-        data.matrices.layerEdgeDistance = cv::Mat::zeros(size, CV_32FC1);
-        data.matrices.layerScore = cv::Mat::zeros(size, CV_32FC1);
-        const bool debugLayersEnabled = data.matrices.debugLayersEnabled;
+        data.matrices.layerEdgeDistance.create(size, CV_32FC1);
+        data.matrices.layerScore.create(size, CV_32FC1);
 
         const float layerAverageDepth = segment_foreground_and_get_average_depth(data);
 
-        if (layerAverageDepth == 0.0f || data.matrices.layerSegmentation.empty())
+        if (layerAverageDepth == 0.0f)
         {
             return INVALID_POINT;
         }
 
+        //every later pass over the layer is limited to the segmented bounds
+        const cv::Rect& bounds = data.matrices.layerBounds;
         cv::Mat& matScore = data.matrices.layerScore;
 
+        //a downscaled test pass also passes the pixels right of and below
+        //each tested pixel, so those need a score as well
+        const cv::Rect scoreBounds(bounds.x,
+                                   bounds.y,
+                                   MIN(size.width - bounds.x, bounds.width + 1),
+                                   MIN(size.height - bounds.y, bounds.height + 1));
+
         calculate_edge_distance(data.matrices.layerSegmentation,
                                 data.matrices.areaSqrt,
                                 data.matrices.layerEdgeDistance,
-                                data.settings.targetEdgeDistance);
+                                data.settings.targetEdgeDistance,
+                                bounds);
 
         calculate_integral_area(data.matrices);
 
-        calculate_layer_score(data, layerAverageDepth);
+        //natural edge tests count edges from the integrals of this layer
+        calculate_integral_edges(data.matrices.layerSegmentation,
+                                 bounds,
+                                 data.matrices.scratch.integralNaturalEdges,
+                                 data.matrices.scratch.integralEdges);
+
+        calculate_layer_score(data, layerAverageDepth, scoreBounds);
 
         double min, max;
         cv::Point minLoc, maxLoc;
 
-        cv::minMaxLoc(matScore, &min, &max, &minLoc, &maxLoc, data.matrices.layerSegmentation);
+        cv::minMaxLoc(matScore(bounds), &min, &max, &minLoc, &maxLoc, data.matrices.layerSegmentation(bounds));
 
         bool foundPoint = maxLoc.x != -1 && maxLoc.y != -1;
 
         if (foundPoint)
         {
+            maxLoc.x += bounds.x;
+            maxLoc.y += bounds.y;
+
             bool passesTests = test_single_point(data, maxLoc);
 
             if (!passesTests)
@@ -842,146 +1134,343 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
                 }
                 else
                 {
-                    cv::minMaxLoc(matScore, &min, &max, &minLoc, &maxLoc, data.matrices.layerTestPassMap);
+                    cv::minMaxLoc(matScore(scoreBounds), &min, &max, &minLoc, &maxLoc, data.matrices.layerTestPassMap(scoreBounds));
+                    maxLoc.x += scoreBounds.x;
+                    maxLoc.y += scoreBounds.y;
                 }
             }
         }
 
-        if (debugLayersEnabled)
+        DebugLayerRecorder<DebugLayersEnabled>::record(data.matrices);
+
+        if (!foundPoint)
         {
-            ++data.matrices.layerCount;
+            return INVALID_POINT;
+        }
 
-            cv::Mat layerCountMat = cv::Mat(size, CV_8UC1, cv::Scalar(data.matrices.layerCount));
+        return maxLoc;
+    }
 
-            cv::bitwise_or(layerCountMat,
-                data.matrices.debugSegmentation,
-                data.matrices.debugSegmentation,
-                data.matrices.layerSegmentation);
+    cv::Point track_point_from_seed(TrackingData& data)
+    {
+        if (data.matrices.debugLayersEnabled)
+        {
+            return track_point_from_seed_impl<true>(data);
+        }
 
-            cv::bitwise_or(layerCountMat,
-                data.matrices.debugTestPassMap,
-                data.matrices.debugTestPassMap,
-                data.matrices.layerTestPassMap);
+        return track_point_from_seed_impl<false>(data);
+    }
 
-            cv::Mat scoreMask;
-            cv::inRange(matScore, 1, INT_MAX, scoreMask);
-            matScore.copyTo(data.matrices.debugScoreValue, scoreMask);
-            cv::normalize(matScore, data.matrices.debugScore, 0, 1, cv::NORM_MINMAX, -1, scoreMask);
+    static int find_blob_root(std::vector<int>& parents, int label)
+    {
+        while (parents[label] != label)
+        {
+            //halve the path on the way up
+            parents[label] = parents[parents[label]];
+            label = parents[label];
         }
+        return label;
+    }
 
-        if (!foundPoint)
+    static void merge_blobs(std::vector<int>& parents, int a, int b)
+    {
+        a = find_blob_root(parents, a);
+        b = find_blob_root(parents, b);
+
+        //the older label wins, so roots stay in raster order
+        if (a < b)
         {
-            return INVALID_POINT;
+            parents[b] = a;
+        }
+        else if (b < a)
+        {
+            parents[a] = b;
         }
-
-        return maxLoc;
     }
 
-    bool find_next_velocity_seed_pixel(cv::Mat& velocitySignalMatrix,
-                                        cv::Mat& searchedMatrix,
-                                        cv::Point& foregroundPosition,
-                                        cv::Point& nextSearchStart)
+    const std::vector<VelocitySeed>& find_velocity_seeds(const cv::Mat& velocitySignalMatrix,
+                                                         VelocitySeedScratch& scratch,
+                                                         int maxSeeds)
     {
         PROFILE_FUNC();
-        assert(velocitySignalMatrix.cols == searchedMatrix.cols);
-        assert(velocitySignalMatrix.rows == searchedMatrix.rows);
-        int width = velocitySignalMatrix.cols;
-        int height = velocitySignalMatrix.rows;
+        typedef VelocitySeedScratch::Run Run;
+
+        std::vector<Run>& runs = scratch.runs;
+        std::vector<int>& parents = scratch.parents;
+        std::vector<int>& blobIndices = scratch.blobIndices;
+        std::vector<VelocitySeed>& seeds = scratch.seeds;
+
+        runs.clear();
+        parents.clear();
+        seeds.clear();
+
+        const int width = velocitySignalMatrix.cols;
+        const int height = velocitySignalMatrix.rows;
 
-        const int startX = MAX(0, MIN(width - 1, nextSearchStart.x));
-        const int startY = MAX(0, MIN(height - 1, nextSearchStart.y));
+        //runs of the previous row, which the current row's runs join
+        size_t previousRowStart = 0;
+        size_t previousRowEnd = 0;
 
-        for (int y = startY; y < height; y++)
+        for (int y = 0; y < height; ++y)
         {
-            for (int x = startX; x < width; x++)
+            const uint8_t* velocityRow = velocitySignalMatrix.ptr<uint8_t>(y);
+            const size_t rowStart = runs.size();
+            size_t previous = previousRowStart;
+
+            int x = 0;
+            while (x < width)
             {
-                uint8_t velocitySignal = *velocitySignalMatrix.ptr<uint8_t>(y, x);
-                uint8_t searched = *searchedMatrix.ptr<uint8_t>(y, x);
-                if (velocitySignal == PixelType::Foreground && searched != PixelType::Searched)
+                if (velocityRow[x] != PixelType::Foreground)
                 {
-                    foregroundPosition.x = x;
-                    foregroundPosition.y = y;
+                    ++x;
+                    continue;
+                }
 
-                    nextSearchStart.x = x + 1;
-                    if (nextSearchStart.x < width)
-                    {
-                        nextSearchStart.y = y;
-                    }
-                    else
-                    {
-                        nextSearchStart.x = 0;
-                        nextSearchStart.y = y + 1;
-                        if (nextSearchStart.y >= height)
-                        {
-                            return false;
-                        }
-                    }
-                    return true;
+                const int startX = x;
+                while (x < width && velocityRow[x] == PixelType::Foreground)
+                {
+                    ++x;
                 }
+
+                const int label = static_cast<int>(parents.size());
+                parents.push_back(label);
+
+                //diagonal neighbours count, so runs touching one column
+                //beyond either end are joined
+                while (previous < previousRowEnd && runs[previous].endX < startX)
+                {
+                    ++previous;
+                }
+                for (size_t p = previous; p < previousRowEnd && runs[p].startX <= x; ++p)
+                {
+                    merge_blobs(parents, runs[p].label, label);
+                }
+
+                Run run;
+                run.y = y;
+                run.startX = startX;
+                run.endX = x;
+                run.label = label;
+                runs.push_back(run);
             }
+
+            previousRowStart = rowStart;
+            previousRowEnd = runs.size();
         }
-        foregroundPosition = segmentation::INVALID_POINT;
-        nextSearchStart.x = width;
-        nextSearchStart.y = height;
-        return false;
+
+        //area and centroid of every blob. Runs are in raster order, so a
+        //blob's first run holds the pixel a row by row scan would reach
+        //first, which is where its seed is placed.
+        blobIndices.assign(parents.size(), -1);
+        for (Run& run : runs)
+        {
+            const int root = find_blob_root(parents, run.label);
+
+            int& blobIndex = blobIndices[root];
+            if (blobIndex < 0)
+            {
+                blobIndex = static_cast<int>(seeds.size());
+                VelocitySeed seed;
+                seed.position = cv::Point(run.startX, run.y);
+                seed.centroid = cv::Point2f(0, 0);
+                seed.area = 0;
+                seeds.push_back(seed);
+            }
+
+            //the centroid holds sums until every run is counted
+            VelocitySeed& seed = seeds[blobIndex];
+            const int length = run.endX - run.startX;
+            seed.area += length;
+            seed.centroid.x += length * (run.startX + run.endX - 1) * 0.5f;
+            seed.centroid.y += length * static_cast<float>(run.y);
+        }
+
+        for (VelocitySeed& seed : seeds)
+        {
+            seed.centroid.x /= seed.area;
+            seed.centroid.y /= seed.area;
+        }
+
+        //equal areas are ranked by seed position, so the order never depends on the sort
+        std::sort(seeds.begin(), seeds.end(),
+                  [](const VelocitySeed& a, const VelocitySeed& b)
+                  {
+                      if (a.area != b.area)
+                      {
+                          return a.area > b.area;
+                      }
+                      if (a.position.y != b.position.y)
+                      {
+                          return a.position.y < b.position.y;
+                      }
+                      return a.position.x < b.position.x;
+                  });
+
+        if (maxSeeds >= 0 && seeds.size() > static_cast<size_t>(maxSeeds))
+        {
+            seeds.resize(maxSeeds);
+        }
+
+        return seeds;
+    }
+
+    //the fewest erosions, at most maxErosions, after which a pixel's edge
+    //distance is past maxEdgeDistance. maxErosions * areaSqrt has to be past it.
+    static int first_erosion_past(const float areaSqrt,
+                                  const float maxEdgeDistance,
+                                  const int maxErosions)
+    {
+        int erosions = 1;
+        if (areaSqrt > 0 && maxEdgeDistance > 0)
+        {
+            erosions = MAX(1, MIN(maxErosions, static_cast<int>(maxEdgeDistance / areaSqrt)));
+        }
+
+        while (erosions > 1 && (erosions - 1) * areaSqrt > maxEdgeDistance)
+        {
+            --erosions;
+        }
+        while (erosions < maxErosions && erosions * areaSqrt <= maxEdgeDistance)
+        {
+            ++erosions;
+        }
+        return erosions;
     }
 
     void calculate_edge_distance(cv::Mat& segmentationMatrix,
                                  cv::Mat& areaSqrtMatrix,
                                  cv::Mat& edgeDistanceMatrix,
-                                 const float maxEdgeDistance)
+                                 const float maxEdgeDistance,
+                                 const cv::Rect& layerBounds)
     {
         PROFILE_FUNC();
-        cv::Mat eroded;
-        cv::Mat crossElement = cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(3, 3));
+        const cv::Size size = segmentationMatrix.size();
+        const int width = size.width;
+        const int height = size.height;
 
-        edgeDistanceMatrix = cv::Mat::zeros(segmentationMatrix.size(), CV_32FC1);
-        cv::Mat ones = cv::Mat::ones(segmentationMatrix.size(), CV_32FC1);
-        segmentationMatrix.copyTo(eroded);
+        //only the layer bounds grown by two pixels are written below
+        edgeDistanceMatrix.create(size, CV_32FC1);
 
-        //close small holes
-        int dilateCount = 1;
-        for (int i = 0; i < dilateCount; i++)
+        if (layerBounds.area() == 0)
         {
-            cv::dilate(eroded, eroded, crossElement);
+            return;
         }
 
-        int nonZeroCount = 0;
-        const int imageLength = eroded.cols * eroded.rows;
-        int iterations = 0;
-        const int maxIterations = segmentationMatrix.cols / 2;
-        bool done;
-        do
+        //closing holes below grows the layer by one pixel, so with two pixels
+        //of margin the window edge is background wherever the image isn't
+        const int x0 = MAX(0, layerBounds.x - 2);
+        const int y0 = MAX(0, layerBounds.y - 2);
+        const int x1 = MIN(width - 1, layerBounds.x + layerBounds.width + 1);
+        const int y1 = MIN(height - 1, layerBounds.y + layerBounds.height + 1);
+
+        //matches the iteration limit of eroding the layer step by step
+        const float maxDistance = static_cast<float>(width / 2 + 1);
+
+        //two-scan city block distance to the nearest background pixel, which
+        //is how many 3x3 cross erosions a pixel survives plus one. Pixels
+        //outside the image are not background, as with cv::erode.
+        for (int y = y0; y <= y1; y++)
         {
-            PROFILE_BEGIN(edge_dist_loop);
-            //erode makes the image smaller
-            cv::erode(eroded, eroded, crossElement);
-            //accumulate the eroded image to the edgeDistance buffer
-            cv::add(areaSqrtMatrix, edgeDistanceMatrix, edgeDistanceMatrix, eroded, CV_32FC1);
+            const uint8_t* segmentationRow = segmentationMatrix.ptr<uint8_t>(y);
+            const uint8_t* upSegmentationRow = y > 0 ? segmentationMatrix.ptr<uint8_t>(y - 1) : nullptr;
+            const uint8_t* downSegmentationRow = y < height - 1 ? segmentationMatrix.ptr<uint8_t>(y + 1) : nullptr;
+            const float* upDistanceRow = y > y0 ? edgeDistanceMatrix.ptr<float>(y - 1) : nullptr;
+            float* distanceRow = edgeDistanceMatrix.ptr<float>(y);
 
-            nonZeroCount = cv::countNonZero(eroded);
-            done = (nonZeroCount == 0);
-            double min, max;
+            for (int x = x0; x <= x1; ++x)
+            {
+                //close small holes with a 3x3 cross dilation
+                const bool isForeground = segmentationRow[x] != 0 ||
+                                          (x > 0 && segmentationRow[x - 1] != 0) ||
+                                          (x < width - 1 && segmentationRow[x + 1] != 0) ||
+                                          (upSegmentationRow != nullptr && upSegmentationRow[x] != 0) ||
+                                          (downSegmentationRow != nullptr && downSegmentationRow[x] != 0);
+
+                if (!isForeground)
+                {
+                    distanceRow[x] = 0;
+                    continue;
+                }
+
+                float distance = maxDistance;
+                if (x > x0)
+                {
+                    distance = MIN(distance, distanceRow[x - 1] + 1);
+                }
+                if (upDistanceRow != nullptr)
+                {
+                    distance = MIN(distance, upDistanceRow[x] + 1);
+                }
+                distanceRow[x] = distance;
+            }
+        }
+
+        //eroding step by step stopped after the first erosion that took any
+        //edge distance past maxEdgeDistance, which caps every pixel at that
+        //many erosions
+        int maxErosions = INT_MAX;
+
+        for (int y = y1; y >= y0; y--)
+        {
+            const float* downDistanceRow = y < y1 ? edgeDistanceMatrix.ptr<float>(y + 1) : nullptr;
+            const float* areaSqrtRow = areaSqrtMatrix.ptr<float>(y);
+            float* distanceRow = edgeDistanceMatrix.ptr<float>(y);
 
-            cv::minMaxLoc(edgeDistanceMatrix, &min, &max);
-            if (max > maxEdgeDistance)
+            for (int x = x1; x >= x0; --x)
             {
-                done = true;
+                float distance = distanceRow[x];
+                if (distance == 0)
+                {
+                    continue;
+                }
+
+                if (x < x1)
+                {
+                    distance = MIN(distance, distanceRow[x + 1] + 1);
+                }
+                if (downDistanceRow != nullptr)
+                {
+                    distance = MIN(distance, downDistanceRow[x] + 1);
+                }
+                distanceRow[x] = distance;
+
+                //only a pixel that is past maxEdgeDistance within both its
+                //own erosions and the current cap can lower the cap
+                const int erosions = MIN(maxErosions, static_cast<int>(distance) - 1);
+                const float areaSqrt = areaSqrtRow[x];
+                if (erosions > 0 && erosions * areaSqrt > maxEdgeDistance)
+                {
+                    maxErosions = first_erosion_past(areaSqrt, maxEdgeDistance, erosions);
+                }
             }
+        }
+
+        //each erosion a pixel survives adds its areaSqrt to its edge distance
+        for (int y = y0; y <= y1; y++)
+        {
+            const float* areaSqrtRow = areaSqrtMatrix.ptr<float>(y);
+            float* edgeDistanceRow = edgeDistanceMatrix.ptr<float>(y);
 
-            PROFILE_END();
-            //nonZeroCount < imageLength guards against segmentation with all 1's, which will never erode
-        } while (!done && nonZeroCount < imageLength && ++iterations < maxIterations);
+            for (int x = x0; x <= x1; ++x)
+            {
+                const int erosions = MIN(maxErosions, static_cast<int>(edgeDistanceRow[x]) - 1);
+                edgeDistanceRow[x] = erosions > 0 ? erosions * areaSqrtRow[x] : 0;
+            }
+        }
     }
 
     void get_circumference_points(cv::Mat& matDepth,
                                   const cv::Point& center,
                                   const float& radius,
                                   const ScalingCoordinateMapper& mapper,
+                                  const CircleOffsetTable& offsets,
                                   std::vector<astra::Vector2i>& points)
     {
         PROFILE_FUNC();
 
+        //clear & reuse capacity across calls
+        points.clear();
+
         int width = matDepth.cols;
         int height = matDepth.rows;
         if (center.x < 0 || center.x >= width ||
@@ -999,44 +1488,19 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
 
         cv::Point offsetRight = mapper.offset_pixel_location_by_mm(center, radius, 0, referenceDepth);
 
-        //http://en.wikipedia.org/wiki/Midpoint_circle_algorithm
         int pixelRadius = offsetRight.x - center.x;
         int cx = center.x;
         int cy = center.y;
 
-        std::vector<astra::Vector2i> offsets;
-        //reserve a slight overestimation of number of points for 1/8 of circumference
-        offsets.reserve(pixelRadius);
-
+        //circles larger than the table lie entirely outside the image
+        if (pixelRadius < 0 || pixelRadius > offsets.max_radius())
         {
-            int dx = pixelRadius; //radius in pixels
-            int dy = 0;
-            int radiusError = 1 - dx;
-
-            while (dx >= dy)
-            {
-                offsets.push_back(Vector2i(dx, dy));
-
-                dy++;
-                if (radiusError < 0)
-                {
-                    radiusError += 2 * dy + 1;
-                }
-                else
-                {
-                    dx--;
-                    radiusError += 2 * (dy - dx) + 1;
-                }
-            }
+            return;
         }
 
-        //PROFILE_BEGIN(circ_checks);
-
-        //clear & reuse capacity across calls
-        points.clear();
-        points.reserve(static_cast<int>(pixelRadius * 2.0f * PI_F));
-
-        int length = offsets.size();
+        //first octant of the circle, entry i is the offset (octant[i], i)
+        const int16_t* octant = offsets.octant(pixelRadius);
+        int length = offsets.octant_length(pixelRadius);
 
         //Order and the permutations of dx,dy are critical here
         //so the points list will contain the points in order
@@ -1044,9 +1508,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = 1; i < length; ++i)
         {
             //dx, dy
-            const astra::Vector2i delta = offsets[i];
-            const int x = cx + delta.x;
-            const int y = cy + delta.y;
+            const int x = cx + octant[i];
+            const int y = cy + i;
 
             if (x >= 0 && x < width &&
                 y >= 0 && y < height)
@@ -1059,10 +1522,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = length-1; i >= 0; --i)
         {
             //dy, dx
-            const astra::Vector2i delta = offsets[i];
-
-            const int dx = delta.x;
-            const int dy = delta.y;
+            const int dx = octant[i];
+            const int dy = i;
             if (dx != dy)
             {
                 const int x = cx + dy;
@@ -1078,9 +1539,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = 1; i < length; ++i)
         {
             //-dy, dx
-            const astra::Vector2i delta = offsets[i];
-            const int x = cx - delta.y;
-            const int y = cy + delta.x;
+            const int x = cx - i;
+            const int y = cy + octant[i];
 
             if (x >= 0 && x < width &&
                 y >= 0 && y < height)
@@ -1092,10 +1552,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = length-1; i >= 0; --i)
         {
             //-dx, dy
-            const astra::Vector2i delta = offsets[i];
-
-            const int dx = delta.x;
-            const int dy = delta.y;
+            const int dx = octant[i];
+            const int dy = i;
             if (dx != dy)
             {
                 const int x = cx - dx;
@@ -1111,9 +1569,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = 1; i < length; ++i)
         {
             //-dx, -dy
-            const astra::Vector2i delta = offsets[i];
-            const int x = cx - delta.x;
-            const int y = cy - delta.y;
+            const int x = cx - octant[i];
+            const int y = cy - i;
 
             if (x >= 0 && x < width &&
                 y >= 0 && y < height)
@@ -1125,10 +1582,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = length-1; i >= 0; --i)
         {
             //-dy, -dx
-            const astra::Vector2i delta = offsets[i];
-
-            const int dx = delta.x;
-            const int dy = delta.y;
+            const int dx = octant[i];
+            const int dy = i;
             if (dx != dy)
             {
                 const int x = cx - dy;
@@ -1144,9 +1599,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = 1; i < length; ++i)
         {
             //dy, -dx
-            const astra::Vector2i delta = offsets[i];
-            const int x = cx + delta.y;
-            const int y = cy - delta.x;
+            const int x = cx + i;
+            const int y = cy - octant[i];
 
             if (x >= 0 && x < width &&
                 y >= 0 && y < height)
@@ -1158,10 +1612,8 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         for (int i = length-1; i >= 0; --i)
         {
             //dx, -dy
-            const astra::Vector2i delta = offsets[i];
-
-            const int dx = delta.x;
-            const int dy = delta.y;
+            const int dx = octant[i];
+            const int dy = i;
             if (dx != dy)
             {
                 const int x = cx + dx;
@@ -1173,7 +1625,6 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
                 }
             }
         }
-        //PROFILE_END();
     }
 
     float get_max_sequential_circumference_percentage(cv::Mat& matDepth,
@@ -1181,6 +1632,7 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
                                                       const cv::Point& center,
                                                       const float& radius,
                                                       const ScalingCoordinateMapper& mapper,
+                                                      const CircleOffsetTable& offsets,
                                                       std::vector<astra::Vector2i>& points)
     {
         PROFILE_FUNC();
@@ -1192,7 +1644,7 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
         bool firstIsForeground = false;
         bool lastIsForeground = false;
 
-        get_circumference_points(matDepth, center, radius, mapper, points);
+        get_circumference_points(matDepth, center, radius, mapper, offsets, points);
 
         for (auto p : points)
         {
@@ -1292,8 +1744,26 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
     }
 
 
+    //integral area at (x, y) when only the bounds of the integral were written
+    static inline float integral_area_at(const cv::Mat& matAreaIntegral,
+                                         const cv::Rect& integralBounds,
+                                         int x,
+                                         int y)
+    {
+        if (integralBounds.area() == 0 || x < integralBounds.x || y < integralBounds.y)
+        {
+            return 0;
+        }
+
+        x = MIN(x, integralBounds.x + integralBounds.width - 1);
+        y = MIN(y, integralBounds.y + integralBounds.height - 1);
+
+        return matAreaIntegral.ptr<float>(y)[x];
+    }
+
     float count_neighborhood_area_integral(cv::Mat& matDepth,
                                            cv::Mat& matAreaIntegral,
+                                           const cv::Rect& integralBounds,
                                            const cv::Point& center,
                                            const float bandwidth,
                                            const ScalingCoordinateMapper& mapper)
@@ -1323,10 +1793,10 @@ namespace astra { namespace plugins { namespace hand { namespace segmentation {
 
         float area = 0;
 
-        area += matAreaIntegral.at<float>(y1, x1);
-        area += matAreaIntegral.at<float>(y0, x0);
-        area -= matAreaIntegral.at<float>(y0, x1);
-        area -= matAreaIntegral.at<float>(y1, x0);
+        area += integral_area_at(matAreaIntegral, integralBounds, x1, y1);
+        area += integral_area_at(matAreaIntegral, integralBounds, x0, y0);
+        area -= integral_area_at(matAreaIntegral, integralBounds, x1, y0);
+        area -= integral_area_at(matAreaIntegral, integralBounds, x0, y1);
 
         return area;
     }
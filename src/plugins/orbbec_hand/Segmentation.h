@@ -50,17 +50,33 @@ namespace astra { namespace plugins { namespace hand {
                                                TestPhase phase,
                                                TestBehavior outputLog);
 
+        //flood fills layerSegmentation outward from the seed within the depth
+        //band of the reference position and returns the filled pixels' average depth
+        float segment_foreground_and_get_average_depth(TrackingData& data);
+
         ForegroundStatus create_test_pass_from_foreground(TrackingData& data);
 
-        bool find_next_velocity_seed_pixel(cv::Mat& foregroundMatrix,
-                                        cv::Mat& searchedMatrix,
-                                        cv::Point& foregroundPosition,
-                                        cv::Point& nextSearchStart);
+        //one seed per 8-connected blob of the velocity signal, at the blob's
+        //first pixel in raster order. Largest blobs come first, at most
+        //maxSeeds of them (all when negative).
+        const std::vector<VelocitySeed>& find_velocity_seeds(const cv::Mat& velocitySignalMatrix,
+                                                             VelocitySeedScratch& scratch,
+                                                             int maxSeeds);
 
+        //areaSqrt summed over the 3x3 cross erosions each pixel of the layer
+        //survives, stopping after the first erosion that takes any pixel past
+        //maxEdgeDistance
         void calculate_edge_distance(cv::Mat& segmentationMatrix,
                                      cv::Mat& areaSqrtMatrix,
                                      cv::Mat& edgeDistanceMatrix,
-                                     const float maxEdgeDistance);
+                                     const float maxEdgeDistance,
+                                     const cv::Rect& layerBounds);
+
+        //scores the pixels within scoreBounds that have a world point, except
+        //those near the edges of the full size frame
+        void calculate_layer_score(TrackingData& data,
+                                   const float layerAverageDepth,
+                                   const cv::Rect& scoreBounds);
 
         float count_neighborhood_area(cv::Mat& matSegmentation,
                                       cv::Mat& matDepth,
@@ -74,6 +90,7 @@ namespace astra { namespace plugins { namespace hand {
 
         float count_neighborhood_area_integral(cv::Mat& matDepth,
                                                cv::Mat& matAreaIntegral,
+                                               const cv::Rect& integralBounds,
                                                const cv::Point& center,
                                                const float bandwidth,
                                                const ScalingCoordinateMapper& mapper);
@@ -86,6 +103,7 @@ namespace astra { namespace plugins { namespace hand {
                                       const cv::Point& center,
                                       const float& radius,
                                       const ScalingCoordinateMapper& mapper,
+                                      const CircleOffsetTable& offsets,
                                       std::vector<astra::Vector2i>& points);
 
         float get_max_sequential_circumference_percentage(cv::Mat& matDepth,
@@ -93,6 +111,7 @@ namespace astra { namespace plugins { namespace hand {
                                                           const cv::Point& center,
                                                           const float& radius,
                                                           const ScalingCoordinateMapper& mapper,
+                                                          const CircleOffsetTable& offsets,
                                                           std::vector<astra::Vector2i>& points);
 
         float get_percent_natural_edges(cv::Mat& matDepth,
@@ -101,6 +120,19 @@ namespace astra { namespace plugins { namespace hand {
                                         const float bandwidth,
                                         const ScalingCoordinateMapper& mapper);
 
+        void calculate_integral_edges(cv::Mat& segmentationMatrix,
+                                      const cv::Rect& layerBounds,
+                                      cv::Mat& integralNaturalEdges,
+                                      cv::Mat& integralEdges);
+
+        float get_percent_natural_edges_integral(cv::Mat& matDepth,
+                                                 cv::Mat& integralNaturalEdges,
+                                                 cv::Mat& integralEdges,
+                                                 const cv::Rect& integralBounds,
+                                                 const cv::Point& center,
+                                                 const float bandwidth,
+                                                 const ScalingCoordinateMapper& mapper);
+
         bool test_natural_edges(TrackingMatrices& matrices,
                                 NaturalEdgeTestSettings& settings,
                                 const cv::Point& targetPoint,
@@ -1,5 +1,7 @@
 #include "../../Astra/vendor/cpptoml.h"
 #include "HandSettings.h"
+#include <sstream>
+#include <sys/stat.h>
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -8,7 +10,12 @@ namespace astra { namespace plugins { namespace hand {
     {
         if (t.contains_qualified(key))
         {
-            return t.get_qualified(key)->as<T>()->get();
+            //a value of the wrong type keeps the default instead of crashing the plugin
+            auto value = t.get_qualified(key)->as<T>();
+            if (value)
+            {
+                return value->get();
+            }
         }
         return defaultValue;
     }
@@ -20,6 +27,11 @@ namespace astra { namespace plugins { namespace hand {
         return static_cast<float>(value);
     }
 
+    bool get_bool_from_table(cpptoml::table& t, std::string key, bool defaultValue)
+    {
+        return get_from_table<bool>(t, key, defaultValue);
+    }
+
     int get_int_from_table(cpptoml::table& t, std::string key, int defaultValue)
     {
         int64_t value = get_from_table<int64_t>(t, key, defaultValue);
@@ -27,10 +39,24 @@ namespace astra { namespace plugins { namespace hand {
         return static_cast<int>(value);
     }
 
-    DepthUtilitySettings parse_depth_utility_settings(cpptoml::table t)
+    HandTrackerInput get_input_from_table(cpptoml::table& t, std::string key, HandTrackerInput defaultValue)
     {
-        DepthUtilitySettings settings;
+        const std::string defaultName = defaultValue == HandTrackerInput::Depth ? "depth" : "points";
+        const std::string name = get_from_table<std::string>(t, key, defaultName);
+
+        if (name == "depth")
+        {
+            return HandTrackerInput::Depth;
+        }
+        if (name == "points")
+        {
+            return HandTrackerInput::Points;
+        }
+        return defaultValue;
+    }
 
+    DepthUtilitySettings parse_depth_utility_settings(cpptoml::table t, DepthUtilitySettings settings)
+    {
         settings.depthSmoothingFactor = get_float_from_table(t, "depthutility.depthSmoothingFactor", settings.depthSmoothingFactor);
         settings.velocityThresholdFactor = get_float_from_table(t, "depthutility.velocityThresholdFactor", settings.velocityThresholdFactor);
         settings.maxDepthJumpPercent = get_float_from_table(t, "depthutility.maxDepthJumpPercent", settings.maxDepthJumpPercent);
@@ -42,10 +68,8 @@ namespace astra { namespace plugins { namespace hand {
         return settings;
     }
 
-    PointProcessorSettings parse_point_processor_settings(cpptoml::table t)
+    PointProcessorSettings parse_point_processor_settings(cpptoml::table t, PointProcessorSettings settings)
     {
-        PointProcessorSettings settings;
-
         settings.maxMatchDistLostActive = get_float_from_table(t, "pointprocessor.maxMatchDistLostActive", settings.maxMatchDistLostActive);
         settings.maxMatchDistDefault = get_float_from_table(t, "pointprocessor.maxMatchDistDefault", settings.maxMatchDistDefault);
         settings.steadyDeadBandRadius = get_float_from_table(t, "pointprocessor.steadyDeadBandRadius", settings.steadyDeadBandRadius);
@@ -61,14 +85,15 @@ namespace astra { namespace plugins { namespace hand {
         settings.secondChanceMinDistance = get_float_from_table(t, "pointprocessor.secondChanceMinDistance", settings.secondChanceMinDistance);
         settings.mergePointDistance = get_float_from_table(t, "pointprocessor.mergePointDistance", settings.mergePointDistance);
         settings.maxHandPointUpdatesPerFrame = get_int_from_table(t, "pointprocessor.maxHandPointUpdatesPerFrame", settings.maxHandPointUpdatesPerFrame);
+        settings.windowUpdateEnabled = get_bool_from_table(t, "pointprocessor.windowUpdateEnabled", settings.windowUpdateEnabled);
+        settings.windowUpdateSize = get_float_from_table(t, "pointprocessor.windowUpdateSize", settings.windowUpdateSize);
+        settings.maxWindowUpdatePixels = get_int_from_table(t, "pointprocessor.maxWindowUpdatePixels", settings.maxWindowUpdatePixels);
 
         return settings;
     }
 
-    TrajectoryAnalyzerSettings parse_trajectory_analyzer_settings(cpptoml::table t)
+    TrajectoryAnalyzerSettings parse_trajectory_analyzer_settings(cpptoml::table t, TrajectoryAnalyzerSettings settings)
     {
-        TrajectoryAnalyzerSettings settings;
-
         settings.maxSteadyDelta = get_float_from_table(t, "trajectoryanalyzer.maxSteadyDelta", settings.maxSteadyDelta);
         settings.minSteadyFrames = get_int_from_table(t, "trajectoryanalyzer.minSteadyFrames", settings.minSteadyFrames);
         settings.minHeadingDist = get_int_from_table(t, "trajectoryanalyzer.minHeadingDist", settings.minHeadingDist);
@@ -81,10 +106,8 @@ namespace astra { namespace plugins { namespace hand {
         return settings;
     }
 
-    AreaTestSettings parse_area_test_settings(cpptoml::table t)
+    AreaTestSettings parse_area_test_settings(cpptoml::table t, AreaTestSettings settings)
     {
-        AreaTestSettings settings;
-
         settings.areaBandwidth = get_float_from_table(t, "areatest.areaBandwidth", settings.areaBandwidth);
         settings.areaBandwidthDepth = get_float_from_table(t, "areatest.areaBandwidthDepth", settings.areaBandwidthDepth);
         settings.minArea = get_float_from_table(t, "areatest.minArea", settings.minArea);
@@ -93,10 +116,8 @@ namespace astra { namespace plugins { namespace hand {
         return settings;
     }
 
-    CircumferenceTestSettings parse_circumference_test_settings(cpptoml::table t)
+    CircumferenceTestSettings parse_circumference_test_settings(cpptoml::table t, CircumferenceTestSettings settings)
     {
-        CircumferenceTestSettings settings;
-
         settings.foregroundRadius1 = get_float_from_table(t, "circumferencetest.foregroundRadius1", settings.foregroundRadius1);
         settings.foregroundRadius2 = get_float_from_table(t, "circumferencetest.foregroundRadius2", settings.foregroundRadius2);
         settings.foregroundRadiusMinPercent1 = get_float_from_table(t, "circumferencetest.foregroundRadiusMinPercent1", settings.foregroundRadiusMinPercent1);
@@ -107,20 +128,16 @@ namespace astra { namespace plugins { namespace hand {
         return settings;
     }
 
-    NaturalEdgeTestSettings parse_natural_edge_test_settings(cpptoml::table t)
+    NaturalEdgeTestSettings parse_natural_edge_test_settings(cpptoml::table t, NaturalEdgeTestSettings settings)
     {
-        NaturalEdgeTestSettings settings;
-
         settings.naturalEdgeBandwidth = get_float_from_table(t, "naturaledgetest.naturalEdgeBandwidth", settings.naturalEdgeBandwidth);
         settings.minPercentNaturalEdges = get_float_from_table(t, "naturaledgetest.minPercentNaturalEdges", settings.minPercentNaturalEdges);
 
         return settings;
     }
 
-    SegmentationSettings parse_segmentation_settings(cpptoml::table t)
+    SegmentationSettings parse_segmentation_settings(cpptoml::table t, SegmentationSettings settings)
     {
-        SegmentationSettings settings;
-
         settings.segmentationBandwidthDepthNear = get_float_from_table(t, "segmentation.segmentationBandwidthDepthNear", settings.segmentationBandwidthDepthNear);
         settings.segmentationBandwidthDepthFar = get_float_from_table(t, "segmentation.segmentationBandwidthDepthFar", settings.segmentationBandwidthDepthFar);
         settings.maxSegmentationDist = get_float_from_table(t, "segmentation.maxSegmentationDist", settings.maxSegmentationDist);
@@ -132,9 +149,36 @@ namespace astra { namespace plugins { namespace hand {
         settings.pointInertiaRadius = get_float_from_table(t, "segmentation.pointInertiaRadius", settings.pointInertiaRadius);
         settings.maxDepthToDownscaleTestPass = get_float_from_table(t, "segmentation.maxDepthToDownscaleTestPass", settings.maxDepthToDownscaleTestPass);
 
-        settings.areaTestSettings = parse_area_test_settings(t);
-        settings.circumferenceTestSettings = parse_circumference_test_settings(t);
-        settings.naturalEdgeTestSettings = parse_natural_edge_test_settings(t);
+        settings.areaTestSettings = parse_area_test_settings(t, settings.areaTestSettings);
+        settings.circumferenceTestSettings = parse_circumference_test_settings(t, settings.circumferenceTestSettings);
+        settings.naturalEdgeTestSettings = parse_natural_edge_test_settings(t, settings.naturalEdgeTestSettings);
+
+        return settings;
+    }
+
+    //keys missing from the table keep their current value
+    HandSettings parse_hand_settings(cpptoml::table t, HandSettings settings)
+    {
+        settings.processingSizeWidth = get_int_from_table(t, "handtracker.processingSizeWidth", settings.processingSizeWidth);
+        settings.processingSizeHeight = get_int_from_table(t, "handtracker.processingSizeHeight", settings.processingSizeHeight);
+        settings.adaptiveProcessingSize = get_bool_from_table(t, "handtracker.adaptiveProcessingSize", settings.adaptiveProcessingSize);
+        settings.coarseProcessingSizeWidth = get_int_from_table(t, "handtracker.coarseProcessingSizeWidth", settings.coarseProcessingSizeWidth);
+        settings.coarseProcessingSizeHeight = get_int_from_table(t, "handtracker.coarseProcessingSizeHeight", settings.coarseProcessingSizeHeight);
+        settings.processingFrameBudget = get_float_from_table(t, "handtracker.processingFrameBudget", settings.processingFrameBudget);
+        settings.watchSettingsFile = get_bool_from_table(t, "handtracker.watchSettingsFile", settings.watchSettingsFile);
+        settings.maxHandCount = get_int_from_table(t, "handtracker.maxHandCount", settings.maxHandCount);
+        settings.padHandFrames = get_bool_from_table(t, "handtracker.padHandFrames", settings.padHandFrames);
+        settings.input = get_input_from_table(t, "handtracker.input", settings.input);
+        settings.inputDepthSubtype = get_int_from_table(t, "handtracker.inputDepthSubtype", settings.inputDepthSubtype);
+
+        PointProcessorSettings& pointProcessorSettings = settings.pointProcessorSettings;
+
+        settings.depthUtilitySettings = parse_depth_utility_settings(t, settings.depthUtilitySettings);
+        pointProcessorSettings = parse_point_processor_settings(t, pointProcessorSettings);
+        pointProcessorSettings.trajectoryAnalyzerSettings =
+            parse_trajectory_analyzer_settings(t, pointProcessorSettings.trajectoryAnalyzerSettings);
+        pointProcessorSettings.segmentationSettings =
+            parse_segmentation_settings(t, pointProcessorSettings.segmentationSettings);
 
         return settings;
     }
@@ -142,26 +186,55 @@ namespace astra { namespace plugins { namespace hand {
     HandSettings parse_settings(std::string path)
     {
         HandSettings settings;
+        parse_settings_file(path, settings);
+        return settings;
+    }
 
+    bool parse_settings_file(const std::string& path, HandSettings& settings)
+    {
         cpptoml::table t;
 
         try
         {
             t = cpptoml::parse_file(path);
         }
-        catch (const cpptoml::parse_exception& e)
+        catch (const cpptoml::parse_exception&)
         {
-            return settings;
+            return false;
         }
 
-        settings.processingSizeWidth = get_int_from_table(t, "handtracker.processingSizeWidth", settings.processingSizeWidth);
-        settings.processingSizeHeight = get_int_from_table(t, "handtracker.processingSizeHeight", settings.processingSizeHeight);
+        settings = parse_hand_settings(t, HandSettings());
+        return true;
+    }
 
-        settings.depthUtilitySettings = parse_depth_utility_settings(t);
-        settings.pointProcessorSettings = parse_point_processor_settings(t);
-        settings.pointProcessorSettings.trajectoryAnalyzerSettings = parse_trajectory_analyzer_settings(t);
-        settings.pointProcessorSettings.segmentationSettings = parse_segmentation_settings(t);
+    bool update_settings(const std::string& text, HandSettings& settings)
+    {
+        std::istringstream stream(text);
+        cpptoml::parser parser(stream);
+        cpptoml::table t;
 
-        return settings;
+        try
+        {
+            t = parser.parse();
+        }
+        catch (const cpptoml::parse_exception&)
+        {
+            return false;
+        }
+
+        settings = parse_hand_settings(t, settings);
+        return true;
+    }
+
+    bool get_settings_file_time(const std::string& path, int64_t& modifiedTime)
+    {
+        struct stat fileStatus;
+        if (stat(path.c_str(), &fileStatus) != 0)
+        {
+            return false;
+        }
+
+        modifiedTime = static_cast<int64_t>(fileStatus.st_mtime);
+        return true;
     }
 }}}
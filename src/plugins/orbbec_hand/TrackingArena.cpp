@@ -0,0 +1,324 @@
+#include "TrackingArena.h"
+#include <Shiny.h>
+#include <cmath>
+#include <cstdlib>
+
+namespace astra { namespace plugins { namespace hand {
+
+    void SegmentationScratch::allocate(const cv::Size& size)
+    {
+        const int pixelCount = size.width * size.height;
+
+        visited.allocate(size);
+        pointQueue.reserve(pixelCount + 1);
+
+        //a circle wider than the image diagonal has no points inside it
+        const int diagonal = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(size.width * size.width + size.height * size.height))));
+        circleOffsets.allocate(diagonal);
+        circlePoints.reserve(4 * (size.width + size.height));
+
+        integralNaturalEdges.create(size.height + 1, size.width + 1, CV_32SC1);
+        integralEdges.create(size.height + 1, size.width + 1, CV_32SC1);
+    }
+
+    void PointGrid::begin(float cellSize)
+    {
+        assert(cellSize > 0);
+        m_cellSize = cellSize;
+        m_added.clear();
+        m_entries.clear();
+    }
+
+    void PointGrid::add(size_t index, const cv::Point3f& position)
+    {
+        assert(m_added.empty() || m_added.back().index < index);
+
+        Entry entry;
+        entry.cellX = cell_of(position.x);
+        entry.cellY = cell_of(position.y);
+        entry.cellZ = cell_of(position.z);
+        entry.index = index;
+        m_added.push_back(entry);
+    }
+
+    void PointGrid::finish()
+    {
+        //about two buckets per point keeps collisions between cells rare
+        size_t bucketCount = 8;
+        while (bucketCount < 2 * m_added.size())
+        {
+            bucketCount *= 2;
+        }
+        m_bucketMask = bucketCount - 1;
+
+        m_bucketStarts.assign(bucketCount + 1, 0);
+        for (const Entry& entry : m_added)
+        {
+            ++m_bucketStarts[bucket_of(entry.cellX, entry.cellY, entry.cellZ) + 1];
+        }
+
+        for (size_t i = 1; i <= bucketCount; ++i)
+        {
+            m_bucketStarts[i] += m_bucketStarts[i - 1];
+        }
+
+        //filling in index order keeps each bucket sorted by index
+        m_bucketFill.assign(m_bucketStarts.begin(), m_bucketStarts.end() - 1);
+        m_entries.resize(m_added.size());
+        for (const Entry& entry : m_added)
+        {
+            int& fill = m_bucketFill[bucket_of(entry.cellX, entry.cellY, entry.cellZ)];
+            m_entries[fill] = entry;
+            ++fill;
+        }
+    }
+
+    void PointGrid::find_near(const cv::Point3f& position, std::vector<size_t>& indices) const
+    {
+        indices.clear();
+        if (m_entries.empty())
+        {
+            return;
+        }
+
+        const int cellX = cell_of(position.x);
+        const int cellY = cell_of(position.y);
+        const int cellZ = cell_of(position.z);
+
+        //neighboring cells may share a bucket, visit each bucket once
+        size_t buckets[27];
+        size_t bucketCount = 0;
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    buckets[bucketCount] = bucket_of(cellX + dx, cellY + dy, cellZ + dz);
+                    ++bucketCount;
+                }
+            }
+        }
+        std::sort(buckets, buckets + bucketCount);
+        bucketCount = std::unique(buckets, buckets + bucketCount) - buckets;
+
+        for (size_t i = 0; i < bucketCount; ++i)
+        {
+            const int end = m_bucketStarts[buckets[i] + 1];
+            for (int e = m_bucketStarts[buckets[i]]; e < end; ++e)
+            {
+                const Entry& entry = m_entries[e];
+                if (std::abs(entry.cellX - cellX) <= 1 &&
+                    std::abs(entry.cellY - cellY) <= 1 &&
+                    std::abs(entry.cellZ - cellZ) <= 1)
+                {
+                    indices.push_back(entry.index);
+                }
+            }
+        }
+
+        std::sort(indices.begin(), indices.end());
+    }
+
+    int PointGrid::cell_of(float coordinate) const
+    {
+        return static_cast<int>(std::floor(coordinate / m_cellSize));
+    }
+
+    size_t PointGrid::bucket_of(int cellX, int cellY, int cellZ) const
+    {
+        const uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^
+                              static_cast<uint32_t>(cellY) * 19349663u ^
+                              static_cast<uint32_t>(cellZ) * 83492791u;
+        return hash & m_bucketMask;
+    }
+
+    void CircleOffsetTable::allocate(int maxRadius)
+    {
+        if (maxRadius == max_radius())
+        {
+            return;
+        }
+
+        m_dx.clear();
+        m_starts.clear();
+        m_starts.reserve(maxRadius + 2);
+
+        //http://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+        for (int radius = 0; radius <= maxRadius; ++radius)
+        {
+            m_starts.push_back(static_cast<int>(m_dx.size()));
+
+            int dx = radius;
+            int dy = 0;
+            int radiusError = 1 - dx;
+
+            while (dx >= dy)
+            {
+                m_dx.push_back(static_cast<int16_t>(dx));
+
+                dy++;
+                if (radiusError < 0)
+                {
+                    radiusError += 2 * dy + 1;
+                }
+                else
+                {
+                    dx--;
+                    radiusError += 2 * (dy - dx) + 1;
+                }
+            }
+        }
+        m_starts.push_back(static_cast<int>(m_dx.size()));
+    }
+
+    void LayerWorkspace::begin_frame(const cv::Size& size)
+    {
+        if (size != foregroundSearched.size())
+        {
+            PROFILE_BLOCK(allocate_workspace);
+            foregroundSearched.create(size, CV_8UC1);
+            layerSegmentation.create(size, CV_8UC1);
+            layerScore.create(size, CV_32FC1);
+            layerEdgeDistance.create(size, CV_32FC1);
+            layerIntegralArea.create(size, CV_32FC1);
+            layerTestPassMap.create(size, CV_8UC1);
+            scratch.allocate(size);
+        }
+
+        clear_plane(foregroundSearched);
+    }
+
+    void WindowWorkspace::begin_window(const cv::Size& size)
+    {
+        if (size != depth.size())
+        {
+            PROFILE_BLOCK(allocate_window);
+            depth.create(size, CV_32FC1);
+            area.create(size, CV_32FC1);
+            areaSqrt.create(size, CV_32FC1);
+            velocitySignal = cv::Mat::zeros(size, CV_8UC1);
+            worldPoints.resize(size.area());
+        }
+
+        layers.begin_frame(size);
+    }
+
+    void TrackingArena::begin_frame(const cv::Size& size, bool debugLayersEnabled)
+    {
+        PROFILE_FUNC();
+        if (size != m_size || layerSegmentation.empty())
+        {
+            allocate(size);
+        }
+
+        clear_plane(depthWindow);
+        clear_plane(layerSegmentation);
+        clear_plane(layerScore);
+        clear_plane(layerEdgeDistance);
+        clear_plane(layerTestPassMap);
+        clear_plane(updateForegroundSearched);
+        clear_plane(createForegroundSearched);
+        clear_plane(refineForegroundSearched);
+        clear_plane(refineSegmentation);
+        clear_plane(refineScore);
+        clear_plane(refineEdgeDistance);
+
+        if (!debugLayersEnabled)
+        {
+            release_debug_planes();
+            return;
+        }
+
+        if (debugUpdateSegmentation.empty())
+        {
+            allocate_debug_planes();
+        }
+
+        clear_plane(debugUpdateSegmentation);
+        clear_plane(debugCreateSegmentation);
+        clear_plane(debugRefineSegmentation);
+        clear_plane(debugUpdateScore);
+        clear_plane(debugCreateScore);
+        clear_plane(debugRefineScore);
+        clear_plane(debugUpdateScoreValue);
+        clear_plane(debugCreateScoreValue);
+        clear_plane(debugRefineScoreValue);
+        clear_plane(debugUpdateTestPassMap);
+        clear_plane(debugCreateTestPassMap);
+        clear_plane(debugRefineTestPassMap);
+    }
+
+    void TrackingArena::allocate(const cv::Size& size)
+    {
+        PROFILE_FUNC();
+        m_size = size;
+
+        depthWindow.create(size, CV_32FC1);
+        //area planes are fully rewritten by each area calculation
+        area = cv::Mat::zeros(size, CV_32FC1);
+        areaSqrt = cv::Mat::zeros(size, CV_32FC1);
+
+        layerSegmentation.create(size, CV_8UC1);
+        layerScore.create(size, CV_32FC1);
+        layerEdgeDistance.create(size, CV_32FC1);
+        layerIntegralArea = cv::Mat::zeros(size, CV_32FC1);
+        layerTestPassMap.create(size, CV_8UC1);
+
+        updateForegroundSearched.create(size, CV_8UC1);
+        createForegroundSearched.create(size, CV_8UC1);
+        refineForegroundSearched.create(size, CV_8UC1);
+        refineSegmentation.create(size, CV_8UC1);
+        refineScore.create(size, CV_32FC1);
+        refineEdgeDistance.create(size, CV_32FC1);
+
+        if (!debugUpdateSegmentation.empty())
+        {
+            allocate_debug_planes();
+        }
+
+        const int pixelCount = size.width * size.height;
+        worldPoints.resize(pixelCount);
+
+        scratch.allocate(size);
+    }
+
+    void TrackingArena::allocate_debug_planes()
+    {
+        PROFILE_FUNC();
+        debugUpdateSegmentation.create(m_size, CV_8UC1);
+        debugCreateSegmentation.create(m_size, CV_8UC1);
+        debugRefineSegmentation.create(m_size, CV_8UC1);
+        debugUpdateScore.create(m_size, CV_32FC1);
+        debugCreateScore.create(m_size, CV_32FC1);
+        debugRefineScore.create(m_size, CV_32FC1);
+        debugUpdateScoreValue.create(m_size, CV_32FC1);
+        debugCreateScoreValue.create(m_size, CV_32FC1);
+        debugRefineScoreValue.create(m_size, CV_32FC1);
+        debugUpdateTestPassMap.create(m_size, CV_8UC1);
+        debugCreateTestPassMap.create(m_size, CV_8UC1);
+        debugRefineTestPassMap.create(m_size, CV_8UC1);
+    }
+
+    void TrackingArena::release_debug_planes()
+    {
+        if (debugUpdateSegmentation.empty())
+        {
+            return;
+        }
+
+        debugUpdateSegmentation.release();
+        debugCreateSegmentation.release();
+        debugRefineSegmentation.release();
+        debugUpdateScore.release();
+        debugCreateScore.release();
+        debugRefineScore.release();
+        debugUpdateScoreValue.release();
+        debugCreateScoreValue.release();
+        debugRefineScoreValue.release();
+        debugUpdateTestPassMap.release();
+        debugCreateTestPassMap.release();
+        debugRefineTestPassMap.release();
+    }
+
+}}}
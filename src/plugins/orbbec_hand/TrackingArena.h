@@ -0,0 +1,340 @@
+#ifndef TRACKINGARENA_H
+#define TRACKINGARENA_H
+
+#include <opencv2/core/core.hpp>
+#include <AstraUL/AstraUL.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace astra { namespace plugins { namespace hand {
+
+    struct PointTTL
+    {
+        int x;
+        int y;
+        float ttl;
+
+        PointTTL() :
+            x(0),
+            y(0),
+            ttl(0)
+        { }
+
+        PointTTL(int x, int y, float ttl) :
+            x(x),
+            y(y),
+            ttl(ttl)
+        { }
+    };
+
+    // FIFO over storage that is only ever grown. A flood fill marks pixels as
+    // visited before enqueueing them, so one entry per pixel (plus the seed)
+    // is always enough and push never allocates.
+    class PointQueue
+    {
+    public:
+        void reserve(size_t capacity)
+        {
+            if (m_points.size() < capacity)
+            {
+                m_points.resize(capacity);
+            }
+            clear();
+        }
+
+        void clear()
+        {
+            m_head = 0;
+            m_tail = 0;
+        }
+
+        bool empty() const { return m_head == m_tail; }
+
+        void push(const PointTTL& point)
+        {
+            assert(m_tail < m_points.size());
+            m_points[m_tail] = point;
+            ++m_tail;
+        }
+
+        const PointTTL& front() const { return m_points[m_head]; }
+
+        void pop() { ++m_head; }
+
+    private:
+        std::vector<PointTTL> m_points;
+        size_t m_head{ 0 };
+        size_t m_tail{ 0 };
+    };
+
+    // Marks the pixels reached by the current flood fill. Starting a fill
+    // bumps the generation instead of clearing the map, so only a generation
+    // wrap ever touches the whole map.
+    class VisitedMap
+    {
+    public:
+        void allocate(const cv::Size& size)
+        {
+            m_width = size.width;
+            m_height = size.height;
+            m_stamps.assign(size.width * size.height, 0);
+            m_generation = 0;
+        }
+
+        void begin_fill()
+        {
+            ++m_generation;
+            if (m_generation == 0)
+            {
+                std::fill(m_stamps.begin(), m_stamps.end(), 0);
+                m_generation = 1;
+            }
+        }
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
+        bool is_visited(int index) const { return m_stamps[index] == m_generation; }
+
+        // marks the pixel and returns true if it was not visited yet
+        bool visit(int index)
+        {
+            uint16_t& stamp = m_stamps[index];
+            if (stamp == m_generation)
+            {
+                return false;
+            }
+            stamp = m_generation;
+            return true;
+        }
+
+    private:
+        std::vector<uint16_t> m_stamps;
+        uint16_t m_generation{ 0 };
+        int m_width{ 0 };
+        int m_height{ 0 };
+    };
+
+    // First octant of the midpoint circle for every pixel radius up to a
+    // maximum, built once so circumference tests only have to mirror it.
+    // Entry i of a radius' octant is the offset (dx, i).
+    class CircleOffsetTable
+    {
+    public:
+        void allocate(int maxRadius);
+
+        int max_radius() const { return static_cast<int>(m_starts.size()) - 2; }
+
+        int octant_length(int radius) const { return m_starts[radius + 1] - m_starts[radius]; }
+        const int16_t* octant(int radius) const { return m_dx.data() + m_starts[radius]; }
+
+    private:
+        std::vector<int16_t> m_dx;
+        std::vector<int> m_starts;
+    };
+
+    // temporaries reused by every segmentation layer within a frame
+    struct SegmentationScratch
+    {
+        VisitedMap visited;
+        PointQueue pointQueue;
+        CircleOffsetTable circleOffsets;
+        std::vector<astra::Vector2i> circlePoints;
+        //padded by one row and column so window sums need no edge cases
+        cv::Mat integralNaturalEdges;
+        cv::Mat integralEdges;
+
+        void allocate(const cv::Size& size);
+    };
+
+    // A connected blob of the velocity signal and the pixel of it a new
+    // point is segmented from
+    struct VelocitySeed
+    {
+        cv::Point position;
+        cv::Point2f centroid;
+        int area;
+    };
+
+    // Storage for labeling the velocity signal's blobs by runs of foreground
+    // pixels. It is only ever grown, so labeling makes no allocations once
+    // it has seen a busy frame.
+    struct VelocitySeedScratch
+    {
+        struct Run
+        {
+            int y;
+            int startX;
+            int endX;
+            int label;
+        };
+
+        std::vector<Run> runs;
+        //union find over run labels, every run starts as its own blob
+        std::vector<int> parents;
+        std::vector<int> blobIndices;
+        std::vector<VelocitySeed> seeds;
+    };
+
+    // Buckets tracked points by the world space cell they are in, so the
+    // points near a position are found without looking at every point.
+    // Cells hash into a power of two number of buckets sized for the point
+    // count, and a counting sort lays the buckets out in storage that is
+    // only ever grown.
+    class PointGrid
+    {
+    public:
+        // starts a new grid, cellSize has to be positive and at least the
+        // largest distance that will be looked for
+        void begin(float cellSize);
+
+        // points have to be added in increasing index order
+        void add(size_t index, const cv::Point3f& position);
+
+        void finish();
+
+        bool empty() const { return m_entries.empty(); }
+
+        // the indices, in increasing order, of the points in the cells
+        // around position: every point closer than the cell size and
+        // possibly some a little further away
+        void find_near(const cv::Point3f& position, std::vector<size_t>& indices) const;
+
+    private:
+        struct Entry
+        {
+            int cellX;
+            int cellY;
+            int cellZ;
+            size_t index;
+        };
+
+        int cell_of(float coordinate) const;
+        size_t bucket_of(int cellX, int cellY, int cellZ) const;
+
+        float m_cellSize{ 1.0f };
+        size_t m_bucketMask{ 0 };
+        std::vector<Entry> m_added;
+        std::vector<Entry> m_entries;
+        //entries of bucket b are [m_bucketStarts[b], m_bucketStarts[b + 1])
+        std::vector<int> m_bucketStarts;
+        std::vector<int> m_bucketFill;
+    };
+
+    // The layer planes one worker needs to segment a point independently of
+    // the points other workers are segmenting at the same time.
+    struct LayerWorkspace
+    {
+        cv::Mat foregroundSearched;
+        cv::Mat layerSegmentation;
+        cv::Mat layerScore;
+        cv::Mat layerEdgeDistance;
+        cv::Mat layerIntegralArea;
+        cv::Mat layerTestPassMap;
+        SegmentationScratch scratch;
+
+        // allocates on a size change and clears the searched plane, which
+        // is the only plane merged back after the workers finish
+        void begin_frame(const cv::Size& size);
+    };
+
+    // The planes for updating a point from a window of the full size depth
+    // frame. Window sizes are rounded up so they only change in steps as the
+    // point moves in depth, which keeps reallocations rare.
+    struct WindowWorkspace
+    {
+        cv::Mat depth;
+        cv::Mat area;
+        cv::Mat areaSqrt;
+        //windows are segmented ignoring velocity, so this stays empty
+        cv::Mat velocitySignal;
+        std::vector<astra::Vector3f> worldPoints;
+        LayerWorkspace layers;
+
+        void begin_window(const cv::Size& size);
+    };
+
+    inline void clear_plane(cv::Mat& plane)
+    {
+        if (plane.isContinuous())
+        {
+            memset(plane.data, 0, plane.total() * plane.elemSize());
+        }
+        else
+        {
+            plane.setTo(cv::Scalar::all(0));
+        }
+    }
+
+    inline void clear_plane(cv::Mat& plane, const cv::Rect& region)
+    {
+        const size_t rowLength = region.width * plane.elemSize();
+        for (int y = region.y; y < region.y + region.height; ++y)
+        {
+            memset(plane.ptr<uint8_t>(y) + region.x * plane.elemSize(), 0, rowLength);
+        }
+    }
+
+    // Owns every plane the TrackingPipeline stages work on. Planes are
+    // allocated once per processing size and cleared in place afterwards, so
+    // a frame at a stable size makes no heap allocations.
+    class TrackingArena
+    {
+    public:
+        // (re)allocates on the first frame or a size change, then clears the
+        // planes that are accumulated into during a frame. Debug planes only
+        // exist while debug layers are enabled and are released otherwise.
+        void begin_frame(const cv::Size& size, bool debugLayersEnabled);
+
+        const cv::Size& size() const { return m_size; }
+
+        cv::Mat depthWindow;
+        cv::Mat area;
+        cv::Mat areaSqrt;
+
+        cv::Mat layerSegmentation;
+        cv::Mat layerScore;
+        cv::Mat layerEdgeDistance;
+        cv::Mat layerIntegralArea;
+        cv::Mat layerTestPassMap;
+
+        cv::Mat updateForegroundSearched;
+        cv::Mat createForegroundSearched;
+        cv::Mat refineForegroundSearched;
+        cv::Mat refineSegmentation;
+        cv::Mat refineScore;
+        cv::Mat refineEdgeDistance;
+
+        //empty unless debug layers are enabled
+        cv::Mat debugUpdateSegmentation;
+        cv::Mat debugCreateSegmentation;
+        cv::Mat debugRefineSegmentation;
+        cv::Mat debugUpdateScore;
+        cv::Mat debugCreateScore;
+        cv::Mat debugRefineScore;
+        cv::Mat debugUpdateScoreValue;
+        cv::Mat debugCreateScoreValue;
+        cv::Mat debugRefineScoreValue;
+        cv::Mat debugUpdateTestPassMap;
+        cv::Mat debugCreateTestPassMap;
+        cv::Mat debugRefineTestPassMap;
+
+        std::vector<astra::Vector3f> worldPoints;
+
+        SegmentationScratch scratch;
+        VelocitySeedScratch velocitySeeds;
+
+    private:
+        void allocate(const cv::Size& size);
+        void allocate_debug_planes();
+        void release_debug_planes();
+
+        cv::Size m_size;
+    };
+
+}}}
+
+#endif // TRACKINGARENA_H
@@ -4,6 +4,7 @@
 #include <opencv2/core/core.hpp>
 #include "ScalingCoordinateMapper.h"
 #include "HandSettings.h"
+#include "TrackingArena.h"
 
 namespace astra { namespace plugins { namespace hand {
 
@@ -68,7 +69,8 @@ namespace astra { namespace plugins { namespace hand {
 
     struct TrackingMatrices
     {
-        cv::Mat& depthFullSize;
+        //size of the frame fullSizeWorldPoints holds, its z is the full size depth
+        const cv::Size fullSize;
         cv::Mat& depth;
         cv::Mat& area;
         cv::Mat& areaSqrt;
@@ -88,11 +90,19 @@ namespace astra { namespace plugins { namespace hand {
         astra::Vector3f* worldPoints;
         bool debugLayersEnabled;
         int layerCount;
+        //pixels written to layerSegmentation by the last segmentation. The
+        //other layer planes are only written within (or just around) them.
+        cv::Rect layerBounds;
+        //set when the depth plane is a window of the full size frame rather
+        //than the whole frame downscaled: where the window starts in the full
+        //size frame and the stride it samples it at
+        cv::Point windowOffset;
+        int windowStride;
         const astra::CoordinateMapper& fullSizeMapper;
         const conversion_cache_t depthToWorldData;
-        std::vector<astra::Vector2i> layerCirclePoints;
+        SegmentationScratch& scratch;
 
-        TrackingMatrices(cv::Mat& depthFullSize,
+        TrackingMatrices(const cv::Size& fullSize,
                          cv::Mat& depth,
                          cv::Mat& area,
                          cv::Mat& areaSqrt,
@@ -112,9 +122,10 @@ namespace astra { namespace plugins { namespace hand {
                          astra::Vector3f* worldPoints,
                          bool debugLayersEnabled,
                          const astra::CoordinateMapper& fullSizeMapper,
-                         const conversion_cache_t depthToWorldData)
+                         const conversion_cache_t depthToWorldData,
+                         SegmentationScratch& scratch)
             :
-            depthFullSize(depthFullSize),
+            fullSize(fullSize),
             depth(depth),
             area(area),
             areaSqrt(areaSqrt),
@@ -134,14 +145,30 @@ namespace astra { namespace plugins { namespace hand {
             worldPoints(worldPoints),
             debugLayersEnabled(debugLayersEnabled),
             layerCount(0),
+            layerBounds(),
+            windowOffset(),
+            windowStride(0),
             fullSizeMapper(fullSizeMapper),
-            depthToWorldData(depthToWorldData)
+            depthToWorldData(depthToWorldData),
+            scratch(scratch)
             { }
+
+        //offset must be a multiple of stride
+        void set_window(const cv::Point& offset, int stride)
+        {
+            windowOffset = offset;
+            windowStride = stride;
+        }
     };
 
     inline float get_resize_factor(TrackingMatrices& matrices)
     {
-        float resizeFactor = matrices.depthFullSize.cols / static_cast<float>(matrices.depth.cols);
+        if (matrices.windowStride > 0)
+        {
+            return matrices.windowStride;
+        }
+
+        float resizeFactor = matrices.fullSize.width / static_cast<float>(matrices.depth.cols);
 
         return resizeFactor;
     }
@@ -150,7 +177,10 @@ namespace astra { namespace plugins { namespace hand {
     {
         const float resizeFactor = get_resize_factor(matrices);
 
-        return ScalingCoordinateMapper(matrices.depthToWorldData, resizeFactor);
+        return ScalingCoordinateMapper(matrices.depthToWorldData,
+                                       resizeFactor,
+                                       matrices.windowOffset.x / resizeFactor,
+                                       matrices.windowOffset.y / resizeFactor);
     }
 
     struct TrackingData
@@ -0,0 +1,129 @@
+#include "TrackingPipeline.h"
+#include "Segmentation.h"
+#include <Shiny.h>
+
+namespace astra { namespace plugins { namespace hand {
+
+    TrackingPipeline::TrackingPipeline(PointProcessor& pointProcessor, const PointProcessorSettings& settings)
+        : m_pointProcessor(pointProcessor),
+          m_settings(settings)
+    { }
+
+    void TrackingPipeline::update_points(const TrackingFrame& frame)
+    {
+        PROFILE_FUNC();
+
+        m_arena.begin_frame(frame.depth.size(), frame.debugLayersEnabled);
+
+        TrackingMatrices updateMatrices(frame.fullSize,
+                                        frame.depth,
+                                        m_arena.area,
+                                        m_arena.areaSqrt,
+                                        frame.velocitySignal,
+                                        m_arena.updateForegroundSearched,
+                                        m_arena.layerSegmentation,
+                                        m_arena.layerScore,
+                                        m_arena.layerEdgeDistance,
+                                        m_arena.layerIntegralArea,
+                                        m_arena.layerTestPassMap,
+                                        m_arena.debugUpdateSegmentation,
+                                        m_arena.debugUpdateScore,
+                                        m_arena.debugUpdateScoreValue,
+                                        m_arena.debugUpdateTestPassMap,
+                                        frame.enableTestPassMap,
+                                        frame.fullSizeWorldPoints,
+                                        m_arena.worldPoints.data(),
+                                        frame.debugLayersEnabled,
+                                        frame.fullSizeMapper,
+                                        frame.depthToWorldData,
+                                        m_arena.scratch);
+
+        if (frame.updateCommonCalculations)
+        {
+            m_pointProcessor.initialize_common_calculations(updateMatrices);
+        }
+
+        //Update existing points first so that if we lose a point, we might recover it in the "add new" stage below
+        //without having at least one frame of a lost point.
+
+        m_pointProcessor.updateTrackedPoints(updateMatrices);
+
+        m_pointProcessor.removeDuplicatePoints();
+    }
+
+    TrackingMatrices TrackingPipeline::make_create_matrices(const TrackingFrame& frame)
+    {
+        return TrackingMatrices(frame.fullSize,
+                                frame.depth,
+                                m_arena.area,
+                                m_arena.areaSqrt,
+                                frame.velocitySignal,
+                                m_arena.createForegroundSearched,
+                                m_arena.layerSegmentation,
+                                m_arena.layerScore,
+                                m_arena.layerEdgeDistance,
+                                m_arena.layerIntegralArea,
+                                m_arena.layerTestPassMap,
+                                m_arena.debugCreateSegmentation,
+                                m_arena.debugCreateScore,
+                                m_arena.debugCreateScoreValue,
+                                m_arena.debugCreateTestPassMap,
+                                frame.enableTestPassMap,
+                                frame.fullSizeWorldPoints,
+                                m_arena.worldPoints.data(),
+                                frame.debugLayersEnabled,
+                                frame.fullSizeMapper,
+                                frame.depthToWorldData,
+                                m_arena.scratch);
+    }
+
+    void TrackingPipeline::create_points_from_seeds(TrackingMatrices& createMatrices)
+    {
+        PROFILE_FUNC();
+
+        const std::vector<VelocitySeed>& seeds =
+            segmentation::find_velocity_seeds(createMatrices.velocitySignal,
+                                              m_arena.velocitySeeds,
+                                              m_settings.maxHandPointUpdatesPerFrame);
+
+        for (const VelocitySeed& seed : seeds)
+        {
+            if (createMatrices.foregroundSearched.at<uint8_t>(seed.position) != PixelType::Searched)
+            {
+                m_pointProcessor.updateTrackedPointOrCreateNewPointFromSeedPosition(createMatrices, seed.position);
+            }
+        }
+    }
+
+    void TrackingPipeline::refine_points(const TrackingFrame& frame)
+    {
+        PROFILE_FUNC();
+
+        //the refinement is never drawn in the debug layers
+        TrackingMatrices refinementMatrices(frame.fullSize,
+                                            m_arena.depthWindow,
+                                            m_arena.area,
+                                            m_arena.areaSqrt,
+                                            frame.velocitySignal,
+                                            m_arena.refineForegroundSearched,
+                                            m_arena.refineSegmentation,
+                                            m_arena.refineScore,
+                                            m_arena.refineEdgeDistance,
+                                            m_arena.layerIntegralArea,
+                                            m_arena.layerTestPassMap,
+                                            m_arena.debugRefineSegmentation,
+                                            m_arena.debugRefineScore,
+                                            m_arena.debugRefineScoreValue,
+                                            m_arena.debugRefineTestPassMap,
+                                            frame.enableTestPassMap,
+                                            frame.fullSizeWorldPoints,
+                                            m_arena.worldPoints.data(),
+                                            false,
+                                            frame.fullSizeMapper,
+                                            frame.depthToWorldData,
+                                            m_arena.scratch);
+
+        m_pointProcessor.update_full_resolution_points(refinementMatrices);
+    }
+
+}}}
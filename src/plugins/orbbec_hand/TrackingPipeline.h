@@ -0,0 +1,125 @@
+#ifndef TRACKINGPIPELINE_H
+#define TRACKINGPIPELINE_H
+
+#include <opencv2/core/core.hpp>
+#include <AstraUL/AstraUL.h>
+#include "TrackingData.h"
+#include "TrackingArena.h"
+#include "PointProcessor.h"
+#include "HandSettings.h"
+#include <chrono>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // One frame's input to the tracking stages: the processing size depth
+    // and velocity signal, and the full size frame's world points
+    struct TrackingFrame
+    {
+        TrackingFrame(cv::Mat& depth,
+                      cv::Mat& velocitySignal,
+                      const cv::Size& fullSize,
+                      const Vector3f* fullSizeWorldPoints,
+                      const CoordinateMapper& fullSizeMapper,
+                      const conversion_cache_t& depthToWorldData)
+            : depth(depth),
+              velocitySignal(velocitySignal),
+              fullSize(fullSize),
+              fullSizeWorldPoints(fullSizeWorldPoints),
+              fullSizeMapper(fullSizeMapper),
+              depthToWorldData(depthToWorldData)
+        { }
+
+        cv::Mat& depth;
+        cv::Mat& velocitySignal;
+        const cv::Size fullSize;
+        const Vector3f* fullSizeWorldPoints;
+        const CoordinateMapper& fullSizeMapper;
+        const conversion_cache_t depthToWorldData;
+
+        bool debugLayersEnabled{ false };
+        bool enableTestPassMap{ false };
+        //off while the input is paused, the area planes are kept from the
+        //last frame that was processed
+        bool updateCommonCalculations{ true };
+    };
+
+    // How long each stage took on the last frame tracked
+    struct TrackingStageTimes
+    {
+        using duration = std::chrono::duration<double, std::milli>;
+
+        duration update{ 0 };
+        duration create{ 0 };
+        duration refine{ 0 };
+        duration trajectories{ 0 };
+    };
+
+    // The stages HandTracker runs on every frame once it has the velocity
+    // signal: update the tracked points, create points from velocity seeds,
+    // refine the points at full resolution and analyze their trajectories.
+    // The pipeline owns the planes the stages work on.
+    class TrackingPipeline
+    {
+    public:
+        TrackingPipeline(PointProcessor& pointProcessor, const PointProcessorSettings& settings);
+
+        void track(const TrackingFrame& frame)
+        {
+            track(frame, [this](TrackingMatrices& createMatrices) { create_points_from_seeds(createMatrices); });
+        }
+
+        // Runs the stages with createPoints(TrackingMatrices&) in place of
+        // creating points from the velocity seeds
+        template<typename TCreatePoints>
+        void track(const TrackingFrame& frame, TCreatePoints&& createPoints)
+        {
+            using clock = std::chrono::steady_clock;
+
+            auto stageStart = clock::now();
+
+            update_points(frame);
+
+            auto updateEnd = clock::now();
+
+            TrackingMatrices createMatrices = make_create_matrices(frame);
+            createPoints(createMatrices);
+            m_pointProcessor.removeOldOrDeadPoints();
+
+            auto createEnd = clock::now();
+
+            refine_points(frame);
+
+            auto refineEnd = clock::now();
+
+            m_pointProcessor.update_trajectories();
+
+            auto trajectoriesEnd = clock::now();
+
+            m_stageTimes.update = updateEnd - stageStart;
+            m_stageTimes.create = createEnd - updateEnd;
+            m_stageTimes.refine = refineEnd - createEnd;
+            m_stageTimes.trajectories = trajectoriesEnd - refineEnd;
+        }
+
+        // one seed per moving blob, largest first. A blob an earlier seed's
+        // segmentation already reached is skipped.
+        void create_points_from_seeds(TrackingMatrices& createMatrices);
+
+        TrackingArena& arena() { return m_arena; }
+
+        const TrackingStageTimes& stage_times() const { return m_stageTimes; }
+
+    private:
+        void update_points(const TrackingFrame& frame);
+        TrackingMatrices make_create_matrices(const TrackingFrame& frame);
+        void refine_points(const TrackingFrame& frame);
+
+        PointProcessor& m_pointProcessor;
+        const PointProcessorSettings& m_settings;
+        TrackingArena m_arena;
+        TrackingStageTimes m_stageTimes;
+    };
+
+}}}
+
+#endif // TRACKINGPIPELINE_H
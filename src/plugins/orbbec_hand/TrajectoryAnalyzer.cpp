@@ -67,7 +67,7 @@ namespace astra { namespace plugins { namespace hand {
         m_isTrackingHeading = false;
     }
 
-    void TrajectoryAnalyzer::update(TrackedPoint& point)
+    void TrajectoryAnalyzer::update(TrackedPoint& point, std::vector<GestureEvent>& events)
     {
         if (point.trackingId != m_trackingId)
         {
@@ -119,6 +119,7 @@ namespace astra { namespace plugins { namespace hand {
                             m_isInflecting = true;
                             m_framesSinceInflection = 0;
                             ++m_numWaveInflections;
+                            add_event(point, InflectionGesture, events);
                             if (!m_isWaveGesture)
                             {
                                 LOG_INFO("TrajectoryAnalyzer", "Wave count %d for point #%d", m_numWaveInflections, m_trackingId);
@@ -126,6 +127,7 @@ namespace astra { namespace plugins { namespace hand {
                                 {
                                     LOG_INFO("TrajectoryAnalyzer", "Wave gesture detected for point #%d", m_trackingId);
                                     m_isWaveGesture = true;
+                                    add_event(point, WaveGesture, events);
                                 }
                             }
                         }
@@ -159,6 +161,7 @@ namespace astra { namespace plugins { namespace hand {
                 m_pointSteady = true;
 
                 LOG_INFO("TrajectoryAnalyzer", "Steady gesture detected for point #%d", m_trackingId);
+                add_event(point, SteadyGesture, events);
 
                 if (m_isWaveGesture)
                 {
@@ -173,6 +176,15 @@ namespace astra { namespace plugins { namespace hand {
         }
     }
 
+    void TrajectoryAnalyzer::add_event(const TrackedPoint& point, GestureType type, std::vector<GestureEvent>& events)
+    {
+        GestureEvent event;
+        event.trackingId = m_trackingId;
+        event.type = type;
+        event.worldPosition = point.fullSizeWorldPosition;
+        events.push_back(event);
+    }
+
     float TrajectoryAnalyzer::get_delta_angle(float x, float y)
     {
         float radians = std::atan2(y, x);
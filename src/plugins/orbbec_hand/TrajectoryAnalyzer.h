@@ -4,15 +4,33 @@
 #include "TrackedPoint.h"
 #include "HandSettings.h"
 #include <Astra/Plugins/PluginLogger.h>
+#include <vector>
 
 namespace astra { namespace plugins { namespace hand {
 
+    enum GestureType
+    {
+        WaveGesture,
+        SteadyGesture,
+        InflectionGesture
+    };
+
+    // A gesture recognized on a point's trajectory, reported on the frame it
+    // is first recognized.
+    struct GestureEvent
+    {
+        int trackingId;
+        GestureType type;
+        cv::Point3f worldPosition;
+    };
+
     class TrajectoryAnalyzer
     {
     public:
         TrajectoryAnalyzer(int trackingId, TrajectoryAnalyzerSettings& settings);
         ~TrajectoryAnalyzer();
-        void update(TrackedPoint& point);
+        //appends the gestures recognized on this update to events
+        void update(TrackedPoint& point, std::vector<GestureEvent>& events);
 
         void reset_wave();
         void set_for_next_inflection();
@@ -26,6 +44,7 @@ namespace astra { namespace plugins { namespace hand {
 
     private:
 
+        void add_event(const TrackedPoint& point, GestureType type, std::vector<GestureEvent>& events);
         float get_delta_angle(float x, float y);
         bool is_valid_heading_dist(const cv::Point3f& currentWorldPosition);
         float get_degree_difference(cv::Point3f& v1, cv::Point3f& v2);
@@ -0,0 +1,293 @@
+#include "depth_sequence.h"
+#include "../ScalingCoordinateMapper.h"
+#include "../constants.h"
+#include <AstraUL/Plugins/stream_types.h>
+#include <common/serialization/FrameStreamReader.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace astra { namespace plugins { namespace hand {
+
+    namespace {
+
+        //the body's half width and the height of its shoulders
+        const float BODY_HALF_WIDTH = 250.0f;
+        const float BODY_TOP = 250.0f;
+
+        conversion_cache_t make_conversion_cache(int width, int height, float horizontalFov, float verticalFov)
+        {
+            conversion_cache_t cache;
+            cache.xzFactor = std::tan(horizontalFov / 2) * 2;
+            cache.yzFactor = std::tan(verticalFov / 2) * 2;
+            cache.resolutionX = width;
+            cache.resolutionY = height;
+            cache.halfResX = width / 2;
+            cache.halfResY = height / 2;
+            cache.coeffX = width / cache.xzFactor;
+            cache.coeffY = height / cache.yzFactor;
+            return cache;
+        }
+    }
+
+    SyntheticScene::SyntheticScene(int width, int height, const SyntheticSceneLayout& layout)
+        : m_width(width),
+          m_height(height),
+          m_layout(layout),
+          m_conversionCache(make_conversion_cache(width, height, layout.horizontalFov, layout.verticalFov))
+    { }
+
+    bool SyntheticScene::in_hand(const SyntheticHand& hand, const cv::Point3f& world, bool& inPalm) const
+    {
+        const float dx = world.x - hand.position.x;
+        const float dy = world.y - hand.position.y;
+        inPalm = dx * dx + dy * dy < m_layout.palmRadius * m_layout.palmRadius;
+        const bool inArm = std::fabs(dx) < m_layout.armHalfWidth &&
+                           dy < 0 &&
+                           (m_layout.armLength <= 0 || dy > -m_layout.armLength);
+        return inPalm || inArm;
+    }
+
+    void SyntheticScene::render(const std::vector<SyntheticHand>& hands,
+                                std::vector<int16_t>& frame,
+                                std::vector<uint8_t>* palmMask) const
+    {
+        frame.resize(m_width * m_height);
+        if (palmMask != nullptr)
+        {
+            palmMask->resize(m_width * m_height);
+        }
+
+        for (int y = 0; y < m_height; ++y)
+        {
+            for (int x = 0; x < m_width; ++x)
+            {
+                float depth = m_layout.wallDepth;
+                bool isPalm = false;
+
+                if (m_layout.bodyDepth > 0)
+                {
+                    cv::Point3f bodyWorld = cv_convert_depth_to_world(m_conversionCache, x, y, m_layout.bodyDepth);
+                    if (std::fabs(bodyWorld.x) < BODY_HALF_WIDTH && bodyWorld.y < BODY_TOP)
+                    {
+                        depth = m_layout.bodyDepth;
+                    }
+                }
+
+                for (const SyntheticHand& hand : hands)
+                {
+                    if (!hand.visible || hand.position.z >= depth)
+                    {
+                        continue;
+                    }
+
+                    cv::Point3f world = cv_convert_depth_to_world(m_conversionCache, x, y, hand.position.z);
+                    bool inPalm;
+                    if (in_hand(hand, world, inPalm))
+                    {
+                        depth = hand.position.z;
+                        isPalm = inPalm;
+                    }
+                }
+
+                const int index = x + y * m_width;
+                frame[index] = static_cast<int16_t>(depth);
+                if (palmMask != nullptr)
+                {
+                    (*palmMask)[index] = isPalm ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    bool script_hands(const std::string& script,
+                      int frame,
+                      int frameCount,
+                      std::vector<SyntheticHand>& hands)
+    {
+        hands.clear();
+        const float t = frame / static_cast<float>(frameCount);
+
+        if (script == "wave")
+        {
+            //raise the hand, then wave side to side
+            const float raise = std::min(1.0f, frame / 15.0f);
+            SyntheticHand hand;
+            hand.position = cv::Point3f(150.0f * std::sin(frame * 2 * PI_F / 24),
+                                        -350.0f + 450.0f * raise,
+                                        1300.0f);
+            hands.push_back(hand);
+        }
+        else if (script == "two_hands")
+        {
+            //two hands circling at different depths, out of phase
+            for (int i = 0; i < 2; ++i)
+            {
+                const float angle = t * 4 * PI_F + i * PI_F;
+                SyntheticHand hand;
+                hand.position = cv::Point3f((i == 0 ? -250.0f : 250.0f) + 90.0f * std::cos(angle),
+                                            80.0f + 90.0f * std::sin(angle),
+                                            1100.0f + 300.0f * i);
+                hands.push_back(hand);
+            }
+        }
+        else if (script == "enter_exit")
+        {
+            //rise into view, wave, then drop back out of view
+            const float enterEnd = 0.2f;
+            const float waveEnd = 0.65f;
+
+            SyntheticHand hand;
+            hand.position = cv::Point3f(-200.0f, 100.0f, 1500.0f);
+
+            if (t < enterEnd)
+            {
+                hand.position.y = -900.0f + 1000.0f * (t / enterEnd);
+            }
+            else if (t < waveEnd)
+            {
+                hand.position.x += 150.0f * std::sin((t - enterEnd) * frameCount * 2 * PI_F / 24);
+            }
+            else
+            {
+                hand.position.y -= 1000.0f * (t - waveEnd) / (1 - waveEnd);
+            }
+            hands.push_back(hand);
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    void sway_hands(int handCount, int frame, std::vector<SyntheticHand>& hands)
+    {
+        const float handSpacing = 300.0f;
+        const float handY = 50.0f;
+
+        hands.resize(handCount);
+        for (int i = 0; i < handCount; ++i)
+        {
+            SyntheticHand& hand = hands[i];
+            hand.position = cv::Point3f((i - (handCount - 1) / 2.0f) * handSpacing +
+                                        20.0f * std::sin(frame * 0.2f + i),
+                                        handY,
+                                        1000.0f + 100.0f * i);
+            hand.visible = true;
+        }
+    }
+
+    bool render_scripted_sequence(const std::string& script,
+                                  int width,
+                                  int height,
+                                  int frameCount,
+                                  DepthSequence& sequence)
+    {
+        std::vector<SyntheticHand> hands;
+        if (!script_hands(script, 0, frameCount, hands))
+        {
+            return false;
+        }
+
+        SyntheticScene scene(width, height);
+
+        sequence.width = width;
+        sequence.height = height;
+        sequence.conversionCache = scene.conversion_cache();
+        sequence.frames.resize(frameCount);
+
+        for (int i = 0; i < frameCount; ++i)
+        {
+            script_hands(script, i, frameCount, hands);
+            scene.render(hands, sequence.frames[i]);
+        }
+
+        return true;
+    }
+
+    bool load_recorded_sequence(const std::string& path, DepthSequence& sequence)
+    {
+        std::unique_ptr<serialization::FrameInputStream> stream;
+        try
+        {
+            stream.reset(serialization::open_frame_input_stream(path.c_str()));
+        }
+        catch (serialization::ResourceNotFoundException&)
+        {
+            return false;
+        }
+
+        serialization::StreamHeader* streamHeader = nullptr;
+        if (!stream->read_stream_header(streamHeader))
+        {
+            return false;
+        }
+
+        //recordings can hold other streams next to the depth stream
+        int depthStreamId = -1;
+        for (int streamId = 0; streamId < stream->get_stream_count(); ++streamId)
+        {
+            if (stream->get_stream_header(streamId, streamHeader) &&
+                streamHeader->frameType == ASTRA_STREAM_DEPTH)
+            {
+                depthStreamId = streamId;
+                break;
+            }
+        }
+
+        if (depthStreamId < 0)
+        {
+            return false;
+        }
+
+        const bool hasConversionCache = streamHeader->hasConversionCache;
+        const conversion_cache_t recordedConversionCache = streamHeader->conversionCache;
+
+        sequence.frames.clear();
+
+        serialization::FrameDescription* frameDescription = nullptr;
+        serialization::Frame* frame = nullptr;
+        while (!stream->is_end_of_file() &&
+               stream->read_frame_description(frameDescription) &&
+               stream->read_frame(frame))
+        {
+            if (frame->streamId != depthStreamId)
+            {
+                continue;
+            }
+
+            //the frame holds the whole image frame wrapper, pixels after the header
+            const astra_imageframe_wrapper_t* wrapper =
+                static_cast<const astra_imageframe_wrapper_t*>(frame->rawFrameWrapper);
+            const int width = wrapper->frame.metadata.width;
+            const int height = wrapper->frame.metadata.height;
+            const size_t pixelBytes = width * height * sizeof(int16_t);
+
+            if (frame->byteLength < static_cast<int>(sizeof(astra_imageframe_wrapper_t) + pixelBytes) ||
+                (!sequence.frames.empty() && (width != sequence.width || height != sequence.height)))
+            {
+                return false;
+            }
+
+            sequence.width = width;
+            sequence.height = height;
+
+            const int16_t* pixels = reinterpret_cast<const int16_t*>(wrapper->frame_data);
+            sequence.frames.push_back(std::vector<int16_t>(pixels, pixels + width * height));
+        }
+
+        stream->close();
+
+        //older recordings don't keep the depth stream's conversion cache
+        sequence.conversionCache = hasConversionCache
+            ? recordedConversionCache
+            : make_conversion_cache(sequence.width,
+                                    sequence.height,
+                                    PLAYER_HORIZONTAL_FOV,
+                                    PLAYER_VERTICAL_FOV);
+        return !sequence.frames.empty();
+    }
+
+}}}
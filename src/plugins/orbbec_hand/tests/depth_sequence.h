@@ -0,0 +1,106 @@
+#ifndef DEPTH_SEQUENCE_H
+#define DEPTH_SEQUENCE_H
+
+#include <opencv2/core/core.hpp>
+#include <AstraUL/streams/depth_types.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // Raw depth frames, as the depth stream delivers them, with the
+    // conversion cache to turn them into world points.
+    struct DepthSequence
+    {
+        std::string name;
+        int width{ 0 };
+        int height{ 0 };
+        conversion_cache_t conversionCache;
+        std::vector<std::vector<int16_t>> frames;
+    };
+
+    //radians, the field of view the stream player reports for recordings
+    //without a conversion cache
+    const float PLAYER_HORIZONTAL_FOV = 1.02259994f;
+    const float PLAYER_VERTICAL_FOV = 0.796615660f;
+
+    // A palm with a forearm reaching down from it, at the palm's world position
+    struct SyntheticHand
+    {
+        cv::Point3f position;
+        bool visible{ true };
+    };
+
+    // What synthetic scenes look like apart from the hands
+    struct SyntheticSceneLayout
+    {
+        //radians
+        float horizontalFov{ PLAYER_HORIZONTAL_FOV };
+        float verticalFov{ PLAYER_VERTICAL_FOV };
+
+        float wallDepth{ 3000.0f };
+        //a body in the middle of the room, none when 0
+        float bodyDepth{ 1900.0f };
+
+        float palmRadius{ 45.0f };
+        float armHalfWidth{ 35.0f };
+        //arms reach out of the image when 0
+        float armLength{ 450.0f };
+    };
+
+    // Renders hands in front of a wall into depth frames, as the depth
+    // stream delivers them. Both the scripted sequences and the tracking
+    // harness' scenes are rendered by it.
+    class SyntheticScene
+    {
+    public:
+        SyntheticScene(int width, int height, const SyntheticSceneLayout& layout = SyntheticSceneLayout());
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        const conversion_cache_t& conversion_cache() const { return m_conversionCache; }
+
+        // the frame is resized to the scene. Pixels of the palms in front
+        // are set in palmMask when it is given.
+        void render(const std::vector<SyntheticHand>& hands,
+                    std::vector<int16_t>& frame,
+                    std::vector<uint8_t>* palmMask = nullptr) const;
+
+    private:
+        bool in_hand(const SyntheticHand& hand, const cv::Point3f& world, bool& inPalm) const;
+
+        int m_width;
+        int m_height;
+        SyntheticSceneLayout m_layout;
+        conversion_cache_t m_conversionCache;
+    };
+
+    // Places the hands of one of the scripted scenes, "wave", "two_hands"
+    // or "enter_exit", at a frame of the sequence. Returns false for an
+    // unknown script.
+    bool script_hands(const std::string& script,
+                      int frame,
+                      int frameCount,
+                      std::vector<SyntheticHand>& hands);
+
+    // Places handCount hands side by side at slightly different depths,
+    // each swaying sideways a few centimeters from frame to frame
+    void sway_hands(int handCount, int frame, std::vector<SyntheticHand>& hands);
+
+    // Renders one of the scripted scenes: "wave", "two_hands" or
+    // "enter_exit". Returns false for an unknown script.
+    bool render_scripted_sequence(const std::string& script,
+                                  int width,
+                                  int height,
+                                  int frameCount,
+                                  DepthSequence& sequence);
+
+    // Loads the depth stream of a recording written by the StreamRecorder
+    // sample. Recordings without the depth stream's conversion cache get the
+    // stream player's field of view.
+    bool load_recorded_sequence(const std::string& path, DepthSequence& sequence);
+
+}}}
+
+#endif // DEPTH_SEQUENCE_H
@@ -0,0 +1,333 @@
+#include "catch.hpp"
+#include "../DepthUtility.h"
+#include "../TrackingData.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // The velocity pipeline as it was before it was fused into one pass: a
+    // separate pass per stage over processing size planes. Kept as the
+    // reference the fused pass is checked against.
+    class ReferenceVelocityPipeline
+    {
+    public:
+        ReferenceVelocityPipeline(int width, int height, const DepthUtilitySettings& settings)
+            : m_width(width),
+              m_height(height),
+              m_settings(settings)
+        {
+            m_rectElement = cv::getStructuringElement(cv::MORPH_RECT,
+                                                      cv::Size(settings.erodeSize * 2 + 1, settings.erodeSize * 2 + 1),
+                                                      cv::Point(settings.erodeSize, settings.erodeSize));
+            m_filled = cv::Mat::zeros(height, width, CV_32FC1);
+            m_filledMask = cv::Mat::zeros(height, width, CV_8UC1);
+            m_previous = cv::Mat::zeros(height, width, CV_32FC1);
+            m_avg = cv::Mat::zeros(height, width, CV_32FC1);
+            m_vel.create(height, width, CV_32FC1);
+            m_velErode.create(height, width, CV_32FC1);
+        }
+
+        void process(const int16_t* depthData, int sourceWidth, int sourceHeight)
+        {
+            cv::Mat fullSize(sourceHeight, sourceWidth, CV_32FC1);
+            for (int y = 0; y < sourceHeight; ++y)
+            {
+                for (int x = 0; x < sourceWidth; ++x)
+                {
+                    fullSize.at<float>(y, x) = depthData[x + y * sourceWidth];
+                }
+            }
+
+            m_depth.create(m_height, m_width, CV_32FC1);
+            cv::resize(fullSize, m_depth, m_depth.size(), 0, 0, CV_INTER_NN);
+
+            m_signal = cv::Mat::zeros(m_height, m_width, CV_8UC1);
+
+            for (int y = 0; y < m_height; ++y)
+            {
+                for (int x = 0; x < m_width; ++x)
+                {
+                    float depth = m_depth.at<float>(y, x);
+                    const bool isFilled = depth == 0;
+                    if (isFilled)
+                    {
+                        depth = m_previous.at<float>(y, x);
+                    }
+                    m_filledMask.at<uint8_t>(y, x) = isFilled ? 1 : 0;
+                    m_filled.at<float>(y, x) = depth;
+                }
+            }
+
+            //cv::accumulateWeighted
+            const float alpha = m_settings.depthSmoothingFactor;
+            const float beta = 1.0f - alpha;
+            for (int y = 0; y < m_height; ++y)
+            {
+                for (int x = 0; x < m_width; ++x)
+                {
+                    float& avg = m_avg.at<float>(y, x);
+                    avg = m_filled.at<float>(y, x) * alpha + avg * beta;
+                }
+            }
+
+            for (int y = 0; y < m_height; ++y)
+            {
+                for (int x = 0; x < m_width; ++x)
+                {
+                    const float depth = m_filled.at<float>(y, x);
+                    float& previousDepth = m_previous.at<float>(y, x);
+
+                    const float deltaPercent = (depth - previousDepth) / previousDepth;
+                    const bool isZeroDepth = (0 == depth || 0 == previousDepth);
+                    const bool isFilled = m_filledMask.at<uint8_t>(y, x) == 1;
+                    const bool isJumpingAway = std::fabs(deltaPercent) > m_settings.maxDepthJumpPercent && deltaPercent > 0;
+
+                    if (isZeroDepth || isFilled || isJumpingAway)
+                    {
+                        m_avg.at<float>(y, x) = depth;
+                    }
+
+                    previousDepth = depth;
+                }
+            }
+
+            //(filled - avg) / avg, where cv::divide yields 0 for a 0 divisor
+            for (int y = 0; y < m_height; ++y)
+            {
+                for (int x = 0; x < m_width; ++x)
+                {
+                    const float avg = m_avg.at<float>(y, x);
+                    const float difference = m_filled.at<float>(y, x) - avg;
+                    m_vel.at<float>(y, x) = avg != 0 ? difference / avg : 0.0f;
+                }
+            }
+
+            if (m_settings.depthAdjustmentFactor != 0)
+            {
+                for (int y = 0; y < m_height; ++y)
+                {
+                    for (int x = 0; x < m_width; ++x)
+                    {
+                        const float depth = m_depth.at<float>(y, x);
+                        if (depth != 0.0f)
+                        {
+                            float& vel = m_vel.at<float>(y, x);
+                            if (depth > m_settings.minDepth && depth < m_settings.maxDepth)
+                            {
+                                vel /= (depth / 1000.0f) * m_settings.depthAdjustmentFactor;
+                            }
+                            else
+                            {
+                                vel = 0;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (int y = 0; y < m_height; ++y)
+            {
+                for (int x = 0; x < m_width; ++x)
+                {
+                    m_velErode.at<float>(y, x) = std::fabs(m_vel.at<float>(y, x));
+                }
+            }
+
+            cv::erode(m_velErode, m_velErode, m_rectElement);
+
+            for (int y = 0; y < m_height; ++y)
+            {
+                for (int x = 0; x < m_width; ++x)
+                {
+                    const bool isMoving = m_velErode.at<float>(y, x) > m_settings.velocityThresholdFactor;
+                    m_signal.at<uint8_t>(y, x) = isMoving ? PixelType::Foreground : PixelType::Background;
+                }
+            }
+        }
+
+        const cv::Mat& depth() const { return m_depth; }
+        const cv::Mat& filled() const { return m_filled; }
+        const cv::Mat& avg() const { return m_avg; }
+        const cv::Mat& vel() const { return m_vel; }
+        const cv::Mat& vel_erode() const { return m_velErode; }
+        const cv::Mat& signal() const { return m_signal; }
+
+    private:
+        int m_width;
+        int m_height;
+        DepthUtilitySettings m_settings;
+        cv::Mat m_rectElement;
+        cv::Mat m_depth;
+        cv::Mat m_filled;
+        cv::Mat m_filledMask;
+        cv::Mat m_previous;
+        cv::Mat m_avg;
+        cv::Mat m_vel;
+        cv::Mat m_velErode;
+        cv::Mat m_signal;
+    };
+
+    // A wall with a hand sized block sweeping across it, sensor holes and
+    // pixels out of the tracked depth range.
+    void render_depth_frame(std::vector<int16_t>& frame, int width, int height, int frameIndex)
+    {
+        frame.resize(width * height);
+        const int blockSize = width / 6;
+        const int blockX = (frameIndex * width / 40) % (width - blockSize);
+        const int blockY = height / 3;
+        unsigned state = 7919 * (frameIndex + 1);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                int16_t depth = static_cast<int16_t>(2500 + (x + y) % 37);
+
+                const bool inBlock = x >= blockX && x < blockX + blockSize &&
+                                     y >= blockY && y < blockY + blockSize;
+                if (inBlock)
+                {
+                    depth = static_cast<int16_t>(1000 + frameIndex * 3);
+                }
+
+                if (x < width / 16)
+                {
+                    //beyond the tracked range
+                    depth = 5000;
+                }
+
+                state = state * 1103515245 + 12345;
+                if ((state >> 16) % 23 == 0)
+                {
+                    depth = 0;
+                }
+
+                frame[x + y * width] = depth;
+            }
+        }
+    }
+
+    bool planes_identical(const cv::Mat& a, const cv::Mat& b)
+    {
+        if (a.size() != b.size() || a.type() != b.type())
+        {
+            return false;
+        }
+
+        for (int y = 0; y < a.rows; ++y)
+        {
+            if (memcmp(a.ptr<uint8_t>(y), b.ptr<uint8_t>(y), a.cols * a.elemSize()) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void require_fused_pipeline_matches_reference(int sourceWidth, int sourceHeight, int erodeSize = 1)
+    {
+        const int processingWidth = 160;
+        const int processingHeight = 120;
+
+        DepthUtilitySettings settings;
+        settings.erodeSize = erodeSize;
+        DepthUtility depthUtility(processingWidth, processingHeight, settings);
+        ReferenceVelocityPipeline reference(processingWidth, processingHeight, settings);
+
+        cv::Mat matDepth;
+        cv::Mat matVelocitySignal;
+        std::vector<int16_t> frame;
+
+        size_t foregroundCount = 0;
+        for (int frameIndex = 0; frameIndex < 30; ++frameIndex)
+        {
+            render_depth_frame(frame, sourceWidth, sourceHeight, frameIndex);
+
+            depthUtility.processDepthToVelocitySignal(frame.data(),
+                                                      sourceWidth,
+                                                      sourceHeight,
+                                                      matDepth,
+                                                      matVelocitySignal);
+            reference.process(frame.data(), sourceWidth, sourceHeight);
+
+            REQUIRE(planes_identical(matDepth, reference.depth()));
+            REQUIRE(planes_identical(depthUtility.matDepthFilled(), reference.filled()));
+            REQUIRE(planes_identical(depthUtility.matDepthAvg(), reference.avg()));
+            REQUIRE(planes_identical(depthUtility.matDepthVel(), reference.vel()));
+            REQUIRE(planes_identical(depthUtility.matDepthVelErode(), reference.vel_erode()));
+            REQUIRE(planes_identical(matVelocitySignal, reference.signal()));
+
+            for (int y = 0; y < matVelocitySignal.rows; ++y)
+            {
+                for (int x = 0; x < matVelocitySignal.cols; ++x)
+                {
+                    if (matVelocitySignal.at<uint8_t>(y, x) == PixelType::Foreground)
+                    {
+                        ++foregroundCount;
+                    }
+                }
+            }
+        }
+
+        //the moving block has to show up for the comparison to mean anything
+        REQUIRE(foregroundCount > 0);
+    }
+}}}
+
+using namespace astra::plugins::hand;
+
+TEST_CASE("Fused velocity pass matches the per stage pipeline when downscaling", "[hand][depth]")
+{
+    require_fused_pipeline_matches_reference(640, 480);
+}
+
+TEST_CASE("Fused velocity pass matches the per stage pipeline at processing size", "[hand][depth]")
+{
+    require_fused_pipeline_matches_reference(160, 120);
+}
+
+TEST_CASE("Fused velocity pass matches the per stage pipeline for uneven scales", "[hand][depth]")
+{
+    require_fused_pipeline_matches_reference(320, 200);
+}
+
+TEST_CASE("Fused velocity pass matches the per stage pipeline for other erode sizes", "[hand][depth]")
+{
+    require_fused_pipeline_matches_reference(640, 480, 0);
+    require_fused_pipeline_matches_reference(640, 480, 3);
+}
+
+TEST_CASE("Point frames give the same velocity signal as their depth frames", "[hand][depth]")
+{
+    const int sourceWidth = 640;
+    const int sourceHeight = 480;
+
+    DepthUtilitySettings settings;
+    DepthUtility fromDepth(160, 120, settings);
+    DepthUtility fromPoints(160, 120, settings);
+
+    cv::Mat depthPlane, depthSignal;
+    cv::Mat pointsPlane, pointsSignal;
+    std::vector<int16_t> frame;
+    std::vector<astra::Vector3f> points(sourceWidth * sourceHeight);
+
+    for (int frameIndex = 0; frameIndex < 30; ++frameIndex)
+    {
+        render_depth_frame(frame, sourceWidth, sourceHeight, frameIndex);
+
+        //only z is read, x and y are left as they were
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+            points[i].z = frame[i];
+        }
+
+        fromDepth.processDepthToVelocitySignal(frame.data(), sourceWidth, sourceHeight, depthPlane, depthSignal);
+        fromPoints.processPointsToVelocitySignal(points.data(), sourceWidth, sourceHeight, pointsPlane, pointsSignal);
+
+        REQUIRE(planes_identical(pointsPlane, depthPlane));
+        REQUIRE(planes_identical(fromPoints.matDepthAvg(), fromDepth.matDepthAvg()));
+        REQUIRE(planes_identical(pointsSignal, depthSignal));
+    }
+}
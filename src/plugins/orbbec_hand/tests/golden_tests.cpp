@@ -0,0 +1,370 @@
+#include "catch.hpp"
+#include "hand_replay.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace astra::plugins::hand;
+
+//regenerate the golden files with: ASTRA_HAND_WRITE_GOLDEN=1 OrbbecHandTests "[golden]"
+//replay recordings kept elsewhere with: ASTRA_HAND_TEST_DATA=<dir> OrbbecHandTests "[golden]"
+
+namespace {
+
+    const float POSITION_TOLERANCE = 10.0f; //mm
+
+    const int SYNTHETIC_WIDTH = 320;
+    const int SYNTHETIC_HEIGHT = 240;
+
+    // One line of sequences.txt: a name, then "synthetic:<script> <frames>"
+    // or the path of a recording relative to the data directory.
+    struct SequenceEntry
+    {
+        std::string name;
+        std::string source;
+        int frameCount;
+    };
+
+    // One tracked point after one frame, as written to a golden file.
+    struct GoldenPoint
+    {
+        int frame;
+        int trackingId;
+        std::string type;
+        std::string status;
+        cv::Point3f position;
+    };
+
+    std::string data_dir()
+    {
+        const char* dir = std::getenv("ASTRA_HAND_TEST_DATA");
+        return dir != nullptr ? dir : HAND_TEST_DATA_DIR;
+    }
+
+    bool write_golden_enabled()
+    {
+        return std::getenv("ASTRA_HAND_WRITE_GOLDEN") != nullptr;
+    }
+
+    std::vector<SequenceEntry> read_manifest(const std::string& dir)
+    {
+        std::vector<SequenceEntry> entries;
+        std::ifstream manifest(dir + "/sequences.txt");
+
+        std::string line;
+        while (std::getline(manifest, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            std::istringstream fields(line);
+            SequenceEntry entry;
+            entry.frameCount = 0;
+            if (fields >> entry.name >> entry.source)
+            {
+                fields >> entry.frameCount;
+                entries.push_back(entry);
+            }
+        }
+
+        return entries;
+    }
+
+    bool load_sequence(const std::string& dir, const SequenceEntry& entry, DepthSequence& sequence)
+    {
+        sequence.name = entry.name;
+
+        const std::string syntheticPrefix = "synthetic:";
+        if (entry.source.compare(0, syntheticPrefix.size(), syntheticPrefix) == 0)
+        {
+            return render_scripted_sequence(entry.source.substr(syntheticPrefix.size()),
+                                            SYNTHETIC_WIDTH,
+                                            SYNTHETIC_HEIGHT,
+                                            entry.frameCount,
+                                            sequence);
+        }
+
+        if (!load_recorded_sequence(dir + "/" + entry.source, sequence))
+        {
+            return false;
+        }
+
+        if (entry.frameCount > 0 && entry.frameCount < static_cast<int>(sequence.frames.size()))
+        {
+            sequence.frames.resize(entry.frameCount);
+        }
+        return true;
+    }
+
+    const char* type_name(TrackedPointType type)
+    {
+        return type == TrackedPointType::ActivePoint ? "active" : "candidate";
+    }
+
+    const char* status_name(TrackingStatus status)
+    {
+        switch (status)
+        {
+        case TrackingStatus::Tracking:
+            return "tracking";
+        case TrackingStatus::Lost:
+            return "lost";
+        case TrackingStatus::Dead:
+            return "dead";
+        default:
+            return "not_tracking";
+        }
+    }
+
+    std::vector<GoldenPoint> replay_sequence(const DepthSequence& sequence, StageTimings* timings = nullptr)
+    {
+        HandSettings settings;
+        HandReplay replay(sequence, settings);
+        std::vector<GoldenPoint> points;
+
+        for (int frame = 0; frame < static_cast<int>(sequence.frames.size()); ++frame)
+        {
+            replay.replay_frame(frame);
+
+            for (const TrackedPoint& trackedPoint : replay.tracked_points())
+            {
+                GoldenPoint point;
+                point.frame = frame;
+                point.trackingId = trackedPoint.trackingId;
+                point.type = type_name(trackedPoint.pointType);
+                point.status = status_name(trackedPoint.trackingStatus);
+                point.position = trackedPoint.fullSizeWorldPosition;
+                points.push_back(point);
+            }
+        }
+
+        if (timings != nullptr)
+        {
+            *timings = replay.timings();
+        }
+        return points;
+    }
+
+    std::string golden_path(const std::string& dir, const std::string& name)
+    {
+        return dir + "/golden/" + name + ".txt";
+    }
+
+    bool read_golden(const std::string& path, std::vector<GoldenPoint>& points)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            std::istringstream fields(line);
+            GoldenPoint point;
+            if (fields >> point.frame >> point.trackingId >> point.type >> point.status
+                       >> point.position.x >> point.position.y >> point.position.z)
+            {
+                points.push_back(point);
+            }
+        }
+        return true;
+    }
+
+    bool write_golden(const std::string& path, const std::string& source, const std::vector<GoldenPoint>& points)
+    {
+        std::ofstream file(path);
+        if (!file)
+        {
+            return false;
+        }
+
+        file << "# " << source << "\n";
+        file << "# frame id type status x y z\n";
+        file << std::fixed << std::setprecision(1);
+        for (const GoldenPoint& point : points)
+        {
+            file << point.frame << " " << point.trackingId << " " << point.type << " " << point.status << " "
+                 << point.position.x << " " << point.position.y << " " << point.position.z << "\n";
+        }
+        return true;
+    }
+
+    std::string describe(const GoldenPoint& point)
+    {
+        std::ostringstream text;
+        text << "frame " << point.frame << " id " << point.trackingId << " " << point.type << " " << point.status
+             << " (" << point.position.x << ", " << point.position.y << ", " << point.position.z << ")";
+        return text.str();
+    }
+
+    bool matches(const GoldenPoint& actual, const GoldenPoint& expected)
+    {
+        const cv::Point3f delta = actual.position - expected.position;
+        return actual.frame == expected.frame &&
+               actual.trackingId == expected.trackingId &&
+               actual.type == expected.type &&
+               actual.status == expected.status &&
+               std::fabs(delta.x) <= POSITION_TOLERANCE &&
+               std::fabs(delta.y) <= POSITION_TOLERANCE &&
+               std::fabs(delta.z) <= POSITION_TOLERANCE;
+    }
+}
+
+TEST_CASE("Replayed sequences match their golden trajectories", "[hand][golden]")
+{
+    const std::string dir = data_dir();
+    const std::vector<SequenceEntry> entries = read_manifest(dir);
+    INFO("data directory: " << dir);
+    REQUIRE(!entries.empty());
+
+    for (const SequenceEntry& entry : entries)
+    {
+        INFO("sequence: " << entry.name << " (" << entry.source << ")");
+
+        DepthSequence sequence;
+        REQUIRE(load_sequence(dir, entry, sequence));
+
+        const std::vector<GoldenPoint> actual = replay_sequence(sequence);
+
+        //a golden file without a tracked hand would not guard anything
+        bool anyTracking = false;
+        for (const GoldenPoint& point : actual)
+        {
+            anyTracking = anyTracking || (point.type == "active" && point.status == "tracking");
+        }
+        REQUIRE(anyTracking);
+
+        const std::string path = golden_path(dir, entry.name);
+        if (write_golden_enabled())
+        {
+            REQUIRE(write_golden(path, entry.source, actual));
+            WARN("wrote " << path);
+            continue;
+        }
+
+        std::vector<GoldenPoint> expected;
+        INFO("golden file: " << path);
+        REQUIRE(read_golden(path, expected));
+
+        const size_t count = MIN(actual.size(), expected.size());
+        size_t firstMismatch = 0;
+        while (firstMismatch < count && matches(actual[firstMismatch], expected[firstMismatch]))
+        {
+            ++firstMismatch;
+        }
+
+        if (firstMismatch < count)
+        {
+            INFO("expected " << describe(expected[firstMismatch]));
+            INFO("actual   " << describe(actual[firstMismatch]));
+            FAIL("trajectory differs from the golden file");
+        }
+
+        REQUIRE(actual.size() == expected.size());
+    }
+}
+
+//run with: OrbbecHandTests "[benchmark]", set ASTRA_HAND_TIMINGS_CSV to append the results to a file
+TEST_CASE("Replay stage timings", "[.][benchmark]")
+{
+    const std::string dir = data_dir();
+    const std::vector<SequenceEntry> entries = read_manifest(dir);
+    REQUIRE(!entries.empty());
+
+    const char* csvPath = std::getenv("ASTRA_HAND_TIMINGS_CSV");
+    std::ofstream csv;
+    if (csvPath != nullptr)
+    {
+        csv.open(csvPath, std::ios::app);
+        if (csv.tellp() == 0)
+        {
+            csv << "sequence,frames,velocity_ms,update_ms,create_ms,refine_ms,trajectories_ms,total_ms\n";
+        }
+    }
+
+    for (const SequenceEntry& entry : entries)
+    {
+        DepthSequence sequence;
+        REQUIRE(load_sequence(dir, entry, sequence));
+
+        StageTimings timings;
+        replay_sequence(sequence, &timings);
+
+        const double frames = MAX(timings.frameCount, 1);
+        WARN(entry.name << " ms/frame: "
+             << "velocity " << timings.velocity.count() / frames << ", "
+             << "update " << timings.update.count() / frames << ", "
+             << "create " << timings.create.count() / frames << ", "
+             << "refine " << timings.refine.count() / frames << ", "
+             << "trajectories " << timings.trajectories.count() / frames << ", "
+             << "total " << timings.total().count() / frames);
+
+        if (csv.is_open())
+        {
+            csv << entry.name << "," << timings.frameCount << ","
+                << timings.velocity.count() / frames << ","
+                << timings.update.count() / frames << ","
+                << timings.create.count() / frames << ","
+                << timings.refine.count() / frames << ","
+                << timings.trajectories.count() / frames << ","
+                << timings.total().count() / frames << "\n";
+        }
+    }
+}
+
+TEST_CASE("A scripted wave reports its gestures once, as they are recognized", "[hand][gesture]")
+{
+    const int frameCount = 90;
+
+    DepthSequence sequence;
+    REQUIRE(render_scripted_sequence("wave", SYNTHETIC_WIDTH, SYNTHETIC_HEIGHT, frameCount, sequence));
+
+    HandSettings settings;
+    HandReplay replay(sequence, settings);
+
+    int waveCount = 0;
+    int inflectionCount = 0;
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        replay.replay_frame(frame);
+
+        for (const GestureEvent& event : replay.gesture_events())
+        {
+            INFO("frame " << frame << " point #" << event.trackingId << " gesture " << event.type);
+
+            const std::vector<TrackedPoint>& points = replay.tracked_points();
+            auto point = std::find_if(points.begin(), points.end(), [&](const TrackedPoint& p) { return p.trackingId == event.trackingId; });
+            REQUIRE(point != points.end());
+            REQUIRE(event.worldPosition == point->fullSizeWorldPosition);
+
+            if (event.type == InflectionGesture && waveCount == 0)
+            {
+                ++inflectionCount;
+            }
+            else if (event.type == WaveGesture)
+            {
+                ++waveCount;
+
+                //the wave is what activates the point, on the same frame
+                REQUIRE(point->pointType == TrackedPointType::ActivePoint);
+                REQUIRE(inflectionCount >= settings.pointProcessorSettings.trajectoryAnalyzerSettings.minWaveInflectionsForGesture);
+            }
+        }
+    }
+
+    REQUIRE(waveCount == 1);
+}
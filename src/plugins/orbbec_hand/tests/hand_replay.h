@@ -0,0 +1,121 @@
+#ifndef HAND_REPLAY_H
+#define HAND_REPLAY_H
+
+#include "depth_sequence.h"
+#include "../TrackingPipeline.h"
+#include "../TrackedPoint.h"
+#include "../PointProcessor.h"
+#include "../DepthUtility.h"
+#include "../HandSettings.h"
+#include <common/parallel/WorkerPool.h>
+#include <chrono>
+#include <vector>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // Time spent in each HandTracker stage, summed over the frames replayed.
+    struct StageTimings
+    {
+        using duration = std::chrono::duration<double, std::milli>;
+
+        duration velocity{ 0 };
+        duration update{ 0 };
+        duration create{ 0 };
+        duration refine{ 0 };
+        duration trajectories{ 0 };
+        int frameCount{ 0 };
+
+        duration total() const { return velocity + update + create + refine + trajectories; }
+    };
+
+    // Replays raw depth frames through the velocity signal and the tracking
+    // pipeline, as HandTracker::update_tracking does, without a device, a
+    // stream set or the plugin service. World points are converted here, as
+    // the point stream would, outside the stage timings.
+    class HandReplay
+    {
+    public:
+        HandReplay(const DepthSequence& sequence, const HandSettings& settings, size_t threadCount = 1)
+            : m_sequence(sequence),
+              m_settings(settings),
+              m_mapper(nullptr),
+              m_depthUtility(static_cast<float>(settings.processingSizeWidth),
+                             static_cast<float>(settings.processingSizeHeight),
+                             m_settings.depthUtilitySettings),
+              m_workerPool(threadCount),
+              m_pointProcessor(m_settings.pointProcessorSettings, m_workerPool),
+              m_trackingPipeline(m_pointProcessor, m_settings.pointProcessorSettings),
+              m_worldPoints(sequence.width * sequence.height)
+        { }
+
+        void replay_frame(int frameIndex)
+        {
+            using clock = std::chrono::steady_clock;
+
+            const std::vector<int16_t>& frame = m_sequence.frames[frameIndex];
+            const int width = m_sequence.width;
+            const int height = m_sequence.height;
+            const conversion_cache_t& depthToWorldData = m_sequence.conversionCache;
+
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    const int index = x + y * width;
+                    cv::Point3f world = cv_convert_depth_to_world(depthToWorldData, x, y, frame[index]);
+                    m_worldPoints[index] = Vector3f(world.x, world.y, world.z);
+                }
+            }
+
+            auto stageStart = clock::now();
+
+            //the tracker's default input, the depth of each pixel is the point's z
+            m_depthUtility.processPointsToVelocitySignal(m_worldPoints.data(),
+                                                         width,
+                                                         height,
+                                                         m_matDepth,
+                                                         m_matVelocitySignal);
+
+            auto velocityEnd = clock::now();
+
+            TrackingFrame trackingFrame(m_matDepth,
+                                        m_matVelocitySignal,
+                                        cv::Size(width, height),
+                                        m_worldPoints.data(),
+                                        m_mapper,
+                                        depthToWorldData);
+
+            m_trackingPipeline.track(trackingFrame);
+
+            const TrackingStageTimes& stageTimes = m_trackingPipeline.stage_times();
+            m_timings.velocity += velocityEnd - stageStart;
+            m_timings.update += stageTimes.update;
+            m_timings.create += stageTimes.create;
+            m_timings.refine += stageTimes.refine;
+            m_timings.trajectories += stageTimes.trajectories;
+            ++m_timings.frameCount;
+        }
+
+        const std::vector<TrackedPoint>& tracked_points() { return m_pointProcessor.get_trackedPoints(); }
+
+        const std::vector<GestureEvent>& gesture_events() const { return m_pointProcessor.gesture_events(); }
+
+        const StageTimings& timings() const { return m_timings; }
+
+    private:
+        const DepthSequence& m_sequence;
+        HandSettings m_settings;
+        CoordinateMapper m_mapper;
+        DepthUtility m_depthUtility;
+        parallel::WorkerPool m_workerPool;
+        PointProcessor m_pointProcessor;
+        TrackingPipeline m_trackingPipeline;
+        std::vector<Vector3f> m_worldPoints;
+        cv::Mat m_matDepth;
+        cv::Mat m_matVelocitySignal;
+        StageTimings m_timings;
+    };
+
+}}}
+
+#endif // HAND_REPLAY_H
@@ -0,0 +1,246 @@
+#include "catch.hpp"
+#include "tracking_harness.h"
+#include <algorithm>
+#include <cstring>
+
+namespace astra { namespace plugins { namespace hand {
+
+    void require_same_tracked_points(std::vector<TrackedPoint>& expected,
+                                     std::vector<TrackedPoint>& actual)
+    {
+        REQUIRE(actual.size() == expected.size());
+
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            REQUIRE(actual[i].trackingId == expected[i].trackingId);
+            REQUIRE(actual[i].trackingStatus == expected[i].trackingStatus);
+            REQUIRE(actual[i].pointType == expected[i].pointType);
+            REQUIRE(actual[i].position == expected[i].position);
+            REQUIRE(actual[i].worldPosition == expected[i].worldPosition);
+            REQUIRE(actual[i].inactiveFrameCount == expected[i].inactiveFrameCount);
+            REQUIRE(actual[i].failedTestCount == expected[i].failedTestCount);
+        }
+    }
+
+    bool planes_equal(const cv::Mat& a, const cv::Mat& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (int y = 0; y < a.rows; ++y)
+        {
+            if (memcmp(a.ptr<uint8_t>(y), b.ptr<uint8_t>(y), a.cols * a.elemSize()) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}}}
+
+using namespace astra::plugins::hand;
+
+TEST_CASE("Parallel point updates match serial point updates", "[hand][pointprocessor]")
+{
+    const int handCount = 3;
+    const int frameCount = 40;
+
+    TrackingHarness serial(160, 120, false, 1, handCount);
+    TrackingHarness parallel(160, 120, false, 4, handCount);
+
+    size_t maxTrackingPoints = 0;
+    for (int i = 0; i < frameCount; ++i)
+    {
+        serial.render(i);
+        serial.track_frame();
+
+        parallel.render(i);
+        parallel.track_frame();
+
+        require_same_tracked_points(serial.tracked_points(), parallel.tracked_points());
+
+        maxTrackingPoints = std::max(maxTrackingPoints, serial.tracking_point_count());
+    }
+
+    //the parallel path only runs with more than one point to update
+    REQUIRE(maxTrackingPoints > 1);
+}
+
+TEST_CASE("Parallel point updates are repeatable", "[hand][pointprocessor]")
+{
+    const int handCount = 3;
+    const int frameCount = 20;
+
+    TrackingHarness first(160, 120, false, 4, handCount);
+    TrackingHarness second(160, 120, false, 3, handCount);
+
+    for (int i = 0; i < frameCount; ++i)
+    {
+        first.render(i);
+        first.track_frame();
+
+        second.render(i);
+        second.track_frame();
+    }
+
+    require_same_tracked_points(first.tracked_points(), second.tracked_points());
+
+    //searched marks from every worker end up in the shared plane
+    REQUIRE(planes_equal(first.arena().updateForegroundSearched,
+                         second.arena().updateForegroundSearched));
+}
+
+TEST_CASE("New points are not matched when the match distances are not positive", "[hand][pointprocessor]")
+{
+    const int handCount = 2;
+    const int frameCount = 10;
+
+    TrackingHarness harness(160, 120, false, 1, handCount);
+
+    //settings can be reloaded with any values while the tracker runs
+    PointProcessorSettings& settings = harness.settings().pointProcessorSettings;
+    settings.maxMatchDistDefault = 0;
+    settings.maxMatchDistLostActive = -10;
+
+    for (int i = 0; i < frameCount; ++i)
+    {
+        harness.render(i);
+        harness.track_frame();
+    }
+
+    REQUIRE(harness.tracking_point_count() > 0);
+}
+
+TEST_CASE("Window updates track active points from the full size frame", "[hand][pointprocessor]")
+{
+    const int frameCount = 40;
+    const int resizeFactor = 4;
+
+    TrackingHarness downscaled(160, 120, false, 1, 1, resizeFactor);
+    TrackingHarness windowed(160, 120, false, 1, 1, resizeFactor);
+    windowed.settings().pointProcessorSettings.windowUpdateEnabled = true;
+
+    float downscaledError = 0;
+    float windowedError = 0;
+    for (int i = 0; i < frameCount; ++i)
+    {
+        downscaled.render(i);
+        downscaled.track_frame();
+
+        windowed.render(i);
+        windowed.track_frame();
+
+        //only active points get a window
+        for (TrackingHarness* harness : { &downscaled, &windowed })
+        {
+            for (TrackedPoint& point : harness->tracked_points())
+            {
+                point.pointType = TrackedPointType::ActivePoint;
+            }
+        }
+
+        std::vector<TrackedPoint>& expected = downscaled.tracked_points();
+        std::vector<TrackedPoint>& actual = windowed.tracked_points();
+        REQUIRE(actual.size() == 1);
+        REQUIRE(expected.size() == 1);
+        REQUIRE(actual[0].trackingStatus == TrackingStatus::Tracking);
+
+        //the same spot on the hand, at a finer pixel spacing
+        REQUIRE(cv::norm(actual[0].worldPosition - expected[0].worldPosition) < 25.0f);
+        REQUIRE(std::abs(actual[0].position.x - expected[0].position.x) <= 2);
+        REQUIRE(std::abs(actual[0].position.y - expected[0].position.y) <= 2);
+
+        //the reference area stays at the processing size
+        REQUIRE(actual[0].referenceAreaSqrt == Approx(expected[0].referenceAreaSqrt).epsilon(0.1));
+
+        const float handX = 20.0f * std::sin(i * 0.2f);
+        downscaledError += std::fabs(expected[0].worldPosition.x - handX);
+        windowedError += std::fabs(actual[0].worldPosition.x - handX);
+    }
+
+    REQUIRE(windowedError < downscaledError);
+}
+
+TEST_CASE("Pixel area matches the footprint between neighboring world points", "[hand][pointprocessor]")
+{
+    const int resizeFactor = 2;
+    const int width = 80;
+    const int height = 60;
+
+    SyntheticHandScene scene(width * resizeFactor, height * resizeFactor);
+    scene.render(3);
+    const conversion_cache_t& depthToWorldData = scene.conversion_cache();
+    const astra::Vector3f* fullSizeWorldPoints = scene.world_points();
+
+    HandSettings settings;
+    astra::parallel::WorkerPool workerPool(1);
+    PointProcessor pointProcessor(settings.pointProcessorSettings, workerPool);
+    astra::CoordinateMapper mapper(nullptr);
+    TrackingArena arena;
+    arena.begin_frame(cv::Size(width, height), false);
+
+    cv::Mat depth(height, width, CV_32FC1);
+    cv::Mat velocitySignal(height, width, CV_8UC1);
+
+    TrackingMatrices matrices(scene.depth().size(),
+                              depth,
+                              arena.area,
+                              arena.areaSqrt,
+                              velocitySignal,
+                              arena.updateForegroundSearched,
+                              arena.layerSegmentation,
+                              arena.layerScore,
+                              arena.layerEdgeDistance,
+                              arena.layerIntegralArea,
+                              arena.layerTestPassMap,
+                              arena.debugUpdateSegmentation,
+                              arena.debugUpdateScore,
+                              arena.debugUpdateScoreValue,
+                              arena.debugUpdateTestPassMap,
+                              false,
+                              fullSizeWorldPoints,
+                              arena.worldPoints.data(),
+                              false,
+                              mapper,
+                              depthToWorldData,
+                              arena.scratch);
+
+    //downscaled, then a window sampling every full size pixel
+    for (int stride : { 0, 1 })
+    {
+        const cv::Point offset = stride == 0 ? cv::Point() : cv::Point(32, 16);
+        const int scale = stride == 0 ? resizeFactor : stride;
+        matrices.set_window(offset, stride);
+
+        pointProcessor.initialize_common_calculations(matrices);
+
+        int handPixels = 0;
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const int fullSizeX = offset.x + x * scale;
+                const int fullSizeY = offset.y + y * scale;
+                const astra::Vector3f& p = fullSizeWorldPoints[fullSizeX + fullSizeY * width * resizeFactor];
+
+                //the world position of the next pixel's corner at the same depth
+                cv::Point3f corner = cv_convert_depth_to_world(depthToWorldData,
+                                                               fullSizeX + scale,
+                                                               fullSizeY + scale,
+                                                               p.z);
+                const float expectedArea = std::fabs((corner.x - p.x) * (corner.y - p.y));
+
+                REQUIRE(arena.area.at<float>(y, x) == Approx(expectedArea).epsilon(0.001));
+                REQUIRE(arena.areaSqrt.at<float>(y, x) == Approx(std::sqrt(expectedArea)).epsilon(0.001));
+                REQUIRE(arena.worldPoints[x + y * width].z == p.z);
+
+                handPixels += p.z < 1500 ? 1 : 0;
+            }
+        }
+
+        //the hand is in view, not only the wall
+        REQUIRE(handPixels > 0);
+    }
+}
@@ -0,0 +1,147 @@
+#include "catch.hpp"
+#include "../ProcessingSizeController.h"
+#include "../DepthUtility.h"
+
+using namespace astra::plugins::hand;
+
+namespace {
+
+    const cv::Size REQUESTED_SIZE(320, 240);
+    const cv::Size COARSE_SIZE(80, 60);
+    const float FRAME_BUDGET = 10.0f;
+
+    //frame time of a tracker that spends a fixed time per pixel and per point
+    float simulated_frame_time(const cv::Size& size, size_t trackedPointCount)
+    {
+        const float timePerPixel = 0.00005f;
+        return size.area() * timePerPixel * (trackedPointCount + 1);
+    }
+
+    void run_frames(ProcessingSizeController& controller, size_t trackedPointCount, int frameCount)
+    {
+        for (int i = 0; i < frameCount; ++i)
+        {
+            controller.update(simulated_frame_time(controller.size(), trackedPointCount), trackedPointCount);
+        }
+    }
+}
+
+TEST_CASE("Fixed processing size ignores the frame budget", "[hand][processing_size]")
+{
+    ProcessingSizeController controller(REQUESTED_SIZE, COARSE_SIZE, FRAME_BUDGET, false);
+
+    REQUIRE(controller.levels().size() == 1);
+
+    controller.update(100.0f, 0);
+    controller.update(100.0f, 3);
+    REQUIRE(controller.size() == REQUESTED_SIZE);
+
+    controller.set_requested_size(cv::Size(160, 120));
+    REQUIRE(controller.size() == cv::Size(160, 120));
+}
+
+TEST_CASE("Adaptive processing size halves down to the coarse size", "[hand][processing_size]")
+{
+    ProcessingSizeController controller(REQUESTED_SIZE, COARSE_SIZE, FRAME_BUDGET, true);
+
+    const std::vector<cv::Size>& levels = controller.levels();
+    REQUIRE(levels.size() == 3);
+    REQUIRE(levels[0] == COARSE_SIZE);
+    REQUIRE(levels[1] == cv::Size(160, 120));
+    REQUIRE(levels[2] == REQUESTED_SIZE);
+
+    controller.set_requested_size(COARSE_SIZE);
+    REQUIRE(controller.levels().size() == 1);
+    REQUIRE(controller.size() == COARSE_SIZE);
+}
+
+TEST_CASE("Adaptive processing size searches for hands at the coarse size", "[hand][processing_size]")
+{
+    ProcessingSizeController controller(REQUESTED_SIZE, COARSE_SIZE, FRAME_BUDGET, true);
+
+    REQUIRE(controller.size() == COARSE_SIZE);
+
+    run_frames(controller, 0, 30);
+    REQUIRE(controller.size() == COARSE_SIZE);
+
+    //a new hand moves up at once to the largest size that fits the budget:
+    //320x240 would take 7.68ms per point, 160x120 takes 1.92ms
+    controller.update(simulated_frame_time(controller.size(), 0), 1);
+    REQUIRE(controller.size() == cv::Size(160, 120));
+
+    run_frames(controller, 1, 60);
+    REQUIRE(controller.size() == cv::Size(160, 120));
+
+    //the hand is gone, the tracker waits a little before dropping back
+    controller.update(simulated_frame_time(controller.size(), 1), 0);
+    REQUIRE(controller.size() == cv::Size(160, 120));
+
+    run_frames(controller, 0, 30);
+    REQUIRE(controller.size() == COARSE_SIZE);
+}
+
+TEST_CASE("Adaptive processing size steps down when more points are tracked", "[hand][processing_size]")
+{
+    ProcessingSizeController controller(REQUESTED_SIZE, COARSE_SIZE, 40.0f, true);
+
+    controller.update(simulated_frame_time(controller.size(), 0), 1);
+    REQUIRE(controller.size() == REQUESTED_SIZE);
+    run_frames(controller, 1, 30);
+    REQUIRE(controller.size() == REQUESTED_SIZE);
+
+    //six points at 320x240 take 26.88ms, too much for a 40ms budget with the
+    //step up margin but not enough to step down
+    controller.update(simulated_frame_time(controller.size(), 1), 6);
+    REQUIRE(controller.size() == REQUESTED_SIZE);
+
+    //eleven take 46.08ms
+    controller.update(simulated_frame_time(controller.size(), 6), 11);
+    REQUIRE(controller.size() == cv::Size(160, 120));
+
+    run_frames(controller, 11, 60);
+    REQUIRE(controller.size() == cv::Size(160, 120));
+
+    //fewer points leave room to step up again once the level has settled
+    run_frames(controller, 1, 30);
+    REQUIRE(controller.size() == REQUESTED_SIZE);
+}
+
+TEST_CASE("Adaptive processing size rebuilds its levels for a new coarse size", "[hand][processing_size]")
+{
+    ProcessingSizeController controller(REQUESTED_SIZE, COARSE_SIZE, FRAME_BUDGET, true);
+
+    controller.set_coarse_size(cv::Size(40, 30));
+
+    const std::vector<cv::Size>& levels = controller.levels();
+    REQUIRE(levels.size() == 4);
+    REQUIRE(levels[0] == cv::Size(40, 30));
+    REQUIRE(levels[1] == cv::Size(80, 60));
+    REQUIRE(controller.size() == cv::Size(40, 30));
+}
+
+TEST_CASE("Changing the processing size keeps the running depth average", "[hand][processing_size]")
+{
+    DepthUtilitySettings settings;
+    DepthUtility depthUtility(160, 120, settings);
+
+    std::vector<int16_t> frame(640 * 480, 1500);
+    cv::Mat matDepth;
+    cv::Mat matVelocitySignal;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        depthUtility.processDepthToVelocitySignal(frame.data(), 640, 480, matDepth, matVelocitySignal);
+    }
+
+    REQUIRE(depthUtility.matDepthAvg().at<float>(60, 80) == 1500.0f);
+
+    depthUtility.set_processing_size(80, 60);
+    REQUIRE(depthUtility.matDepthAvg().size() == cv::Size(80, 60));
+    REQUIRE(depthUtility.matDepthAvg().at<float>(30, 40) == 1500.0f);
+
+    depthUtility.processDepthToVelocitySignal(frame.data(), 640, 480, matDepth, matVelocitySignal);
+    REQUIRE(matDepth.size() == cv::Size(80, 60));
+    REQUIRE(matVelocitySignal.size() == cv::Size(80, 60));
+    REQUIRE(depthUtility.matDepthAvg().at<float>(30, 40) == 1500.0f);
+    REQUIRE(depthUtility.matDepthVel().at<float>(30, 40) == 0.0f);
+}
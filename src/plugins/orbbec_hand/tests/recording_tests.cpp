@@ -0,0 +1,164 @@
+#include "catch.hpp"
+#include "depth_sequence.h"
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <Astra/Plugins/plugin_capi.h>
+#include <common/serialization/FrameStreamWriter.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace astra::plugins::hand;
+using namespace astra::serialization;
+
+namespace {
+
+    const uint64_t FRAME_INTERVAL = 33333; //us
+
+    // Writes the frames as the depth stream's image frame wrappers. Some
+    // frames get trailing bytes, so the frames are not all the same size.
+    bool write_indexed_recording(const std::string& path, const DepthSequence& sequence)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        FrameOutputStream* stream = open_indexed_frame_output_stream(file);
+
+        StreamHeader streamHeader;
+        streamHeader.frameType = ASTRA_STREAM_DEPTH;
+        stream->stage_stream_header(streamHeader);
+        bool isSuccessful = stream->write_stream_header();
+
+        const size_t pixelBytes = sequence.width * sequence.height * sizeof(int16_t);
+        std::vector<uint8_t> buffer;
+
+        for (size_t i = 0; isSuccessful && i < sequence.frames.size(); ++i)
+        {
+            buffer.assign(sizeof(astra_imageframe_wrapper_t) + pixelBytes + (i % 3) * 100, 0);
+
+            astra_imageframe_wrapper_t* wrapper = reinterpret_cast<astra_imageframe_wrapper_t*>(buffer.data());
+            wrapper->frame.metadata.width = sequence.width;
+            wrapper->frame.metadata.height = sequence.height;
+            wrapper->frame.metadata.pixelFormat = ASTRA_PIXEL_FORMAT_DEPTH_MM;
+            std::memcpy(wrapper->frame_data, sequence.frames[i].data(), pixelBytes);
+
+            FrameDescription frameDescription;
+            frameDescription.framePeriod = 30;
+            frameDescription.bufferLength = static_cast<int>(buffer.size());
+            frameDescription.timestamp = i * FRAME_INTERVAL;
+
+            Frame frame;
+            frame.byteLength = static_cast<int>(buffer.size());
+            frame.frameIndex = static_cast<int>(i);
+            frame.rawFrameWrapper = buffer.data();
+
+            stream->stage_frame_description(frameDescription);
+            stream->stage_frame(frame);
+            isSuccessful = stream->write_frame_description() && stream->write_frame();
+        }
+
+        close_frame_output_stream(stream);
+        fclose(file);
+        return isSuccessful;
+    }
+
+    // A stream's frame as the writer gets it from a reader frame
+    astra_frame_t make_astra_frame(std::vector<uint8_t>& buffer, int frameIndex)
+    {
+        astra_frame_t astraFrame;
+        astraFrame.byteLength = buffer.size();
+        astraFrame.frameIndex = frameIndex;
+        astraFrame.data = buffer.data();
+        return astraFrame;
+    }
+}
+
+TEST_CASE("Indexed recordings load like the recorder's", "[hand][recording]")
+{
+    const std::string path = "orbbec_hand_recording_test.df";
+    const int frameCount = 20;
+
+    DepthSequence rendered;
+    REQUIRE(render_scripted_sequence("wave", 160, 120, frameCount, rendered));
+    REQUIRE(write_indexed_recording(path, rendered));
+
+    DepthSequence loaded;
+    REQUIRE(load_recorded_sequence(path, loaded));
+    REQUIRE(loaded.width == rendered.width);
+    REQUIRE(loaded.height == rendered.height);
+    REQUIRE(loaded.frames == rendered.frames);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Recorded sequences load the depth stream of a recording with other streams", "[hand][recording]")
+{
+    const std::string path = "orbbec_hand_recording_test.df";
+    const int frameCount = 4;
+
+    DepthSequence rendered;
+    REQUIRE(render_scripted_sequence("wave", 160, 120, frameCount, rendered));
+    const size_t pixelBytes = rendered.width * rendered.height * sizeof(int16_t);
+
+    //a wider field of view than the stream player's default
+    conversion_cache_t conversionCache = rendered.conversionCache;
+    conversionCache.xzFactor = 1.5f;
+    conversionCache.coeffX = rendered.width / conversionCache.xzFactor;
+
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        FrameOutputStream* stream = open_indexed_frame_output_stream(file);
+
+        StreamHeader handHeader;
+        handHeader.frameType = ASTRA_STREAM_HAND;
+
+        StreamHeader depthHeader;
+        depthHeader.frameType = ASTRA_STREAM_DEPTH;
+        depthHeader.hasConversionCache = true;
+        depthHeader.conversionCache = conversionCache;
+
+        FrameStreamWriter writer(*stream);
+        REQUIRE(writer.add_stream(handHeader) == 0);
+        REQUIRE(writer.add_stream(depthHeader) == 1);
+        REQUIRE(writer.begin_write());
+
+        std::vector<uint8_t> depthBuffer(sizeof(astra_imageframe_wrapper_t) + pixelBytes);
+        astra_imageframe_wrapper_t* depthWrapper = reinterpret_cast<astra_imageframe_wrapper_t*>(depthBuffer.data());
+        depthWrapper->frame.metadata.width = rendered.width;
+        depthWrapper->frame.metadata.height = rendered.height;
+        depthWrapper->frame.metadata.pixelFormat = ASTRA_PIXEL_FORMAT_DEPTH_MM;
+
+        //the hand frames are smaller than the depth frames and come first
+        std::vector<uint8_t> handBuffer(sizeof(astra_handframe_wrapper_t) + sizeof(astra_handpoint_t));
+        astra_handframe_wrapper_t* handWrapper = reinterpret_cast<astra_handframe_wrapper_t*>(handBuffer.data());
+        handWrapper->frame.handCount = 1;
+
+        for (int i = 0; i < frameCount; ++i)
+        {
+            astra_frame_t handFrame = make_astra_frame(handBuffer, i);
+            REQUIRE(writer.write(0, handFrame));
+
+            std::memcpy(depthWrapper->frame_data, rendered.frames[i].data(), pixelBytes);
+            astra_frame_t depthFrame = make_astra_frame(depthBuffer, i);
+            REQUIRE(writer.write(1, depthFrame));
+        }
+
+        REQUIRE(writer.end_write());
+        close_frame_output_stream(stream);
+        fclose(file);
+    }
+
+    DepthSequence loaded;
+    REQUIRE(load_recorded_sequence(path, loaded));
+    REQUIRE(loaded.width == rendered.width);
+    REQUIRE(loaded.height == rendered.height);
+    REQUIRE(loaded.frames == rendered.frames);
+    REQUIRE(std::memcmp(&loaded.conversionCache, &conversionCache, sizeof(conversion_cache_t)) == 0);
+
+    std::remove(path.c_str());
+}
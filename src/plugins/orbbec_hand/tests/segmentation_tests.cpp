@@ -0,0 +1,1271 @@
+#include "catch.hpp"
+#include "tracking_harness.h"
+#include "../Segmentation.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstring>
+#include <queue>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // The flood fill as it was before the segmentation scratch was
+    // introduced: a std::queue, a freshly zeroed visited plane per seed and
+    // cv::Mat::at<> for every pixel access. Kept as the reference the
+    // current fill is checked and benchmarked against.
+    namespace reference {
+
+        void enqueue_neighbors(cv::Mat& matVisited,
+                               std::queue<PointTTL>& pointQueue,
+                               const PointTTL& pt)
+        {
+            const int& x = pt.x;
+            const int& y = pt.y;
+            const int width = matVisited.cols;
+            const int height = matVisited.rows;
+
+            if (x < 1 || x > width - 2 ||
+                y < 1 || y > height - 2)
+            {
+                return;
+            }
+
+            const float& ttlRef = pt.ttl;
+
+            char& rightVisited = matVisited.at<char>(y, x+1);
+            if (0 == rightVisited)
+            {
+                rightVisited = 1;
+                pointQueue.push(PointTTL(x+1, y, ttlRef));
+            }
+
+            char& leftVisited = matVisited.at<char>(y, x-1);
+            if (0 == leftVisited)
+            {
+                leftVisited = 1;
+                pointQueue.push(PointTTL(x-1, y, ttlRef));
+            }
+
+            char& downVisited = matVisited.at<char>(y+1, x);
+            if (0 == downVisited)
+            {
+                downVisited = 1;
+                pointQueue.push(PointTTL(x, y+1, ttlRef));
+            }
+
+            char& upVisited = matVisited.at<char>(y-1, x);
+            if (0 == upVisited)
+            {
+                upVisited = 1;
+                pointQueue.push(PointTTL(x, y-1, ttlRef));
+            }
+        }
+
+        cv::Point find_nearest_in_range_pixel(TrackingData& data, cv::Mat& matVisited)
+        {
+            const float referenceAreaSqrt = data.referenceAreaSqrt;
+            if (referenceAreaSqrt == 0)
+            {
+                return segmentation::INVALID_POINT;
+            }
+
+            const float minDepth = data.referenceWorldPosition.z - data.settings.segmentationBandwidthDepthNear;
+            const float maxDepth = data.referenceWorldPosition.z + data.settings.segmentationBandwidthDepthFar;
+            const float maxSegmentationDist = data.settings.maxSegmentationDist;
+            cv::Mat& depthMatrix = data.matrices.depth;
+            cv::Mat& searchedMatrix = data.matrices.foregroundSearched;
+
+            std::queue<PointTTL> pointQueue;
+
+            pointQueue.push(PointTTL(data.seedPosition.x,
+                                     data.seedPosition.y,
+                                     maxSegmentationDist));
+
+            matVisited.at<char>(data.seedPosition) = 1;
+
+            while (!pointQueue.empty())
+            {
+                PointTTL pt = pointQueue.front();
+                pointQueue.pop();
+                const int& x = pt.x;
+                const int& y = pt.y;
+                float& ttlRef = pt.ttl;
+
+                if (ttlRef <= 0)
+                {
+                    continue;
+                }
+
+                searchedMatrix.at<char>(y, x) = PixelType::SearchedFromOutOfRange;
+
+                float depth = depthMatrix.at<float>(y, x);
+                bool pointInRange = depth != 0 && depth > minDepth && depth < maxDepth;
+
+                if (pointInRange)
+                {
+                    return cv::Point(x, y);
+                }
+
+                ttlRef -= referenceAreaSqrt;
+
+                enqueue_neighbors(matVisited, pointQueue, pt);
+            }
+
+            return segmentation::INVALID_POINT;
+        }
+
+        float segment_foreground_and_get_average_depth(TrackingData& data)
+        {
+            const float& maxSegmentationDist = data.settings.maxSegmentationDist;
+            const SegmentationVelocityPolicy& velocitySignalPolicy = data.velocityPolicy;
+            const float seedDepth = data.matrices.depth.at<float>(data.seedPosition);
+            const float referenceAreaSqrt = data.referenceAreaSqrt;
+            cv::Mat& depthMatrix = data.matrices.depth;
+            cv::Mat& velocitySignalMatrix = data.matrices.velocitySignal;
+            cv::Mat& segmentationMatrix = data.matrices.layerSegmentation;
+            cv::Mat& searchedMatrix = data.matrices.foregroundSearched;
+
+            segmentationMatrix = cv::Mat::zeros(depthMatrix.size(), CV_8UC1);
+
+            std::queue<PointTTL> pointQueue;
+
+            double totalDepth = 0;
+            int depthCount = 0;
+
+            const float minDepth = data.referenceWorldPosition.z - data.settings.segmentationBandwidthDepthNear;
+            const float maxDepth = data.referenceWorldPosition.z + data.settings.segmentationBandwidthDepthFar;
+
+            cv::Mat matVisited = cv::Mat::zeros(depthMatrix.size(), CV_8UC1);
+
+            cv::Point seedPosition = data.seedPosition;
+
+            bool seedInRange = seedDepth != 0 && seedDepth > minDepth && seedDepth < maxDepth;
+            if (!seedInRange)
+            {
+                seedPosition = find_nearest_in_range_pixel(data, matVisited);
+                if (seedPosition == segmentation::INVALID_POINT)
+                {
+                    return 0.0f;
+                }
+            }
+
+            pointQueue.push(PointTTL(seedPosition.x,
+                                     seedPosition.y,
+                                     maxSegmentationDist));
+
+            matVisited.at<char>(seedPosition) = 1;
+
+            while (!pointQueue.empty())
+            {
+                PointTTL pt = pointQueue.front();
+                pointQueue.pop();
+                const int& x = pt.x;
+                const int& y = pt.y;
+                float& ttlRef = pt.ttl;
+
+                if (velocitySignalPolicy == VELOCITY_POLICY_RESET_TTL &&
+                    velocitySignalMatrix.at<char>(y, x) == PixelType::Foreground)
+                {
+                    ttlRef = maxSegmentationDist;
+                }
+
+                float depth = depthMatrix.at<float>(y, x);
+                bool pointOutOfRange = depth == 0 ||
+                                       depth < minDepth ||
+                                       depth > maxDepth;
+
+                if (ttlRef <= 0)
+                {
+                    segmentationMatrix.at<char>(y, x) = PixelType::ForegroundOutOfRangeEdge;
+                    continue;
+                }
+                else if (pointOutOfRange)
+                {
+                    segmentationMatrix.at<char>(y, x) = PixelType::ForegroundNaturalEdge;
+                    continue;
+                }
+
+                totalDepth += depth;
+                ++depthCount;
+
+                searchedMatrix.at<char>(y, x) = PixelType::Searched;
+                segmentationMatrix.at<char>(y, x) = PixelType::Foreground;
+
+                ttlRef -= referenceAreaSqrt;
+
+                enqueue_neighbors(matVisited, pointQueue, pt);
+            }
+
+            return depthCount > 0 ? static_cast<float>(totalDepth / depthCount) : 0.0f;
+        }
+
+        // edge distance by eroding the layer one step at a time
+        //3x3 cross min or max over one row. Neighbors outside the image are
+        //skipped, which matches the default border of cv::erode and cv::dilate.
+        template<typename TSelect>
+        void filter_cross_row(const uint8_t* upRow,
+                              const uint8_t* row,
+                              const uint8_t* downRow,
+                              const int width,
+                              uint8_t* outRow,
+                              TSelect select)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                uint8_t value = row[x];
+                if (x > 0)
+                {
+                    value = select(value, row[x - 1]);
+                }
+                if (x < width - 1)
+                {
+                    value = select(value, row[x + 1]);
+                }
+                if (upRow != nullptr)
+                {
+                    value = select(value, upRow[x]);
+                }
+                if (downRow != nullptr)
+                {
+                    value = select(value, downRow[x]);
+                }
+                outRow[x] = value;
+            }
+        }
+
+        template<typename TSelect>
+        void filter_cross(const cv::Mat& src, cv::Mat& dst, TSelect select)
+        {
+            const int width = src.cols;
+            const int height = src.rows;
+
+            for (int y = 0; y < height; y++)
+            {
+                const uint8_t* upRow = y > 0 ? src.ptr<uint8_t>(y - 1) : nullptr;
+                const uint8_t* downRow = y < height - 1 ? src.ptr<uint8_t>(y + 1) : nullptr;
+
+                filter_cross_row(upRow, src.ptr<uint8_t>(y), downRow, width, dst.ptr<uint8_t>(y), select);
+            }
+        }
+
+        //erodes src into dst and adds areaSqrt to the edge distance of every pixel
+        //that survives. Returns the surviving pixel count.
+        int erode_and_accumulate(const cv::Mat& src,
+                                 cv::Mat& dst,
+                                 cv::Mat& areaSqrtMatrix,
+                                 cv::Mat& edgeDistanceMatrix,
+                                 float& maxEdgeDistance)
+        {
+            const int width = src.cols;
+            const int height = src.rows;
+            auto selectMin = [](uint8_t a, uint8_t b) { return MIN(a, b); };
+
+            int nonZeroCount = 0;
+            for (int y = 0; y < height; y++)
+            {
+                const uint8_t* upRow = y > 0 ? src.ptr<uint8_t>(y - 1) : nullptr;
+                const uint8_t* downRow = y < height - 1 ? src.ptr<uint8_t>(y + 1) : nullptr;
+                uint8_t* erodedRow = dst.ptr<uint8_t>(y);
+
+                filter_cross_row(upRow, src.ptr<uint8_t>(y), downRow, width, erodedRow, selectMin);
+
+                const float* areaSqrtRow = areaSqrtMatrix.ptr<float>(y);
+                float* edgeDistanceRow = edgeDistanceMatrix.ptr<float>(y);
+
+                for (int x = 0; x < width; ++x)
+                {
+                    if (erodedRow[x] != 0)
+                    {
+                        const float edgeDistance = edgeDistanceRow[x] + areaSqrtRow[x];
+                        edgeDistanceRow[x] = edgeDistance;
+                        maxEdgeDistance = MAX(maxEdgeDistance, edgeDistance);
+                        ++nonZeroCount;
+                    }
+                }
+            }
+
+            return nonZeroCount;
+        }
+
+        void calculate_edge_distance(cv::Mat& segmentationMatrix,
+                                     cv::Mat& areaSqrtMatrix,
+                                     cv::Mat& edgeDistanceMatrix,
+                                     const float maxEdgeDistance,
+                                     cv::Mat& erodedPlane,
+                                     cv::Mat& erodedNextPlane)
+        {
+            const cv::Size size = segmentationMatrix.size();
+
+            edgeDistanceMatrix.create(size, CV_32FC1);
+            clear_plane(edgeDistanceMatrix);
+            erodedPlane.create(size, CV_8UC1);
+            erodedNextPlane.create(size, CV_8UC1);
+
+            //close small holes
+            filter_cross(segmentationMatrix, erodedPlane, [](uint8_t a, uint8_t b) { return MAX(a, b); });
+
+            //ping-pong between the two scratch planes instead of eroding in place
+            cv::Mat* eroded = &erodedPlane;
+            cv::Mat* erodedNext = &erodedNextPlane;
+
+            int nonZeroCount = 0;
+            const int imageLength = size.width * size.height;
+            int iterations = 0;
+            const int maxIterations = segmentationMatrix.cols / 2;
+            //edge distances only grow, so the running max is the max of the matrix
+            float maxDistance = 0;
+            bool done;
+            do
+            {
+                //erode makes the image smaller, and what remains accumulates to the edge distance
+                nonZeroCount = erode_and_accumulate(*eroded,
+                                                    *erodedNext,
+                                                    areaSqrtMatrix,
+                                                    edgeDistanceMatrix,
+                                                    maxDistance);
+                std::swap(eroded, erodedNext);
+
+                done = (nonZeroCount == 0);
+                if (maxDistance > maxEdgeDistance)
+                {
+                    done = true;
+                }
+
+                //nonZeroCount < imageLength guards against segmentation with all 1's, which will never erode
+            } while (!done && nonZeroCount < imageLength && ++iterations < maxIterations);
+        }
+
+
+        // circumference points from a midpoint circle generated per call
+        void get_circumference_points(cv::Mat& matDepth,
+                                      const cv::Point& center,
+                                      const float& radius,
+                                      const ScalingCoordinateMapper& mapper,
+                                      std::vector<astra::Vector2i>& offsets,
+                                      std::vector<astra::Vector2i>& points)
+        {
+            int width = matDepth.cols;
+            int height = matDepth.rows;
+            if (center.x < 0 || center.x >= width ||
+                center.y < 0 || center.y >= height ||
+                radius < 1)
+            {
+                return;
+            }
+
+            float referenceDepth = matDepth.at<float>(center);
+            if (referenceDepth == 0)
+            {
+                return;
+            }
+
+            cv::Point offsetRight = mapper.offset_pixel_location_by_mm(center, radius, 0, referenceDepth);
+
+            //http://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+            int pixelRadius = offsetRight.x - center.x;
+            int cx = center.x;
+            int cy = center.y;
+
+            //clear & reuse capacity across calls
+            offsets.clear();
+            //reserve a slight overestimation of number of points for 1/8 of circumference
+            offsets.reserve(pixelRadius);
+
+            {
+                int dx = pixelRadius; //radius in pixels
+                int dy = 0;
+                int radiusError = 1 - dx;
+
+                while (dx >= dy)
+                {
+                    offsets.push_back(astra::Vector2i(dx, dy));
+
+                    dy++;
+                    if (radiusError < 0)
+                    {
+                        radiusError += 2 * dy + 1;
+                    }
+                    else
+                    {
+                        dx--;
+                        radiusError += 2 * (dy - dx) + 1;
+                    }
+                }
+            }
+
+            //clear & reuse capacity across calls
+            points.clear();
+            points.reserve(static_cast<int>(pixelRadius * 2.0f * PI_F));
+
+            int length = offsets.size();
+
+            //Order and the permutations of dx,dy are critical here
+            //so the points list will contain the points in order
+
+            for (int i = 1; i < length; ++i)
+            {
+                //dx, dy
+                const astra::Vector2i delta = offsets[i];
+                const int x = cx + delta.x;
+                const int y = cy + delta.y;
+
+                if (x >= 0 && x < width &&
+                    y >= 0 && y < height)
+                {
+                    points.push_back(astra::Vector2i(x, y));
+                }
+            }
+
+            //even quadrants are reversed order
+            for (int i = length-1; i >= 0; --i)
+            {
+                //dy, dx
+                const astra::Vector2i delta = offsets[i];
+
+                const int dx = delta.x;
+                const int dy = delta.y;
+                if (dx != dy)
+                {
+                    const int x = cx + dy;
+                    const int y = cy + dx;
+                    if (x >= 0 && x < width &&
+                        y >= 0 && y < height)
+                    {
+                        points.push_back(astra::Vector2i(x, y));
+                    }
+                }
+            }
+
+            for (int i = 1; i < length; ++i)
+            {
+                //-dy, dx
+                const astra::Vector2i delta = offsets[i];
+                const int x = cx - delta.y;
+                const int y = cy + delta.x;
+
+                if (x >= 0 && x < width &&
+                    y >= 0 && y < height)
+                {
+                    points.push_back(astra::Vector2i(x, y));
+                }
+            }
+
+            for (int i = length-1; i >= 0; --i)
+            {
+                //-dx, dy
+                const astra::Vector2i delta = offsets[i];
+
+                const int dx = delta.x;
+                const int dy = delta.y;
+                if (dx != dy)
+                {
+                    const int x = cx - dx;
+                    const int y = cy + dy;
+                    if (x >= 0 && x < width &&
+                        y >= 0 && y < height)
+                    {
+                        points.push_back(astra::Vector2i(x, y));
+                    }
+                }
+            }
+
+            for (int i = 1; i < length; ++i)
+            {
+                //-dx, -dy
+                const astra::Vector2i delta = offsets[i];
+                const int x = cx - delta.x;
+                const int y = cy - delta.y;
+
+                if (x >= 0 && x < width &&
+                    y >= 0 && y < height)
+                {
+                    points.push_back(astra::Vector2i(x, y));
+                }
+            }
+
+            for (int i = length-1; i >= 0; --i)
+            {
+                //-dy, -dx
+                const astra::Vector2i delta = offsets[i];
+
+                const int dx = delta.x;
+                const int dy = delta.y;
+                if (dx != dy)
+                {
+                    const int x = cx - dy;
+                    const int y = cy - dx;
+                    if (x >= 0 && x < width &&
+                        y >= 0 && y < height)
+                    {
+                        points.push_back(astra::Vector2i(x, y));
+                    }
+                }
+            }
+
+            for (int i = 1; i < length; ++i)
+            {
+                //dy, -dx
+                const astra::Vector2i delta = offsets[i];
+                const int x = cx + delta.y;
+                const int y = cy - delta.x;
+
+                if (x >= 0 && x < width &&
+                    y >= 0 && y < height)
+                {
+                    points.push_back(astra::Vector2i(x, y));
+                }
+            }
+
+            for (int i = length-1; i >= 0; --i)
+            {
+                //dx, -dy
+                const astra::Vector2i delta = offsets[i];
+
+                const int dx = delta.x;
+                const int dy = delta.y;
+                if (dx != dy)
+                {
+                    const int x = cx + dx;
+                    const int y = cy - dy;
+                    if (x >= 0 && x < width &&
+                        y >= 0 && y < height)
+                    {
+                        points.push_back(astra::Vector2i(x, y));
+                    }
+                }
+            }
+        }
+    }
+
+    bool planes_match(const cv::Mat& a, const cv::Mat& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (int y = 0; y < a.rows; ++y)
+        {
+            if (memcmp(a.ptr<uint8_t>(y), b.ptr<uint8_t>(y), a.cols * a.elemSize()) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Planes for running one flood fill outside the tracker.
+    struct FillPlanes
+    {
+        cv::Mat area;
+        cv::Mat areaSqrt;
+        cv::Mat searched;
+        cv::Mat segmentation;
+        cv::Mat unused;
+        SegmentationScratch scratch;
+        CoordinateMapper mapper;
+        cv::Rect layerBounds;
+
+        FillPlanes(const cv::Size& size)
+            : area(size, CV_32FC1),
+              areaSqrt(size, CV_32FC1),
+              searched(size, CV_8UC1),
+              segmentation(size, CV_8UC1),
+              mapper(nullptr)
+        {
+            scratch.allocate(size);
+        }
+
+        TrackingMatrices matrices(SyntheticHandScene& scene)
+        {
+            return TrackingMatrices(scene.depth().size(),
+                                    scene.depth(),
+                                    area,
+                                    areaSqrt,
+                                    scene.velocity_signal(),
+                                    searched,
+                                    segmentation,
+                                    unused,
+                                    unused,
+                                    unused,
+                                    unused,
+                                    unused,
+                                    unused,
+                                    unused,
+                                    unused,
+                                    false,
+                                    scene.world_points(),
+                                    nullptr,
+                                    false,
+                                    mapper,
+                                    scene.conversion_cache(),
+                                    scratch);
+        }
+    };
+
+    // A spread of seeds over the scene: on hands, on the wall and on hand
+    // edges, with reference depths both on and off the seed pixel.
+    struct FillCase
+    {
+        cv::Point seed;
+        float referenceDepth;
+        SegmentationVelocityPolicy policy;
+    };
+
+    std::vector<FillCase> make_fill_cases(SyntheticHandScene& scene, int count)
+    {
+        std::vector<FillCase> cases;
+        const cv::Mat& depth = scene.depth();
+        unsigned state = 12345;
+
+        for (int i = 0; i < count; ++i)
+        {
+            state = state * 1103515245 + 12345;
+            const int x = (state >> 8) % depth.cols;
+            state = state * 1103515245 + 12345;
+            const int y = (state >> 8) % depth.rows;
+            state = state * 1103515245 + 12345;
+            const float offset = static_cast<float>((state >> 8) % 400) - 200.0f;
+
+            FillCase fillCase;
+            fillCase.seed = cv::Point(x, y);
+            fillCase.referenceDepth = depth.at<float>(y, x) + (i % 2 == 0 ? 0.0f : offset);
+            fillCase.policy = i % 3 == 0 ? VELOCITY_POLICY_RESET_TTL : VELOCITY_POLICY_IGNORE;
+            cases.push_back(fillCase);
+        }
+        return cases;
+    }
+
+    template<typename TFill>
+    float run_fill(SyntheticHandScene& scene,
+                   FillPlanes& planes,
+                   const FillCase& fillCase,
+                   const SegmentationSettings& settings,
+                   TFill fill)
+    {
+        TrackingMatrices matrices = planes.matrices(scene);
+        const cv::Point3f referenceWorldPosition(0, 0, fillCase.referenceDepth);
+
+        TrackingData data(matrices,
+                          fillCase.seed,
+                          referenceWorldPosition,
+                          3.0f,
+                          fillCase.policy,
+                          settings,
+                          TEST_PHASE_UPDATE);
+
+        const float averageDepth = fill(data);
+        planes.layerBounds = matrices.layerBounds;
+        return averageDepth;
+    }
+}}}
+
+using namespace astra::plugins::hand;
+
+TEST_CASE("Flood fill matches the reference implementation", "[hand][segmentation]")
+{
+    SyntheticHandScene scene(160, 120, 3);
+    SegmentationSettings settings;
+
+    FillPlanes current(cv::Size(160, 120));
+    FillPlanes expected(cv::Size(160, 120));
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        scene.render(frame);
+
+        for (const FillCase& fillCase : make_fill_cases(scene, 100))
+        {
+            clear_plane(current.searched);
+            clear_plane(expected.searched);
+
+            const float averageDepth = run_fill(scene, current, fillCase, settings,
+                                                segmentation::segment_foreground_and_get_average_depth);
+            const float expectedAverageDepth = run_fill(scene, expected, fillCase, settings,
+                                                        reference::segment_foreground_and_get_average_depth);
+
+            REQUIRE(averageDepth == expectedAverageDepth);
+            REQUIRE(planes_match(current.segmentation, expected.segmentation));
+            REQUIRE(planes_match(current.searched, expected.searched));
+        }
+    }
+}
+
+TEST_CASE("Visited map starts every fill empty", "[hand][segmentation]")
+{
+    VisitedMap visited;
+    visited.allocate(cv::Size(4, 4));
+
+    visited.begin_fill();
+    REQUIRE(visited.visit(5));
+    REQUIRE_FALSE(visited.visit(5));
+    REQUIRE(visited.is_visited(5));
+
+    visited.begin_fill();
+    REQUIRE_FALSE(visited.is_visited(5));
+
+    //wrapping the generation clears stale stamps
+    for (int i = 0; i < 70000; ++i)
+    {
+        visited.begin_fill();
+        if (i == 100)
+        {
+            visited.visit(7);
+        }
+    }
+    REQUIRE_FALSE(visited.is_visited(7));
+}
+
+//run with: OrbbecHandTests "[benchmark]"
+TEST_CASE("Flood fill bounds the pixels it segments", "[hand][segmentation]")
+{
+    SyntheticHandScene scene(160, 120, 3);
+    SegmentationSettings settings;
+    FillPlanes planes(cv::Size(160, 120));
+    scene.render(0);
+
+    for (const FillCase& fillCase : make_fill_cases(scene, 100))
+    {
+        clear_plane(planes.searched);
+
+        run_fill(scene, planes, fillCase, settings,
+                 segmentation::segment_foreground_and_get_average_depth);
+
+        int minX = planes.segmentation.cols;
+        int minY = planes.segmentation.rows;
+        int maxX = -1;
+        int maxY = -1;
+        for (int y = 0; y < planes.segmentation.rows; ++y)
+        {
+            for (int x = 0; x < planes.segmentation.cols; ++x)
+            {
+                if (planes.segmentation.at<uint8_t>(y, x) != 0)
+                {
+                    minX = std::min(minX, x);
+                    minY = std::min(minY, y);
+                    maxX = std::max(maxX, x);
+                    maxY = std::max(maxY, y);
+                }
+            }
+        }
+
+        const cv::Rect& bounds = planes.layerBounds;
+        if (maxX < 0)
+        {
+            REQUIRE(bounds.area() == 0);
+        }
+        else
+        {
+            REQUIRE(bounds.x == minX);
+            REQUIRE(bounds.y == minY);
+            REQUIRE(bounds.width == maxX - minX + 1);
+            REQUIRE(bounds.height == maxY - minY + 1);
+        }
+    }
+}
+
+TEST_CASE("Edge distance matches eroding the layer step by step", "[hand][segmentation]")
+{
+    SyntheticHandScene scene(160, 120, 3);
+    SegmentationSettings settings;
+    FillPlanes planes(cv::Size(160, 120));
+
+    cv::Mat edgeDistance(planes.segmentation.size(), CV_32FC1);
+    cv::Mat expectedEdgeDistance(planes.segmentation.size(), CV_32FC1);
+    cv::Mat eroded;
+    cv::Mat erodedNext;
+
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        scene.render(frame);
+
+        //pixel size grows with depth
+        for (int y = 0; y < planes.areaSqrt.rows; ++y)
+        {
+            for (int x = 0; x < planes.areaSqrt.cols; ++x)
+            {
+                planes.areaSqrt.at<float>(y, x) = scene.depth().at<float>(y, x) * 0.003f + 0.01f * (x % 7);
+            }
+        }
+
+        for (const FillCase& fillCase : make_fill_cases(scene, 50))
+        {
+            clear_plane(planes.searched);
+
+            run_fill(scene, planes, fillCase, settings,
+                     segmentation::segment_foreground_and_get_average_depth);
+
+            //the tracker's cap, one that stops after a few erosions, and none
+            const float maxEdgeDistances[] = { settings.targetEdgeDistance, 10.0f, FLT_MAX };
+
+            for (float maxEdgeDistance : maxEdgeDistances)
+            {
+                clear_plane(edgeDistance);
+                segmentation::calculate_edge_distance(planes.segmentation,
+                                                      planes.areaSqrt,
+                                                      edgeDistance,
+                                                      maxEdgeDistance,
+                                                      planes.layerBounds);
+
+                reference::calculate_edge_distance(planes.segmentation,
+                                                   planes.areaSqrt,
+                                                   expectedEdgeDistance,
+                                                   maxEdgeDistance,
+                                                   eroded,
+                                                   erodedNext);
+
+                int mismatchCount = 0;
+                for (int y = 0; y < edgeDistance.rows; ++y)
+                {
+                    for (int x = 0; x < edgeDistance.cols; ++x)
+                    {
+                        if (edgeDistance.at<float>(y, x) != Approx(expectedEdgeDistance.at<float>(y, x)).epsilon(1e-4))
+                        {
+                            ++mismatchCount;
+                        }
+                    }
+                }
+                REQUIRE(mismatchCount == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Integral area within the layer bounds matches the whole layer", "[hand][segmentation]")
+{
+    SyntheticHandScene scene(160, 120, 3);
+    SegmentationSettings settings;
+    FillPlanes planes(cv::Size(160, 120));
+    ScalingCoordinateMapper mapper(scene.conversion_cache(), 1.0f);
+    const cv::Rect wholeLayer(0, 0, 160, 120);
+
+    cv::Mat wholeIntegralArea(planes.segmentation.size(), CV_32FC1);
+    cv::Mat boundedIntegralArea(planes.segmentation.size(), CV_32FC1);
+
+    const float bandwidths[] = { 5.0f, 50.0f, 100.0f, 1000.0f };
+
+    scene.render(0);
+    for (int y = 0; y < planes.area.rows; ++y)
+    {
+        for (int x = 0; x < planes.area.cols; ++x)
+        {
+            planes.area.at<float>(y, x) = 1.0f + 0.25f * (x % 3) + 0.5f * (y % 5);
+        }
+    }
+
+    for (const FillCase& fillCase : make_fill_cases(scene, 50))
+    {
+        clear_plane(planes.searched);
+        run_fill(scene, planes, fillCase, settings,
+                 segmentation::segment_foreground_and_get_average_depth);
+
+        TrackingMatrices matrices = planes.matrices(scene);
+
+        matrices.layerBounds = wholeLayer;
+        segmentation::calculate_integral_area(matrices);
+        wholeIntegralArea = planes.unused.clone();
+
+        clear_plane(planes.unused);
+        matrices.layerBounds = planes.layerBounds;
+        segmentation::calculate_integral_area(matrices);
+        boundedIntegralArea = planes.unused.clone();
+
+        for (float bandwidth : bandwidths)
+        {
+            const cv::Point& center = fillCase.seed;
+            const float area = segmentation::count_neighborhood_area_integral(scene.depth(),
+                                                                               boundedIntegralArea,
+                                                                               planes.layerBounds,
+                                                                               center,
+                                                                               bandwidth,
+                                                                               mapper);
+            const float expectedArea = segmentation::count_neighborhood_area_integral(scene.depth(),
+                                                                                       wholeIntegralArea,
+                                                                                       wholeLayer,
+                                                                                       center,
+                                                                                       bandwidth,
+                                                                                       mapper);
+            REQUIRE(area == Approx(expectedArea));
+        }
+    }
+}
+
+TEST_CASE("Layer scores of a window exclude only the full size frame's edges", "[hand][segmentation]")
+{
+    const int stride = 2;
+    SyntheticHandScene scene(160, 120, 3);
+    scene.render(0);
+    SegmentationSettings settings;
+    astra::CoordinateMapper mapper(nullptr);
+    const cv::Size fullSize = scene.depth().size();
+    const cv::Point3f referenceWorldPosition(0, 0, 1000.0f);
+
+    //scores a plane sampling the full size frame every stride pixels from offset
+    auto score_plane = [&](const cv::Size& size, const cv::Point& offset, int windowStride)
+    {
+        FillPlanes planes(size);
+        cv::Mat depth(size, CV_32FC1);
+        cv::Mat layerScore(size, CV_32FC1);
+        cv::Mat edgeDistance(size, CV_32FC1, cv::Scalar(10.0f));
+        std::vector<astra::Vector3f> worldPoints(size.area());
+
+        for (int y = 0; y < size.height; ++y)
+        {
+            for (int x = 0; x < size.width; ++x)
+            {
+                const astra::Vector3f& p = scene.world_points()[offset.x + x * stride + (offset.y + y * stride) * fullSize.width];
+                depth.at<float>(y, x) = p.z;
+                worldPoints[x + y * size.width] = p;
+            }
+        }
+
+        TrackingMatrices matrices(fullSize,
+                                  depth,
+                                  planes.area,
+                                  planes.areaSqrt,
+                                  planes.unused,
+                                  planes.searched,
+                                  planes.segmentation,
+                                  layerScore,
+                                  edgeDistance,
+                                  planes.unused,
+                                  planes.unused,
+                                  planes.unused,
+                                  planes.unused,
+                                  planes.unused,
+                                  planes.unused,
+                                  false,
+                                  scene.world_points(),
+                                  worldPoints.data(),
+                                  false,
+                                  mapper,
+                                  scene.conversion_cache(),
+                                  planes.scratch);
+        matrices.set_window(offset, windowStride);
+
+        TrackingData data(matrices,
+                          cv::Point(0, 0),
+                          referenceWorldPosition,
+                          3.0f,
+                          VELOCITY_POLICY_IGNORE,
+                          settings,
+                          TEST_PHASE_UPDATE);
+
+        segmentation::calculate_layer_score(data, 1500.0f, cv::Rect(0, 0, size.width, size.height));
+        return layerScore;
+    };
+
+    //the whole frame downscaled by the stride
+    const cv::Size downscaledSize(fullSize.width / stride, fullSize.height / stride);
+    cv::Mat downscaledScore = score_plane(downscaledSize, cv::Point(), 0);
+
+    //at a corner, inside the frame and at the opposite corner
+    const cv::Size windowSize(30, 20);
+    const cv::Point offsets[] = { cv::Point(0, 0),
+                                  cv::Point(40, 40),
+                                  cv::Point(fullSize.width - windowSize.width * stride,
+                                            fullSize.height - windowSize.height * stride) };
+
+    for (const cv::Point& offset : offsets)
+    {
+        cv::Mat windowScore = score_plane(windowSize, offset, stride);
+
+        int excludedCount = 0;
+        for (int y = 0; y < windowSize.height; ++y)
+        {
+            for (int x = 0; x < windowSize.width; ++x)
+            {
+                const float expectedScore = downscaledScore.at<float>(offset.y / stride + y, offset.x / stride + x);
+                REQUIRE(windowScore.at<float>(y, x) == expectedScore);
+
+                excludedCount += expectedScore == 0 ? 1 : 0;
+            }
+        }
+
+        //only windows at the frame's edges lose pixels
+        REQUIRE((excludedCount > 0) == (offset != cv::Point(40, 40)));
+    }
+}
+
+TEST_CASE("Circumference points match a per call midpoint circle", "[hand][segmentation]")
+{
+    SyntheticHandScene scene(160, 120, 3);
+    scene.render(0);
+
+    SegmentationScratch scratch;
+    scratch.allocate(cv::Size(160, 120));
+    ScalingCoordinateMapper mapper(scene.conversion_cache(), 1.0f);
+
+    std::vector<astra::Vector2i> offsets;
+    std::vector<astra::Vector2i> points;
+    std::vector<astra::Vector2i> expectedPoints;
+
+    const float radii[] = { 0.5f, 1.0f, 10.0f, 45.0f, 100.0f, 250.0f, 1000.0f, 5000.0f };
+
+    for (const FillCase& fillCase : make_fill_cases(scene, 100))
+    {
+        for (float radius : radii)
+        {
+            points.assign(3, astra::Vector2i(-1, -1));
+            expectedPoints.clear();
+
+            segmentation::get_circumference_points(scene.depth(),
+                                                   fillCase.seed,
+                                                   radius,
+                                                   mapper,
+                                                   scratch.circleOffsets,
+                                                   points);
+            reference::get_circumference_points(scene.depth(),
+                                                fillCase.seed,
+                                                radius,
+                                                mapper,
+                                                offsets,
+                                                expectedPoints);
+
+            REQUIRE(points == expectedPoints);
+        }
+    }
+}
+
+TEST_CASE("Natural edge percentages from integrals match the pixel loop", "[hand][segmentation]")
+{
+    SyntheticHandScene scene(160, 120, 3);
+    SegmentationSettings settings;
+    FillPlanes planes(cv::Size(160, 120));
+    ScalingCoordinateMapper mapper(scene.conversion_cache(), 1.0f);
+
+    const float bandwidths[] = { 5.0f, 50.0f, 100.0f, 1000.0f };
+
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        scene.render(frame);
+
+        for (const FillCase& fillCase : make_fill_cases(scene, 50))
+        {
+            clear_plane(planes.searched);
+            run_fill(scene, planes, fillCase, settings,
+                     segmentation::segment_foreground_and_get_average_depth);
+
+            segmentation::calculate_integral_edges(planes.segmentation,
+                                                   planes.layerBounds,
+                                                   planes.scratch.integralNaturalEdges,
+                                                   planes.scratch.integralEdges);
+
+            for (float bandwidth : bandwidths)
+            {
+                const float percent = segmentation::get_percent_natural_edges_integral(scene.depth(),
+                                                                                       planes.scratch.integralNaturalEdges,
+                                                                                       planes.scratch.integralEdges,
+                                                                                       planes.layerBounds,
+                                                                                       fillCase.seed,
+                                                                                       bandwidth,
+                                                                                       mapper);
+                const float expectedPercent = segmentation::get_percent_natural_edges(scene.depth(),
+                                                                                      planes.segmentation,
+                                                                                      fillCase.seed,
+                                                                                      bandwidth,
+                                                                                      mapper);
+                REQUIRE(percent == expectedPercent);
+            }
+        }
+    }
+}
+
+namespace astra { namespace plugins { namespace hand { namespace reference {
+
+    // Blobs as the old seed scan met them: the first foreground pixel not
+    // yet labeled, in raster order, flood filled to its 8-connected blob.
+    std::vector<VelocitySeed> find_velocity_seeds(const cv::Mat& velocitySignal)
+    {
+        std::vector<VelocitySeed> seeds;
+        cv::Mat labeled = cv::Mat::zeros(velocitySignal.size(), CV_8UC1);
+
+        for (int y = 0; y < velocitySignal.rows; ++y)
+        {
+            for (int x = 0; x < velocitySignal.cols; ++x)
+            {
+                if (velocitySignal.at<uint8_t>(y, x) != PixelType::Foreground ||
+                    labeled.at<uint8_t>(y, x) != 0)
+                {
+                    continue;
+                }
+
+                VelocitySeed seed;
+                seed.position = cv::Point(x, y);
+                seed.area = 0;
+                double sumX = 0;
+                double sumY = 0;
+
+                std::queue<cv::Point> queue;
+                labeled.at<uint8_t>(y, x) = 1;
+                queue.push(seed.position);
+
+                while (!queue.empty())
+                {
+                    const cv::Point p = queue.front();
+                    queue.pop();
+
+                    ++seed.area;
+                    sumX += p.x;
+                    sumY += p.y;
+
+                    for (int dy = -1; dy <= 1; ++dy)
+                    {
+                        for (int dx = -1; dx <= 1; ++dx)
+                        {
+                            const cv::Point n(p.x + dx, p.y + dy);
+                            if (n.x >= 0 && n.x < velocitySignal.cols &&
+                                n.y >= 0 && n.y < velocitySignal.rows &&
+                                velocitySignal.at<uint8_t>(n.y, n.x) == PixelType::Foreground &&
+                                labeled.at<uint8_t>(n.y, n.x) == 0)
+                            {
+                                labeled.at<uint8_t>(n.y, n.x) = 1;
+                                queue.push(n);
+                            }
+                        }
+                    }
+                }
+
+                seed.centroid = cv::Point2f(static_cast<float>(sumX / seed.area),
+                                            static_cast<float>(sumY / seed.area));
+                seeds.push_back(seed);
+            }
+        }
+
+        std::stable_sort(seeds.begin(), seeds.end(),
+                         [](const VelocitySeed& a, const VelocitySeed& b)
+                         {
+                             return a.area > b.area;
+                         });
+        return seeds;
+    }
+}}}}
+
+TEST_CASE("Velocity seeds find each blob once, largest first", "[hand][segmentation]")
+{
+    const int F = PixelType::Foreground;
+    const uint8_t pixels[6][8] = {
+        { F, 0, F, 0, 0, 0, 0, F },
+        { F, 0, F, 0, 0, 0, F, 0 },
+        { F, F, F, 0, 0, F, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, F, F, 0 },
+        { F, 0, 0, 0, 0, F, F, 0 }
+    };
+
+    cv::Mat velocitySignal(6, 8, CV_8UC1);
+    for (int y = 0; y < 6; ++y)
+    {
+        memcpy(velocitySignal.ptr<uint8_t>(y), pixels[y], 8);
+    }
+
+    VelocitySeedScratch scratch;
+    const std::vector<VelocitySeed>& seeds = segmentation::find_velocity_seeds(velocitySignal, scratch, 10);
+    REQUIRE(seeds.size() == 4);
+
+    //a U joined at the bottom is one blob, seeded at its first pixel even
+    //though its centroid lies outside it
+    REQUIRE(seeds[0].area == 7);
+    REQUIRE(seeds[0].position == cv::Point(0, 0));
+    REQUIRE(seeds[0].centroid.x == Approx(1.0f));
+    REQUIRE(seeds[0].centroid.y == Approx(8.0f / 7));
+
+    //equal areas are ranked by seed position
+    REQUIRE(seeds[1].area == 4);
+    REQUIRE(seeds[1].position == cv::Point(5, 4));
+    REQUIRE(seeds[1].centroid == cv::Point2f(5.5f, 4.5f));
+
+    //pixels touching only diagonally are one blob
+    REQUIRE(seeds[2].area == 3);
+    REQUIRE(seeds[2].position == cv::Point(7, 0));
+
+    REQUIRE(seeds[3].area == 1);
+    REQUIRE(seeds[3].position == cv::Point(0, 5));
+
+    REQUIRE(segmentation::find_velocity_seeds(velocitySignal, scratch, 2).size() == 2);
+}
+
+TEST_CASE("Velocity seeds match flood filling each blob", "[hand][segmentation]")
+{
+    const int width = 80;
+    const int height = 60;
+    cv::Mat velocitySignal(height, width, CV_8UC1);
+    VelocitySeedScratch scratch;
+    unsigned state = 54321;
+
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        //sparse noise to dense tangles, with a few rectangles on top
+        const unsigned density = 10 + frame * 3;
+        for (int y = 0; y < height; ++y)
+        {
+            uint8_t* row = velocitySignal.ptr<uint8_t>(y);
+            for (int x = 0; x < width; ++x)
+            {
+                state = state * 1103515245 + 12345;
+                row[x] = (state >> 8) % 100 < density ? PixelType::Foreground : PixelType::Background;
+            }
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            state = state * 1103515245 + 12345;
+            const int x = (state >> 8) % (width - 10);
+            state = state * 1103515245 + 12345;
+            const int y = (state >> 8) % (height - 10);
+            velocitySignal(cv::Rect(x, y, 10, 10)).setTo(cv::Scalar(PixelType::Foreground));
+        }
+
+        const std::vector<VelocitySeed>& seeds = segmentation::find_velocity_seeds(velocitySignal, scratch, -1);
+        const std::vector<VelocitySeed> expected = reference::find_velocity_seeds(velocitySignal);
+
+        REQUIRE(seeds.size() == expected.size());
+        for (size_t i = 0; i < seeds.size(); ++i)
+        {
+            REQUIRE(seeds[i].area == expected[i].area);
+            REQUIRE(seeds[i].position == expected[i].position);
+            REQUIRE(seeds[i].centroid.x == Approx(expected[i].centroid.x));
+            REQUIRE(seeds[i].centroid.y == Approx(expected[i].centroid.y));
+        }
+    }
+}
+
+TEST_CASE("Flood fill benchmark", "[.][benchmark]")
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    SyntheticHandScene scene(160, 120, 3);
+    scene.render(0);
+    SegmentationSettings settings;
+
+    FillPlanes current(cv::Size(160, 120));
+    FillPlanes expected(cv::Size(160, 120));
+
+    const std::vector<FillCase> fillCases = make_fill_cases(scene, 200);
+    const int iterations = 50;
+
+    auto referenceStart = clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        for (const FillCase& fillCase : fillCases)
+        {
+            run_fill(scene, expected, fillCase, settings,
+                     reference::segment_foreground_and_get_average_depth);
+        }
+    }
+    auto referenceTime = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - referenceStart);
+
+    auto currentStart = clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        for (const FillCase& fillCase : fillCases)
+        {
+            run_fill(scene, current, fillCase, settings,
+                     segmentation::segment_foreground_and_get_average_depth);
+        }
+    }
+    auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - currentStart);
+
+    const double fillCount = static_cast<double>(iterations * fillCases.size());
+    WARN("reference: " << referenceTime.count() / fillCount << " us/fill, "
+         << "current: " << currentTime.count() / fillCount << " us/fill");
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "../HandSettings.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace astra::plugins::hand;
+
+TEST_CASE("Settings updates only change the keys they contain", "[hand][settings]")
+{
+    HandSettings settings;
+    settings.processingFrameBudget = 12.0f;
+    settings.pointProcessorSettings.segmentationSettings.maxSegmentationDist = 300.0f;
+
+    const bool accepted = update_settings("[pointprocessor]\n"
+                                          "maxHandPointUpdatesPerFrame = 5\n"
+                                          "[areatest]\n"
+                                          "minArea = 2500.0\n",
+                                          settings);
+
+    REQUIRE(accepted);
+    REQUIRE(settings.pointProcessorSettings.maxHandPointUpdatesPerFrame == 5);
+    REQUIRE(settings.pointProcessorSettings.segmentationSettings.areaTestSettings.minArea == 2500.0f);
+
+    //everything else keeps its current value, not the default
+    REQUIRE(settings.processingFrameBudget == 12.0f);
+    REQUIRE(settings.pointProcessorSettings.segmentationSettings.maxSegmentationDist == 300.0f);
+    REQUIRE(settings.pointProcessorSettings.segmentationSettings.areaTestSettings.maxArea == 35000.0f);
+}
+
+TEST_CASE("Settings updates that do not parse are rejected", "[hand][settings]")
+{
+    HandSettings settings;
+    settings.pointProcessorSettings.maxHandPointUpdatesPerFrame = 7;
+
+    REQUIRE_FALSE(update_settings("[pointprocessor\nmaxHandPointUpdatesPerFrame = 5\n", settings));
+    REQUIRE(settings.pointProcessorSettings.maxHandPointUpdatesPerFrame == 7);
+
+    //a value of the wrong type keeps the current one
+    REQUIRE(update_settings("[pointprocessor]\nmaxHandPointUpdatesPerFrame = 5.5\n", settings));
+    REQUIRE(settings.pointProcessorSettings.maxHandPointUpdatesPerFrame == 7);
+
+    //so does an input that is not one of the modes
+    settings.input = HandTrackerInput::Depth;
+    REQUIRE(update_settings("[handtracker]\ninput = \"color\"\n", settings));
+    REQUIRE(settings.input == HandTrackerInput::Depth);
+}
+
+TEST_CASE("Reloading a settings file starts from the defaults", "[hand][settings]")
+{
+    const std::string path = "orbbec_hand_settings_test.toml";
+    {
+        std::ofstream file(path);
+        file << "[handtracker]\n"
+             << "watchSettingsFile = true\n"
+             << "maxHandCount = 4\n"
+             << "input = \"depth\"\n"
+             << "inputDepthSubtype = 2\n"
+             << "[depthutility]\n"
+             << "erodeSize = 2\n";
+    }
+
+    HandSettings settings;
+    settings.processingFrameBudget = 12.0f;
+
+    REQUIRE(parse_settings_file(path, settings));
+    REQUIRE(settings.watchSettingsFile);
+    REQUIRE(settings.maxHandCount == 4);
+    REQUIRE_FALSE(settings.padHandFrames);
+    REQUIRE(settings.input == HandTrackerInput::Depth);
+    REQUIRE(settings.inputDepthSubtype == 2);
+    REQUIRE(settings.depthUtilitySettings.erodeSize == 2);
+    REQUIRE(settings.processingFrameBudget == HandSettings().processingFrameBudget);
+
+    int64_t modifiedTime = 0;
+    REQUIRE(get_settings_file_time(path, modifiedTime));
+    REQUIRE(modifiedTime > 0);
+
+    std::remove(path.c_str());
+
+    //a missing file leaves the settings alone
+    settings.depthUtilitySettings.erodeSize = 3;
+    REQUIRE_FALSE(parse_settings_file(path, settings));
+    REQUIRE(settings.depthUtilitySettings.erodeSize == 3);
+    REQUIRE_FALSE(get_settings_file_time(path, modifiedTime));
+}
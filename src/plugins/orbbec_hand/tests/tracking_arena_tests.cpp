@@ -0,0 +1,298 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <Astra/Plugins/PluginLogger.h>
+#include "tracking_harness.h"
+#include "../DepthUtility.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    std::atomic<size_t> g_allocationCount(0);
+
+    astra_status_t discard_log(void*,
+                               const char*,
+                               astra_log_severity_t,
+                               const char*,
+                               int,
+                               const char*,
+                               const char*,
+                               va_list)
+    {
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    PluginServiceProxyBase create_logging_proxy()
+    {
+        PluginServiceProxyBase proxy = {};
+        proxy.log = &discard_log;
+        return proxy;
+    }
+
+    PluginServiceProxyBase g_loggingProxy = create_logging_proxy();
+}
+
+astra::PluginServiceProxy* __g_serviceProxy = static_cast<astra::PluginServiceProxy*>(&g_loggingProxy);
+
+#if defined(__GLIBC__)
+//cv::Mat buffers come from cv::fastMalloc, which calls malloc rather than
+//operator new. With glibc, malloc itself can be replaced to count them, and
+//operator new below allocates through it as well.
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    void* malloc(size_t size)
+    {
+        ++g_allocationCount;
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        ++g_allocationCount;
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        ++g_allocationCount;
+        return __libc_realloc(ptr, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        ++g_allocationCount;
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** ptr, size_t alignment, size_t size)
+    {
+        ++g_allocationCount;
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr != nullptr ? 0 : ENOMEM;
+    }
+}
+#endif
+
+void* operator new(size_t size)
+{
+#if !defined(__GLIBC__)
+    ++g_allocationCount;
+#endif
+    void* ptr = malloc(size > 0 ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+namespace astra { namespace plugins { namespace hand {
+
+    void require_steady_state_without_allocations(bool debugLayersEnabled,
+                                                  size_t threadCount = 1,
+                                                  int handCount = 1)
+    {
+        const int warmupFrames = 10;
+        const int measuredFrames = 60;
+
+        TrackingHarness harness(160, 120, debugLayersEnabled, threadCount, handCount);
+
+        //the velocity signal HandTracker would compute from the same frames.
+        //Tracking uses the scene's signal, which always has the hands moving.
+        DepthUtility depthUtility(160, 120, harness.settings().depthUtilitySettings);
+        cv::Mat depth;
+        cv::Mat velocitySignal;
+
+        auto process_frame = [&]()
+        {
+            const cv::Size fullSize = harness.scene().depth().size();
+            depthUtility.processPointsToVelocitySignal(harness.scene().world_points(),
+                                                       fullSize.width,
+                                                       fullSize.height,
+                                                       depth,
+                                                       velocitySignal);
+            harness.track_frame();
+        };
+
+        for (int i = 0; i < warmupFrames; ++i)
+        {
+            harness.render(i);
+            process_frame();
+        }
+
+        REQUIRE(harness.tracking_point_count() > 0);
+
+        const uint8_t* segmentationData = harness.arena().layerSegmentation.data;
+        const uint8_t* searchedData = harness.arena().updateForegroundSearched.data;
+        const uint8_t* velocitySignalData = velocitySignal.data;
+        const uint8_t* velocityErodeData = depthUtility.matDepthVelErode().data;
+
+        size_t allocations = 0;
+        for (int i = warmupFrames; i < warmupFrames + measuredFrames; ++i)
+        {
+            harness.render(i);
+
+            const size_t allocationsBefore = g_allocationCount;
+            process_frame();
+            allocations += g_allocationCount - allocationsBefore;
+        }
+
+        REQUIRE(harness.tracking_point_count() > 0);
+        REQUIRE(allocations == 0);
+
+        //the swaying hands show up in the velocity signal as well
+        REQUIRE(cv::countNonZero(velocitySignal) > 0);
+
+        //planes are cleared in place rather than reallocated
+        REQUIRE(harness.arena().layerSegmentation.data == segmentationData);
+        REQUIRE(harness.arena().updateForegroundSearched.data == searchedData);
+        REQUIRE(velocitySignal.data == velocitySignalData);
+        REQUIRE(depthUtility.matDepthVelErode().data == velocityErodeData);
+    }
+}}}
+
+using namespace astra::plugins::hand;
+
+TEST_CASE("Hand tracking makes no heap allocations in steady state", "[hand][arena]")
+{
+    require_steady_state_without_allocations(false);
+}
+
+TEST_CASE("Hand tracking with debug layers makes no heap allocations in steady state", "[hand][arena]")
+{
+    require_steady_state_without_allocations(true);
+}
+
+TEST_CASE("Parallel hand tracking makes no heap allocations in steady state", "[hand][arena]")
+{
+    require_steady_state_without_allocations(false, 4, 3);
+}
+
+TEST_CASE("Tracking arena reallocates only when the size changes", "[hand][arena]")
+{
+    TrackingArena arena;
+
+    arena.begin_frame(cv::Size(160, 120), false);
+    const uint8_t* data = arena.layerScore.data;
+    REQUIRE(arena.worldPoints.size() == 160 * 120);
+
+    arena.layerScore.at<float>(10, 10) = 1.0f;
+    arena.begin_frame(cv::Size(160, 120), false);
+    REQUIRE(arena.layerScore.data == data);
+    REQUIRE(arena.layerScore.at<float>(10, 10) == 0.0f);
+
+    arena.begin_frame(cv::Size(320, 240), false);
+    REQUIRE(arena.layerScore.size() == cv::Size(320, 240));
+    REQUIRE(arena.worldPoints.size() == 320 * 240);
+}
+
+TEST_CASE("Tracking arena only holds debug planes while debug layers are enabled", "[hand][arena]")
+{
+    TrackingArena arena;
+
+    arena.begin_frame(cv::Size(160, 120), false);
+    REQUIRE(arena.debugCreateScore.empty());
+    REQUIRE(arena.debugRefineTestPassMap.empty());
+
+    arena.begin_frame(cv::Size(160, 120), true);
+    REQUIRE(arena.debugCreateScore.size() == cv::Size(160, 120));
+
+    arena.begin_frame(cv::Size(320, 240), true);
+    REQUIRE(arena.debugRefineTestPassMap.size() == cv::Size(320, 240));
+
+    arena.begin_frame(cv::Size(320, 240), false);
+    REQUIRE(arena.debugCreateScore.empty());
+}
+
+TEST_CASE("Hand tracking without debug layers leaves the debug planes unallocated", "[hand][arena]")
+{
+    TrackingHarness harness(160, 120, false);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        harness.render(i);
+        harness.track_frame();
+    }
+
+    REQUIRE(harness.tracking_point_count() > 0);
+    REQUIRE(harness.arena().debugUpdateSegmentation.empty());
+    REQUIRE(harness.arena().debugCreateScoreValue.empty());
+}
+
+TEST_CASE("Point queue is first in first out", "[hand][arena]")
+{
+    PointQueue queue;
+    queue.reserve(4);
+
+    queue.push(PointTTL(1, 2, 3.0f));
+    queue.push(PointTTL(4, 5, 6.0f));
+
+    REQUIRE(queue.front().x == 1);
+    queue.pop();
+    REQUIRE(queue.front().y == 5);
+    queue.pop();
+    REQUIRE(queue.empty());
+
+    queue.clear();
+    queue.push(PointTTL(7, 8, 9.0f));
+    REQUIRE(queue.front().ttl == 9.0f);
+}
+
+TEST_CASE("Point grid finds every point a brute force search finds", "[hand][arena]")
+{
+    const float cellSize = 100.0f;
+    std::vector<cv::Point3f> positions;
+    for (int i = 0; i < 200; ++i)
+    {
+        //spread over a few cells either side of zero, with some points stacked up
+        positions.push_back(cv::Point3f(static_cast<float>((i * 37) % 600 - 300),
+                                        static_cast<float>((i * 53) % 400 - 200),
+                                        static_cast<float>(800 + (i * 71) % 500)));
+    }
+    positions.push_back(positions[5]);
+    positions.push_back(cv::Point3f(-99.9f, 0.0f, 1000.0f));
+    positions.push_back(cv::Point3f(0.0f, 0.0f, 1000.0f));
+
+    PointGrid grid;
+    grid.begin(cellSize);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        grid.add(i, positions[i]);
+    }
+    grid.finish();
+    REQUIRE_FALSE(grid.empty());
+
+    std::vector<size_t> near;
+    for (const cv::Point3f& query : positions)
+    {
+        grid.find_near(query, near);
+
+        REQUIRE(std::is_sorted(near.begin(), near.end()));
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            if (cv::norm(positions[i] - query) < cellSize)
+            {
+                REQUIRE(std::binary_search(near.begin(), near.end(), i));
+            }
+        }
+    }
+
+    //starting over forgets the old points
+    grid.begin(cellSize);
+    grid.finish();
+    REQUIRE(grid.empty());
+    grid.find_near(positions[0], near);
+    REQUIRE(near.empty());
+}
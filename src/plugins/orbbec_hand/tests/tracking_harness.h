@@ -0,0 +1,175 @@
+#ifndef TRACKING_HARNESS_H
+#define TRACKING_HARNESS_H
+
+#include "depth_sequence.h"
+#include "../TrackingPipeline.h"
+#include "../TrackedPoint.h"
+#include "../PointProcessor.h"
+#include "../constants.h"
+#include <common/parallel/WorkerPool.h>
+#include <vector>
+
+namespace astra { namespace plugins { namespace hand {
+
+    // The planes tracking works on for a SyntheticScene of hands with
+    // forearms reaching down out of the image, in front of a far wall,
+    // swaying sideways a few pixels so the tracker keeps working. Hands are
+    // spread across the image at slightly different depths, and the palms
+    // are the velocity signal's foreground.
+    class SyntheticHandScene
+    {
+    public:
+        SyntheticHandScene(int width, int height, int handCount = 1)
+            : m_scene(width, height, layout()),
+              m_handCount(handCount),
+              m_depth(height, width, CV_32FC1),
+              m_velocitySignal(height, width, CV_8UC1),
+              m_worldPoints(width * height)
+        { }
+
+        void render(int frameIndex)
+        {
+            sway_hands(m_handCount, frameIndex, m_hands);
+            m_scene.render(m_hands, m_frame, &m_palmMask);
+
+            const conversion_cache_t& conversionCache = m_scene.conversion_cache();
+            for (int y = 0; y < m_depth.rows; ++y)
+            {
+                float* depthRow = m_depth.ptr<float>(y);
+                uint8_t* velocityRow = m_velocitySignal.ptr<uint8_t>(y);
+
+                for (int x = 0; x < m_depth.cols; ++x)
+                {
+                    const int index = x + y * m_depth.cols;
+                    const float depth = m_frame[index];
+
+                    depthRow[x] = depth;
+                    velocityRow[x] = m_palmMask[index] ? PixelType::Foreground : PixelType::Background;
+
+                    cv::Point3f world = cv_convert_depth_to_world(conversionCache, x, y, depth);
+                    m_worldPoints[index] = Vector3f(world.x, world.y, world.z);
+                }
+            }
+        }
+
+        cv::Mat& depth() { return m_depth; }
+        cv::Mat& velocity_signal() { return m_velocitySignal; }
+        const Vector3f* world_points() const { return m_worldPoints.data(); }
+        const conversion_cache_t& conversion_cache() const { return m_scene.conversion_cache(); }
+
+    private:
+        static SyntheticSceneLayout layout()
+        {
+            SyntheticSceneLayout layout;
+            layout.horizontalFov = 58.0f * PI_F / 180.0f;
+            layout.verticalFov = 45.0f * PI_F / 180.0f;
+            layout.wallDepth = 2500.0f;
+            layout.bodyDepth = 0;
+            layout.palmRadius = 50.0f;
+            layout.armHalfWidth = 35.0f;
+            layout.armLength = 0;
+            return layout;
+        }
+
+        SyntheticScene m_scene;
+        int m_handCount;
+        std::vector<SyntheticHand> m_hands;
+        std::vector<int16_t> m_frame;
+        std::vector<uint8_t> m_palmMask;
+        cv::Mat m_depth;
+        cv::Mat m_velocitySignal;
+        std::vector<Vector3f> m_worldPoints;
+    };
+
+    // Runs a SyntheticHandScene through the same TrackingPipeline as
+    // HandTracker. With a resize factor the scene is rendered at full size
+    // and tracked at the size divided by it.
+    class TrackingHarness
+    {
+    public:
+        TrackingHarness(int width,
+                        int height,
+                        bool debugLayersEnabled,
+                        size_t threadCount = 1,
+                        int handCount = 1,
+                        int resizeFactor = 1)
+            : m_scene(width * resizeFactor, height * resizeFactor, handCount),
+              m_mapper(nullptr),
+              m_workerPool(threadCount),
+              m_pointProcessor(m_settings.pointProcessorSettings, m_workerPool),
+              m_trackingPipeline(m_pointProcessor, m_settings.pointProcessorSettings),
+              m_debugLayersEnabled(debugLayersEnabled),
+              m_resizeFactor(resizeFactor),
+              m_depth(height, width, CV_32FC1),
+              m_velocitySignal(height, width, CV_8UC1)
+        { }
+
+        void render(int frameIndex)
+        {
+            m_scene.render(frameIndex);
+
+            for (int y = 0; y < m_depth.rows; ++y)
+            {
+                const float* fullSizeDepthRow = m_scene.depth().ptr<float>(y * m_resizeFactor);
+                const uint8_t* fullSizeVelocityRow = m_scene.velocity_signal().ptr<uint8_t>(y * m_resizeFactor);
+                float* depthRow = m_depth.ptr<float>(y);
+                uint8_t* velocityRow = m_velocitySignal.ptr<uint8_t>(y);
+
+                for (int x = 0; x < m_depth.cols; ++x)
+                {
+                    depthRow[x] = fullSizeDepthRow[x * m_resizeFactor];
+                    velocityRow[x] = fullSizeVelocityRow[x * m_resizeFactor];
+                }
+            }
+        }
+
+        void track_frame()
+        {
+            TrackingFrame frame(m_depth,
+                                m_velocitySignal,
+                                m_scene.depth().size(),
+                                m_scene.world_points(),
+                                m_mapper,
+                                m_scene.conversion_cache());
+            frame.debugLayersEnabled = m_debugLayersEnabled;
+
+            m_trackingPipeline.track(frame);
+        }
+
+        size_t tracking_point_count()
+        {
+            size_t count = 0;
+            for (const TrackedPoint& point : m_pointProcessor.get_trackedPoints())
+            {
+                if (point.trackingStatus == TrackingStatus::Tracking)
+                {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        std::vector<TrackedPoint>& tracked_points() { return m_pointProcessor.get_trackedPoints(); }
+
+        TrackingArena& arena() { return m_trackingPipeline.arena(); }
+
+        HandSettings& settings() { return m_settings; }
+
+        SyntheticHandScene& scene() { return m_scene; }
+
+    private:
+        HandSettings m_settings;
+        SyntheticHandScene m_scene;
+        CoordinateMapper m_mapper;
+        parallel::WorkerPool m_workerPool;
+        PointProcessor m_pointProcessor;
+        TrackingPipeline m_trackingPipeline;
+        bool m_debugLayersEnabled;
+        int m_resizeFactor;
+        cv::Mat m_depth;
+        cv::Mat m_velocitySignal;
+    };
+
+}}}
+
+#endif // TRACKING_HARNESS_H
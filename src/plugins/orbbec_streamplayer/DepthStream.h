@@ -7,6 +7,7 @@
 #include <common/serialization/FrameStreamReader.h>
 #include "PlaybackStream.h"
 #include <Astra/StreamDescription.h>
+#include <cmath>
 #include <cstring>
 
 using namespace astra::serialization;
@@ -17,20 +18,25 @@ namespace astra { namespace plugins { namespace streamplayer
         class DepthStream : public PlaybackStream<astra_imageframe_wrapper_t>
         {
         public:
-            DepthStream(FrameStreamReader& streamParser,
+            DepthStream(const StreamHeader& streamHeader,
                              PluginServiceProxy& pluginService,
                              astra_streamset_t streamSet)
-                             : PlaybackStream(streamParser, pluginService, streamSet, StreamDescription(
-                                  ASTRA_STREAM_DEPTH,
-                                  DEFAULT_SUBTYPE)) { }
+                             : PlaybackStream(streamHeader, pluginService, streamSet) { }
             virtual ~DepthStream() {}
 
             virtual astra_status_t on_open() override
             {
-                refresh_conversion_cache(1.02259994,
-                                         0.796615660,
-                                         320,
-                                         240);
+                if (m_streamHeader.hasConversionCache)
+                {
+                    m_conversionCache = m_streamHeader.conversionCache;
+                    return ASTRA_STATUS_SUCCESS;
+                }
+
+                //older recordings only kept the frames
+                refresh_conversion_cache(m_streamHeader.horizontalFov > 0 ? m_streamHeader.horizontalFov : DEFAULT_HORIZONTAL_FOV,
+                                         m_streamHeader.verticalFov > 0 ? m_streamHeader.verticalFov : DEFAULT_VERTICAL_FOV,
+                                         m_streamHeader.width > 0 ? m_streamHeader.width : 320,
+                                         m_streamHeader.height > 0 ? m_streamHeader.height : 240);
 
                 return ASTRA_STATUS_SUCCESS;
             }
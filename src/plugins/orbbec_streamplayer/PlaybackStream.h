@@ -5,6 +5,7 @@
 #include <Astra/Plugins/StreamBin.h>
 #include <Astra/Plugins/plugin_capi.h>
 #include <AstraUL/streams/image_parameters.h>
+#include <AstraUL/Plugins/stream_types.h>
 #include <common/serialization/FrameStreamReader.h>
 #include <cstring>
 
@@ -12,6 +13,27 @@ using namespace astra::serialization;
 
 namespace astra { namespace plugins { namespace streamplayer {
 
+    //what the sensor reports, for recordings that did not keep it
+    const float DEFAULT_HORIZONTAL_FOV = 1.02259994f;
+    const float DEFAULT_VERTICAL_FOV = 0.796615660f;
+
+    //frames are recorded with the pointers of the process that recorded them,
+    //these point the copied wrapper at its own data
+    inline void relink_frame_data(astra_imageframe_wrapper_t* frameWrapper)
+    {
+        frameWrapper->frame.data = &(frameWrapper->frame_data);
+    }
+
+    inline void relink_frame_data(astra_handframe_wrapper_t* frameWrapper)
+    {
+        frameWrapper->frame.handpoints = reinterpret_cast<astra_handpoint_t*>(&(frameWrapper->frame_data));
+    }
+
+    inline void relink_frame_data(astra_gestureframe_wrapper_t* frameWrapper)
+    {
+        frameWrapper->frame.events = reinterpret_cast<astra_gesture_event_t*>(&(frameWrapper->frame_data));
+    }
+
     class PlaybackStreamBase : public Stream
     {
     public:
@@ -24,7 +46,8 @@ namespace astra { namespace plugins { namespace streamplayer {
 
         virtual ~PlaybackStreamBase() { };
 
-        virtual astra_status_t read() = 0;
+        //publishes a frame read from the recording
+        virtual astra_status_t play(astra::serialization::Frame& frame) = 0;
         virtual astra_status_t open() = 0;
         virtual astra_status_t close() = 0;
         virtual astra_status_t start() = 0;
@@ -37,10 +60,9 @@ namespace astra { namespace plugins { namespace streamplayer {
     public:
         using wrapper_type = TFrameWrapper;
 
-        PlaybackStream(FrameStreamReader& depthStreamParser,
+        PlaybackStream(const StreamHeader& streamHeader,
                         PluginServiceProxy& pluginService,
-                        astra_streamset_t streamSet,
-                        StreamDescription desc);
+                        astra_streamset_t streamSet);
 
         virtual ~PlaybackStream();
 
@@ -48,7 +70,7 @@ namespace astra { namespace plugins { namespace streamplayer {
         virtual astra_status_t start() override { return ASTRA_STATUS_SUCCESS; }
         virtual astra_status_t stop() override { return ASTRA_STATUS_SUCCESS; }
         virtual astra_status_t open() override;
-        virtual astra_status_t read() override;
+        virtual astra_status_t play(astra::serialization::Frame& frame) override;
 
         bool is_streaming();
 
@@ -66,7 +88,7 @@ namespace astra { namespace plugins { namespace streamplayer {
             return ASTRA_STATUS_SUCCESS;
         }
 
-        FrameStreamReader& m_frameStreamReader;
+        const StreamHeader m_streamHeader;
 
     private:
         bool m_isOpen{ false };
@@ -79,14 +101,15 @@ namespace astra { namespace plugins { namespace streamplayer {
     };
 
     template<typename TFrameWrapper>
-    PlaybackStream<TFrameWrapper>::PlaybackStream(FrameStreamReader& frameStreamReader,
+    PlaybackStream<TFrameWrapper>::PlaybackStream(const StreamHeader& streamHeader,
                                                     PluginServiceProxy& pluginService,
-                                                    astra_streamset_t streamSet,
-                                                    StreamDescription desc) :
+                                                    astra_streamset_t streamSet) :
                                                     PlaybackStreamBase(pluginService,
                                                     streamSet,
-                                                    desc),
-                                                    m_frameStreamReader(frameStreamReader)
+                                                    StreamDescription(
+                                                        streamHeader.frameType,
+                                                        streamHeader.subtype)),
+                                                    m_streamHeader(streamHeader)
     {
 
     }
@@ -105,10 +128,13 @@ namespace astra { namespace plugins { namespace streamplayer {
             return ASTRA_STATUS_SUCCESS;
         }
 
+        const size_t maxFrameLength = m_streamHeader.maxFrameLength;
+        const size_t dataLength = maxFrameLength > sizeof(wrapper_type) ? maxFrameLength - sizeof(wrapper_type) : 0;
+
         m_bin = std::make_unique<StreamBin<wrapper_type> >(
             pluginService(),
             get_handle(),
-            m_frameStreamReader.get_buffer_length() - sizeof(wrapper_type));
+            dataLength);
 
         on_open();
 
@@ -171,7 +197,7 @@ namespace astra { namespace plugins { namespace streamplayer {
                 if (rc == ASTRA_STATUS_SUCCESS)
                 {
                     float* hFov = reinterpret_cast<float*>(parameterData);
-                    *hFov = 1.02259994;
+                    *hFov = m_streamHeader.horizontalFov > 0 ? m_streamHeader.horizontalFov : DEFAULT_HORIZONTAL_FOV;
                 }
                 break;
             }
@@ -186,7 +212,7 @@ namespace astra { namespace plugins { namespace streamplayer {
                 if (rc == ASTRA_STATUS_SUCCESS)
                 {
                     float* vFov = reinterpret_cast<float*>(parameterData);
-                    *vFov = 0.796615660;
+                    *vFov = m_streamHeader.verticalFov > 0 ? m_streamHeader.verticalFov : DEFAULT_VERTICAL_FOV;
                 }
                 break;
             }
@@ -194,24 +220,23 @@ namespace astra { namespace plugins { namespace streamplayer {
     }
 
     template<typename TFrameWrapper>
-    astra_status_t PlaybackStream<TFrameWrapper>::read()
+    astra_status_t PlaybackStream<TFrameWrapper>::play(astra::serialization::Frame& decodedFrame)
     {
-        if (!is_streaming()) return ASTRA_STATUS_SUCCESS;
+        if (!is_streaming() || m_bin == nullptr) return ASTRA_STATUS_SUCCESS;
 
-        if (!m_frameStreamReader.read())
+        if (decodedFrame.byteLength < static_cast<int>(sizeof(wrapper_type)) ||
+            decodedFrame.byteLength > m_streamHeader.maxFrameLength)
         {
-            return ASTRA_STATUS_SUCCESS;
+            return ASTRA_STATUS_INVALID_PARAMETER;
         }
 
-        astra::serialization::Frame& decodedFrame = m_frameStreamReader.peek();
-
         auto framePair = m_bin->begin_write_ex(m_frameIndex);
 
         wrapper_type* frameWrapper = framePair.second;
         astra_frame_t* frame = framePair.first;
 
 	std::memcpy(frame->data, decodedFrame.rawFrameWrapper, decodedFrame.byteLength);
-        frameWrapper->frame.data = &(frameWrapper->frame_data);
+        relink_frame_data(frameWrapper);
         frameWrapper->frame.frame = frame;
 
         m_bin->end_write();
@@ -68,7 +68,7 @@ namespace astra { namespace plugins { namespace streamplayer {
                 m_frameStream = std::unique_ptr<FrameInputStream>(open_frame_input_stream(STREAMPLAYERPLUGIN_FILE_PATH));
                 m_frameStreamReader = std::make_unique<FrameStreamReader>(m_frameStream.get());
 
-                open_stream();
+                open_streams();
 
                 m_isOpen = true;
             }
@@ -89,7 +89,10 @@ namespace astra { namespace plugins { namespace streamplayer {
 
             for (StreamPtr& s : m_streams)
             {
-                s->close();
+                if (s != nullptr)
+                {
+                    s->close();
+                }
             }
 
             m_streams.clear();
@@ -106,33 +109,85 @@ namespace astra { namespace plugins { namespace streamplayer {
                 return ASTRA_STATUS_SUCCESS;
             }
 
-            for (StreamPtr& s : m_streams)
+            //frames of all the streams come interleaved, in the order they were
+            //recorded. Playing no more of them than there are streams keeps a
+            //slow update from looping over a whole recording
+            for (size_t i = 0; i < m_streams.size() && m_frameStreamReader->read(); ++i)
             {
-                s->read();
+                astra::serialization::Frame& frame = m_frameStreamReader->peek();
+
+                if (frame.streamId >= 0 &&
+                    frame.streamId < static_cast<int>(m_streams.size()) &&
+                    m_streams[frame.streamId] != nullptr)
+                {
+                    m_streams[frame.streamId]->play(frame);
+                }
             }
 
             return ASTRA_STATUS_SUCCESS;
         }
 
     private:
-        astra_status_t open_stream()
+        void open_streams()
         {
-            switch (m_frameStreamReader->get_stream_type())
+            //streams keep their place in the recording, frames name them by it
+            for (int streamId = 0; streamId < m_frameStreamReader->get_stream_count(); ++streamId)
             {
-                case ASTRA_STREAM_DEPTH:
+                StreamHeader* recordedHeader = nullptr;
+                if (!m_frameStreamReader->get_stream_header(streamId, recordedHeader))
+                {
+                    m_streams.push_back(nullptr);
+                    continue;
+                }
+
+                StreamHeader streamHeader = *recordedHeader;
+                if (streamHeader.maxFrameLength == 0)
+                {
+                    //the format does not know its largest frame, so size for the first
+                    streamHeader.maxFrameLength = m_frameStreamReader->get_buffer_length();
+                }
+
+                PlaybackStreamBase* stream = create_stream(streamHeader);
+                if (stream != nullptr)
                 {
-                    DepthStream* stream = make_stream<DepthStream>(*m_frameStreamReader, m_pluginService, m_streamSetHandle);
                     stream->open();
-                    m_streams.push_back(StreamPtr(stream));
-                    break;
+                }
+
+                m_streams.push_back(StreamPtr(stream));
+            }
+        }
+
+        PlaybackStreamBase* create_stream(const StreamHeader& streamHeader)
+        {
+            switch (streamHeader.frameType)
+            {
+                case ASTRA_STREAM_DEPTH:
+                {
+                    return make_stream<DepthStream>(streamHeader, m_pluginService, m_streamSetHandle);
+                }
+                case ASTRA_STREAM_COLOR:
+                case ASTRA_STREAM_INFRARED:
+                case ASTRA_STREAM_STYLIZED_DEPTH:
+                case ASTRA_STREAM_POINT:
+                case ASTRA_STREAM_NORMAL:
+                case ASTRA_STREAM_COLORED_POINT:
+                case ASTRA_STREAM_DEBUG_HAND:
+                {
+                    return make_stream<PlaybackStream<astra_imageframe_wrapper_t> >(streamHeader, m_pluginService, m_streamSetHandle);
+                }
+                case ASTRA_STREAM_HAND:
+                {
+                    return make_stream<PlaybackStream<astra_handframe_wrapper_t> >(streamHeader, m_pluginService, m_streamSetHandle);
+                }
+                case ASTRA_STREAM_GESTURE:
+                {
+                    return make_stream<PlaybackStream<astra_gestureframe_wrapper_t> >(streamHeader, m_pluginService, m_streamSetHandle);
                 }
                 default:
                 {
-                    return ASTRA_STATUS_DEVICE_ERROR;
+                    return nullptr;
                 }
             }
-
-            return ASTRA_STATUS_SUCCESS;
         }
 
 
@@ -0,0 +1,195 @@
+#include "ColoredPointCalculator.h"
+#include <Shiny.h>
+#include <algorithm>
+#include <cmath>
+
+namespace astra { namespace plugins { namespace xs {
+
+    namespace {
+
+        const int MIN_ROWS_PER_BAND = 16;
+
+        // per-frame constants shared by every row
+        struct ProjectionParams
+        {
+            float xzFactor;
+            float yzFactor;
+            float invResolutionX;
+            float invResolutionY;
+
+            float fx, fy, cx, cy;
+            float tx, ty, tz;
+
+            const float* p_rayX;
+            const float* p_rayY;
+            const float* p_rayZ;
+
+            const astra_rgb_pixel_t* p_color;
+            int colorWidth;
+            int colorHeight;
+        };
+
+        // Computes the world point and the color sample for one depth pixel.
+        // Only the color fetch depends on the data; everything else is
+        // branch free so the surrounding loops vectorize.
+        inline void color_point(const ProjectionParams& params,
+                                int x,
+                                float normalizedY,
+                                size_t index,
+                                int16_t depthValue,
+                                float& pointX,
+                                float& pointY,
+                                float& pointZ,
+                                astra_rgb_pixel_t& color,
+                                uint8_t& alpha)
+        {
+            const float z = static_cast<uint16_t>(depthValue);
+            const float normalizedX = x * params.invResolutionX - .5f;
+
+            pointX = normalizedX * z * params.xzFactor;
+            pointY = normalizedY * z * params.yzFactor;
+            pointZ = z;
+
+            const float colorX = z * params.p_rayX[index] + params.tx;
+            const float colorY = z * params.p_rayY[index] + params.ty;
+            const float colorZ = z * params.p_rayZ[index] + params.tz;
+
+            const float invZ = colorZ > 0 ? 1.0f / colorZ : 0.0f;
+
+            //clamp before converting so points near the camera plane cannot overflow
+            const float colorU = std::min(std::max(params.fx * colorX * invZ + params.cx + 0.5f, -1.0f),
+                                          static_cast<float>(params.colorWidth));
+            const float colorV = std::min(std::max(params.fy * colorY * invZ + params.cy + 0.5f, -1.0f),
+                                          static_cast<float>(params.colorHeight));
+
+            const int u = static_cast<int>(std::floor(colorU));
+            const int v = static_cast<int>(std::floor(colorV));
+
+            const bool isValid = z > 0 &&
+                                 colorZ > 0 &&
+                                 u >= 0 && u < params.colorWidth &&
+                                 v >= 0 && v < params.colorHeight;
+
+            const int colorIndex = isValid ? v * params.colorWidth + u : 0;
+            const astra_rgb_pixel_t sample = params.p_color[colorIndex];
+
+            color.r = isValid ? sample.r : 0;
+            color.g = isValid ? sample.g : 0;
+            color.b = isValid ? sample.b : 0;
+            alpha = isValid ? 255 : 0;
+        }
+    }
+
+    ColoredPointCalculator::ColoredPointCalculator(parallel::WorkerPool& workerPool)
+        : m_workerPool(workerPool)
+    {}
+
+    void ColoredPointCalculator::calculate_colored_points(const int16_t* p_depth,
+                                                          int width,
+                                                          int height,
+                                                          const conversion_cache_t& depthConversionCache,
+                                                          DepthRegistration& registration,
+                                                          const astra_rgb_pixel_t* p_color,
+                                                          int colorWidth,
+                                                          int colorHeight,
+                                                          astra_colored_point_layout_t layout,
+                                                          void* p_output)
+    {
+        PROFILE_FUNC();
+
+        registration.update_lookup_table(width, height);
+
+        const astra_depth_calibration_t& calibration = registration.calibration();
+        const astra_camera_intrinsics_t& color = calibration.colorIntrinsics;
+
+        //the calibration may describe a different color mode than the frames
+        const float scaleX = static_cast<float>(colorWidth) / color.width;
+        const float scaleY = static_cast<float>(colorHeight) / color.height;
+
+        ProjectionParams params;
+        params.xzFactor = depthConversionCache.xzFactor;
+        params.yzFactor = depthConversionCache.yzFactor;
+        params.invResolutionX = 1.0f / depthConversionCache.resolutionX;
+        params.invResolutionY = 1.0f / depthConversionCache.resolutionY;
+        params.fx = color.fx * scaleX;
+        params.fy = color.fy * scaleY;
+        params.cx = color.cx * scaleX;
+        params.cy = color.cy * scaleY;
+        params.tx = calibration.translation[0];
+        params.ty = calibration.translation[1];
+        params.tz = calibration.translation[2];
+        params.p_rayX = registration.ray_x();
+        params.p_rayY = registration.ray_y();
+        params.p_rayZ = registration.ray_z();
+        params.p_color = p_color;
+        params.colorWidth = colorWidth;
+        params.colorHeight = colorHeight;
+
+        const size_t length = width * height;
+
+        if (layout == ASTRA_COLORED_POINT_LAYOUT_PLANAR)
+        {
+            float* p_x = static_cast<float*>(p_output);
+            float* p_y = p_x + length;
+            float* p_z = p_y + length;
+            uint8_t* p_r = reinterpret_cast<uint8_t*>(p_z + length);
+            uint8_t* p_g = p_r + length;
+            uint8_t* p_b = p_g + length;
+            uint8_t* p_alpha = p_b + length;
+
+            m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+            {
+                for (int y = rowBegin; y < rowEnd; ++y)
+                {
+                    const float normalizedY = .5f - y * params.invResolutionY;
+                    size_t index = y * width;
+
+                    for (int x = 0; x < width; ++x, ++index)
+                    {
+                        astra_rgb_pixel_t rgb;
+                        color_point(params, x, normalizedY, index, p_depth[index],
+                                    p_x[index], p_y[index], p_z[index],
+                                    rgb, p_alpha[index]);
+
+                        p_r[index] = rgb.r;
+                        p_g[index] = rgb.g;
+                        p_b[index] = rgb.b;
+                    }
+                }
+            });
+        }
+        else
+        {
+            astra_colored_point_t* p_points = static_cast<astra_colored_point_t*>(p_output);
+
+            m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+            {
+                for (int y = rowBegin; y < rowEnd; ++y)
+                {
+                    const float normalizedY = .5f - y * params.invResolutionY;
+                    size_t index = y * width;
+
+                    for (int x = 0; x < width; ++x, ++index)
+                    {
+                        astra_colored_point_t& point = p_points[index];
+
+                        float pointX, pointY, pointZ;
+                        astra_rgb_pixel_t rgb;
+                        uint8_t alpha;
+                        color_point(params, x, normalizedY, index, p_depth[index],
+                                    pointX, pointY, pointZ, rgb, alpha);
+
+                        point.x = pointX;
+                        point.y = pointY;
+                        point.z = pointZ;
+                        point.r = rgb.r;
+                        point.g = rgb.g;
+                        point.b = rgb.b;
+                        point.alpha = alpha;
+                    }
+                }
+            });
+        }
+    }
+
+}}}
@@ -0,0 +1,38 @@
+#ifndef COLOREDPOINTCALCULATOR_H
+#define COLOREDPOINTCALCULATOR_H
+
+#include <AstraUL/AstraUL.h>
+#include <AstraUL/streams/depth_types.h>
+#include <common/parallel/WorkerPool.h>
+#include "DepthRegistration.h"
+
+namespace astra { namespace plugins { namespace xs {
+
+    class ColoredPointCalculator
+    {
+    public:
+        ColoredPointCalculator(parallel::WorkerPool& workerPool);
+
+        // Converts depth to world points and samples the color image at each
+        // point's projection in a single pass over the depth frame. The
+        // projection uses the registration calibration, with the color
+        // intrinsics rescaled to colorWidth x colorHeight.
+        // p_output holds width * height * sizeof(astra_colored_point_t) bytes.
+        void calculate_colored_points(const int16_t* p_depth,
+                                      int width,
+                                      int height,
+                                      const conversion_cache_t& depthConversionCache,
+                                      DepthRegistration& registration,
+                                      const astra_rgb_pixel_t* p_color,
+                                      int colorWidth,
+                                      int colorHeight,
+                                      astra_colored_point_layout_t layout,
+                                      void* p_output);
+
+    private:
+        parallel::WorkerPool& m_workerPool;
+    };
+
+}}}
+
+#endif /* COLOREDPOINTCALCULATOR_H */
@@ -0,0 +1,61 @@
+#include "ColoredPointStream.h"
+#include <AstraUL/streams/colored_point_parameters.h>
+#include <cstring>
+
+namespace astra { namespace plugins { namespace xs {
+
+    void ColoredPointStream::on_set_parameter(astra_streamconnection_t connection,
+                                              astra_parameter_id id,
+                                              size_t inByteLength,
+                                              astra_parameter_data_t inData)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_COLORED_POINT_LAYOUT:
+            set_layout_parameter(inByteLength, inData);
+            break;
+        }
+    }
+
+    void ColoredPointStream::on_get_parameter(astra_streamconnection_t connection,
+                                              astra_parameter_id id,
+                                              astra_parameter_bin_t& parameterBin)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_COLORED_POINT_LAYOUT:
+            get_layout_parameter(parameterBin);
+            break;
+        }
+    }
+
+    void ColoredPointStream::get_layout_parameter(astra_parameter_bin_t& parameterBin)
+    {
+        size_t resultByteLength = sizeof(int32_t);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            int32_t layout = m_layout;
+            memcpy(parameterData, &layout, resultByteLength);
+        }
+    }
+
+    void ColoredPointStream::set_layout_parameter(size_t inByteLength, astra_parameter_data_t& inData)
+    {
+        if (inByteLength >= sizeof(int32_t))
+        {
+            int32_t newLayout;
+            memcpy(&newLayout, inData, sizeof(int32_t));
+
+            if (newLayout == ASTRA_COLORED_POINT_LAYOUT_INTERLEAVED ||
+                newLayout == ASTRA_COLORED_POINT_LAYOUT_PLANAR)
+            {
+                m_layout = static_cast<astra_colored_point_layout_t>(newLayout);
+            }
+        }
+    }
+}}}
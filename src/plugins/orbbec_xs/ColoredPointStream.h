@@ -0,0 +1,46 @@
+#ifndef COLOREDPOINTSTREAM_H
+#define COLOREDPOINTSTREAM_H
+
+#include <Astra/Plugins/SingleBinStream.h>
+#include <AstraUL/streams/colored_point_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <Shiny.h>
+
+namespace astra { namespace plugins { namespace xs {
+
+    class ColoredPointStream : public astra::plugins::SingleBinStream<astra_imageframe_wrapper_t>
+    {
+    public:
+        ColoredPointStream(PluginServiceProxy& pluginService,
+                           astra_streamset_t streamSet,
+                           uint32_t width,
+                           uint32_t height)
+            : SingleBinStream(pluginService,
+                              streamSet,
+                              StreamDescription(ASTRA_STREAM_COLORED_POINT,
+                                                DEFAULT_SUBTYPE),
+                              width * height * sizeof(astra_colored_point_t))
+        {}
+
+        astra_colored_point_layout_t layout() const { return m_layout; }
+
+    protected:
+        virtual void on_set_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      size_t inByteLength,
+                                      astra_parameter_data_t inData) override;
+
+        virtual void on_get_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      astra_parameter_bin_t& parameterBin) override;
+
+    private:
+        void get_layout_parameter(astra_parameter_bin_t& parameterBin);
+        void set_layout_parameter(size_t inByteLength, astra_parameter_data_t& inData);
+
+        astra_colored_point_layout_t m_layout{ ASTRA_COLORED_POINT_LAYOUT_INTERLEAVED };
+    };
+}}}
+
+#endif /* COLOREDPOINTSTREAM_H */
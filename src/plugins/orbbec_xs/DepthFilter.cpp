@@ -0,0 +1,299 @@
+#include "DepthFilter.h"
+#include <Shiny.h>
+#include <algorithm>
+#include <cmath>
+
+namespace astra { namespace plugins { namespace xs {
+
+    namespace {
+
+        const int MIN_ROWS_PER_BAND = 16;
+
+        const int MAX_HOLE_FILL_RADIUS = 64;
+        const int MAX_SPATIAL_RADIUS = 16;
+        const float MIN_TEMPORAL_ALPHA = 0.01f;
+
+        // 1 when the neighbor lies on the same surface as a valid center, else 0
+        inline float edge_weight(float center, float neighbor, float edgeThreshold)
+        {
+            return center != 0 &&
+                   neighbor != 0 &&
+                   std::fabs(neighbor - center) <= edgeThreshold ? 1.0f : 0.0f;
+        }
+
+        inline void resolve_average(const float* p_sum, const float* p_count, int width, float* p_out)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const float count = p_count[x];
+                p_out[x] = count > 0 ? p_sum[x] / count : 0.0f;
+            }
+        }
+    }
+
+    DepthFilter::DepthFilter(parallel::WorkerPool& workerPool)
+        : m_workerPool(workerPool)
+    {}
+
+    astra_depth_filter_settings_t DepthFilter::default_settings()
+    {
+        astra_depth_filter_settings_t settings;
+
+        settings.holeFillRadius = 4;
+        settings.spatialRadius = 2;
+        settings.spatialEdgeThreshold = 40.0f;
+        settings.temporalAlpha = 0.5f;
+        settings.temporalJumpThreshold = 0.1f;
+
+        return settings;
+    }
+
+    astra_depth_filter_settings_t DepthFilter::sanitize_settings(const astra_depth_filter_settings_t& settings)
+    {
+        astra_depth_filter_settings_t sanitized = settings;
+
+        sanitized.holeFillRadius = std::min(std::max(settings.holeFillRadius, 0), MAX_HOLE_FILL_RADIUS);
+        sanitized.spatialRadius = std::min(std::max(settings.spatialRadius, 0), MAX_SPATIAL_RADIUS);
+        sanitized.spatialEdgeThreshold = std::max(settings.spatialEdgeThreshold, 0.0f);
+        sanitized.temporalAlpha = std::min(std::max(settings.temporalAlpha, MIN_TEMPORAL_ALPHA), 1.0f);
+        sanitized.temporalJumpThreshold = std::max(settings.temporalJumpThreshold, 0.0f);
+
+        return sanitized;
+    }
+
+    void DepthFilter::reset()
+    {
+        m_hasHistory = false;
+    }
+
+    void DepthFilter::prepare_buffers(int width, int height)
+    {
+        if (!m_hasHistory)
+        {
+            std::fill(m_average.begin(), m_average.end(), 0.0f);
+            m_hasHistory = true;
+        }
+
+        if (width == m_width && height == m_height)
+        {
+            return;
+        }
+
+        m_width = width;
+        m_height = height;
+
+        const size_t length = width * height;
+        m_filled.resize(length);
+        m_horizontal.resize(length);
+        m_smoothed.resize(length);
+        m_sum.resize(length);
+        m_count.resize(length);
+        m_average.assign(length, 0.0f);
+    }
+
+    void DepthFilter::filter_depth(const int16_t* p_depth,
+                                   int width,
+                                   int height,
+                                   const astra_depth_filter_settings_t& settings,
+                                   int16_t* p_filtered)
+    {
+        PROFILE_FUNC();
+
+        prepare_buffers(width, height);
+
+        const int holeFillRadius = settings.holeFillRadius;
+        const int spatialRadius = settings.spatialRadius;
+        const float edgeThreshold = settings.spatialEdgeThreshold;
+
+        m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            fill_hole_rows(p_depth, width, holeFillRadius, rowBegin, rowEnd);
+
+            if (spatialRadius > 0)
+            {
+                smooth_horizontal_rows(width, spatialRadius, edgeThreshold, rowBegin, rowEnd);
+            }
+        });
+
+        //the vertical pass reads rows owned by neighboring bands
+        const float* p_current = m_filled.data();
+        if (spatialRadius > 0)
+        {
+            m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+            {
+                smooth_vertical_rows(width, height, spatialRadius, edgeThreshold, rowBegin, rowEnd);
+            });
+            p_current = m_smoothed.data();
+        }
+
+        m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            blend_temporal_rows(p_current,
+                                width,
+                                settings.temporalAlpha,
+                                settings.temporalJumpThreshold,
+                                rowBegin,
+                                rowEnd,
+                                p_filtered);
+        });
+    }
+
+    void DepthFilter::fill_hole_rows(const int16_t* p_depth, int width, int radius, int rowBegin, int rowEnd)
+    {
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const int16_t* p_row = p_depth + y * width;
+            float* p_out = m_filled.data() + y * width;
+
+            if (radius == 0)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    p_out[x] = p_row[x];
+                }
+                continue;
+            }
+
+            //nearest valid depth to the left within the radius
+            float lastDepth = 0;
+            int distance = radius + 1;
+            for (int x = 0; x < width; ++x)
+            {
+                const float depth = p_row[x];
+                if (depth != 0)
+                {
+                    lastDepth = depth;
+                    distance = 0;
+                }
+                else
+                {
+                    ++distance;
+                }
+
+                p_out[x] = depth != 0 ? depth : (distance <= radius ? lastDepth : 0.0f);
+            }
+
+            //and to the right; the farther candidate wins so holes at object
+            //boundaries take the background instead of growing the foreground
+            lastDepth = 0;
+            distance = radius + 1;
+            for (int x = width - 1; x >= 0; --x)
+            {
+                const float depth = p_row[x];
+                if (depth != 0)
+                {
+                    lastDepth = depth;
+                    distance = 0;
+                }
+                else
+                {
+                    ++distance;
+
+                    const float candidate = distance <= radius ? lastDepth : 0.0f;
+                    p_out[x] = std::max(p_out[x], candidate);
+                }
+            }
+        }
+    }
+
+    void DepthFilter::smooth_horizontal_rows(int width, int radius, float edgeThreshold, int rowBegin, int rowEnd)
+    {
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const size_t rowStart = y * width;
+            const float* p_row = m_filled.data() + rowStart;
+            float* p_sum = m_sum.data() + rowStart;
+            float* p_count = m_count.data() + rowStart;
+
+            std::fill(p_sum, p_sum + width, 0.0f);
+            std::fill(p_count, p_count + width, 0.0f);
+
+            //one sweep per offset keeps the inner loop free of bounds checks
+            for (int k = -radius; k <= radius; ++k)
+            {
+                const int xBegin = std::max(0, -k);
+                const int xEnd = std::min(width, width - k);
+
+                for (int x = xBegin; x < xEnd; ++x)
+                {
+                    const float neighbor = p_row[x + k];
+                    const float weight = edge_weight(p_row[x], neighbor, edgeThreshold);
+
+                    p_sum[x] += weight * neighbor;
+                    p_count[x] += weight;
+                }
+            }
+
+            resolve_average(p_sum, p_count, width, m_horizontal.data() + rowStart);
+        }
+    }
+
+    void DepthFilter::smooth_vertical_rows(int width, int height, int radius, float edgeThreshold, int rowBegin, int rowEnd)
+    {
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const size_t rowStart = y * width;
+            const float* p_guide = m_filled.data() + rowStart;
+            float* p_sum = m_sum.data() + rowStart;
+            float* p_count = m_count.data() + rowStart;
+
+            std::fill(p_sum, p_sum + width, 0.0f);
+            std::fill(p_count, p_count + width, 0.0f);
+
+            const int yBegin = std::max(0, y - radius);
+            const int yEnd = std::min(height, y + radius + 1);
+
+            //edges are judged on the unsmoothed depth so both passes agree
+            //on which pixels belong to the same surface
+            for (int neighborY = yBegin; neighborY < yEnd; ++neighborY)
+            {
+                const float* p_neighborGuide = m_filled.data() + neighborY * width;
+                const float* p_neighbor = m_horizontal.data() + neighborY * width;
+
+                for (int x = 0; x < width; ++x)
+                {
+                    const float weight = edge_weight(p_guide[x], p_neighborGuide[x], edgeThreshold);
+
+                    p_sum[x] += weight * p_neighbor[x];
+                    p_count[x] += weight;
+                }
+            }
+
+            resolve_average(p_sum, p_count, width, m_smoothed.data() + rowStart);
+        }
+    }
+
+    void DepthFilter::blend_temporal_rows(const float* p_current,
+                                          int width,
+                                          float alpha,
+                                          float jumpThreshold,
+                                          int rowBegin,
+                                          int rowEnd,
+                                          int16_t* p_filtered)
+    {
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const size_t rowStart = y * width;
+            const float* p_row = p_current + rowStart;
+            float* p_average = m_average.data() + rowStart;
+            int16_t* p_out = p_filtered + rowStart;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const float depth = p_row[x];
+                const float average = p_average[x];
+
+                //start over on holes, new pixels and large jumps
+                const bool isReset = depth == 0 ||
+                                     average == 0 ||
+                                     std::fabs(depth - average) > jumpThreshold * average;
+
+                const float blended = isReset ? depth : average + alpha * (depth - average);
+
+                p_average[x] = blended;
+                p_out[x] = static_cast<int16_t>(blended + 0.5f);
+            }
+        }
+    }
+
+}}}
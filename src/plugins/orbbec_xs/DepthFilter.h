@@ -0,0 +1,66 @@
+#ifndef DEPTHFILTER_H
+#define DEPTHFILTER_H
+
+#include <AstraUL/streams/depth_types.h>
+#include <common/parallel/WorkerPool.h>
+#include <cstdint>
+#include <vector>
+
+namespace astra { namespace plugins { namespace xs {
+
+    // Full resolution depth cleanup: hole filling, edge-preserving spatial
+    // smoothing and an exponential moving average over time. Every stage
+    // works on whole rows so the inner loops vectorize and bands of rows
+    // are spread over the worker pool.
+    class DepthFilter
+    {
+    public:
+        DepthFilter(parallel::WorkerPool& workerPool);
+
+        static astra_depth_filter_settings_t default_settings();
+
+        // clamps every setting into its supported range
+        static astra_depth_filter_settings_t sanitize_settings(const astra_depth_filter_settings_t& settings);
+
+        // forgets the temporal history
+        void reset();
+
+        void filter_depth(const int16_t* p_depth,
+                          int width,
+                          int height,
+                          const astra_depth_filter_settings_t& settings,
+                          int16_t* p_filtered);
+
+    private:
+        void prepare_buffers(int width, int height);
+
+        void fill_hole_rows(const int16_t* p_depth, int width, int radius, int rowBegin, int rowEnd);
+        void smooth_horizontal_rows(int width, int radius, float edgeThreshold, int rowBegin, int rowEnd);
+        void smooth_vertical_rows(int width, int height, int radius, float edgeThreshold, int rowBegin, int rowEnd);
+        void blend_temporal_rows(const float* p_current,
+                                 int width,
+                                 float alpha,
+                                 float jumpThreshold,
+                                 int rowBegin,
+                                 int rowEnd,
+                                 int16_t* p_filtered);
+
+        parallel::WorkerPool& m_workerPool;
+
+        int m_width{ 0 };
+        int m_height{ 0 };
+        bool m_hasHistory{ false };
+
+        std::vector<float> m_filled;
+        std::vector<float> m_horizontal;
+        std::vector<float> m_smoothed;
+        std::vector<float> m_average;
+
+        // per pixel weight and weighted sum for the smoothing passes
+        std::vector<float> m_sum;
+        std::vector<float> m_count;
+    };
+
+}}}
+
+#endif /* DEPTHFILTER_H */
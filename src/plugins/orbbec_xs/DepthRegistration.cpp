@@ -0,0 +1,281 @@
+#include "DepthRegistration.h"
+#include <Shiny.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace astra { namespace plugins { namespace xs {
+
+    namespace {
+
+        const int MIN_ROWS_PER_BAND = 16;
+
+        const int MAX_SPLAT_SIZE = 4;
+
+        const float MAX_DEPTH = std::numeric_limits<int16_t>::max();
+
+        inline void z_test(int16_t& target, int16_t depth)
+        {
+            if (target == 0 || depth < target)
+            {
+                target = depth;
+            }
+        }
+    }
+
+    DepthRegistration::DepthRegistration(parallel::WorkerPool& workerPool)
+        : m_workerPool(workerPool)
+    {
+        memset(&m_calibration, 0, sizeof(astra_depth_calibration_t));
+    }
+
+    astra_depth_calibration_t DepthRegistration::default_calibration(const conversion_cache_t& depthConversionCache)
+    {
+        astra_depth_calibration_t calibration;
+        memset(&calibration, 0, sizeof(astra_depth_calibration_t));
+
+        astra_camera_intrinsics_t& depth = calibration.depthIntrinsics;
+        depth.width = depthConversionCache.resolutionX;
+        depth.height = depthConversionCache.resolutionY;
+        depth.fx = depthConversionCache.coeffX;
+        depth.fy = depthConversionCache.coeffY;
+        depth.cx = depthConversionCache.resolutionX / 2.0f;
+        depth.cy = depthConversionCache.resolutionY / 2.0f;
+
+        calibration.colorIntrinsics = depth;
+
+        calibration.rotation[0] = 1;
+        calibration.rotation[4] = 1;
+        calibration.rotation[8] = 1;
+
+        return calibration;
+    }
+
+    bool DepthRegistration::is_valid_calibration(const astra_depth_calibration_t& calibration)
+    {
+        const astra_camera_intrinsics_t& depth = calibration.depthIntrinsics;
+        const astra_camera_intrinsics_t& color = calibration.colorIntrinsics;
+
+        return depth.fx > 0 && depth.fy > 0 && depth.width > 0 && depth.height > 0 &&
+               color.fx > 0 && color.fy > 0 && color.width > 0 && color.height > 0;
+    }
+
+    void DepthRegistration::set_calibration(const astra_depth_calibration_t& calibration)
+    {
+        m_calibration = calibration;
+        m_lookupTableDirty = true;
+    }
+
+    void DepthRegistration::update_lookup_table(int width, int height)
+    {
+        if (!m_lookupTableDirty && width == m_width && height == m_height)
+        {
+            return;
+        }
+
+        PROFILE_FUNC();
+
+        m_width = width;
+        m_height = height;
+        m_lookupTableDirty = false;
+
+        const size_t length = width * height;
+        m_rayX.resize(length);
+        m_rayY.resize(length);
+        m_rayZ.resize(length);
+        m_targetX.resize(length);
+        m_targetY.resize(length);
+        m_targetDepth.resize(length);
+        m_rowMinTargetY.resize(height);
+        m_rowMaxTargetY.resize(height);
+
+        //calibration may describe a different depth mode than the incoming frames
+        const astra_camera_intrinsics_t& depth = m_calibration.depthIntrinsics;
+        const float scaleX = static_cast<float>(width) / depth.width;
+        const float scaleY = static_cast<float>(height) / depth.height;
+
+        const float invFx = 1.0f / (depth.fx * scaleX);
+        const float invFy = 1.0f / (depth.fy * scaleY);
+        const float cx = depth.cx * scaleX;
+        const float cy = depth.cy * scaleY;
+
+        //when the color image is magnified relative to depth, each sample
+        //covers a block so the output does not end up with cracks
+        const astra_camera_intrinsics_t& color = m_calibration.colorIntrinsics;
+        const float magnification = std::max(color.fx * invFx, color.fy * invFy);
+        m_splatSize = std::min(MAX_SPLAT_SIZE, std::max(1, static_cast<int>(std::ceil(magnification - 0.05f))));
+
+        const float* r = m_calibration.rotation;
+
+        for (int y = 0; y < height; ++y)
+        {
+            const float rayY = (y - cy) * invFy;
+            size_t index = y * width;
+
+            for (int x = 0; x < width; ++x, ++index)
+            {
+                const float rayX = (x - cx) * invFx;
+
+                m_rayX[index] = r[0] * rayX + r[1] * rayY + r[2];
+                m_rayY[index] = r[3] * rayX + r[4] * rayY + r[5];
+                m_rayZ[index] = r[6] * rayX + r[7] * rayY + r[8];
+            }
+        }
+    }
+
+    void DepthRegistration::register_depth(const int16_t* p_depth,
+                                           int width,
+                                           int height,
+                                           int16_t* p_registered)
+    {
+        PROFILE_FUNC();
+
+        const int outputWidth = m_calibration.colorIntrinsics.width;
+        const int outputHeight = m_calibration.colorIntrinsics.height;
+
+        if (!is_valid_calibration(m_calibration))
+        {
+            memset(p_registered, 0, outputWidth * outputHeight * sizeof(int16_t));
+            return;
+        }
+
+        update_lookup_table(width, height);
+
+        m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            project_rows(p_depth, width, rowBegin, rowEnd);
+        });
+
+        m_workerPool.parallel_for_rows(outputHeight, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            splat_rows(width, height, rowBegin, rowEnd, p_registered);
+        });
+    }
+
+    void DepthRegistration::project_rows(const int16_t* p_depth, int width, int rowBegin, int rowEnd)
+    {
+        const astra_camera_intrinsics_t& color = m_calibration.colorIntrinsics;
+        const float fx = color.fx;
+        const float fy = color.fy;
+        const float cx = color.cx;
+        const float cy = color.cy;
+
+        const float tx = m_calibration.translation[0];
+        const float ty = m_calibration.translation[1];
+        const float tz = m_calibration.translation[2];
+
+        const int maxX = color.width;
+        const int maxY = color.height;
+        const int splatSize = m_splatSize;
+
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const size_t rowStart = y * width;
+
+            const int16_t* p_depthRow = p_depth + rowStart;
+            const float* p_rayX = m_rayX.data() + rowStart;
+            const float* p_rayY = m_rayY.data() + rowStart;
+            const float* p_rayZ = m_rayZ.data() + rowStart;
+
+            int16_t* p_targetX = m_targetX.data() + rowStart;
+            int16_t* p_targetY = m_targetY.data() + rowStart;
+            uint16_t* p_targetDepth = m_targetDepth.data() + rowStart;
+
+            int minTargetY = maxY;
+            int maxTargetY = -splatSize;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = p_depthRow[x];
+
+                const float colorX = z * p_rayX[x] + tx;
+                const float colorY = z * p_rayY[x] + ty;
+                const float colorZ = z * p_rayZ[x] + tz;
+
+                const float invZ = colorZ > 0 ? 1.0f / colorZ : 0.0f;
+
+                //clamp before converting so points near the camera plane cannot overflow
+                const float colorU = std::min(std::max(fx * colorX * invZ + cx + 0.5f, -MAX_SPLAT_SIZE - 1.0f), maxX + 1.0f);
+                const float colorV = std::min(std::max(fy * colorY * invZ + cy + 0.5f, -MAX_SPLAT_SIZE - 1.0f), maxY + 1.0f);
+
+                const int u = static_cast<int>(std::floor(colorU));
+                const int v = static_cast<int>(std::floor(colorV));
+
+                const bool isValid = z > 0 &&
+                                     colorZ > 0 &&
+                                     colorZ < MAX_DEPTH &&
+                                     u > -splatSize && u < maxX &&
+                                     v > -splatSize && v < maxY;
+
+                p_targetX[x] = static_cast<int16_t>(isValid ? u : 0);
+                p_targetY[x] = static_cast<int16_t>(isValid ? v : 0);
+                p_targetDepth[x] = static_cast<uint16_t>(isValid ? colorZ + 0.5f : 0);
+
+                if (isValid)
+                {
+                    minTargetY = std::min(minTargetY, v);
+                    maxTargetY = std::max(maxTargetY, v);
+                }
+            }
+
+            m_rowMinTargetY[y] = minTargetY;
+            m_rowMaxTargetY[y] = maxTargetY;
+        }
+    }
+
+    void DepthRegistration::splat_rows(int width,
+                                       int height,
+                                       int rowBegin,
+                                       int rowEnd,
+                                       int16_t* p_registered)
+    {
+        const int outputWidth = m_calibration.colorIntrinsics.width;
+        const int splatSize = m_splatSize;
+
+        memset(p_registered + rowBegin * outputWidth,
+               0,
+               (rowEnd - rowBegin) * outputWidth * sizeof(int16_t));
+
+        for (int y = 0; y < height; ++y)
+        {
+            //skip depth rows whose samples all land outside this band
+            if (m_rowMaxTargetY[y] + splatSize <= rowBegin || m_rowMinTargetY[y] >= rowEnd)
+            {
+                continue;
+            }
+
+            const size_t rowStart = y * width;
+            const int16_t* p_targetX = m_targetX.data() + rowStart;
+            const int16_t* p_targetY = m_targetY.data() + rowStart;
+            const uint16_t* p_targetDepth = m_targetDepth.data() + rowStart;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const int16_t depth = static_cast<int16_t>(p_targetDepth[x]);
+                if (depth == 0)
+                {
+                    continue;
+                }
+
+                const int u = p_targetX[x];
+                const int v = p_targetY[x];
+
+                const int minY = std::max(v, rowBegin);
+                const int maxY = std::min(v + splatSize, rowEnd);
+                const int minX = std::max(u, 0);
+                const int maxX = std::min(u + splatSize, outputWidth);
+
+                for (int ty = minY; ty < maxY; ++ty)
+                {
+                    int16_t* p_out = p_registered + ty * outputWidth;
+                    for (int tx = minX; tx < maxX; ++tx)
+                    {
+                        z_test(p_out[tx], depth);
+                    }
+                }
+            }
+        }
+    }
+
+}}}
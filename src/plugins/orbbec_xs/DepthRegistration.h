@@ -0,0 +1,71 @@
+#ifndef DEPTHREGISTRATION_H
+#define DEPTHREGISTRATION_H
+
+#include <AstraUL/streams/depth_types.h>
+#include <common/parallel/WorkerPool.h>
+#include <cstdint>
+#include <vector>
+
+namespace astra { namespace plugins { namespace xs {
+
+    // Warps depth images into the color camera. A per-pixel table holds the
+    // rotated viewing ray for every depth pixel, so the per-frame work is
+    // z * ray + translation followed by the color projection.
+    class DepthRegistration
+    {
+    public:
+        DepthRegistration(parallel::WorkerPool& workerPool);
+
+        // identity extrinsics with both cameras described by the depth conversion cache
+        static astra_depth_calibration_t default_calibration(const conversion_cache_t& depthConversionCache);
+        static bool is_valid_calibration(const astra_depth_calibration_t& calibration);
+
+        void set_calibration(const astra_depth_calibration_t& calibration);
+        const astra_depth_calibration_t& calibration() const { return m_calibration; }
+
+        // p_registered must hold colorIntrinsics.width * colorIntrinsics.height values.
+        // Overlapping samples keep the nearest depth.
+        void register_depth(const int16_t* p_depth,
+                            int width,
+                            int height,
+                            int16_t* p_registered);
+
+        // rebuilds the ray tables when the calibration or depth size changed
+        void update_lookup_table(int width, int height);
+
+        const float* ray_x() const { return m_rayX.data(); }
+        const float* ray_y() const { return m_rayY.data(); }
+        const float* ray_z() const { return m_rayZ.data(); }
+
+    private:
+        void project_rows(const int16_t* p_depth, int width, int rowBegin, int rowEnd);
+        void splat_rows(int width, int height, int rowBegin, int rowEnd, int16_t* p_registered);
+
+        parallel::WorkerPool& m_workerPool;
+
+        astra_depth_calibration_t m_calibration;
+        bool m_lookupTableDirty{ true };
+        int m_splatSize{ 1 };
+
+        int m_width{ 0 };
+        int m_height{ 0 };
+
+        // rotation * inverse(depth intrinsics) * (x, y, 1) per depth pixel
+        std::vector<float> m_rayX;
+        std::vector<float> m_rayY;
+        std::vector<float> m_rayZ;
+
+        // per depth pixel projection into the color image, depth 0 when invalid
+        std::vector<int16_t> m_targetX;
+        std::vector<int16_t> m_targetY;
+        std::vector<uint16_t> m_targetDepth;
+
+        // range of target rows written by each depth row, used to give every
+        // output band only the source rows that can touch it
+        std::vector<int> m_rowMinTargetY;
+        std::vector<int> m_rowMaxTargetY;
+    };
+
+}}}
+
+#endif /* DEPTHREGISTRATION_H */
@@ -0,0 +1,73 @@
+#include "FilteredDepthStream.h"
+#include "DepthFilter.h"
+#include <AstraUL/streams/depth_parameters.h>
+#include <AstraUL/streams/image_parameters.h>
+#include <cmath>
+#include <cstring>
+
+namespace astra { namespace plugins { namespace xs {
+
+    template<typename T>
+    void FilteredDepthStream::get_parameter_value(astra_parameter_bin_t& parameterBin, const T& value)
+    {
+        size_t resultByteLength = sizeof(T);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            memcpy(parameterData, &value, resultByteLength);
+        }
+    }
+
+    void FilteredDepthStream::on_get_parameter(astra_streamconnection_t connection,
+                                               astra_parameter_id id,
+                                               astra_parameter_bin_t& parameterBin)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_DEPTH_FILTER_SETTINGS:
+            get_parameter_value(parameterBin, m_settings);
+            break;
+        case ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE:
+            get_parameter_value(parameterBin, m_conversionCache);
+            break;
+        case ASTRA_PARAMETER_DEPTH_REGISTRATION:
+            get_parameter_value(parameterBin, false);
+            break;
+        case ASTRA_PARAMETER_IMAGE_HFOV:
+        {
+            float hFov = 2 * std::atan(m_conversionCache.xzFactor / 2);
+            get_parameter_value(parameterBin, hFov);
+            break;
+        }
+        case ASTRA_PARAMETER_IMAGE_VFOV:
+        {
+            float vFov = 2 * std::atan(m_conversionCache.yzFactor / 2);
+            get_parameter_value(parameterBin, vFov);
+            break;
+        }
+        }
+    }
+
+    void FilteredDepthStream::on_set_parameter(astra_streamconnection_t connection,
+                                               astra_parameter_id id,
+                                               size_t inByteLength,
+                                               astra_parameter_data_t inData)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_DEPTH_FILTER_SETTINGS:
+            if (inByteLength >= sizeof(astra_depth_filter_settings_t))
+            {
+                astra_depth_filter_settings_t settings;
+                memcpy(&settings, inData, sizeof(astra_depth_filter_settings_t));
+
+                m_settings = DepthFilter::sanitize_settings(settings);
+            }
+            break;
+        }
+    }
+}}}
@@ -0,0 +1,51 @@
+#ifndef FILTEREDDEPTHSTREAM_H
+#define FILTEREDDEPTHSTREAM_H
+
+#include <Astra/Plugins/SingleBinStream.h>
+#include <AstraUL/streams/depth_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <Shiny.h>
+
+namespace astra { namespace plugins { namespace xs {
+
+    class FilteredDepthStream : public astra::plugins::SingleBinStream<astra_imageframe_wrapper_t>
+    {
+    public:
+        FilteredDepthStream(PluginServiceProxy& pluginService,
+                            astra_streamset_t streamSet,
+                            uint32_t width,
+                            uint32_t height,
+                            const conversion_cache_t& conversionCache,
+                            const astra_depth_filter_settings_t& settings)
+            : SingleBinStream(pluginService,
+                              streamSet,
+                              StreamDescription(ASTRA_STREAM_DEPTH,
+                                                ASTRA_DEPTH_SUBTYPE_FILTERED),
+                              width * height * sizeof(int16_t)),
+              m_conversionCache(conversionCache),
+              m_settings(settings)
+        {}
+
+        const astra_depth_filter_settings_t& settings() const { return m_settings; }
+
+    protected:
+        virtual void on_set_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      size_t inByteLength,
+                                      astra_parameter_data_t inData) override;
+
+        virtual void on_get_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      astra_parameter_bin_t& parameterBin) override;
+
+    private:
+        template<typename T>
+        void get_parameter_value(astra_parameter_bin_t& parameterBin, const T& value);
+
+        const conversion_cache_t m_conversionCache;
+        astra_depth_filter_settings_t m_settings;
+    };
+}}}
+
+#endif /* FILTEREDDEPTHSTREAM_H */
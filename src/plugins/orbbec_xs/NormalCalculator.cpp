@@ -0,0 +1,262 @@
+#include "NormalCalculator.h"
+#include <Shiny.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace astra { namespace plugins { namespace xs {
+
+    namespace {
+
+        // rows per worker task; keeps tasks large enough to amortize scheduling
+        const int MIN_ROWS_PER_BAND = 16;
+
+        // Normal of one row from central differences: (down - up) x (right - left),
+        // which equals the sum of the four neighbor cross products. Written
+        // without data-dependent branches so the loop vectorizes.
+        void calculate_normal_row(const Vector3f* p_up,
+                                  const Vector3f* p_row,
+                                  const Vector3f* p_down,
+                                  int width,
+                                  Vector3f* p_out)
+        {
+            p_out[0] = Vector3f::zero();
+            p_out[width - 1] = Vector3f::zero();
+
+            for (int x = 1; x < width - 1; ++x)
+            {
+                const Vector3f& left = p_row[x - 1];
+                const Vector3f& right = p_row[x + 1];
+                const Vector3f& up = p_up[x];
+                const Vector3f& down = p_down[x];
+
+                const float ax = right.x - left.x;
+                const float ay = right.y - left.y;
+                const float az = right.z - left.z;
+
+                const float bx = down.x - up.x;
+                const float by = down.y - up.y;
+                const float bz = down.z - up.z;
+
+                const float nx = by * az - bz * ay;
+                const float ny = bz * ax - bx * az;
+                const float nz = bx * ay - by * ax;
+
+                const float lengthSquared = nx * nx + ny * ny + nz * nz;
+
+                const bool isValid = p_row[x].z != 0 &&
+                                     left.z != 0 &&
+                                     right.z != 0 &&
+                                     up.z != 0 &&
+                                     down.z != 0 &&
+                                     lengthSquared > 0;
+
+                const float scale = isValid ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+                Vector3f& out = p_out[x];
+                out.x = nx * scale;
+                out.y = ny * scale;
+                out.z = nz * scale;
+            }
+        }
+
+        void fill_zero(Vector3f* p_normals, int count)
+        {
+            std::fill(p_normals, p_normals + count, Vector3f::zero());
+        }
+    }
+
+    NormalCalculator::NormalCalculator(parallel::WorkerPool& workerPool)
+        : m_workerPool(workerPool)
+    {}
+
+    void NormalCalculator::prepare_buffers(int width, int height, bool smoothing)
+    {
+        const bool sizeChanged = width != m_width || height != m_height;
+
+        m_width = width;
+        m_height = height;
+
+        if (!smoothing)
+        {
+            return;
+        }
+
+        if (sizeChanged || m_rawNormals == nullptr)
+        {
+            m_rawNormals = std::make_unique<Vector3f[]>(width * height);
+        }
+
+        const size_t integralLength = (width + 1) * (height + 1);
+        if (m_integralX.size() != integralLength)
+        {
+            m_integralX.assign(integralLength, 0);
+            m_integralY.assign(integralLength, 0);
+            m_integralZ.assign(integralLength, 0);
+        }
+    }
+
+    void NormalCalculator::calculate_normals(const Vector3f* p_points,
+                                             int width,
+                                             int height,
+                                             int smoothingRadius,
+                                             Vector3f* p_normals)
+    {
+        PROFILE_FUNC();
+
+        if (width < 3 || height < 3)
+        {
+            fill_zero(p_normals, width * height);
+            return;
+        }
+
+        const bool smoothing = smoothingRadius > 0;
+        prepare_buffers(width, height, smoothing);
+
+        if (!smoothing)
+        {
+            calculate_raw_normals(p_points, width, height, p_normals);
+            return;
+        }
+
+        calculate_raw_normals(p_points, width, height, m_rawNormals.get());
+        calculate_integral_normals(m_rawNormals.get(), width, height);
+        smooth_normals(m_rawNormals.get(), width, height, smoothingRadius, p_normals);
+    }
+
+    void NormalCalculator::calculate_raw_normals(const Vector3f* p_points,
+                                                 int width,
+                                                 int height,
+                                                 Vector3f* p_normals)
+    {
+        PROFILE_FUNC();
+
+        //top and bottom rows have no vertical neighbors
+        fill_zero(p_normals, width);
+        fill_zero(p_normals + (height - 1) * width, width);
+
+        m_workerPool.parallel_for_rows(height - 2, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            for (int y = rowBegin + 1; y < rowEnd + 1; ++y)
+            {
+                const Vector3f* p_row = p_points + y * width;
+                calculate_normal_row(p_row - width,
+                                     p_row,
+                                     p_row + width,
+                                     width,
+                                     p_normals + y * width);
+            }
+        });
+    }
+
+    void NormalCalculator::calculate_integral_normals(const Vector3f* p_normals,
+                                                      int width,
+                                                      int height)
+    {
+        PROFILE_FUNC();
+
+        const int stride = width + 1;
+
+        double* p_sumX = m_integralX.data();
+        double* p_sumY = m_integralY.data();
+        double* p_sumZ = m_integralZ.data();
+
+        //horizontal prefix sums are independent per row
+        m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            for (int y = rowBegin; y < rowEnd; ++y)
+            {
+                const Vector3f* p_row = p_normals + y * width;
+                const int offset = (y + 1) * stride;
+
+                double sumX = 0, sumY = 0, sumZ = 0;
+                p_sumX[offset] = p_sumY[offset] = p_sumZ[offset] = 0;
+
+                for (int x = 0; x < width; ++x)
+                {
+                    sumX += p_row[x].x;
+                    sumY += p_row[x].y;
+                    sumZ += p_row[x].z;
+
+                    p_sumX[offset + x + 1] = sumX;
+                    p_sumY[offset + x + 1] = sumY;
+                    p_sumZ[offset + x + 1] = sumZ;
+                }
+            }
+        });
+
+        //vertical accumulation, serial in y but vectorizable across x
+        std::fill(p_sumX, p_sumX + stride, 0.0);
+        std::fill(p_sumY, p_sumY + stride, 0.0);
+        std::fill(p_sumZ, p_sumZ + stride, 0.0);
+
+        for (int y = 2; y <= height; ++y)
+        {
+            double* p_rowX = p_sumX + y * stride;
+            double* p_rowY = p_sumY + y * stride;
+            double* p_rowZ = p_sumZ + y * stride;
+
+            const double* p_aboveX = p_rowX - stride;
+            const double* p_aboveY = p_rowY - stride;
+            const double* p_aboveZ = p_rowZ - stride;
+
+            for (int x = 1; x < stride; ++x)
+            {
+                p_rowX[x] += p_aboveX[x];
+                p_rowY[x] += p_aboveY[x];
+                p_rowZ[x] += p_aboveZ[x];
+            }
+        }
+    }
+
+    void NormalCalculator::smooth_normals(const Vector3f* p_rawNormals,
+                                          int width,
+                                          int height,
+                                          int smoothingRadius,
+                                          Vector3f* p_normals)
+    {
+        PROFILE_FUNC();
+
+        const int stride = width + 1;
+
+        const double* p_sumX = m_integralX.data();
+        const double* p_sumY = m_integralY.data();
+        const double* p_sumZ = m_integralZ.data();
+
+        m_workerPool.parallel_for_rows(height, MIN_ROWS_PER_BAND, [&](int rowBegin, int rowEnd)
+        {
+            for (int y = rowBegin; y < rowEnd; ++y)
+            {
+                const int top = std::max(0, y - smoothingRadius) * stride;
+                const int bottom = std::min(height, y + smoothingRadius + 1) * stride;
+
+                const Vector3f* p_raw = p_rawNormals + y * width;
+                Vector3f* p_out = p_normals + y * width;
+
+                for (int x = 0; x < width; ++x)
+                {
+                    const int left = std::max(0, x - smoothingRadius);
+                    const int right = std::min(width, x + smoothingRadius + 1);
+
+                    const float sumX = static_cast<float>(p_sumX[bottom + right] - p_sumX[bottom + left]
+                                                          - p_sumX[top + right] + p_sumX[top + left]);
+                    const float sumY = static_cast<float>(p_sumY[bottom + right] - p_sumY[bottom + left]
+                                                          - p_sumY[top + right] + p_sumY[top + left]);
+                    const float sumZ = static_cast<float>(p_sumZ[bottom + right] - p_sumZ[bottom + left]
+                                                          - p_sumZ[top + right] + p_sumZ[top + left]);
+
+                    const float lengthSquared = sumX * sumX + sumY * sumY + sumZ * sumZ;
+
+                    //keep holes as holes instead of bleeding neighbors into them
+                    const bool isValid = !p_raw[x].is_zero() && lengthSquared > 0;
+                    const float scale = isValid ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+
+                    p_out[x].x = sumX * scale;
+                    p_out[x].y = sumY * scale;
+                    p_out[x].z = sumZ * scale;
+                }
+            }
+        });
+    }
+
+}}}
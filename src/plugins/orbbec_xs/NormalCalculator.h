@@ -0,0 +1,60 @@
+#ifndef NORMALCALCULATOR_H
+#define NORMALCALCULATOR_H
+
+#include <AstraUL/AstraUL.h>
+#include <common/parallel/WorkerPool.h>
+#include <memory>
+#include <vector>
+
+namespace astra { namespace plugins { namespace xs {
+
+    class NormalCalculator
+    {
+    public:
+        NormalCalculator(parallel::WorkerPool& workerPool);
+
+        // Computes a unit surface normal per pixel from an organized point map.
+        // Pixels without a complete 4-neighborhood of valid depth get a zero normal.
+        // A smoothingRadius > 0 box-averages the normals over a
+        // (2r+1)x(2r+1) window using integral images, so the cost
+        // does not depend on the radius.
+        void calculate_normals(const Vector3f* p_points,
+                               int width,
+                               int height,
+                               int smoothingRadius,
+                               Vector3f* p_normals);
+
+    private:
+        void prepare_buffers(int width, int height, bool smoothing);
+
+        void calculate_raw_normals(const Vector3f* p_points,
+                                   int width,
+                                   int height,
+                                   Vector3f* p_normals);
+
+        void calculate_integral_normals(const Vector3f* p_normals,
+                                        int width,
+                                        int height);
+
+        void smooth_normals(const Vector3f* p_rawNormals,
+                            int width,
+                            int height,
+                            int smoothingRadius,
+                            Vector3f* p_normals);
+
+        parallel::WorkerPool& m_workerPool;
+
+        int m_width{ 0 };
+        int m_height{ 0 };
+
+        std::unique_ptr<Vector3f[]> m_rawNormals;
+
+        // summed-area tables, (width + 1) x (height + 1), one plane per component
+        std::vector<double> m_integralX;
+        std::vector<double> m_integralY;
+        std::vector<double> m_integralZ;
+    };
+
+}}}
+
+#endif /* NORMALCALCULATOR_H */
@@ -0,0 +1,57 @@
+#include "NormalStream.h"
+#include <AstraUL/streams/normal_parameters.h>
+#include <cstring>
+
+namespace astra { namespace plugins { namespace xs {
+
+    void NormalStream::on_set_parameter(astra_streamconnection_t connection,
+                                        astra_parameter_id id,
+                                        size_t inByteLength,
+                                        astra_parameter_data_t inData)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_NORMAL_SMOOTHING_RADIUS:
+            set_smoothing_radius_parameter(inByteLength, inData);
+            break;
+        }
+    }
+
+    void NormalStream::on_get_parameter(astra_streamconnection_t connection,
+                                        astra_parameter_id id,
+                                        astra_parameter_bin_t& parameterBin)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_NORMAL_SMOOTHING_RADIUS:
+            get_smoothing_radius_parameter(parameterBin);
+            break;
+        }
+    }
+
+    void NormalStream::get_smoothing_radius_parameter(astra_parameter_bin_t& parameterBin)
+    {
+        size_t resultByteLength = sizeof(int32_t);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            int32_t radius = m_smoothingRadius;
+            memcpy(parameterData, &radius, resultByteLength);
+        }
+    }
+
+    void NormalStream::set_smoothing_radius_parameter(size_t inByteLength, astra_parameter_data_t& inData)
+    {
+        if (inByteLength >= sizeof(int32_t))
+        {
+            int32_t newRadius;
+            memcpy(&newRadius, inData, sizeof(int32_t));
+
+            set_smoothing_radius(newRadius);
+        }
+    }
+}}}
@@ -0,0 +1,50 @@
+#ifndef NORMALSTREAM_H
+#define NORMALSTREAM_H
+
+#include <Astra/Plugins/SingleBinStream.h>
+#include <AstraUL/streams/normal_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <Shiny.h>
+
+namespace astra { namespace plugins { namespace xs {
+
+    class NormalStream : public astra::plugins::SingleBinStream<astra_imageframe_wrapper_t>
+    {
+    public:
+        NormalStream(PluginServiceProxy& pluginService,
+                     astra_streamset_t streamSet,
+                     uint32_t width,
+                     uint32_t height)
+            : SingleBinStream(pluginService,
+                              streamSet,
+                              StreamDescription(ASTRA_STREAM_NORMAL,
+                                                DEFAULT_SUBTYPE),
+                              width * height * sizeof(astra_vector3f_t))
+        {}
+
+        int smoothing_radius() const { return m_smoothingRadius; }
+        void set_smoothing_radius(int smoothingRadius)
+        {
+            m_smoothingRadius = smoothingRadius < 0 ? 0 : smoothingRadius;
+        }
+
+    protected:
+        virtual void on_set_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      size_t inByteLength,
+                                      astra_parameter_data_t inData) override;
+
+        virtual void on_get_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      astra_parameter_bin_t& parameterBin) override;
+
+    private:
+        void get_smoothing_radius_parameter(astra_parameter_bin_t& parameterBin);
+        void set_smoothing_radius_parameter(size_t inByteLength, astra_parameter_data_t& inData);
+
+        int m_smoothingRadius{ 0 };
+    };
+}}}
+
+#endif /* NORMALSTREAM_H */
@@ -1,19 +1,28 @@
 #include "PointProcessor.h"
 #include <Shiny.h>
+#include <cstring>
 
 namespace astra { namespace plugins { namespace xs {
 
     PointProcessor::PointProcessor(PluginServiceProxy& pluginService,
                                    astra_streamset_t streamset,
-                                   StreamDescription& depthDesc)
+                                   StreamDescription& depthDesc,
+                                   parallel::WorkerPool& workerPool)
         : m_streamset(get_uri_for_streamset(pluginService, streamset)),
           m_streamSet(streamset),
           m_reader(m_streamset.create_reader()),
           m_depthStream(m_reader.stream<DepthStream>(depthDesc.subtype())),
-          m_pluginService(pluginService)
+          m_pluginService(pluginService),
+          m_normalCalculator(workerPool),
+          m_depthRegistration(workerPool),
+          m_coloredPointCalculator(workerPool),
+          m_depthFilter(workerPool),
+          m_colorReader(m_streamset.create_reader()),
+          m_colorStream(m_colorReader.stream<ColorStream>())
     {
         m_depthStream.start();
         m_reader.addListener(*this);
+        m_colorReader.addListener(*this);
     }
 
     PointProcessor::~PointProcessor()
@@ -22,15 +31,55 @@ namespace astra { namespace plugins { namespace xs {
 
     void PointProcessor::on_frame_ready(StreamReader& reader, Frame& frame)
     {
+        if (reader == m_colorReader)
+        {
+            cache_color_frame(frame);
+            return;
+        }
+
         DepthFrame depthFrame = frame.get<DepthFrame>();
 
         create_point_stream_if_necessary(depthFrame);
+        create_normal_stream_if_necessary(depthFrame);
+        create_registered_depth_stream_if_necessary(depthFrame);
+        create_colored_point_stream_if_necessary(depthFrame);
+        create_filtered_depth_stream_if_necessary(depthFrame);
+
+        update_color_stream_state();
+
+        if (m_registeredDepthStream->has_connections())
+        {
+            LOG_TRACE("PointProcessor", "updating registered depth frame");
+            update_registered_depthframe(depthFrame);
+        }
+
+        if (m_coloredPointStream->has_connections())
+        {
+            LOG_TRACE("PointProcessor", "updating colored point frame");
+            update_colored_pointframe(depthFrame);
+        }
+
+        if (m_filteredDepthStream->has_connections())
+        {
+            LOG_TRACE("PointProcessor", "updating filtered depth frame");
+            update_filtered_depthframe(depthFrame);
+        }
+        else
+        {
+            //stale history would blend into the first frames after a restart
+            m_depthFilter.reset();
+        }
 
         if (m_pointStream->has_connections())
         {
             LOG_TRACE("PointProcessor", "updating point frame");
             update_pointframe_from_depth(depthFrame);
         }
+        else if (m_normalStream->has_connections())
+        {
+            LOG_TRACE("PointProcessor", "updating normal frame");
+            update_normalframe_from_points(depthFrame, calculate_point_buffer(depthFrame));
+        }
     }
 
     void PointProcessor::create_point_stream_if_necessary(DepthFrame& depthFrame)
@@ -54,6 +103,240 @@ namespace astra { namespace plugins { namespace xs {
         m_depthConversionCache = m_depthStream.depth_to_world_data();
     }
 
+    void PointProcessor::create_normal_stream_if_necessary(DepthFrame& depthFrame)
+    {
+        if (m_normalStream != nullptr)
+        {
+            return;
+        }
+
+        LOG_INFO("PointProcessor", "creating normal stream");
+
+        int width = depthFrame.resolutionX();
+        int height = depthFrame.resolutionY();
+
+        auto ns = make_stream<NormalStream>(m_pluginService, m_streamSet, width, height);
+        m_normalStream = std::unique_ptr<NormalStream>(std::move(ns));
+
+        LOG_INFO("PointProcessor", "created normal stream");
+    }
+
+    void PointProcessor::create_registered_depth_stream_if_necessary(DepthFrame& depthFrame)
+    {
+        if (m_registeredDepthStream != nullptr)
+        {
+            return;
+        }
+
+        LOG_INFO("PointProcessor", "creating registered depth stream");
+
+        //no factory calibration available here, clients set one through
+        //ASTRA_PARAMETER_DEPTH_CALIBRATION on the registered stream
+        astra_depth_calibration_t calibration =
+            DepthRegistration::default_calibration(m_depthConversionCache);
+
+        auto rs = make_stream<RegisteredDepthStream>(m_pluginService, m_streamSet, calibration);
+        m_registeredDepthStream = std::unique_ptr<RegisteredDepthStream>(std::move(rs));
+
+        LOG_INFO("PointProcessor", "created registered depth stream");
+    }
+
+    void PointProcessor::create_colored_point_stream_if_necessary(DepthFrame& depthFrame)
+    {
+        if (m_coloredPointStream != nullptr)
+        {
+            return;
+        }
+
+        LOG_INFO("PointProcessor", "creating colored point stream");
+
+        int width = depthFrame.resolutionX();
+        int height = depthFrame.resolutionY();
+
+        auto cs = make_stream<ColoredPointStream>(m_pluginService, m_streamSet, width, height);
+        m_coloredPointStream = std::unique_ptr<ColoredPointStream>(std::move(cs));
+
+        LOG_INFO("PointProcessor", "created colored point stream");
+    }
+
+    void PointProcessor::create_filtered_depth_stream_if_necessary(DepthFrame& depthFrame)
+    {
+        if (m_filteredDepthStream != nullptr)
+        {
+            return;
+        }
+
+        LOG_INFO("PointProcessor", "creating filtered depth stream");
+
+        int width = depthFrame.resolutionX();
+        int height = depthFrame.resolutionY();
+
+        auto fs = make_stream<FilteredDepthStream>(m_pluginService,
+                                                   m_streamSet,
+                                                   width,
+                                                   height,
+                                                   m_depthConversionCache,
+                                                   DepthFilter::default_settings());
+        m_filteredDepthStream = std::unique_ptr<FilteredDepthStream>(std::move(fs));
+
+        LOG_INFO("PointProcessor", "created filtered depth stream");
+    }
+
+    void PointProcessor::update_filtered_depthframe(DepthFrame& depthFrame)
+    {
+        astra_frame_index_t frameIndex = depthFrame.frameIndex();
+
+        astra_imageframe_wrapper_t* filteredFrameWrapper = m_filteredDepthStream->begin_write(frameIndex);
+
+        if (filteredFrameWrapper != nullptr)
+        {
+            filteredFrameWrapper->frame.frame = nullptr;
+            filteredFrameWrapper->frame.data = &filteredFrameWrapper->frame_data[0];
+
+            astra_image_metadata_t metadata;
+
+            metadata.width = depthFrame.resolutionX();
+            metadata.height = depthFrame.resolutionY();
+            metadata.pixelFormat = ASTRA_PIXEL_FORMAT_DEPTH_MM;
+
+            filteredFrameWrapper->frame.metadata = metadata;
+
+            int16_t* p_filtered = reinterpret_cast<int16_t*>(filteredFrameWrapper->frame.data);
+            m_depthFilter.filter_depth(depthFrame.data(),
+                                       metadata.width,
+                                       metadata.height,
+                                       m_filteredDepthStream->settings(),
+                                       p_filtered);
+
+            m_filteredDepthStream->end_write();
+        }
+    }
+
+    void PointProcessor::update_color_stream_state()
+    {
+        //only pull color while someone wants colored points
+        const bool colorNeeded = m_coloredPointStream->has_connections() &&
+                                 m_colorStream.is_available();
+
+        if (colorNeeded && !m_colorStreamStarted)
+        {
+            LOG_INFO("PointProcessor", "starting color stream for colored points");
+            m_colorStream.start();
+            m_colorStreamStarted = true;
+        }
+        else if (!colorNeeded && m_colorStreamStarted)
+        {
+            LOG_INFO("PointProcessor", "stopping color stream for colored points");
+            m_colorStream.stop();
+            m_colorStreamStarted = false;
+            m_colorWidth = m_colorHeight = 0;
+        }
+    }
+
+    void PointProcessor::cache_color_frame(Frame& frame)
+    {
+        ColorFrame colorFrame = frame.get<ColorFrame>();
+
+        if (!colorFrame.is_valid())
+        {
+            return;
+        }
+
+        m_colorWidth = colorFrame.resolutionX();
+        m_colorHeight = colorFrame.resolutionY();
+        m_colorBuffer.resize(m_colorWidth * m_colorHeight);
+
+        memcpy(m_colorBuffer.data(),
+               colorFrame.data(),
+               m_colorBuffer.size() * sizeof(astra_rgb_pixel_t));
+    }
+
+    void PointProcessor::sync_registration_calibration()
+    {
+        if (m_registeredDepthStream->calibration_changed())
+        {
+            m_depthRegistration.set_calibration(m_registeredDepthStream->calibration());
+            m_registeredDepthStream->clear_calibration_changed();
+        }
+    }
+
+    void PointProcessor::update_colored_pointframe(DepthFrame& depthFrame)
+    {
+        //nothing to sample until the first color frame arrives
+        if (m_colorWidth == 0 || m_colorHeight == 0)
+        {
+            return;
+        }
+
+        sync_registration_calibration();
+
+        astra_frame_index_t frameIndex = depthFrame.frameIndex();
+
+        astra_imageframe_wrapper_t* coloredPointFrameWrapper = m_coloredPointStream->begin_write(frameIndex);
+
+        if (coloredPointFrameWrapper != nullptr)
+        {
+            coloredPointFrameWrapper->frame.frame = nullptr;
+            coloredPointFrameWrapper->frame.data = &coloredPointFrameWrapper->frame_data[0];
+
+            const astra_colored_point_layout_t layout = m_coloredPointStream->layout();
+
+            astra_image_metadata_t metadata;
+
+            metadata.width = depthFrame.resolutionX();
+            metadata.height = depthFrame.resolutionY();
+            metadata.pixelFormat = layout == ASTRA_COLORED_POINT_LAYOUT_PLANAR
+                ? ASTRA_PIXEL_FORMAT_COLORED_POINT_PLANAR
+                : ASTRA_PIXEL_FORMAT_COLORED_POINT;
+
+            coloredPointFrameWrapper->frame.metadata = metadata;
+
+            m_coloredPointCalculator.calculate_colored_points(depthFrame.data(),
+                                                              metadata.width,
+                                                              metadata.height,
+                                                              m_depthConversionCache,
+                                                              m_depthRegistration,
+                                                              m_colorBuffer.data(),
+                                                              m_colorWidth,
+                                                              m_colorHeight,
+                                                              layout,
+                                                              coloredPointFrameWrapper->frame.data);
+
+            m_coloredPointStream->end_write();
+        }
+    }
+
+    void PointProcessor::update_registered_depthframe(DepthFrame& depthFrame)
+    {
+        sync_registration_calibration();
+
+        astra_frame_index_t frameIndex = depthFrame.frameIndex();
+
+        astra_imageframe_wrapper_t* registeredFrameWrapper = m_registeredDepthStream->begin_write(frameIndex);
+
+        if (registeredFrameWrapper != nullptr)
+        {
+            registeredFrameWrapper->frame.frame = nullptr;
+            registeredFrameWrapper->frame.data = &registeredFrameWrapper->frame_data[0];
+
+            astra_image_metadata_t metadata;
+
+            metadata.width = m_registeredDepthStream->width();
+            metadata.height = m_registeredDepthStream->height();
+            metadata.pixelFormat = ASTRA_PIXEL_FORMAT_DEPTH_MM;
+
+            registeredFrameWrapper->frame.metadata = metadata;
+
+            int16_t* p_registered = reinterpret_cast<int16_t*>(registeredFrameWrapper->frame.data);
+            m_depthRegistration.register_depth(depthFrame.data(),
+                                               depthFrame.resolutionX(),
+                                               depthFrame.resolutionY(),
+                                               p_registered);
+
+            m_registeredDepthStream->end_write();
+        }
+    }
+
     void PointProcessor::update_pointframe_from_depth(DepthFrame& depthFrame)
     {
         //use same frameIndex as source depth frame
@@ -77,10 +360,61 @@ namespace astra { namespace plugins { namespace xs {
             Vector3f* p_points = reinterpret_cast<Vector3f*>(pointFrameWrapper->frame.data);
             calculate_point_frame(depthFrame, p_points);
 
+            if (m_normalStream->has_connections())
+            {
+                update_normalframe_from_points(depthFrame, p_points);
+            }
+
             m_pointStream->end_write();
         }
     }
 
+    const Vector3f* PointProcessor::calculate_point_buffer(DepthFrame& depthFrame)
+    {
+        const size_t length = depthFrame.resolutionX() * depthFrame.resolutionY();
+
+        if (m_pointBuffer == nullptr || m_pointBufferLength != length)
+        {
+            m_pointBuffer = std::make_unique<Vector3f[]>(length);
+            m_pointBufferLength = length;
+        }
+
+        calculate_point_frame(depthFrame, m_pointBuffer.get());
+
+        return m_pointBuffer.get();
+    }
+
+    void PointProcessor::update_normalframe_from_points(DepthFrame& depthFrame,
+                                                        const Vector3f* p_points)
+    {
+        astra_frame_index_t frameIndex = depthFrame.frameIndex();
+
+        astra_imageframe_wrapper_t* normalFrameWrapper = m_normalStream->begin_write(frameIndex);
+
+        if (normalFrameWrapper != nullptr)
+        {
+            normalFrameWrapper->frame.frame = nullptr;
+            normalFrameWrapper->frame.data = &normalFrameWrapper->frame_data[0];
+
+            astra_image_metadata_t metadata;
+
+            metadata.width = depthFrame.resolutionX();
+            metadata.height = depthFrame.resolutionY();
+            metadata.pixelFormat = ASTRA_PIXEL_FORMAT_NORMAL;
+
+            normalFrameWrapper->frame.metadata = metadata;
+
+            Vector3f* p_normals = reinterpret_cast<Vector3f*>(normalFrameWrapper->frame.data);
+            m_normalCalculator.calculate_normals(p_points,
+                                                 metadata.width,
+                                                 metadata.height,
+                                                 m_normalStream->smoothing_radius(),
+                                                 p_normals);
+
+            m_normalStream->end_write();
+        }
+    }
+
     void PointProcessor::calculate_point_frame(DepthFrame& depthFrame,
                                                Vector3f* p_points)
     {
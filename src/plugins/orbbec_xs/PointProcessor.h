@@ -3,7 +3,18 @@
 
 #include <Astra/Plugins/PluginKit.h>
 #include <AstraUL/AstraUL.h>
+#include <common/parallel/WorkerPool.h>
 #include "PointStream.h"
+#include "NormalStream.h"
+#include "NormalCalculator.h"
+#include "RegisteredDepthStream.h"
+#include "DepthRegistration.h"
+#include "ColoredPointStream.h"
+#include "ColoredPointCalculator.h"
+#include "FilteredDepthStream.h"
+#include "DepthFilter.h"
+#include <memory>
+#include <vector>
 
 namespace astra { namespace plugins { namespace xs {
 
@@ -12,16 +23,30 @@ namespace astra { namespace plugins { namespace xs {
     public:
         PointProcessor(PluginServiceProxy& pluginService,
                        astra_streamset_t streamset,
-                       StreamDescription& depthDesc);
+                       StreamDescription& depthDesc,
+                       parallel::WorkerPool& workerPool);
         virtual ~PointProcessor();
         virtual void on_frame_ready(StreamReader& reader, Frame& frame) override;
 
     private:
         void create_point_stream_if_necessary(DepthFrame& depthFrame);
+        void create_normal_stream_if_necessary(DepthFrame& depthFrame);
+        void create_registered_depth_stream_if_necessary(DepthFrame& depthFrame);
+        void create_colored_point_stream_if_necessary(DepthFrame& depthFrame);
+        void create_filtered_depth_stream_if_necessary(DepthFrame& depthFrame);
 
         void update_pointframe_from_depth(DepthFrame& depthFrame);
+        void update_normalframe_from_points(DepthFrame& depthFrame,
+                                            const Vector3f* p_points);
         void calculate_point_frame(DepthFrame& depthFrame,
                                    Vector3f* p_points);
+        const Vector3f* calculate_point_buffer(DepthFrame& depthFrame);
+        void update_registered_depthframe(DepthFrame& depthFrame);
+        void update_colored_pointframe(DepthFrame& depthFrame);
+        void update_filtered_depthframe(DepthFrame& depthFrame);
+        void update_color_stream_state();
+        void cache_color_frame(Frame& frame);
+        void sync_registration_calibration();
 
         StreamSet m_streamset;
         astra_streamset_t m_streamSet;
@@ -32,6 +57,40 @@ namespace astra { namespace plugins { namespace xs {
         using PointStreamPtr = std::unique_ptr<PointStream>;
         PointStreamPtr m_pointStream;
 
+        using NormalStreamPtr = std::unique_ptr<NormalStream>;
+        NormalStreamPtr m_normalStream;
+
+        NormalCalculator m_normalCalculator;
+
+        using RegisteredDepthStreamPtr = std::unique_ptr<RegisteredDepthStream>;
+        RegisteredDepthStreamPtr m_registeredDepthStream;
+
+        DepthRegistration m_depthRegistration;
+
+        using ColoredPointStreamPtr = std::unique_ptr<ColoredPointStream>;
+        ColoredPointStreamPtr m_coloredPointStream;
+
+        ColoredPointCalculator m_coloredPointCalculator;
+
+        using FilteredDepthStreamPtr = std::unique_ptr<FilteredDepthStream>;
+        FilteredDepthStreamPtr m_filteredDepthStream;
+
+        DepthFilter m_depthFilter;
+
+        //color has its own reader so depth derived streams are not
+        //held back waiting for color frames
+        StreamReader m_colorReader;
+        ColorStream m_colorStream;
+        bool m_colorStreamStarted{ false };
+
+        std::vector<astra_rgb_pixel_t> m_colorBuffer;
+        int m_colorWidth{ 0 };
+        int m_colorHeight{ 0 };
+
+        //point storage for when normals are requested but points are not
+        std::unique_ptr<Vector3f[]> m_pointBuffer;
+        size_t m_pointBufferLength{ 0 };
+
         conversion_cache_t m_depthConversionCache;
     };
 
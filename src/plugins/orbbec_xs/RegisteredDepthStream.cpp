@@ -0,0 +1,117 @@
+#include "RegisteredDepthStream.h"
+#include "DepthRegistration.h"
+#include <AstraUL/streams/depth_parameters.h>
+#include <AstraUL/streams/image_parameters.h>
+#include <cmath>
+#include <cstring>
+
+namespace astra { namespace plugins { namespace xs {
+
+    void RegisteredDepthStream::set_calibration(const astra_depth_calibration_t& calibration)
+    {
+        m_calibration = calibration;
+
+        //the bin size is fixed, so keep the color intrinsics at the stream resolution
+        astra_camera_intrinsics_t& color = m_calibration.colorIntrinsics;
+        if (color.width > 0 && color.height > 0 &&
+            (color.width != m_width || color.height != m_height))
+        {
+            const float scaleX = static_cast<float>(m_width) / color.width;
+            const float scaleY = static_cast<float>(m_height) / color.height;
+
+            color.fx *= scaleX;
+            color.cx *= scaleX;
+            color.fy *= scaleY;
+            color.cy *= scaleY;
+        }
+
+        color.width = m_width;
+        color.height = m_height;
+
+        refresh_conversion_cache();
+        m_calibrationChanged = true;
+    }
+
+    void RegisteredDepthStream::refresh_conversion_cache()
+    {
+        const astra_camera_intrinsics_t& color = m_calibration.colorIntrinsics;
+
+        m_conversionCache.resolutionX = color.width;
+        m_conversionCache.resolutionY = color.height;
+        m_conversionCache.halfResX = color.width / 2;
+        m_conversionCache.halfResY = color.height / 2;
+        m_conversionCache.coeffX = color.fx;
+        m_conversionCache.coeffY = color.fy;
+        m_conversionCache.xzFactor = color.width / color.fx;
+        m_conversionCache.yzFactor = color.height / color.fy;
+    }
+
+    template<typename T>
+    void RegisteredDepthStream::get_parameter_value(astra_parameter_bin_t& parameterBin, const T& value)
+    {
+        size_t resultByteLength = sizeof(T);
+
+        astra_parameter_data_t parameterData;
+        astra_status_t rc = pluginService().get_parameter_bin(resultByteLength,
+                                                              &parameterBin,
+                                                              &parameterData);
+        if (rc == ASTRA_STATUS_SUCCESS)
+        {
+            memcpy(parameterData, &value, resultByteLength);
+        }
+    }
+
+    void RegisteredDepthStream::on_get_parameter(astra_streamconnection_t connection,
+                                                 astra_parameter_id id,
+                                                 astra_parameter_bin_t& parameterBin)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_DEPTH_CALIBRATION:
+            get_parameter_value(parameterBin, m_calibration);
+            break;
+        case ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE:
+            get_parameter_value(parameterBin, m_conversionCache);
+            break;
+        case ASTRA_PARAMETER_DEPTH_REGISTRATION:
+            get_parameter_value(parameterBin, true);
+            break;
+        case ASTRA_PARAMETER_IMAGE_HFOV:
+        {
+            const astra_camera_intrinsics_t& color = m_calibration.colorIntrinsics;
+            float hFov = 2 * std::atan(color.width / (2 * color.fx));
+            get_parameter_value(parameterBin, hFov);
+            break;
+        }
+        case ASTRA_PARAMETER_IMAGE_VFOV:
+        {
+            const astra_camera_intrinsics_t& color = m_calibration.colorIntrinsics;
+            float vFov = 2 * std::atan(color.height / (2 * color.fy));
+            get_parameter_value(parameterBin, vFov);
+            break;
+        }
+        }
+    }
+
+    void RegisteredDepthStream::on_set_parameter(astra_streamconnection_t connection,
+                                                 astra_parameter_id id,
+                                                 size_t inByteLength,
+                                                 astra_parameter_data_t inData)
+    {
+        switch (id)
+        {
+        case ASTRA_PARAMETER_DEPTH_CALIBRATION:
+            if (inByteLength >= sizeof(astra_depth_calibration_t))
+            {
+                astra_depth_calibration_t calibration;
+                memcpy(&calibration, inData, sizeof(astra_depth_calibration_t));
+
+                if (DepthRegistration::is_valid_calibration(calibration))
+                {
+                    set_calibration(calibration);
+                }
+            }
+            break;
+        }
+    }
+}}}
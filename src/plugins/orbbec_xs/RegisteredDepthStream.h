@@ -0,0 +1,65 @@
+#ifndef REGISTEREDDEPTHSTREAM_H
+#define REGISTEREDDEPTHSTREAM_H
+
+#include <Astra/Plugins/SingleBinStream.h>
+#include <AstraUL/streams/depth_types.h>
+#include <AstraUL/astraul_ctypes.h>
+#include <AstraUL/Plugins/stream_types.h>
+#include <Shiny.h>
+
+namespace astra { namespace plugins { namespace xs {
+
+    class RegisteredDepthStream : public astra::plugins::SingleBinStream<astra_imageframe_wrapper_t>
+    {
+    public:
+        RegisteredDepthStream(PluginServiceProxy& pluginService,
+                              astra_streamset_t streamSet,
+                              const astra_depth_calibration_t& calibration)
+            : SingleBinStream(pluginService,
+                              streamSet,
+                              StreamDescription(ASTRA_STREAM_DEPTH,
+                                                ASTRA_DEPTH_SUBTYPE_REGISTERED),
+                              calibration.colorIntrinsics.width *
+                              calibration.colorIntrinsics.height *
+                              sizeof(int16_t)),
+              m_width(calibration.colorIntrinsics.width),
+              m_height(calibration.colorIntrinsics.height)
+        {
+            set_calibration(calibration);
+        }
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
+        const astra_depth_calibration_t& calibration() const { return m_calibration; }
+        void set_calibration(const astra_depth_calibration_t& calibration);
+
+        bool calibration_changed() const { return m_calibrationChanged; }
+        void clear_calibration_changed() { m_calibrationChanged = false; }
+
+    protected:
+        virtual void on_set_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      size_t inByteLength,
+                                      astra_parameter_data_t inData) override;
+
+        virtual void on_get_parameter(astra_streamconnection_t connection,
+                                      astra_parameter_id id,
+                                      astra_parameter_bin_t& parameterBin) override;
+
+    private:
+        void refresh_conversion_cache();
+
+        template<typename T>
+        void get_parameter_value(astra_parameter_bin_t& parameterBin, const T& value);
+
+        const int m_width;
+        const int m_height;
+
+        astra_depth_calibration_t m_calibration;
+        conversion_cache_t m_conversionCache;
+        bool m_calibrationChanged{ true };
+    };
+}}}
+
+#endif /* REGISTEREDDEPTHSTREAM_H */
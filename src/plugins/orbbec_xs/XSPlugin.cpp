@@ -10,7 +10,9 @@ namespace astra { namespace plugins { namespace xs {
                                    astra_stream_t streamHandle,
                                    astra_stream_desc_t streamDesc)
     {
+        //derived depth subtypes are published by the processors themselves
         if (streamDesc.type == ASTRA_STREAM_DEPTH &&
+            streamDesc.subtype == DEFAULT_SUBTYPE &&
             m_pointProcessorMap.find(streamHandle) == m_pointProcessorMap.end())
         {
             LOG_INFO("astra.plugins.xs.XSPlugin", "creating point processor");
@@ -19,7 +21,8 @@ namespace astra { namespace plugins { namespace xs {
 
             auto pointProcessorPtr = std::make_unique<PointProcessor>(pluginService(),
                                                                       setHandle,
-                                                                      depthDescription);
+                                                                      depthDescription,
+                                                                      m_workerPool);
 
             m_pointProcessorMap[streamHandle] = std::move(pointProcessorPtr);
         }
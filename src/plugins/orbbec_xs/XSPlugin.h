@@ -4,6 +4,7 @@
 #include <Astra/Plugins/PluginKit.h>
 #include <AstraUL/AstraUL.h>
 #include "PointProcessor.h"
+#include <common/parallel/WorkerPool.h>
 #include <memory>
 #include <unordered_map>
 
@@ -41,6 +42,9 @@ namespace astra { namespace plugins { namespace xs {
                                                      StreamHandleHash,
                                                      StreamHandleEqualTo>;
 
+        //shared by all processors, frames are processed one at a time
+        parallel::WorkerPool m_workerPool;
+
         PointProcessorMap m_pointProcessorMap;
     };
 }}}